@@ -0,0 +1,261 @@
+/*************************************************************************/
+/*  test_canvas.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_canvas.h"
+#include "test_check.h"
+#include "servers/visual_server.h"
+#include "globals.h"
+#include "print_string.h"
+#include "os/os.h"
+
+/* Checks the canvas batching and culling stages of the visual server. Meant
+ * to run on the server platform (RasterizerDummy), but works on any renderer. */
+
+namespace TestCanvas {
+
+static void _check(const String& p_what,VisualServer *p_vs,int p_batches,int p_commands=-1) {
+
+	p_vs->draw();
+	int batches=p_vs->get_render_info(VS::INFO_CANVAS_BATCHES_IN_FRAME);
+	int commands=p_vs->get_render_info(VS::INFO_CANVAS_BATCHED_COMMANDS_IN_FRAME);
+
+	bool ok = batches==p_batches && (p_commands<0 || commands==p_commands);
+	TestCheck::check(ok,p_what+" - batches: "+itos(batches)+" (expected "+itos(p_batches)+"), commands: "+itos(commands));
+}
+
+static Rect2 _cell(int p_idx) {
+
+	return Rect2((p_idx%40)*16,((p_idx/40)%30)*16,16,16);
+}
+
+MainLoop* test_batching() {
+
+	VisualServer *vs=VS::get_singleton();
+	TestCheck::begin();
+
+	Image img(16,16,false,Image::FORMAT_RGBA);
+	RID tex_a=vs->texture_create_from_image(img);
+	RID tex_b=vs->texture_create_from_image(img);
+
+	RID viewport=vs->viewport_create();
+	VS::ViewportRect vr;
+	vr.x=0;
+	vr.y=0;
+	vr.width=640;
+	vr.height=480;
+	vs->viewport_set_rect(viewport,vr);
+	vs->viewport_attach_to_screen(viewport);
+
+	RID canvas=vs->canvas_create();
+	vs->viewport_attach_canvas(viewport,canvas);
+
+	RID item=vs->canvas_item_create();
+	vs->canvas_item_set_parent(item,canvas);
+
+	for(int i=0;i<1000;i++)
+		vs->canvas_item_add_texture_rect(item,_cell(i),tex_a);
+	_check("rects sharing a texture",vs,1,1000);
+
+	vs->canvas_item_clear(item);
+	for(int i=0;i<100;i++)
+		vs->canvas_item_add_texture_rect(item,_cell(i),i%2?tex_a:tex_b);
+	_check("alternating textures",vs,100,100);
+
+	vs->canvas_item_clear(item);
+	for(int i=0;i<100;i++) {
+		if (i==50)
+			vs->canvas_item_add_set_blend_mode(item,VS::MATERIAL_BLEND_MODE_ADD);
+		vs->canvas_item_add_texture_rect(item,_cell(i),tex_a);
+	}
+	_check("blend mode change",vs,2,100);
+
+	vs->canvas_item_clear(item);
+	for(int i=0;i<100;i++) {
+		if (i==50)
+			vs->canvas_item_add_line(item,Point2(0,0),Point2(100,100),Color(1,1,1));
+		vs->canvas_item_add_rect(item,_cell(i),Color(1,0,0));
+	}
+	_check("line between rects",vs,2,100);
+
+	vs->canvas_item_clear(item);
+	for(int i=0;i<10;i++)
+		vs->canvas_item_add_style_box(item,Rect2(i*40,0,32,32),tex_a,Vector2(4,4),Vector2(4,4));
+	_check("style boxes",vs,1,10);
+
+	vs->canvas_item_clear(item);
+	for(int i=0;i<3000;i++)
+		vs->canvas_item_add_texture_rect(item,_cell(i),tex_a);
+	_check("more quads than a batch holds",vs,2,3000);
+
+	vs->canvas_item_clear(item);
+	Vector<RID> items;
+	for(int i=0;i<200;i++) {
+
+		RID ci=vs->canvas_item_create();
+		vs->canvas_item_set_parent(ci,canvas);
+		vs->canvas_item_set_transform(ci,Matrix32(0,_cell(i).pos));
+		vs->canvas_item_add_texture_rect(ci,Rect2(0,0,16,16),tex_a);
+		items.push_back(ci);
+	}
+	_check("one rect per item",vs,1,200);
+
+	Globals::get_singleton()->set("render/canvas_batching",false);
+	_check("batching disabled",vs,0,0);
+	Globals::get_singleton()->set("render/canvas_batching",true);
+
+	for(int i=0;i<items.size();i++)
+		vs->free(items[i]);
+	vs->free(item);
+	vs->free(canvas);
+	vs->free(viewport);
+	vs->free(tex_a);
+	vs->free(tex_b);
+
+	TestCheck::end();
+
+	return NULL;
+}
+
+static void _check_cull(const String& p_what,VisualServer *p_vs,RID p_canvas,const Rect2& p_rect,int p_items) {
+
+	int items=p_vs->canvas_cull_rect(p_canvas,p_rect).size();
+
+	TestCheck::check(items==p_items,p_what+" - items: "+itos(items)+" (expected "+itos(p_items)+")");
+}
+
+MainLoop* test_culling() {
+
+	VisualServer *vs=VS::get_singleton();
+	TestCheck::begin();
+
+	Image img(16,16,false,Image::FORMAT_RGBA);
+	RID tex=vs->texture_create_from_image(img);
+
+	RID viewport=vs->viewport_create();
+	VS::ViewportRect vr;
+	vr.x=0;
+	vr.y=0;
+	vr.width=640;
+	vr.height=480;
+	vs->viewport_set_rect(viewport,vr);
+	vs->viewport_attach_to_screen(viewport);
+
+	RID canvas=vs->canvas_create();
+	vs->viewport_attach_canvas(viewport,canvas);
+
+	// a 3200x3200 level, a 21x16 block of sprites fits on screen
+	RID layer=vs->canvas_item_create();
+	vs->canvas_item_set_parent(layer,canvas);
+
+	Vector<RID> items;
+	for(int i=0;i<10000;i++) {
+
+		RID ci=vs->canvas_item_create();
+		vs->canvas_item_set_parent(ci,layer);
+		vs->canvas_item_set_transform(ci,Matrix32(0,Vector2((i%100)*32,(i/100)*32)));
+		vs->canvas_item_add_texture_rect(ci,Rect2(0,0,16,16),tex);
+		items.push_back(ci);
+	}
+
+	_check("level origin",vs,1,336);
+
+	vs->viewport_set_canvas_transform(viewport,canvas,Matrix32(0,Vector2(-1000,-1000)));
+	_check("scrolled view",vs,1,336);
+
+	vs->canvas_item_set_transform(layer,Matrix32(0,Vector2(1000,1000)));
+	_check("moved parent",vs,1,336);
+
+	uint64_t from=OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<100;i++)
+		vs->draw();
+	print_line("frame time: "+itos((OS::get_singleton()->get_ticks_usec()-from)/100)+" usec");
+
+	_check_cull("rect query",vs,canvas,Rect2(1000,1000,100,100),16);
+	_check_cull("empty area",vs,canvas,Rect2(-500,-500,100,100),0);
+
+	vs->canvas_item_set_parent(layer,RID());
+	_check("detached parent",vs,0,0);
+	_check_cull("detached parent",vs,canvas,Rect2(0,0,5000,5000),0);
+
+	for(int i=0;i<items.size();i++)
+		vs->free(items[i]);
+	vs->free(layer);
+	vs->free(canvas);
+	vs->free(viewport);
+	vs->free(tex);
+
+	TestCheck::end();
+
+	return NULL;
+}
+
+MainLoop* test_commands() {
+
+	// controls clear and re-add their commands on every update
+	VisualServer *vs=VS::get_singleton();
+
+	RID canvas=vs->canvas_create();
+	Vector<RID> items;
+	for(int i=0;i<1000;i++) {
+
+		RID ci=vs->canvas_item_create();
+		vs->canvas_item_set_parent(ci,canvas);
+		items.push_back(ci);
+	}
+
+	Vector<Point2> points;
+	points.push_back(Point2(0,0));
+	points.push_back(Point2(16,0));
+	points.push_back(Point2(16,16));
+	points.push_back(Point2(0,16));
+	Vector<Color> colors;
+	colors.push_back(Color(1,1,1));
+
+	uint64_t from=OS::get_singleton()->get_ticks_usec();
+	for(int f=0;f<100;f++) {
+
+		for(int i=0;i<items.size();i++) {
+
+			vs->canvas_item_clear(items[i]);
+			for(int j=0;j<20;j++)
+				vs->canvas_item_add_rect(items[i],_cell(j),Color(1,1,1));
+			vs->canvas_item_add_polygon(items[i],points,colors);
+			vs->canvas_item_add_line(items[i],Point2(),Point2(16,16),Color(1,1,1));
+		}
+	}
+
+	print_line("100 frames rebuilding 1000 items: "+itos((OS::get_singleton()->get_ticks_usec()-from)/1000)+" msec");
+
+	for(int i=0;i<items.size();i++)
+		vs->free(items[i]);
+	vs->free(canvas);
+
+	return NULL;
+}
+
+}
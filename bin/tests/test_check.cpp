@@ -0,0 +1,67 @@
+/*************************************************************************/
+/*  test_check.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_check.h"
+#include "print_string.h"
+#include "error_macros.h"
+#include "os/os.h"
+
+namespace TestCheck {
+
+static int failed=0;
+
+void begin() {
+
+	failed=0;
+}
+
+bool check(bool p_ok,const String& p_what) {
+
+	if (p_ok) {
+		print_line("PASS: "+p_what);
+	} else {
+		failed++;
+		ERR_PRINT(("FAIL: "+p_what).utf8().get_data());
+	}
+
+	return p_ok;
+}
+
+int end() {
+
+	if (failed) {
+		print_line(itos(failed)+" checks failed.");
+		OS::get_singleton()->set_exit_code(1);
+	} else {
+		print_line("All checks passed.");
+	}
+
+	return failed;
+}
+
+}
@@ -39,6 +39,8 @@
 #include "modules/gdscript/gd_parser.h"
 #include "modules/gdscript/gd_compiler.h"
 #include "modules/gdscript/gd_script.h"
+#include "modules/gdscript/gd_bytecode.h"
+#include "test_check.h"
 
 
 namespace TestGDScript {
@@ -514,10 +516,15 @@ static void _disassemble_class(const Ref<GDScript>& p_class,const Vector<String>
 
 			switch(code[ip]) {
 
-				case GDFunction::OPCODE_OPERATOR: {
+				case GDFunction::OPCODE_OPERATOR:
+				case GDFunction::OPCODE_OPERATOR_INT:
+				case GDFunction::OPCODE_OPERATOR_REAL:
+				case GDFunction::OPCODE_OPERATOR_VECTOR2:
+				case GDFunction::OPCODE_OPERATOR_VECTOR3: {
 
+					static const char* typed[]={"op ","op-int ","op-real ","op-vector2 ","op-vector3 "};
 					int op = code[ip+1];
-					txt+="op ";
+					txt+=typed[code[ip]-GDFunction::OPCODE_OPERATOR];
 
 					String opname = Variant::get_operator_name(Variant::Operator(op));
 
@@ -575,6 +582,28 @@ static void _disassemble_class(const Ref<GDScript>& p_class,const Vector<String>
 					txt+="\"]";
 					incr+=4;
 
+				} break;
+				case GDFunction::OPCODE_SET_MEMBER: {
+
+					txt+=" set_member ";
+					txt+=DADDR(1);
+					txt+=".";
+					txt+=func.get_global_name(code[ip+2]);
+					txt+="=";
+					txt+=DADDR(4);
+					incr+=5;
+
+				} break;
+				case GDFunction::OPCODE_GET_MEMBER: {
+
+					txt+=" get_member ";
+					txt+=DADDR(4);
+					txt+="=";
+					txt+=DADDR(1);
+					txt+=".";
+					txt+=func.get_global_name(code[ip+2]);
+					incr+=5;
+
 				} break;
 				case GDFunction::OPCODE_ASSIGN: {
 
@@ -675,7 +704,7 @@ static void _disassemble_class(const Ref<GDScript>& p_class,const Vector<String>
 
 					int argc=code[ip+1];
 					if (ret) {
-						txt+=DADDR(4+argc)+"=";
+						txt+=DADDR(5+argc)+"=";
 					}
 
 					txt+=DADDR(2)+".";
@@ -685,12 +714,12 @@ static void _disassemble_class(const Ref<GDScript>& p_class,const Vector<String>
 					for(int i=0;i<argc;i++) {
 						if (i>0)
 							txt+=", ";
-						txt+=DADDR(4+i);
+						txt+=DADDR(5+i);
 					}
-					txt+=")";
+					txt+=") cache "+itos(code[ip+4]);
 
 
-					incr=5+argc;
+					incr=6+argc;
 
 				} break;
 				case GDFunction::OPCODE_CALL_BUILT_IN: {
@@ -788,6 +817,18 @@ static void _disassemble_class(const Ref<GDScript>& p_class,const Vector<String>
 					txt+=" for-loop "+DADDR(4)+" in "+DADDR(2)+" counter "+DADDR(1)+" end "+itos(code[ip+3]);
 					incr+=5;
 
+				} break;
+				case GDFunction::OPCODE_ITERATE_RANGE_BEGIN: {
+
+					txt+=" for-range-init "+DADDR(5)+" from "+DADDR(1)+" to "+DADDR(2)+" step "+DADDR(3)+" end "+itos(code[ip+4]);
+					incr+=6;
+
+				} break;
+				case GDFunction::OPCODE_ITERATE_RANGE: {
+
+					txt+=" for-range-loop "+DADDR(5)+" counter "+DADDR(1)+" to "+DADDR(2)+" step "+DADDR(3)+" end "+itos(code[ip+4]);
+					incr+=6;
+
 				} break;
 				case GDFunction::OPCODE_LINE: {
 
@@ -821,8 +862,207 @@ static void _disassemble_class(const Ref<GDScript>& p_class,const Vector<String>
 	}
 }
 
+static void _benchmark_calls() {
+
+	//a chain of classes, the method and member are defined in the first one only
+	const int max_depth=16;
+	const int iterations=1000000;
+
+	String code="extends Reference\n\n";
+	code+="class L0 extends Reference:\n\n\tvar value=0\n\n\tfunc f(a):\n\t\treturn a\n\n";
+	for(int i=1;i<=max_depth;i++) {
+		code+="class L"+itos(i)+" extends L"+itos(i-1)+":\n\n\tfunc m"+itos(i)+"():\n\t\tpass\n\n";
+	}
+
+	GDParser parser;
+	Error err = parser.parse(code);
+	if (err) {
+		print_line("Parse Error:\n"+itos(parser.get_error_line())+":"+itos(parser.get_error_column())+":"+parser.get_error());
+		return;
+	}
+
+	Ref<GDScript> script = memnew( GDScript );
+	GDCompiler gdc;
+	err = gdc.compile(&parser,script.ptr());
+	if (err) {
+		print_line("Compile Error:\n"+itos(gdc.get_error_line())+":"+itos(gdc.get_error_column())+":"+gdc.get_error());
+		return;
+	}
+
+	StringName method="f";
+	StringName member="value";
+	Variant arg=1;
+
+	print_line("calls and member access through "+itos(iterations)+" iterations, usec per 1000 operations:");
+
+	for(int depth=0;depth<=max_depth;depth+=4) {
+
+		const Map<StringName,Ref<GDScript> >::Element *E = script->get_subclasses().find("L"+itos(depth));
+		ERR_CONTINUE(!E);
+
+		Variant::CallError ce;
+		Ref<GDScript> level = E->get();
+		Variant instance = level->_new(NULL,0,ce);
+		Object *obj = instance;
+		ERR_CONTINUE(!obj);
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		for(int i=0;i<iterations;i++)
+			obj->call(method,arg);
+		uint64_t call_time = OS::get_singleton()->get_ticks_usec()-from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		for(int i=0;i<iterations;i++) {
+			obj->set(member,arg);
+			obj->get(member);
+		}
+		uint64_t member_time = OS::get_singleton()->get_ticks_usec()-from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		for(int i=0;i<iterations;i++)
+			obj->has_method(method);
+		uint64_t has_time = OS::get_singleton()->get_ticks_usec()-from;
+
+		print_line("depth "+itos(depth)+": call "+rtos(call_time*1000.0/iterations)+", set+get "+rtos(member_time*1000.0/iterations)+", has_method "+rtos(has_time*1000.0/iterations));
+	}
+}
+
+static void _benchmark_vm() {
+
+	//each function is a tight loop dominated by one kind of opcode
+	const int iterations=1000000;
+
+	String code="extends Reference\n\n";
+	code+="var member=0\n\n";
+	code+="func int_loop(n):\n\tvar a=0\n\tvar i=0\n\twhile(i<n):\n\t\ta=a+i*2\n\t\ti+=1\n\treturn a\n\n";
+	code+="func real_math(n):\n\tvar x=0.0\n\tfor i in range(n):\n\t\tx=x*0.5+1.5\n\treturn x\n\n";
+	code+="func vector_math(n):\n\tvar v=Vector3()\n\tvar d=Vector3(1,2,3)\n\tfor i in range(n):\n\t\tv=v+d*0.5\n\treturn v\n\n";
+	code+="func g(a):\n\treturn a\n\n";
+	code+="func calls(n):\n\tvar a=0\n\tfor i in range(n):\n\t\ta=g(a)\n\treturn a\n\n";
+	code+="func members(n):\n\tfor i in range(n):\n\t\tmember=member+1\n\treturn member\n\n";
+	code+="func builtin_calls(n):\n\tvar arr=[1,2,3]\n\tvar v=Vector3(1,2,3)\n\tvar a=0\n\tfor i in range(n):\n\t\ta+=arr.size()+v.length()\n\treturn a\n\n";
+	code+="func array_loop(n):\n\tvar arr=[]\n\tarr.resize(n)\n\tvar a=0\n\tfor e in arr:\n\t\ta+=1\n\treturn a\n\n";
+
+	GDParser parser;
+	Error err = parser.parse(code);
+	if (err) {
+		print_line("Parse Error:\n"+itos(parser.get_error_line())+":"+itos(parser.get_error_column())+":"+parser.get_error());
+		return;
+	}
+
+	Ref<GDScript> script = memnew( GDScript );
+	GDCompiler gdc;
+	err = gdc.compile(&parser,script.ptr());
+	if (err) {
+		print_line("Compile Error:\n"+itos(gdc.get_error_line())+":"+itos(gdc.get_error_column())+":"+gdc.get_error());
+		return;
+	}
+
+	Variant::CallError ce;
+	Variant instance = script->_new(NULL,0,ce);
+	Object *obj = instance;
+	ERR_FAIL_COND(!obj);
+
+	const char *tests[]={"int_loop","real_math","vector_math","calls","members","builtin_calls","array_loop",NULL};
+	Variant n=iterations;
+
+	print_line("vm loops of "+itos(iterations)+" iterations, usec per 1000 iterations:");
+
+	for(int i=0;tests[i];i++) {
+
+		StringName method=tests[i];
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		Variant ret = obj->call(method,n);
+		uint64_t time = OS::get_singleton()->get_ticks_usec()-from;
+
+		print_line(String(tests[i])+": "+rtos(time*1000.0/iterations)+" (returned "+String(ret)+")");
+	}
+}
+
+static Ref<GDScript> _compile_code(const String& p_code) {
+
+	GDParser parser;
+	Error err = parser.parse(p_code);
+	if (err) {
+		print_line("Parse Error:\n"+itos(parser.get_error_line())+":"+itos(parser.get_error_column())+":"+parser.get_error());
+		return Ref<GDScript>();
+	}
+
+	Ref<GDScript> script = memnew( GDScript );
+	GDCompiler gdc;
+	err = gdc.compile(&parser,script.ptr());
+	if (err) {
+		print_line("Compile Error:\n"+itos(gdc.get_error_line())+":"+itos(gdc.get_error_column())+":"+gdc.get_error());
+		return Ref<GDScript>();
+	}
+
+	return script;
+}
+
+static Variant _call_new(const Ref<GDScript>& p_script,const StringName& p_method) {
+
+	Ref<GDScript> script = p_script;
+	Variant::CallError ce;
+	Variant instance = script->_new(NULL,0,ce);
+	Object *obj = instance;
+	ERR_FAIL_COND_V(!obj,Variant());
+	return obj->call(p_method);
+}
+
+static void _test_bytecode_cache() {
+
+	//Box extends a sibling that sorts after it, so subclasses must load in the order they were declared
+	String code="extends Reference\n\n";
+	code+="class Shape:\n\tvar sides=0\n\tfunc describe():\n\t\treturn sides\n\n";
+	code+="class Box extends Shape:\n\tclass Lid:\n\t\tfunc weight():\n\t\t\treturn 3\n";
+	code+="\tfunc _init():\n\t\tsides=4\n\tfunc describe():\n\t\treturn sides*10+Lid.new().weight()\n\n";
+	code+="class Crate extends Box:\n\tfunc describe():\n\t\treturn .describe()+100\n\n";
+	code+="func run():\n\treturn Crate.new().describe()*1000+Box.new().describe()+Shape.new().describe()\n";
+
+	TestCheck::begin();
+
+	Ref<GDScript> script=_compile_code(code);
+	if (TestCheck::check(script.is_valid(),"compile")) {
+
+		Vector<uint8_t> bytecode;
+		Error err = GDBytecode::save(script.ptr(),bytecode);
+		TestCheck::check(err==OK,"save - "+itos(bytecode.size())+" bytes");
+
+		Ref<GDScript> loaded = memnew( GDScript );
+		err = GDBytecode::load(loaded.ptr(),bytecode);
+		if (TestCheck::check(err==OK,"load - error "+itos(err))) {
+
+			TestCheck::check(loaded->get_subclasses().size()==3,"subclasses - "+itos(loaded->get_subclasses().size())+" (expected 3)");
+
+			Variant expected=_call_new(script,"run");
+			Variant result=_call_new(loaded,"run");
+			TestCheck::check(expected==result,"same result - "+String(result)+" (expected "+String(expected)+")");
+		}
+	}
+
+	TestCheck::end();
+}
+
 MainLoop* test(TestType p_test) {
 
+	if (p_test==TEST_CALL_BENCHMARK) {
+
+		_benchmark_calls();
+		return NULL;
+	}
+
+	if (p_test==TEST_VM_BENCHMARK) {
+
+		_benchmark_vm();
+		return NULL;
+	}
+
+	if (p_test==TEST_BYTECODE_CACHE) {
+
+		_test_bytecode_cache();
+		return NULL;
+	}
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
@@ -38,6 +38,9 @@ enum TestType {
 	TEST_PARSER,
 	TEST_COMPILER,
 	TEST_BYTECODE,
+	TEST_CALL_BENCHMARK,
+	TEST_VM_BENCHMARK,
+	TEST_BYTECODE_CACHE,
 };
 
 MainLoop* test(TestType p_type);
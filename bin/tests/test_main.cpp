@@ -47,6 +47,8 @@
 #include "test_shader_lang.h"
 #include "test_gdscript.h"
 #include "test_image.h"
+#include "test_memory.h"
+#include "test_canvas.h"
 
 
 const char ** tests_get_names()  {
@@ -84,12 +86,22 @@ MainLoop* test_main(String p_test,const List<String>& p_args) {
 	
 		return TestMath::test();
 	}
+
+	if (p_test=="math_simd") {
+
+		return TestMath::test_simd();
+	}
   
 	if (p_test=="physics") {
 	
 		return TestPhysics::test();
 	}
 
+	if (p_test=="physics_broadphase") {
+
+		return TestPhysics::test_broadphase();
+	}
+
 	if (p_test=="physics_2d") {
 
 		return TestPhysics2D::test();
@@ -157,6 +169,61 @@ MainLoop* test_main(String p_test,const List<String>& p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test=="gd_call_bench") {
+
+		return TestGDScript::test(TestGDScript::TEST_CALL_BENCHMARK);
+	}
+
+	if (p_test=="gd_vm_bench") {
+
+		return TestGDScript::test(TestGDScript::TEST_VM_BENCHMARK);
+	}
+
+	if (p_test=="gd_bytecode_cache") {
+
+		return TestGDScript::test(TestGDScript::TEST_BYTECODE_CACHE);
+	}
+
+	if (p_test=="memory_bench") {
+
+		return TestMemory::test();
+	}
+
+	if (p_test=="dvector_bench") {
+
+		return TestMemory::test_dvector();
+	}
+
+	if (p_test=="render_culling") {
+
+		return TestRender::test_culling();
+	}
+
+	if (p_test=="render_lod") {
+
+		return TestRender::test_lod();
+	}
+
+	if (p_test=="render_simplify") {
+
+		return TestRender::test_simplifier();
+	}
+
+	if (p_test=="canvas_batching") {
+
+		return TestCanvas::test_batching();
+	}
+
+	if (p_test=="canvas_culling") {
+
+		return TestCanvas::test_culling();
+	}
+
+	if (p_test=="canvas_commands_bench") {
+
+		return TestCanvas::test_commands();
+	}
+
 	if (p_test=="image") {
 
 		return TestImage::test();
@@ -40,6 +40,8 @@
 #include "scene/resources/texture.h"
 #include "vmap.h"
 #include "os/os.h"
+#include "math_simd.h"
+#include "test_check.h"
 namespace TestMath {
 
 
@@ -76,6 +78,168 @@ fix: 0, 0, 100, 100
 }
 
 
+/* micro benchmarks for the SIMD kernels, each one runs with the scalar path first and then the SIMD one */
+
+static uint64_t _bench_kernel(int p_kernel,int p_rounds,const Vector<Transform>& p_xforms,const Vector<Vector3>& p_points,Vector<Vector3>& r_points,const Vector<AABB>& p_aabbs,const MathSIMD::PlaneSet& p_planes,int &r_checksum) {
+
+	uint64_t begin=OS::get_singleton()->get_ticks_usec();
+	r_checksum=0;
+
+	for(int r=0;r<p_rounds;r++) {
+
+		switch(p_kernel) {
+			case 0: {
+
+				Transform accum;
+				for(int i=0;i<p_xforms.size();i++) {
+					accum*=p_xforms[i];
+					accum.orthonormalize();
+				}
+				r_checksum+=accum.origin.x>0;
+			} break;
+			case 1: {
+
+				MathSIMD::transform_points(p_xforms[r%p_xforms.size()],&p_points[0],&r_points[0],p_points.size());
+				r_checksum+=r_points[0].x>0;
+			} break;
+			case 2: {
+
+				for(int i=0;i<p_aabbs.size();i++) {
+					if (MathSIMD::aabb_intersects_planes(p_aabbs[i],p_planes))
+						r_checksum++;
+				}
+			} break;
+			case 3: {
+
+				AABB aabb=MathSIMD::aabb_merge(&p_aabbs[0],p_aabbs.size());
+				r_checksum+=aabb.size.x>0;
+			} break;
+			case 4: {
+
+				AABB aabb=MathSIMD::aabb_from_points(&p_points[0],p_points.size());
+				r_checksum+=aabb.size.x>0;
+			} break;
+		}
+	}
+
+	return OS::get_singleton()->get_ticks_usec()-begin;
+}
+
+/* the SIMD kernels add in a different order than the scalar code, so results are compared per element, with a tolerance
+ * relative to the magnitude of the terms that were added (an element can cancel to almost zero) */
+
+static real_t _simd_error(const Vector3& p_a,const Vector3& p_b,real_t p_scale) {
+
+	Vector3 d=(p_a-p_b).abs();
+	return MAX(d.x,MAX(d.y,d.z))/MAX(1.0,p_scale);
+}
+
+static void _check_simd(const Vector<Transform>& p_xforms,const Vector<Vector3>& p_points) {
+
+	const real_t tolerance=1e-5;
+	int count=p_xforms.size();
+
+	real_t compose_err=0;
+	real_t points_err=0;
+
+	Vector<Vector3> scalar_points;
+	Vector<Vector3> simd_points;
+	scalar_points.resize(count);
+	simd_points.resize(count);
+
+	for(int i=0;i<count;i++) {
+
+		const Transform &a=p_xforms[i];
+		const Transform &b=p_xforms[(i*7+1)%count];
+
+		MathSIMD::set_enabled(false);
+		Transform scalar=a;
+		scalar*=b;
+		MathSIMD::set_enabled(true);
+		Transform simd=a;
+		simd*=b;
+
+		//bases are orthonormal, the origin adds up both origins
+		for(int j=0;j<3;j++)
+			compose_err=MAX(compose_err,_simd_error(scalar.basis[j],simd.basis[j],1.0));
+		compose_err=MAX(compose_err,_simd_error(scalar.origin,simd.origin,a.origin.length()+b.origin.length()));
+	}
+
+	for(int i=0;i<16;i++) {
+
+		const Transform &xform=p_xforms[i];
+
+		MathSIMD::set_enabled(false);
+		MathSIMD::transform_points(xform,&p_points[0],&scalar_points[0],count);
+		MathSIMD::set_enabled(true);
+		MathSIMD::transform_points(xform,&p_points[0],&simd_points[0],count);
+
+		for(int j=0;j<count;j++)
+			points_err=MAX(points_err,_simd_error(scalar_points[j],simd_points[j],p_points[j].length()+xform.origin.length()));
+	}
+
+	TestCheck::check(compose_err<=tolerance,"transform compose matches scalar, max relative error "+rtos(compose_err));
+	TestCheck::check(points_err<=tolerance,"transform points matches scalar, max relative error "+rtos(points_err));
+}
+
+MainLoop* test_simd() {
+
+	const int count=16384;
+	const int rounds=200;
+
+	Math::seed(1234);
+
+	Vector<Transform> xforms;
+	Vector<Vector3> points;
+	Vector<Vector3> out_points;
+	Vector<AABB> aabbs;
+	xforms.resize(count);
+	points.resize(count);
+	out_points.resize(count);
+	aabbs.resize(count);
+
+	for(int i=0;i<count;i++) {
+
+		Vector3 axis(Math::random(-1,1),Math::random(-1,1),Math::random(-1,1));
+		if (axis==Vector3())
+			axis=Vector3(0,1,0);
+		xforms[i]=Transform(Matrix3(axis.normalized(),Math::random(-Math_PI,Math_PI)),Vector3(Math::random(-1,1),Math::random(-1,1),Math::random(-1,1)));
+		points[i]=Vector3(Math::random(-500,500),Math::random(-500,500),Math::random(-500,500));
+		aabbs[i]=AABB(points[i],Vector3(Math::random(0,10),Math::random(0,10),Math::random(0,10)));
+	}
+
+	CameraMatrix cm;
+	cm.set_perspective(60,1.33,0.1,400);
+	Vector<Plane> frustum=cm.get_projection_planes(Transform());
+	MathSIMD::PlaneSet planes;
+	planes.set(&frustum[0],frustum.size());
+
+	const char *names[5]={"transform compose","transform points","aabb vs planes","aabb merge","aabb from points"};
+
+	print_line("SIMD kernels "+String(MathSIMD::is_supported()?"available":"not available, both runs are scalar")+", "+itos(count)+" elements, "+itos(rounds)+" rounds.");
+
+	TestCheck::begin();
+	_check_simd(xforms,points);
+
+	for(int i=0;i<5;i++) {
+
+		int scalar_check,simd_check;
+
+		MathSIMD::set_enabled(false);
+		uint64_t scalar_time=_bench_kernel(i,rounds,xforms,points,out_points,aabbs,planes,scalar_check);
+		MathSIMD::set_enabled(true);
+		uint64_t simd_time=_bench_kernel(i,rounds,xforms,points,out_points,aabbs,planes,simd_check);
+
+		print_line(String(names[i])+": scalar "+itos(scalar_time)+" usec, simd "+itos(simd_time)+" usec");
+		if (i>=2) //the aabb kernels give the same answers on this data, the transform ones are checked above
+			TestCheck::check(scalar_check==simd_check,String(names[i])+" matches scalar: "+itos(scalar_check)+" vs "+itos(simd_check));
+	}
+
+	TestCheck::end();
+
+	return NULL;
+}
+
 MainLoop* test() {
 
 	{
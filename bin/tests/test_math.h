@@ -34,6 +34,7 @@
 namespace TestMath {
 
 MainLoop* test();
+MainLoop* test_simd();
 
 }
 
@@ -0,0 +1,223 @@
+/*************************************************************************/
+/*  test_memory.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_memory.h"
+#include "os/memory.h"
+#include "dvector.h"
+#include "os/os.h"
+#include "os/thread.h"
+#include "print_string.h"
+
+namespace TestMemory {
+
+enum {
+	SLOTS=512,
+	ITERATIONS=400000,
+	MAX_THREADS=8
+};
+
+struct WorkerData {
+
+	uint32_t seed;
+	uint64_t checksum;
+};
+
+static uint32_t _rand(uint32_t &r_seed) {
+
+	r_seed=r_seed*1664525+1013904223;
+	return r_seed>>8;
+}
+
+static size_t _rand_size(uint32_t &r_seed) {
+
+	uint32_t r=_rand(r_seed);
+	//mostly small blocks, like strings and containers, some medium and few large ones
+	switch(r&15) {
+		case 15: return 4096+(r>>4)%65536;
+		case 14:
+		case 13: return 256+(r>>4)%4096;
+		default: return 1+(r>>4)%256;
+	}
+}
+
+static void _worker(void *p_data) {
+
+	WorkerData *wd=(WorkerData*)p_data;
+	void *slots[SLOTS];
+	for(int i=0;i<SLOTS;i++)
+		slots[i]=NULL;
+
+	uint32_t seed=wd->seed;
+	uint64_t checksum=0;
+
+	for(int i=0;i<ITERATIONS;i++) {
+
+		uint32_t r=_rand(seed);
+		int idx=r%SLOTS;
+
+		if (!slots[idx]) {
+
+			size_t size=_rand_size(seed);
+			slots[idx]=Memory::alloc_static(size);
+			((uint8_t*)slots[idx])[0]=r&0xFF;
+		} else if ((r>>16)%4==0) {
+
+			slots[idx]=Memory::realloc_static(slots[idx],_rand_size(seed));
+			checksum+=((uint8_t*)slots[idx])[0];
+		} else {
+
+			checksum+=((uint8_t*)slots[idx])[0];
+			Memory::free_static(slots[idx]);
+			slots[idx]=NULL;
+		}
+	}
+
+	for(int i=0;i<SLOTS;i++) {
+		if (slots[i])
+			Memory::free_static(slots[i]);
+	}
+
+	wd->checksum=checksum;
+}
+
+MainLoop* test() {
+
+	print_line("static allocator benchmark, "+itos(ITERATIONS)+" operations per thread");
+
+	for(int threads=1;threads<=MAX_THREADS;threads*=2) {
+
+		WorkerData data[MAX_THREADS];
+		Thread *thread[MAX_THREADS];
+
+		uint64_t from=OS::get_singleton()->get_ticks_usec();
+
+		for(int i=0;i<threads;i++) {
+			data[i].seed=12345+i*7919;
+			data[i].checksum=0;
+			thread[i]=Thread::create(_worker,&data[i]);
+		}
+
+		for(int i=0;i<threads;i++) {
+			Thread::wait_to_finish(thread[i]);
+			memdelete(thread[i]);
+		}
+
+		uint64_t usec=OS::get_singleton()->get_ticks_usec()-from;
+		uint64_t ops=(uint64_t)threads*ITERATIONS;
+
+		uint64_t checksum=0;
+		for(int i=0;i<threads;i++)
+			checksum+=data[i].checksum;
+
+		print_line(itos(threads)+" threads: "+rtos(usec/1000.0)+" msec, "+rtos(ops*1000.0/usec)+" ops/msec, checksum "+itos(checksum));
+	}
+
+	print_line("static memory in use: "+itos(Memory::get_static_mem_usage()));
+
+	return NULL;
+}
+
+enum {
+	DVECTOR_SIZE=4096,
+	DVECTOR_ITERATIONS=20000
+};
+
+struct DVectorWorkerData {
+
+	const DVector<float> *shared;
+	float sum;
+};
+
+static void _dvector_worker(void *p_data) {
+
+	DVectorWorkerData *wd=(DVectorWorkerData*)p_data;
+	float sum=0;
+
+	for(int i=0;i<DVECTOR_ITERATIONS;i++) {
+
+		//share, read a few elements, then modify the private copy every now and then
+		DVector<float> local=*wd->shared;
+		{
+			DVector<float>::Read r=local.read();
+			sum+=r[i%DVECTOR_SIZE];
+		}
+		sum+=local.get((i*7)%DVECTOR_SIZE);
+
+		if (i%64==0) {
+			DVector<float>::Write w=local.write();
+			w[0]=sum;
+		}
+	}
+
+	wd->sum=sum;
+}
+
+MainLoop* test_dvector() {
+
+	print_line("DVector sharing benchmark, "+itos(DVECTOR_ITERATIONS)+" copies per thread");
+
+	DVector<float> shared;
+	shared.resize(DVECTOR_SIZE);
+	{
+		DVector<float>::Write w=shared.write();
+		for(int i=0;i<DVECTOR_SIZE;i++)
+			w[i]=i;
+	}
+
+	for(int threads=1;threads<=MAX_THREADS;threads*=2) {
+
+		DVectorWorkerData data[MAX_THREADS];
+		Thread *thread[MAX_THREADS];
+
+		uint64_t from=OS::get_singleton()->get_ticks_usec();
+
+		for(int i=0;i<threads;i++) {
+			data[i].shared=&shared;
+			data[i].sum=0;
+			thread[i]=Thread::create(_dvector_worker,&data[i]);
+		}
+
+		for(int i=0;i<threads;i++) {
+			Thread::wait_to_finish(thread[i]);
+			memdelete(thread[i]);
+		}
+
+		uint64_t usec=OS::get_singleton()->get_ticks_usec()-from;
+		uint64_t ops=(uint64_t)threads*DVECTOR_ITERATIONS;
+
+		float sum=0;
+		for(int i=0;i<threads;i++)
+			sum+=data[i].sum;
+
+		print_line(itos(threads)+" threads: "+rtos(usec/1000.0)+" msec, "+rtos(ops*1000.0/usec)+" copies/msec, sum "+rtos(sum));
+	}
+
+	return NULL;
+}
+
+}
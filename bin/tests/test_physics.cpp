@@ -37,6 +37,9 @@
 #include "map.h"
 #include "os/os.h"
 #include "quick_hull.h"
+#include "servers/physics/body_sw.h"
+#include "servers/physics/broad_phase_octree.h"
+#include "servers/physics/broad_phase_bvh.h"
 
 class TestPhysicsMainLoop : public MainLoop {
 
@@ -659,4 +662,108 @@ MainLoop* test() {
 
 }
 
+/* broadphase benchmark, moves a cloud of boxes around a static floor and measures pair generation */
+
+static void* _bench_pair_callback(CollisionObjectSW *A,int p_subindex_A,CollisionObjectSW *B,int p_subindex_B,void *p_userdata) {
+
+	(*(int*)p_userdata)++;
+	return NULL;
+}
+
+static void _bench_unpair_callback(CollisionObjectSW *A,int p_subindex_A,CollisionObjectSW *B,int p_subindex_B,void *p_data,void *p_userdata) {
+
+	(*(int*)p_userdata)--;
+}
+
+static void _bench_broadphase(const String& p_name,BroadPhaseSW *p_bp,Vector<BodySW*>& p_objects,int p_static_count,int p_steps) {
+
+	int pairs=0;
+	p_bp->set_pair_callback(_bench_pair_callback,&pairs);
+	p_bp->set_unpair_callback(_bench_unpair_callback,&pairs);
+
+	Math::seed(1234);
+
+	int count=p_objects.size();
+	Vector<BroadPhaseSW::ID> ids;
+	Vector<AABB> aabbs;
+	Vector<Vector3> velocities;
+	ids.resize(count);
+	aabbs.resize(count);
+	velocities.resize(count);
+
+	const real_t extent=200;
+	int floor_side=Math::ceil(Math::sqrt((double)p_static_count));
+
+	uint64_t begin=OS::get_singleton()->get_ticks_usec();
+
+	for(int i=0;i<count;i++) {
+
+		bool is_static=i<p_static_count;
+		if (is_static) {
+			real_t cell=extent/floor_side;
+			aabbs[i]=AABB(Vector3((i%floor_side)*cell,-1,(i/floor_side)*cell),Vector3(cell,1,cell));
+		} else {
+			aabbs[i]=AABB(Vector3(Math::random(0,extent),Math::random(0,extent*0.25),Math::random(0,extent)),Vector3(1,1,1));
+			velocities[i]=Vector3(Math::random(-1,1),Math::random(-1,1),Math::random(-1,1))*0.5;
+		}
+
+		ids[i]=p_bp->create(p_objects[i]);
+		p_bp->set_static(ids[i],is_static);
+		p_bp->move(ids[i],aabbs[i]);
+	}
+	p_bp->update();
+
+	uint64_t insert_time=OS::get_singleton()->get_ticks_usec()-begin;
+	begin=OS::get_singleton()->get_ticks_usec();
+
+	for(int s=0;s<p_steps;s++) {
+
+		for(int i=p_static_count;i<count;i++) {
+
+			AABB &aabb=aabbs[i];
+			Vector3 &vel=velocities[i];
+			aabb.pos+=vel;
+			for(int j=0;j<3;j++) {
+				if (aabb.pos[j]<0 || aabb.pos[j]>(j==1?extent*0.25:extent))
+					vel[j]=-vel[j];
+			}
+			p_bp->move(ids[i],aabb);
+		}
+		p_bp->update();
+	}
+
+	uint64_t step_time=OS::get_singleton()->get_ticks_usec()-begin;
+
+	for(int i=0;i<count;i++)
+		p_bp->remove(ids[i]);
+
+	print_line(p_name+": insert "+itos(insert_time)+" usec, "+rtos(step_time/(double)p_steps)+" usec per step, "+itos(pairs)+" pairs at end.");
+}
+
+MainLoop* test_broadphase() {
+
+	const int static_count=1024;
+	const int dynamic_count=8192;
+	const int steps=100;
+
+	Vector<BodySW*> objects;
+	for(int i=0;i<static_count+dynamic_count;i++)
+		objects.push_back(memnew( BodySW ));
+
+	print_line("Broadphase benchmark: "+itos(static_count)+" static, "+itos(dynamic_count)+" moving, "+itos(steps)+" steps.");
+
+	BroadPhaseSW *bp = BroadPhaseOctree::_create();
+	_bench_broadphase("Octree",bp,objects,static_count,steps);
+	memdelete(bp);
+
+	bp = BroadPhaseBVH::_create();
+	_bench_broadphase("BVH",bp,objects,static_count,steps);
+	memdelete(bp);
+
+	for(int i=0;i<objects.size();i++)
+		memdelete(objects[i]);
+
+	return NULL;
+}
+
 }
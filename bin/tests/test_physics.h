@@ -38,6 +38,7 @@
 namespace TestPhysics {
 
 MainLoop* test();
+MainLoop* test_broadphase();
 
 }
 
@@ -27,12 +27,16 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 #include "test_render.h"
+#include "test_check.h"
 #include "servers/visual_server.h"
 #include "os/main_loop.h"
 #include "math_funcs.h"
 #include "print_string.h"
 #include "os/os.h"
 #include "quick_hull.h"
+#include "scene/resources/mesh_simplifier.h"
+#include "scene/resources/surface_tool.h"
+#include "scene/resources/material.h"
 #define OBJECT_COUNT 50
 
 namespace TestRender {
@@ -254,4 +258,249 @@ MainLoop* test() {
 
 }
 
+static void _check_cull(const String& p_what,int p_expected) {
+
+	VisualServer *vs=VisualServer::get_singleton();
+	vs->draw();
+
+	int visible=vs->get_render_info(VS::INFO_CULL_VISIBLE_IN_FRAME);
+	TestCheck::check(visible==p_expected,p_what+" - visible: "+itos(visible)+" (expected "+itos(p_expected)+"), in frustum: "+itos(vs->get_render_info(VS::INFO_CULL_INSTANCES_IN_FRAME))+", cull time: "+itos(vs->get_render_info(VS::INFO_CULL_USEC_IN_FRAME))+" usec");
+}
+
+MainLoop* test_culling() {
+
+	// more instances than the old fixed cull buffer (8192) could hold
+	VisualServer *vs=VisualServer::get_singleton();
+	RID cube=vs->get_test_cube();
+	RID scenario=vs->scenario_create();
+
+	List<RID> instances;
+	for(int i=0;i<100;i++) {
+		for(int j=0;j<100;j++) {
+
+			RID instance=vs->instance_create2(cube,scenario);
+			vs->instance_set_transform(instance,Transform(Matrix3(),Vector3(i*4-200,0,j*4-200)));
+			instances.push_back(instance);
+		}
+	}
+
+	RID camera=vs->camera_create();
+	vs->camera_set_orthogonal(camera,1000,1,100);
+
+	RID viewport=vs->viewport_create();
+	VS::ViewportRect vr;
+	vr.width=640;
+	vr.height=640;
+	vs->viewport_set_rect(viewport,vr);
+	vs->viewport_attach_to_screen(viewport);
+	vs->viewport_attach_camera(viewport,camera);
+	vs->viewport_set_scenario(viewport,scenario);
+
+	TestCheck::begin();
+	Transform looking_down;
+	looking_down.set_look_at(Vector3(0,50,0),Vector3(),Vector3(0,0,-1));
+	vs->camera_set_transform(camera,looking_down);
+	_check_cull("whole grid",10000);
+
+	Transform looking_up;
+	looking_up.set_look_at(Vector3(0,50,0),Vector3(0,100,0),Vector3(0,0,-1));
+	vs->camera_set_transform(camera,looking_up);
+	_check_cull("nothing",0);
+
+	vs->free(viewport);
+	vs->free(camera);
+	for(List<RID>::Element *E=instances.front();E;E=E->next())
+		vs->free(E->get());
+	vs->free(scenario);
+
+	TestCheck::end();
+
+	return NULL;
+}
+
+// flat p_size x p_size grid of quads, uvs are split at column p_seam
+static Ref<Mesh> _make_grid(int p_size,int p_seam,const Ref<Material>& p_material) {
+
+	Ref<SurfaceTool> st = memnew( SurfaceTool );
+	st->begin(Mesh::PRIMITIVE_TRIANGLES);
+
+	// one vertex per grid point, plus a second column on the seam for the right side
+	for(int x=0;x<=p_size;x++) {
+		for(int z=0;z<=p_size;z++) {
+
+			st->add_normal(Vector3(0,1,0));
+			st->add_uv(Vector2(float(x)/p_size+(x>p_seam?1:0),float(z)/p_size));
+			st->add_vertex(Vector3(x,0,z));
+		}
+	}
+
+	int seam_base=(p_size+1)*(p_size+1);
+	for(int z=0;z<=p_size;z++) {
+
+		st->add_normal(Vector3(0,1,0));
+		st->add_uv(Vector2(float(p_seam)/p_size+1,float(z)/p_size));
+		st->add_vertex(Vector3(p_seam,0,z));
+	}
+
+	static const int quad[6][2]={{0,0},{1,0},{1,1},{0,0},{1,1},{0,1}};
+
+	for(int i=0;i<p_size;i++) {
+		for(int j=0;j<p_size;j++) {
+
+			for(int k=0;k<6;k++) {
+
+				int x=i+quad[k][0];
+				int z=j+quad[k][1];
+				st->add_index(x==p_seam && i>=p_seam ? seam_base+z : x*(p_size+1)+z);
+			}
+		}
+	}
+
+	st->set_material(p_material);
+	return st->commit();
+}
+
+MainLoop* test_simplifier() {
+
+	const int size=20;
+	const int seam=10;
+	const float ratio=0.25;
+
+	Ref<Material> material = memnew( FixedMaterial );
+	Ref<Mesh> grid=_make_grid(size,seam,material);
+
+	Ref<MeshSimplifier> simplifier = memnew( MeshSimplifier );
+	Ref<Mesh> lod=simplifier->simplify(grid,ratio);
+
+	TestCheck::begin();
+
+	int faces=grid->surface_get_array_index_len(0)/3;
+	int lod_faces=lod->surface_get_array_index_len(0)/3;
+	int target=int(faces*ratio);
+	TestCheck::check(lod_faces>0 && lod_faces<=target,"face count: "+itos(lod_faces)+" (from "+itos(faces)+", target "+itos(target)+")");
+
+	TestCheck::check(lod->surface_get_material(0)==material,"surface keeps its material");
+	TestCheck::check(lod->surface_get_format(0)==grid->surface_get_format(0),"surface keeps its format - "+itos(lod->surface_get_format(0))+" (expected "+itos(grid->surface_get_format(0))+")");
+
+	Array arrays=lod->surface_get_arrays(0);
+	DVector<Vector3> points=arrays[Mesh::ARRAY_VERTEX];
+	DVector<Vector2> uvs=arrays[Mesh::ARRAY_TEX_UV];
+
+	// vertices are never moved, so every one must still be on a grid point
+	Set<Vector3> positions;
+	bool on_grid=true;
+	for(int i=0;i<points.size();i++) {
+
+		Vector3 v=points[i];
+		if (v.y!=0 || v.x!=Math::floor(v.x) || v.z!=Math::floor(v.z))
+			on_grid=false;
+		positions.insert(v);
+	}
+	TestCheck::check(on_grid,"vertices stay on the grid");
+
+	int border_missing=0;
+	for(int i=0;i<=size;i++) {
+
+		if (!positions.has(Vector3(i,0,0)))
+			border_missing++;
+		if (!positions.has(Vector3(i,0,size)))
+			border_missing++;
+		if (!positions.has(Vector3(0,0,i)))
+			border_missing++;
+		if (!positions.has(Vector3(size,0,i)))
+			border_missing++;
+	}
+	TestCheck::check(border_missing==0,"border vertices kept - missing: "+itos(border_missing));
+
+	// both sides of the uv seam must survive, with their own uvs
+	int seam_missing=0;
+	for(int i=0;i<=size;i++) {
+
+		bool left=false,right=false;
+		for(int j=0;j<points.size();j++) {
+
+			if (points[j]!=Vector3(seam,0,i))
+				continue;
+			if (uvs[j].x<1)
+				left=true;
+			else
+				right=true;
+		}
+		if (!left || !right)
+			seam_missing++;
+	}
+	TestCheck::check(seam_missing==0,"seam vertices kept on both sides - missing: "+itos(seam_missing));
+
+	TestCheck::end();
+
+	return NULL;
+}
+
+static void _check_lod(RID p_camera,RID p_instance,float p_distance,int p_expected) {
+
+	VisualServer *vs=VisualServer::get_singleton();
+	Transform xform;
+	xform.origin=Vector3(0,0,p_distance);
+	vs->camera_set_transform(p_camera,xform);
+	vs->draw();
+
+	int level=vs->instance_geometry_get_lod_level(p_instance);
+	TestCheck::check(level==p_expected,"distance "+rtos(p_distance)+" - lod level: "+itos(level)+" (expected "+itos(p_expected)+")");
+}
+
+MainLoop* test_lod() {
+
+	VisualServer *vs=VisualServer::get_singleton();
+	RID cube=vs->get_test_cube();
+	RID scenario=vs->scenario_create();
+	RID instance=vs->instance_create2(cube,scenario);
+
+	Vector<RID> meshes;
+	meshes.push_back(vs->mesh_create());
+	meshes.push_back(vs->mesh_create());
+	Vector<float> distances;
+	distances.push_back(10);
+	distances.push_back(20);
+	vs->instance_geometry_set_lod_meshes(instance,meshes,distances);
+	vs->instance_geometry_set_lod_hysteresis(instance,1);
+
+	RID camera=vs->camera_create();
+	vs->camera_set_perspective(camera,60,0.1,100);
+
+	RID viewport=vs->viewport_create();
+	VS::ViewportRect vr;
+	vr.width=640;
+	vr.height=640;
+	vs->viewport_set_rect(viewport,vr);
+	vs->viewport_attach_to_screen(viewport);
+	vs->viewport_attach_camera(viewport,camera);
+	vs->viewport_set_scenario(viewport,scenario);
+
+	TestCheck::begin();
+	_check_lod(camera,instance,5,0);
+	_check_lod(camera,instance,10.5,0); // inside the hysteresis margin
+	_check_lod(camera,instance,12,1);
+	_check_lod(camera,instance,9.5,1);
+	_check_lod(camera,instance,8,0);
+	_check_lod(camera,instance,50,2); // several levels at once
+	_check_lod(camera,instance,19.5,2);
+	_check_lod(camera,instance,15,1);
+
+	// freeing a lod mesh drops it and the coarser levels
+	vs->free(meshes[1]);
+	int remaining=vs->instance_geometry_get_lod_meshes(instance).size();
+	TestCheck::check(remaining==1,"freed lod mesh - levels: "+itos(remaining)+" (expected 1)");
+	_check_lod(camera,instance,50,1);
+
+	vs->free(viewport);
+	vs->free(camera);
+	vs->free(instance);
+	vs->free(meshes[0]);
+	vs->free(scenario);
+
+	TestCheck::end();
+
+	return NULL;
+}
+
 }
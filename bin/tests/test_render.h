@@ -38,6 +38,9 @@
 namespace TestRender {
 
 MainLoop* test();
+MainLoop* test_culling();
+MainLoop* test_lod();
+MainLoop* test_simplifier();
 
 }
 
@@ -29,63 +29,113 @@
 #include "command_queue_mt.h"
 #include "os/os.h"
 
-void CommandQueueMT::lock() {
-
-	if (mutex)
-		mutex->lock();
+CommandQueueMT::Chunk *CommandQueueMT::_create_chunk() {
+
+	Chunk *chunk = memnew( Chunk );
+	chunk->mem = (uint8_t*)memalloc(COMMAND_MEM_SIZE);
+	chunk->committed=0;
+	chunk->next=NULL;
+	chunk_count++;
+	stats.memory_used=chunk_count*COMMAND_MEM_SIZE;
+	return chunk;
 }
 
-void CommandQueueMT::unlock() {
+void CommandQueueMT::_next_chunk() {
 
-	if (mutex)
-		mutex->unlock();
-}
+	// called with the producer lock held, the command written so far stays unpublished until unlock()
+	Chunk *next = write_chunk->next;
 
-void CommandQueueMT::wait_for_flush() {
+	if (next==read_chunk) {
+		// the consumer is still in the next chunk, link a new one in instead of waiting for it
+		Chunk *chunk = _create_chunk();
+		chunk->next=next;
+		next=chunk;
+		stats.stalls++;
+	}
 
-	// wait one millisecond for a flush to happen
-	OS::get_singleton()->delay_usec(1000);
-}
+	next->committed=0;
+	COMMAND_QUEUE_BARRIER();
+	write_chunk->next=next;
 
-CommandQueueMT::SyncSemaphore* CommandQueueMT::_alloc_sync_sem() {
+	// zero means, continue in the next chunk
+	*(uint32_t*)&write_chunk->mem[write_ptr]=0;
+	write_ptr+=COMMAND_HEADER_SIZE;
 
-	int idx=-1;
+	COMMAND_QUEUE_BARRIER();
+	write_chunk->committed=write_ptr;
 
-	while(true) {
+	write_chunk=next;
+	write_ptr=0;
+}
+
+CommandQueueMT::SyncSemaphore* CommandQueueMT::_alloc_sync_sem() {
 
-		for(int i=0;i<SYNC_SEMAPHORES;i++) {
+	// called with the producer lock held
+	SyncSemaphore *ss=sync_sems;
 
-			if (!sync_sems[i].in_use) {
-				sync_sems[i].in_use=true;
-				idx=i;
-				break;
-			}
-		}
+	while(ss) {
 
-		if (idx==-1) {
-			wait_for_flush();
-		} else {
+		if (!ss->in_use)
 			break;
-		}
+		ss=ss->next;
+	}
+
+	if (!ss) {
+		//all in use, add one
+		ss = memnew( SyncSemaphore );
+		ss->sem=Semaphore::create();
+		ss->next=sync_sems;
+		sync_sems=ss;
 	}
 
-	return &sync_sems[idx];
+	ss->in_use=true;
+	stats.sync_waits++;
+
+	return ss;
 }
 
+void CommandQueueMT::_wait_sync(SyncSemaphore *p_sync_sem) {
 
-CommandQueueMT::CommandQueueMT(bool p_sync){
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	p_sync_sem->sem->wait();
+	uint64_t waited = OS::get_singleton()->get_ticks_usec()-begin;
 
-	read_ptr=0;
-	write_ptr=0;	
-	mutex = Mutex::create();
+	if (mutex)
+		mutex->lock();
+	stats.sync_wait_usec+=waited;
+	if (mutex)
+		mutex->unlock();
+}
 
-	for(int i=0;i<SYNC_SEMAPHORES;i++) {
+void CommandQueueMT::reset_stats() {
 
-		sync_sems[i].sem=Semaphore::create();
-		sync_sems[i].in_use=false;
+	stats.commands_pushed=0;
+	stats.bytes_pushed=0;
+	stats.stalls=0;
+	stats.sync_waits=0;
+	stats.sync_wait_usec=0;
+}
 
 
-	}
+CommandQueueMT::CommandQueueMT(bool p_sync,bool p_single_producer){
+
+	chunk_count=0;
+	reset_stats();
+
+	//a ring of one
+	write_chunk=_create_chunk();
+	write_chunk->next=write_chunk;
+	read_chunk=write_chunk;
+	read_ptr=0;
+	write_ptr=0;
+
+	if (p_single_producer)
+		mutex=NULL;
+	else
+		mutex = Mutex::create();
+
+	sync_sems=NULL;
+
 	if (p_sync)
 		sync = Semaphore::create();
 	else
@@ -97,11 +147,22 @@ CommandQueueMT::~CommandQueueMT() {
 
 	if (sync)
 		memdelete(sync);
-	memdelete(mutex);
-	for(int i=0;i<SYNC_SEMAPHORES;i++) {
+	if (mutex)
+		memdelete(mutex);
 
-		memdelete(sync_sems[i].sem);
-	}
-}
+	while(sync_sems) {
 
+		SyncSemaphore *ss=sync_sems;
+		sync_sems=ss->next;
+		memdelete(ss->sem);
+		memdelete(ss);
+	}
 
+	Chunk *chunk=write_chunk;
+	do {
+		Chunk *next=chunk->next;
+		memfree(chunk->mem);
+		memdelete(chunk);
+		chunk=next;
+	} while(chunk!=write_chunk);
+}
@@ -34,16 +34,43 @@
 #include "os/mutex.h"
 #include "os/memory.h"
 #include "simple_type.h"
+
+#if defined(NO_THREADS)
+#define COMMAND_QUEUE_BARRIER()
+#elif defined(__GNUC__)
+#define COMMAND_QUEUE_BARRIER() __sync_synchronize()
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define COMMAND_QUEUE_BARRIER() _ReadWriteBarrier()
+#else
+#define COMMAND_QUEUE_BARRIER()
+#endif
+
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
 */
 
 class CommandQueueMT {
 
+public:
+
+	struct Stats {
+
+		uint64_t commands_pushed;
+		uint64_t bytes_pushed;
+		uint64_t stalls; ///< times the queue was full and had to grow, the consumer was a full ring behind
+		uint64_t sync_waits; ///< pushes that waited for the consumer to run them
+		uint64_t sync_wait_usec; ///< time spent in those waits
+		int memory_used; ///< bytes allocated for commands
+	};
+
+private:
+
 	struct SyncSemaphore {
 
 		Semaphore *sem;
-		bool in_use;
+		volatile bool in_use;
+		SyncSemaphore *next;
 	};
 
 	struct CommandBase {
@@ -392,60 +419,60 @@ class CommandQueueMT {
 
 	/***** BASE *******/
 
+	/* Commands are written into a ring of chunks. The producer only ever writes
+	   in chunks the consumer is not reading, and when it reaches the chunk the
+	   consumer is in, it links a new one in instead of waiting, so the ring grows
+	   to whatever a frame needs. Commands are published by advancing the chunk's
+	   committed size, so the consumer never locks. Producers only lock among
+	   themselves, and not at all if the queue is single producer. */
+
 	enum {	
 		COMMAND_MEM_SIZE_KB=256,
 		COMMAND_MEM_SIZE=COMMAND_MEM_SIZE_KB*1024,
-		SYNC_SEMAPHORES=8
+		COMMAND_HEADER_SIZE=8, // keeps commands 8 bytes aligned
 	};
 
+	struct Chunk {
 
-	uint8_t command_mem[COMMAND_MEM_SIZE];
-	uint32_t read_ptr;
+		Chunk * volatile next;
+		volatile uint32_t committed; // bytes the consumer may read
+		uint8_t *mem;
+	};
+
+	Chunk *write_chunk;
 	uint32_t write_ptr;
-	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
+	Chunk * volatile read_chunk;
+	uint32_t read_ptr;
+	int chunk_count;
+
+	SyncSemaphore *sync_sems; //linked list, grows as needed
 	Mutex *mutex;
 	Semaphore *sync;
-	
+
+	Stats stats;
+
+	Chunk *_create_chunk();
 	
 	template<class T>
 	T* allocate() {
 	
-		// alloc size is size+T+safeguard
-		uint32_t alloc_size=sizeof(T)+sizeof(uint32_t);
-		
-		tryagain:
-		
-		if (write_ptr < read_ptr) {
-			// behind read_ptr, check that there is room
-			if ( (read_ptr-write_ptr) <= alloc_size )
-				return NULL;
-		} else if (write_ptr >= read_ptr) {
-			// ahead of read_ptr, check that there is room
-			
-			
-			if ( (COMMAND_MEM_SIZE-write_ptr) < alloc_size+4 ) {
-				// no room at the end, wrap down;
-				
-				if (read_ptr==0) // dont want write_ptr to become read_ptr
-					return NULL;
-					
-				// if this happens, it's a bug
-				ERR_FAIL_COND_V( (COMMAND_MEM_SIZE-write_ptr) < sizeof(uint32_t), NULL );
-				// zero means, wrap to begining
-
-				uint32_t * p = (uint32_t*)&command_mem[write_ptr];
-				*p=0;
-				write_ptr=0;
-				goto tryagain;
-			}
+		// alloc size is header+T, rounded up so the next one stays aligned
+		uint32_t alloc_size=(COMMAND_HEADER_SIZE+sizeof(T)+COMMAND_HEADER_SIZE-1)&~(COMMAND_HEADER_SIZE-1);
+
+		if ( (COMMAND_MEM_SIZE-write_ptr) < alloc_size+COMMAND_HEADER_SIZE ) {
+			// no room at the end, continue in the next chunk
+			_next_chunk();
 		}
+
 		// allocate the size
-		uint32_t * p = (uint32_t*)&command_mem[write_ptr];
-		*p=sizeof(T);
-		write_ptr+=sizeof(uint32_t);
+		uint32_t * p = (uint32_t*)&write_chunk->mem[write_ptr];
+		*p=alloc_size-COMMAND_HEADER_SIZE;
 		// allocate the command
-		T* cmd = memnew_placement( &command_mem[write_ptr], T );
-		write_ptr+=sizeof(T);
+		T* cmd = memnew_placement( &write_chunk->mem[write_ptr+COMMAND_HEADER_SIZE], T );
+		write_ptr+=alloc_size;
+
+		stats.commands_pushed++;
+		stats.bytes_pushed+=alloc_size;
 		return cmd;
 	
 	}
@@ -454,54 +481,62 @@ class CommandQueueMT {
 	T* allocate_and_lock() {
 	
 		lock();
-		T* ret;
-		
-		while ( (ret=allocate<T>())==NULL ) {
-		
-			unlock();
-			// sleep a little until fetch happened and some room is made			
-			wait_for_flush();
-			lock();
-			
-		}
-				
-		return ret;
+		return allocate<T>();
 	}
 	
 	
 	bool flush_one() {
 	
 		tryagain:
+
+		Chunk *chunk=read_chunk;
+		uint32_t committed=chunk->committed;
+		COMMAND_QUEUE_BARRIER();
 		
 		// tried to read an empty queue
-		if (read_ptr == write_ptr )
+		if (read_ptr == committed )
 			return false;
 		
-		uint32_t size = *(uint32_t*)( &command_mem[read_ptr] );
+		uint32_t size = *(uint32_t*)( &chunk->mem[read_ptr] );
 		
 		if (size==0) {
-			//end of ringbuffer, wrap
+			//end of chunk, continue in the next one
 			read_ptr=0;
+			COMMAND_QUEUE_BARRIER();
+			read_chunk=chunk->next;
 			goto tryagain;
 		}
 		
-		read_ptr+=sizeof(uint32_t);
-		
-		CommandBase *cmd = reinterpret_cast<CommandBase*>( &command_mem[read_ptr] );
+		CommandBase *cmd = reinterpret_cast<CommandBase*>( &chunk->mem[read_ptr+COMMAND_HEADER_SIZE] );
 		
 		cmd->call();
 		cmd->~CommandBase();
 		
-		read_ptr+=size;		
+		read_ptr+=COMMAND_HEADER_SIZE+size;
 
 		return true;
 	}
 	
 	
-	void lock();
-	void unlock();
-	void wait_for_flush();
+	_FORCE_INLINE_ void lock() {
+
+		if (mutex)
+			mutex->lock();
+	}
+
+	_FORCE_INLINE_ void unlock() {
+
+		// publish what was written
+		COMMAND_QUEUE_BARRIER();
+		write_chunk->committed=write_ptr;
+
+		if (mutex)
+			mutex->unlock();
+	}
+
+	void _next_chunk();
 	SyncSemaphore* _alloc_sync_sem();
+	void _wait_sync(SyncSemaphore *p_sync_sem);
 	
 	
 public:
@@ -656,7 +691,7 @@ public:
 		unlock();
 		
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1,class R>
@@ -674,7 +709,7 @@ public:
 		unlock();
 		
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2,class R>
@@ -693,7 +728,7 @@ public:
 		unlock();
 		
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2, class P3,class R>
@@ -713,7 +748,7 @@ public:
 		unlock();
 		
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2, class P3, class P4,class R>
@@ -734,7 +769,7 @@ public:
 		unlock();
 		
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2, class P3, class P4, class P5,class R>
@@ -756,7 +791,7 @@ public:
 		unlock();
 		
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2, class P3, class P4, class P5, class P6,class R>
@@ -779,7 +814,7 @@ public:
 		unlock();
 		
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 	
 	template<class T, class M, class P1, class P2, class P3, class P4, class P5, class P6,class P7,class R>
@@ -803,7 +838,7 @@ public:
 		unlock();
 		
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 
@@ -821,7 +856,7 @@ public:
 		unlock();
 
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1>
@@ -839,7 +874,7 @@ public:
 		unlock();
 
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2>
@@ -858,7 +893,7 @@ public:
 		unlock();
 
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2, class P3>
@@ -878,7 +913,7 @@ public:
 		unlock();
 
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2, class P3, class P4>
@@ -899,7 +934,7 @@ public:
 		unlock();
 
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2, class P3, class P4, class P5>
@@ -921,7 +956,7 @@ public:
 		unlock();
 
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2, class P3, class P4, class P5, class P6>
@@ -944,7 +979,7 @@ public:
 		unlock();
 
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	template<class T, class M, class P1, class P2, class P3, class P4, class P5, class P6,class P7>
@@ -968,30 +1003,29 @@ public:
 		unlock();
 
 		if (sync) sync->post();
-		ss->sem->wait();
+		_wait_sync(ss);
 	}
 
 	void wait_and_flush_one() {
 		ERR_FAIL_COND(!sync);
 		sync->wait();
-		lock();
-		flush_one();		
-		unlock();
+		flush_one();
 	}
 	
 	void flush_all() {
 			
 		ERR_FAIL_COND(sync);
-		lock();
 		while (true) {
 			bool exit = !flush_one();
 			if (exit)
 				break;
 		}
-		unlock();
 	}
+
+	const Stats& get_stats() const { return stats; }
+	void reset_stats();
 	
-	CommandQueueMT(bool p_sync);
+	CommandQueueMT(bool p_sync,bool p_single_producer=false);
 	~CommandQueueMT();
 	
 };
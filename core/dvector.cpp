@@ -28,5 +28,3 @@
 /*************************************************************************/
 #include "dvector.h"
 
-Mutex* dvector_lock=NULL;
-
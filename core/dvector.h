@@ -37,121 +37,96 @@
 */
 
 
-extern Mutex* dvector_lock;
-
 template<class T>
 class DVector {
 
 	mutable MID mem;
-		
-		
+
+	/* the shared buffer starts with the refcount, elements follow */
+
+	_FORCE_INLINE_ static SafeRefCount *_get_refcount(void *p_data) { return (SafeRefCount*)p_data; }
+	_FORCE_INLINE_ static T *_get_data(void *p_data) { return (T*)((uint8_t*)p_data+sizeof(SafeRefCount)); }
+
 	void copy_on_write() {
 		
 		if (!mem.is_valid())
 			return;
 
-		if (dvector_lock)
-			dvector_lock->lock();
-					
 		MID_Lock lock( mem );
 		
-
-		if ( *(int*)lock.data()  == 1 ) {
+		if ( _get_refcount(lock.data())->get() == 1 ) {
 			// one reference, means no refcount changes
-			if (dvector_lock)
-				dvector_lock->unlock();
 			return;
 		}
 		
 		MID new_mem= dynalloc( mem.get_size() );
 		
-		if (!new_mem.is_valid()) {
-		
-			if (dvector_lock)
-				dvector_lock->unlock();
-			ERR_FAIL_COND( new_mem.is_valid() ); // out of memory		
-		}
+		ERR_FAIL_COND( !new_mem.is_valid() ); // out of memory		
 		
 		MID_Lock dst_lock( new_mem );
 		
-		int *rc = (int*)dst_lock.data();
-		
-		*rc=1;
-		
-		T * dst = (T*)(rc + 1 );
+		_get_refcount(dst_lock.data())->init();
 		
-		T * src =(T*) ((int*)lock.data() + 1 );
+		T * dst = _get_data(dst_lock.data());
+		T * src = _get_data(lock.data());
 		
-		int count = (mem.get_size() - sizeof(int)) / sizeof(T);
+		int count = (mem.get_size() - sizeof(SafeRefCount)) / sizeof(T);
 		
 		for (int i=0;i<count;i++) {
 		
 			memnew_placement( &dst[i], T(src[i]) );
 		}
 		
-		(*(int*)lock.data())--;
+		if (_get_refcount(lock.data())->unref()) {
+			// other owners went away while copying
+			for (int i=0;i<count;i++) {
+
+				src[i].~T();
+			}
+		}
 		
 		// unlock all
 		dst_lock=MID_Lock();
 		lock=MID_Lock();
 		
 		mem=new_mem;
-				
-		if (dvector_lock)
-			dvector_lock->unlock();
-				
 	}
 	
 	void reference( const DVector& p_dvector ) {
 	
 		unreference();
 				
-		if (dvector_lock)
-			dvector_lock->lock();
-		
 		if (!p_dvector.mem.is_valid()) {
 		
-			if (dvector_lock)
-				dvector_lock->unlock();
 			return;			
 		}
 		
 		MID_Lock lock(p_dvector.mem);
 		
-		int * rc = (int*)lock.data();
-		(*rc)++;
+		if (!_get_refcount(lock.data())->ref()) {
+			// being destroyed
+			return;
+		}
 		
 		lock = MID_Lock();
 		mem=p_dvector.mem;
-			
-		if (dvector_lock)
-			dvector_lock->unlock();
-			
 	}
 	
 	
 	void unreference() {
 	
-		if (dvector_lock)
-			dvector_lock->lock();
-		
 		if (!mem.is_valid()) {
 		
-			if (dvector_lock)
-				dvector_lock->unlock();
 			return;			
 		}
 		
 		MID_Lock lock(mem);
 		
-		int * rc = (int*)lock.data();
-		(*rc)--;
-		
-		if (*rc==0) {
+		if (_get_refcount(lock.data())->unref()) {
 			// no one else using it, destruct
 			
-			T * t= (T*)(rc+1);
-			int count = (mem.get_size() - sizeof(int)) / sizeof(T);
+			T * t= _get_data(lock.data());
+			int count = (mem.get_size() - sizeof(SafeRefCount)) / sizeof(T);
 			
 			for (int i=0;i<count;i++) {
 			
@@ -164,10 +139,6 @@ class DVector {
 		lock = MID_Lock();
 		
 		mem = MID ();
-		
-		if (dvector_lock)
-			dvector_lock->unlock();
-					
 	}
 	
 public:
@@ -202,7 +173,7 @@ public:
 		Read r;
 		if (mem.is_valid()) {		
 			r.lock = MID_Lock( mem );
-			r.mem = (const T*)((int*)r.lock.data()+1);
+			r.mem = _get_data(r.lock.data());
 		}
 		return r;		
 	}
@@ -212,7 +183,7 @@ public:
 		if (mem.is_valid()) {
 			copy_on_write();
 			w.lock = MID_Lock( mem );
-			w.mem = (T*)((int*)w.lock.data()+1);
+			w.mem = _get_data(w.lock.data());
 		}
 		return w;		
 	}
@@ -279,7 +250,7 @@ public:
 template<class T>
 int DVector<T>::size() const {
 
-	return mem.is_valid() ? ((mem.get_size() - sizeof(int)) / sizeof(T) ) : 0;
+	return mem.is_valid() ? ((mem.get_size() - sizeof(SafeRefCount)) / sizeof(T) ) : 0;
 }
 
 template<class T>
@@ -323,16 +294,9 @@ const T DVector<T>::operator[](int p_index) const {
 template<class T>
 Error DVector<T>::resize(int p_size) {
 
-	if (dvector_lock)
-		dvector_lock->lock();
-
-	bool same = p_size==size();
-	
-	if (dvector_lock)
-		dvector_lock->unlock();
-	// no further locking is necesary because we are supposed to own the only copy of this (using copy on write)	
+	// no locking is necesary because we are supposed to own the only copy of this (using copy on write)	
 	
-	if (same)
+	if (p_size==size())
 		return OK;
 
 	if (p_size == 0 ) {
@@ -354,14 +318,13 @@ Error DVector<T>::resize(int p_size) {
 		
 		if (oldsize==0) {
 
-			mem = dynalloc( p_size * sizeof(T) + sizeof(int) );
+			mem = dynalloc( p_size * sizeof(T) + sizeof(SafeRefCount) );
 			lock=MID_Lock(mem);
-			int *rc = ((int*)lock.data());
-			*rc=1;
+			_get_refcount(lock.data())->init();
 			
 		} else {
 
-			if (dynrealloc( mem, p_size * sizeof(T) + sizeof(int) )!=OK ) {
+			if (dynrealloc( mem, p_size * sizeof(T) + sizeof(SafeRefCount) )!=OK ) {
 			
 				ERR_FAIL_V(ERR_OUT_OF_MEMORY); // out of memory
 			}
@@ -372,7 +335,7 @@ Error DVector<T>::resize(int p_size) {
 	
 		
 		
-		T *t = (T*)((int*)lock.data() + 1);
+		T *t = _get_data(lock.data());
 		
 		for (int i=oldsize;i<p_size;i++) {
 		
@@ -387,7 +350,7 @@ Error DVector<T>::resize(int p_size) {
 		MID_Lock lock(mem);
 		
 		
-		T *t = (T*)((int*)lock.data() + 1);
+		T *t = _get_data(lock.data());
 		
 		for (int i=p_size;i<oldsize;i++) {
 		
@@ -396,7 +359,7 @@ Error DVector<T>::resize(int p_size) {
 		
 		lock = MID_Lock(); // clear
 	
-		if (dynrealloc( mem, p_size * sizeof(T) + sizeof(int) )!=OK ) {
+		if (dynrealloc( mem, p_size * sizeof(T) + sizeof(SafeRefCount) )!=OK ) {
 	
 			ERR_FAIL_V(ERR_OUT_OF_MEMORY); // wtf error		
 		}
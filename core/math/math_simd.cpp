@@ -0,0 +1,225 @@
+/*************************************************************************/
+/*  math_simd.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "math_simd.h"
+
+bool MathSIMD::enabled=true;
+
+void MathSIMD::PlaneSet::set(const Plane *p_planes,int p_plane_count) {
+
+	planes=p_planes;
+	plane_count=p_plane_count;
+
+	if (p_plane_count>MAX_PLANES) {
+		count=-1;
+		return;
+	}
+
+	count=(p_plane_count+3)&~3;
+
+	for(int i=0;i<count;i++) {
+
+		if (i<p_plane_count) {
+			nx[i]=p_planes[i].normal.x;
+			ny[i]=p_planes[i].normal.y;
+			nz[i]=p_planes[i].normal.z;
+			d[i]=p_planes[i].d;
+		} else {
+			//0>0 never rejects
+			nx[i]=0;
+			ny[i]=0;
+			nz[i]=0;
+			d[i]=0;
+		}
+	}
+}
+
+bool MathSIMD::is_supported() {
+
+#if defined(SIMD_SSE2_ENABLED) || defined(SIMD_NEON_ENABLED)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void MathSIMD::set_enabled(bool p_enabled) {
+
+	enabled=p_enabled;
+}
+
+bool MathSIMD::is_enabled() {
+
+	return enabled && is_supported();
+}
+
+void MathSIMD::transform_points(const Transform& p_xform,const Vector3 *p_src,Vector3 *p_dst,int p_count) {
+
+	const Matrix3 &b=p_xform.basis;
+
+#ifdef SIMD_SSE2_ENABLED
+	if (enabled) {
+
+		__m128 c0=_mm_setr_ps(b.elements[0][0],b.elements[1][0],b.elements[2][0],0);
+		__m128 c1=_mm_setr_ps(b.elements[0][1],b.elements[1][1],b.elements[2][1],0);
+		__m128 c2=_mm_setr_ps(b.elements[0][2],b.elements[1][2],b.elements[2][2],0);
+		__m128 o=_load3(p_xform.origin);
+
+		for(int i=0;i<p_count;i++) {
+
+			const Vector3 &v=p_src[i];
+			__m128 r=_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v.x),c0),_mm_mul_ps(_mm_set1_ps(v.y),c1)),_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v.z),c2),o));
+			_store3(p_dst[i],r);
+		}
+		return;
+	}
+#endif
+
+#ifdef SIMD_NEON_ENABLED
+	if (enabled) {
+
+		float32x4_t c0=_load3(Vector3(b.elements[0][0],b.elements[1][0],b.elements[2][0]));
+		float32x4_t c1=_load3(Vector3(b.elements[0][1],b.elements[1][1],b.elements[2][1]));
+		float32x4_t c2=_load3(Vector3(b.elements[0][2],b.elements[1][2],b.elements[2][2]));
+		float32x4_t o=_load3(p_xform.origin);
+
+		for(int i=0;i<p_count;i++) {
+
+			const Vector3 &v=p_src[i];
+			float32x4_t r=vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(o,c0,v.x),c1,v.y),c2,v.z);
+			_store3(p_dst[i],r);
+		}
+		return;
+	}
+#endif
+
+	for(int i=0;i<p_count;i++)
+		p_dst[i]=p_xform.xform(p_src[i]);
+}
+
+AABB MathSIMD::aabb_merge(const AABB *p_aabbs,int p_count) {
+
+	if (p_count<=0)
+		return AABB();
+
+#ifdef SIMD_SSE2_ENABLED
+	if (enabled) {
+
+		__m128 min=_load3(p_aabbs[0].pos);
+		__m128 max=_mm_add_ps(min,_load3(p_aabbs[0].size));
+
+		for(int i=1;i<p_count;i++) {
+
+			__m128 pos=_load3(p_aabbs[i].pos);
+			min=_mm_min_ps(min,pos);
+			max=_mm_max_ps(max,_mm_add_ps(pos,_load3(p_aabbs[i].size)));
+		}
+
+		AABB r;
+		_store3(r.pos,min);
+		_store3(r.size,_mm_sub_ps(max,min));
+		return r;
+	}
+#endif
+
+#ifdef SIMD_NEON_ENABLED
+	if (enabled) {
+
+		float32x4_t min=_load3(p_aabbs[0].pos);
+		float32x4_t max=vaddq_f32(min,_load3(p_aabbs[0].size));
+
+		for(int i=1;i<p_count;i++) {
+
+			float32x4_t pos=_load3(p_aabbs[i].pos);
+			min=vminq_f32(min,pos);
+			max=vmaxq_f32(max,vaddq_f32(pos,_load3(p_aabbs[i].size)));
+		}
+
+		AABB r;
+		_store3(r.pos,min);
+		_store3(r.size,vsubq_f32(max,min));
+		return r;
+	}
+#endif
+
+	AABB r=p_aabbs[0];
+	for(int i=1;i<p_count;i++)
+		r.merge_with(p_aabbs[i]);
+	return r;
+}
+
+AABB MathSIMD::aabb_from_points(const Vector3 *p_points,int p_count) {
+
+	if (p_count<=0)
+		return AABB();
+
+#ifdef SIMD_SSE2_ENABLED
+	if (enabled) {
+
+		__m128 min=_load3(p_points[0]);
+		__m128 max=min;
+
+		for(int i=1;i<p_count;i++) {
+
+			__m128 p=_load3(p_points[i]);
+			min=_mm_min_ps(min,p);
+			max=_mm_max_ps(max,p);
+		}
+
+		AABB r;
+		_store3(r.pos,min);
+		_store3(r.size,_mm_sub_ps(max,min));
+		return r;
+	}
+#endif
+
+#ifdef SIMD_NEON_ENABLED
+	if (enabled) {
+
+		float32x4_t min=_load3(p_points[0]);
+		float32x4_t max=min;
+
+		for(int i=1;i<p_count;i++) {
+
+			float32x4_t p=_load3(p_points[i]);
+			min=vminq_f32(min,p);
+			max=vmaxq_f32(max,p);
+		}
+
+		AABB r;
+		_store3(r.pos,min);
+		_store3(r.size,vsubq_f32(max,min));
+		return r;
+	}
+#endif
+
+	AABB r(p_points[0],Vector3());
+	for(int i=1;i<p_count;i++)
+		r.expand_to(p_points[i]);
+	return r;
+}
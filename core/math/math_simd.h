@@ -0,0 +1,224 @@
+/*************************************************************************/
+/*  math_simd.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef MATH_SIMD_H
+#define MATH_SIMD_H
+
+#include "transform.h"
+#include "aabb.h"
+#include "plane.h"
+
+/**
+	SIMD kernels for the hottest Vector3/Transform/AABB loops. SSE2 or NEON
+	are picked at compile time when real_t is float, everything else (or
+	set_enabled(false) at runtime) goes through the regular scalar math.
+*/
+
+#if !defined(NO_SIMD) && !defined(REAL_T_IS_DOUBLE)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#define SIMD_SSE2_ENABLED
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SIMD_NEON_ENABLED
+#include <arm_neon.h>
+#endif
+
+#endif
+
+class MathSIMD {
+
+	static bool enabled;
+
+#ifdef SIMD_SSE2_ENABLED
+	static _FORCE_INLINE_ __m128 _load3(const Vector3& p_v) { return _mm_setr_ps(p_v.x,p_v.y,p_v.z,0); }
+	static _FORCE_INLINE_ void _store3(Vector3& r_v,__m128 p_m) { float f[4]; _mm_storeu_ps(f,p_m); r_v.x=f[0]; r_v.y=f[1]; r_v.z=f[2]; }
+#endif
+
+#ifdef SIMD_NEON_ENABLED
+	static _FORCE_INLINE_ float32x4_t _load3(const Vector3& p_v) { float f[4]={p_v.x,p_v.y,p_v.z,0}; return vld1q_f32(f); }
+	static _FORCE_INLINE_ void _store3(Vector3& r_v,float32x4_t p_m) { float f[4]; vst1q_f32(f,p_m); r_v.x=f[0]; r_v.y=f[1]; r_v.z=f[2]; }
+#endif
+
+public:
+
+	/* planes laid out as structure of arrays, padded to a multiple of four
+	   with planes that never reject, so they can be tested four at a time */
+
+	struct PlaneSet {
+
+		enum {
+			MAX_PLANES=32
+		};
+
+		real_t nx[MAX_PLANES];
+		real_t ny[MAX_PLANES];
+		real_t nz[MAX_PLANES];
+		real_t d[MAX_PLANES];
+		int count; //padded, -1 if there were too many planes
+		const Plane *planes; //original planes, for the scalar path
+		int plane_count;
+
+		void set(const Plane *p_planes,int p_plane_count);
+		PlaneSet() { count=0; planes=NULL; plane_count=0; }
+	};
+
+	static bool is_supported();
+	static void set_enabled(bool p_enabled);
+	static bool is_enabled();
+
+	static _FORCE_INLINE_ void transform_compose(const Transform& p_a,const Transform& p_b,Transform& r_result); ///< r_result=p_a*p_b, r_result can be either of them
+	static void transform_points(const Transform& p_xform,const Vector3 *p_src,Vector3 *p_dst,int p_count);
+	static _FORCE_INLINE_ bool aabb_intersects_planes(const AABB& p_aabb,const PlaneSet& p_planes); ///< same as AABB::intersects_convex_shape()
+	static AABB aabb_merge(const AABB *p_aabbs,int p_count);
+	static AABB aabb_from_points(const Vector3 *p_points,int p_count);
+};
+
+
+void MathSIMD::transform_compose(const Transform& p_a,const Transform& p_b,Transform& r_result) {
+
+#ifdef SIMD_SSE2_ENABLED
+	if (enabled) {
+
+		const Matrix3 &a=p_a.basis;
+		__m128 b0=_load3(p_b.basis.elements[0]);
+		__m128 b1=_load3(p_b.basis.elements[1]);
+		__m128 b2=_load3(p_b.basis.elements[2]);
+
+		__m128 r0=_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a.elements[0][0]),b0),_mm_mul_ps(_mm_set1_ps(a.elements[0][1]),b1)),_mm_mul_ps(_mm_set1_ps(a.elements[0][2]),b2));
+		__m128 r1=_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a.elements[1][0]),b0),_mm_mul_ps(_mm_set1_ps(a.elements[1][1]),b1)),_mm_mul_ps(_mm_set1_ps(a.elements[1][2]),b2));
+		__m128 r2=_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a.elements[2][0]),b0),_mm_mul_ps(_mm_set1_ps(a.elements[2][1]),b1)),_mm_mul_ps(_mm_set1_ps(a.elements[2][2]),b2));
+
+		__m128 c0=_mm_setr_ps(a.elements[0][0],a.elements[1][0],a.elements[2][0],0);
+		__m128 c1=_mm_setr_ps(a.elements[0][1],a.elements[1][1],a.elements[2][1],0);
+		__m128 c2=_mm_setr_ps(a.elements[0][2],a.elements[1][2],a.elements[2][2],0);
+		const Vector3 &bo=p_b.origin;
+		__m128 o=_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(bo.x),c0),_mm_mul_ps(_mm_set1_ps(bo.y),c1)),_mm_add_ps(_mm_mul_ps(_mm_set1_ps(bo.z),c2),_load3(p_a.origin)));
+
+		_store3(r_result.basis.elements[0],r0);
+		_store3(r_result.basis.elements[1],r1);
+		_store3(r_result.basis.elements[2],r2);
+		_store3(r_result.origin,o);
+		return;
+	}
+#endif
+
+#ifdef SIMD_NEON_ENABLED
+	if (enabled) {
+
+		const Matrix3 &a=p_a.basis;
+		float32x4_t b0=_load3(p_b.basis.elements[0]);
+		float32x4_t b1=_load3(p_b.basis.elements[1]);
+		float32x4_t b2=_load3(p_b.basis.elements[2]);
+
+		float32x4_t r0=vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(b0,a.elements[0][0]),b1,a.elements[0][1]),b2,a.elements[0][2]);
+		float32x4_t r1=vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(b0,a.elements[1][0]),b1,a.elements[1][1]),b2,a.elements[1][2]);
+		float32x4_t r2=vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(b0,a.elements[2][0]),b1,a.elements[2][1]),b2,a.elements[2][2]);
+
+		float32x4_t c0=_load3(Vector3(a.elements[0][0],a.elements[1][0],a.elements[2][0]));
+		float32x4_t c1=_load3(Vector3(a.elements[0][1],a.elements[1][1],a.elements[2][1]));
+		float32x4_t c2=_load3(Vector3(a.elements[0][2],a.elements[1][2],a.elements[2][2]));
+		const Vector3 &bo=p_b.origin;
+		float32x4_t o=vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(_load3(p_a.origin),c0,bo.x),c1,bo.y),c2,bo.z);
+
+		_store3(r_result.basis.elements[0],r0);
+		_store3(r_result.basis.elements[1],r1);
+		_store3(r_result.basis.elements[2],r2);
+		_store3(r_result.origin,o);
+		return;
+	}
+#endif
+
+	Vector3 origin=p_a.xform(p_b.origin);
+	r_result.basis=p_a.basis*p_b.basis;
+	r_result.origin=origin;
+}
+
+bool MathSIMD::aabb_intersects_planes(const AABB& p_aabb,const PlaneSet& p_planes) {
+
+#if defined(SIMD_SSE2_ENABLED) || defined(SIMD_NEON_ENABLED)
+	if (enabled && p_planes.count>=0) {
+
+		//a box is outside when its corner most inside a plane is over it:
+		//n.center - |n|.half_extents > d
+
+		Vector3 half_extents = p_aabb.size * 0.5;
+		Vector3 center = p_aabb.pos + half_extents;
+
+#ifdef SIMD_SSE2_ENABLED
+		__m128 cx=_mm_set1_ps(center.x);
+		__m128 cy=_mm_set1_ps(center.y);
+		__m128 cz=_mm_set1_ps(center.z);
+		__m128 hx=_mm_set1_ps(half_extents.x);
+		__m128 hy=_mm_set1_ps(half_extents.y);
+		__m128 hz=_mm_set1_ps(half_extents.z);
+		__m128 abs_mask=_mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+		for(int i=0;i<p_planes.count;i+=4) {
+
+			__m128 nx=_mm_loadu_ps(&p_planes.nx[i]);
+			__m128 ny=_mm_loadu_ps(&p_planes.ny[i]);
+			__m128 nz=_mm_loadu_ps(&p_planes.nz[i]);
+
+			__m128 dc=_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx,cx),_mm_mul_ps(ny,cy)),_mm_mul_ps(nz,cz));
+			__m128 dh=_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(nx,abs_mask),hx),_mm_mul_ps(_mm_and_ps(ny,abs_mask),hy)),_mm_mul_ps(_mm_and_ps(nz,abs_mask),hz));
+
+			if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_sub_ps(dc,dh),_mm_loadu_ps(&p_planes.d[i]))))
+				return false;
+		}
+#else
+		float32x4_t cx=vdupq_n_f32(center.x);
+		float32x4_t cy=vdupq_n_f32(center.y);
+		float32x4_t cz=vdupq_n_f32(center.z);
+		float32x4_t hx=vdupq_n_f32(half_extents.x);
+		float32x4_t hy=vdupq_n_f32(half_extents.y);
+		float32x4_t hz=vdupq_n_f32(half_extents.z);
+
+		for(int i=0;i<p_planes.count;i+=4) {
+
+			float32x4_t nx=vld1q_f32(&p_planes.nx[i]);
+			float32x4_t ny=vld1q_f32(&p_planes.ny[i]);
+			float32x4_t nz=vld1q_f32(&p_planes.nz[i]);
+
+			float32x4_t dc=vmlaq_f32(vmlaq_f32(vmulq_f32(nx,cx),ny,cy),nz,cz);
+			float32x4_t dh=vmlaq_f32(vmlaq_f32(vmulq_f32(vabsq_f32(nx),hx),vabsq_f32(ny),hy),vabsq_f32(nz),hz);
+
+			uint32x4_t over=vcgtq_f32(vsubq_f32(dc,dh),vld1q_f32(&p_planes.d[i]));
+			uint32x2_t any=vorr_u32(vget_low_u32(over),vget_high_u32(over));
+			if (vget_lane_u32(vpmax_u32(any,any),0))
+				return false;
+		}
+#endif
+		return true;
+	}
+#endif
+
+	return p_aabb.intersects_convex_shape(p_planes.planes,p_planes.plane_count);
+}
+
+#endif // MATH_SIMD_H
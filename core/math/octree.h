@@ -31,10 +31,12 @@
 
 #include "vector3.h"
 #include "aabb.h"
+#include "math_simd.h"
 #include "list.h"
 #include "variant.h"
 #include "map.h"
 #include "print_string.h"
+#include "os/thread_work_pool.h"
 
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
@@ -349,6 +351,7 @@ private:
 
 		const Plane* planes;
 		int plane_count;
+		MathSIMD::PlaneSet plane_set;
 		T** result_array;
 		int *result_idx;
 		int result_max;
@@ -356,6 +359,48 @@ private:
 	};
 
 	void _cull_convex(Octant *p_octant,_CullConvexData *p_cull);
+
+	/* Unbounded (and optionally threaded) convex cull: octants close to the
+	 * root are culled on the calling thread until there are enough subtrees
+	 * to keep the work pool busy, then each subtree is culled as a separate
+	 * task. Tasks don't touch the elements, so an element living in more than
+	 * one octant can show up more than once; duplicates are dropped (using
+	 * last_pass) when the task results are merged. */
+
+	struct _CullConvexTask {
+
+		Octant *octant;
+		Vector<Element*> result;
+		int count;
+
+		_FORCE_INLINE_ void add(Element *p_element) {
+
+			if (count==result.size())
+				result.resize(MAX(64,count*2));
+			result[count++]=p_element;
+		}
+	};
+
+	struct _CullConvexWork {
+
+		Octree *octree;
+		_CullConvexData *cull;
+		_CullConvexTask *tasks;
+	};
+
+	Vector<_CullConvexTask> cull_tasks; // kept between culls, so result buffers are reused
+	Vector<Octant*> cull_octants[2];
+
+	_FORCE_INLINE_ static void _cull_result_add(Vector<T*> *r_result,int &r_count,T* p_userdata) {
+
+		if (r_count==r_result->size())
+			r_result->resize(MAX(64,r_count*2));
+		(*r_result)[r_count++]=p_userdata;
+	}
+
+	_FORCE_INLINE_ void _cull_convex_elements(List<Element*,AL>& p_elements,_CullConvexData *p_cull,Vector<T*> *r_result,int &r_count);
+	void _cull_convex_task(Octant *p_octant,_CullConvexData *p_cull,_CullConvexTask *p_task);
+	static void _cull_convex_work(void *p_userdata,int p_index);
 	void _cull_AABB(Octant *p_octant,const AABB& p_aabb, T** p_result_array,int *p_result_idx,int p_result_max,int *p_subindex_array,uint32_t p_mask);
 	void _cull_segment(Octant *p_octant,const Vector3& p_from, const Vector3& p_to,T** p_result_array,int *p_result_idx,int p_result_max,int *p_subindex_array,uint32_t p_mask);
 	void _cull_point(Octant *p_octant,const Vector3& p_point,T** p_result_array,int *p_result_idx,int p_result_max,int *p_subindex_array,uint32_t p_mask);
@@ -385,6 +430,7 @@ public:
 	int get_subindex(OctreeElementID p_id) const;
 
 	int cull_convex(const Vector<Plane>& p_convex,T** p_result_array,int p_result_max,uint32_t p_mask=0xFFFFFFFF);
+	int cull_convex(const Vector<Plane>& p_convex,Vector<T*> *r_result,ThreadWorkPool *p_work_pool=NULL,uint32_t p_mask=0xFFFFFFFF); ///< r_result grows as needed and is never shrunk, returns the amount of results
 	int cull_AABB(const AABB& p_aabb,T** p_result_array,int p_result_max,int *p_subindex_array=NULL,uint32_t p_mask=0xFFFFFFFF);
 	int cull_segment(const Vector3& p_from, const Vector3& p_to,T** p_result_array,int p_result_max,int *p_subindex_array=NULL,uint32_t p_mask=0xFFFFFFFF);
 
@@ -395,6 +441,7 @@ public:
 
 	int get_octant_count() const { return octant_count; }
 	int get_pair_count() const { return pair_count; }
+	int get_elem_count() const { return element_map.size(); }
 	Octree(real_t p_unit_size=1.0);
 	~Octree() { _remove_tree(root); }
 };
@@ -1079,7 +1126,7 @@ void Octree<T,use_pairs,AL>::_cull_convex(Octant *p_octant,_CullConvexData *p_cu
 				continue;
 			e->last_pass=pass;
 			
-			if (e->aabb.intersects_convex_shape(p_cull->planes,p_cull->plane_count)) {
+			if (MathSIMD::aabb_intersects_planes(e->aabb,p_cull->plane_set)) {
 				
 				if (*p_cull->result_idx<p_cull->result_max) {
 					p_cull->result_array[*p_cull->result_idx] = e->userdata;
@@ -1105,7 +1152,7 @@ void Octree<T,use_pairs,AL>::_cull_convex(Octant *p_octant,_CullConvexData *p_cu
 				continue;
 			e->last_pass=pass;
 			
-			if (e->aabb.intersects_convex_shape(p_cull->planes,p_cull->plane_count)) {
+			if (MathSIMD::aabb_intersects_planes(e->aabb,p_cull->plane_set)) {
 				
 				if (*p_cull->result_idx<p_cull->result_max) {
 
@@ -1121,13 +1168,73 @@ void Octree<T,use_pairs,AL>::_cull_convex(Octant *p_octant,_CullConvexData *p_cu
 		
 	for (int i=0;i<8;i++) {
 		
-		if (p_octant->children[i] && p_octant->children[i]->aabb.intersects_convex_shape(p_cull->planes,p_cull->plane_count)) {
+		if (p_octant->children[i] && MathSIMD::aabb_intersects_planes(p_octant->children[i]->aabb,p_cull->plane_set)) {
 			_cull_convex(p_octant->children[i],p_cull);
 		}
 	}	
 }
 
 
+template<class T,bool use_pairs,class AL>
+void Octree<T,use_pairs,AL>::_cull_convex_elements(List<Element*,AL>& p_elements,_CullConvexData *p_cull,Vector<T*> *r_result,int &r_count) {
+
+	for(typename List< Element*,AL >::Element *I=p_elements.front();I;I=I->next()) {
+
+		Element *e=I->get();
+
+		if (e->last_pass==pass || (use_pairs && !(e->pairable_type&p_cull->mask)))
+			continue;
+		e->last_pass=pass;
+
+		if (MathSIMD::aabb_intersects_planes(e->aabb,p_cull->plane_set))
+			_cull_result_add(r_result,r_count,e->userdata);
+	}
+}
+
+template<class T,bool use_pairs,class AL>
+void Octree<T,use_pairs,AL>::_cull_convex_task(Octant *p_octant,_CullConvexData *p_cull,_CullConvexTask *p_task) {
+
+	for(typename List< Element*,AL >::Element *I=p_octant->elements.front();I;I=I->next()) {
+
+		Element *e=I->get();
+
+		if (use_pairs && !(e->pairable_type&p_cull->mask))
+			continue;
+
+		if (MathSIMD::aabb_intersects_planes(e->aabb,p_cull->plane_set))
+			p_task->add(e);
+	}
+
+	if (use_pairs) {
+
+		for(typename List< Element*,AL >::Element *I=p_octant->pairable_elements.front();I;I=I->next()) {
+
+			Element *e=I->get();
+
+			if (!(e->pairable_type&p_cull->mask))
+				continue;
+
+			if (MathSIMD::aabb_intersects_planes(e->aabb,p_cull->plane_set))
+				p_task->add(e);
+		}
+	}
+
+	for (int i=0;i<8;i++) {
+
+		if (p_octant->children[i] && MathSIMD::aabb_intersects_planes(p_octant->children[i]->aabb,p_cull->plane_set)) {
+			_cull_convex_task(p_octant->children[i],p_cull,p_task);
+		}
+	}
+}
+
+template<class T,bool use_pairs,class AL>
+void Octree<T,use_pairs,AL>::_cull_convex_work(void *p_userdata,int p_index) {
+
+	_CullConvexWork *work=(_CullConvexWork*)p_userdata;
+	_CullConvexTask *task=&work->tasks[p_index];
+	work->octree->_cull_convex_task(task->octant,work->cull,task);
+}
+
 template<class T,bool use_pairs,class AL>
 void Octree<T,use_pairs,AL>::_cull_AABB(Octant *p_octant,const AABB& p_aabb, T** p_result_array,int *p_result_idx,int p_result_max,int *p_subindex_array,uint32_t p_mask) {
 	
@@ -1363,6 +1470,7 @@ int Octree<T,use_pairs,AL>::cull_convex(const Vector<Plane>& p_convex,T** p_resu
 	_CullConvexData cdata;
 	cdata.planes=&p_convex[0];
 	cdata.plane_count=p_convex.size();
+	cdata.plane_set.set(cdata.planes,cdata.plane_count);
 	cdata.result_array=p_result_array;
 	cdata.result_max=p_result_max;
 	cdata.result_idx=&result_count;
@@ -1373,6 +1481,98 @@ int Octree<T,use_pairs,AL>::cull_convex(const Vector<Plane>& p_convex,T** p_resu
 	return result_count;
 }
 
+template<class T,bool use_pairs,class AL>
+int Octree<T,use_pairs,AL>::cull_convex(const Vector<Plane>& p_convex,Vector<T*> *r_result,ThreadWorkPool *p_work_pool,uint32_t p_mask) {
+
+	if (!root)
+		return 0;
+
+	int result_count=0;
+	pass++;
+	_CullConvexData cdata;
+	cdata.planes=&p_convex[0];
+	cdata.plane_count=p_convex.size();
+	cdata.plane_set.set(cdata.planes,cdata.plane_count);
+	cdata.result_array=NULL;
+	cdata.result_max=0;
+	cdata.result_idx=NULL;
+	cdata.mask=p_mask;
+
+	// a few tasks per thread, as subtrees vary a lot in size
+	int task_target = (p_work_pool && p_work_pool->is_threaded()) ? p_work_pool->get_thread_count()*4 : 1;
+
+	int level=0;
+	cull_octants[0].resize(0);
+	cull_octants[0].push_back(root);
+
+	while(cull_octants[level].size() && cull_octants[level].size()<task_target) {
+
+		Vector<Octant*> &octants=cull_octants[level];
+		Vector<Octant*> &next=cull_octants[level^1];
+		next.resize(0);
+
+		for(int i=0;i<octants.size();i++) {
+
+			Octant *o=octants[i];
+			_cull_convex_elements(o->elements,&cdata,r_result,result_count);
+			if (use_pairs)
+				_cull_convex_elements(o->pairable_elements,&cdata,r_result,result_count);
+
+			for (int j=0;j<8;j++) {
+
+				if (o->children[j] && MathSIMD::aabb_intersects_planes(o->children[j]->aabb,cdata.plane_set))
+					next.push_back(o->children[j]);
+			}
+		}
+
+		level^=1;
+	}
+
+	int task_count=cull_octants[level].size();
+	if (task_count==0)
+		return result_count;
+
+	if (cull_tasks.size()<task_count)
+		cull_tasks.resize(task_count);
+
+	_CullConvexTask *tasks=cull_tasks.ptr();
+	for(int i=0;i<task_count;i++) {
+
+		tasks[i].octant=cull_octants[level][i];
+		tasks[i].count=0;
+	}
+
+	_CullConvexWork work;
+	work.octree=this;
+	work.cull=&cdata;
+	work.tasks=tasks;
+
+	if (p_work_pool) {
+		p_work_pool->do_work(task_count,_cull_convex_work,&work);
+	} else {
+		for(int i=0;i<task_count;i++)
+			_cull_convex_work(&work,i);
+	}
+
+	// merge
+	for(int i=0;i<task_count;i++) {
+
+		Element **elements=tasks[i].result.ptr();
+		int count=tasks[i].count;
+
+		for(int j=0;j<count;j++) {
+
+			Element *e=elements[j];
+			if (e->last_pass==pass)
+				continue;
+			e->last_pass=pass;
+			_cull_result_add(r_result,result_count,e->userdata);
+		}
+	}
+
+	return result_count;
+}
+
 
 
 template<class T,bool use_pairs,class AL>
@@ -30,6 +30,7 @@
 #include "math_funcs.h"
 #include "os/copymem.h"
 #include "print_string.h"
+#include "math_simd.h"
 	
 
 void Transform::affine_invert() {
@@ -192,8 +193,7 @@ bool Transform::operator!=(const Transform& p_transform) const {
 
 void Transform::operator*=(const Transform& p_transform) {
 
-	origin=xform(p_transform.origin);
-	basis*=p_transform.basis;	
+	MathSIMD::transform_compose(*this,p_transform,*this);
 }
 
 Transform Transform::operator*(const Transform& p_transform) const {
@@ -813,6 +813,13 @@ Variant Object::call(const StringName& p_method,const Variant** p_args,int p_arg
 			ERR_EXPLAIN("Can't 'free' a reference.");
 			ERR_FAIL_V(Variant());
 		}
+
+		if (_lock_index>0) {
+			r_error.argument=0;
+			r_error.error=Variant::CallError::CALL_ERROR_INVALID_METHOD;
+			ERR_EXPLAIN("Object is locked and can't be freed.");
+			ERR_FAIL_V(Variant());
+		}
 #endif
 		//must be here, must be before everything,
 		memdelete(this);
@@ -821,6 +828,7 @@ Variant Object::call(const StringName& p_method,const Variant** p_args,int p_arg
 	}
 
 	Variant ret;
+	OBJ_DEBUG_LOCK(this)
 
 	if (script_instance) {
 		ret = script_instance->call(p_method,p_args,p_argcount,r_error);
@@ -1527,6 +1535,9 @@ Object::Object() {
 
 	_block_signals=false;
 	_predelete_ok=0;
+#ifdef DEBUG_ENABLED
+	_lock_index=0;
+#endif
 	_instance_ID=0;
 	_instance_ID = ObjectDB::add_instance(this);
 	_can_translate=true;
@@ -207,6 +207,7 @@ static String inherits_static() {\
 }\
 virtual bool is_type(const String& p_type) const { return (p_type==(#m_type))?true:m_inherits::is_type(p_type); }\
 virtual bool is_type_ptr(void *p_ptr) const { return (p_ptr==get_type_ptr_static())?true:m_inherits::is_type_ptr(p_ptr); }\
+virtual void* get_type_ptr() const { return get_type_ptr_static(); }\
 \
 \
 static void get_valid_parents_static(List<String> *p_parents) {\
@@ -379,6 +380,10 @@ friend void postinitialize_handler(Object*);
 	ScriptInstance *script_instance;
 	RefPtr script;
 	Dictionary metadata;
+#ifdef DEBUG_ENABLED
+friend class _ObjectDebugLock;
+	int _lock_index; //calls in progress on this object, it can't be freed from inside them
+#endif
 
 	void _add_user_signal(const String& p_name, const Array& p_pargs=Array());
 	Variant _emit_signal(const Variant** p_args, int p_argcount, Variant::CallError& r_error);
@@ -514,6 +519,7 @@ public:
 	virtual StringName get_type_name() const { return StringName("Object"); }
 	virtual bool is_type(const String& p_type) const { return (p_type=="Object"); }
 	virtual bool is_type_ptr(void *p_ptr) const { return get_type_ptr_static()==p_ptr; }
+	virtual void* get_type_ptr() const { return get_type_ptr_static(); } ///< unique per type, cheaper to compare than get_type_name()
 
 
 	
@@ -589,6 +595,24 @@ public:
 
 };
 
+#ifdef DEBUG_ENABLED
+
+class _ObjectDebugLock {
+
+	Object *obj;
+public:
+	_FORCE_INLINE_ _ObjectDebugLock(Object *p_obj) { obj=p_obj; obj->_lock_index++; }
+	_FORCE_INLINE_ ~_ObjectDebugLock() { obj->_lock_index--; }
+};
+
+#define OBJ_DEBUG_LOCK(m_obj) _ObjectDebugLock _debug_lock(m_obj);
+
+#else
+
+#define OBJ_DEBUG_LOCK(m_obj)
+
+#endif
+
 
 bool predelete_handler(Object *p_object);
 void postinitialize_handler(Object *p_object);
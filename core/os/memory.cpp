@@ -98,7 +98,7 @@ Error Memory::realloc_dynamic(MID p_mid,size_t p_bytes) {
 	if (id==MemoryPoolDynamic::INVALID_ID)
 		return ERR_INVALID_PARAMETER;
 		
-	return MemoryPoolDynamic::get_singleton()->realloc(p_mid, p_bytes);
+	return p_mid._resize(p_bytes);
 
 }
 
@@ -45,6 +45,9 @@ class MID {
 	
 		SafeRefCount refcount;
 		MemoryPoolDynamic::ID id;
+		size_t size;
+		void *ptr; // only set if the pool never moves memory, locking is then tracked here
+		SafeRefCount locks; // 1 + active locks
 	};
 
 	mutable Data *data;
@@ -77,23 +80,46 @@ friend class MID_Lock;
 
 	inline void lock() {
 	
-		if (data && data->id!=MemoryPoolDynamic::INVALID_ID)
+		if (data && data->ptr)
+			data->locks.ref();
+		else if (data && data->id!=MemoryPoolDynamic::INVALID_ID)
 			MemoryPoolDynamic::get_singleton()->lock(data->id);
 	}
 	inline void unlock() {
 	
-		if (data && data->id!=MemoryPoolDynamic::INVALID_ID)
+		if (data && data->ptr)
+			data->locks.unref();
+		else if (data && data->id!=MemoryPoolDynamic::INVALID_ID)
 			MemoryPoolDynamic::get_singleton()->unlock(data->id);
 	
 	}
 	
 	inline void * get() {
 	
+		if (data && data->ptr)
+			return data->ptr;
 		if (data && data->id!=MemoryPoolDynamic::INVALID_ID)
 			return MemoryPoolDynamic::get_singleton()->get(data->id);
 		
 		return NULL;
 	}
+
+	void _update_cache() {
+
+		data->size=0;
+		data->ptr=NULL;
+		if (data->id==MemoryPoolDynamic::INVALID_ID)
+			return;
+
+		MemoryPoolDynamic *pool=MemoryPoolDynamic::get_singleton();
+		data->size=pool->get_size(data->id);
+		if (!pool->can_move()) {
+			// address is stable until the next resize, so no need to ask the pool every time
+			pool->lock(data->id);
+			data->ptr=pool->get(data->id);
+			pool->unlock(data->id);
+		}
+	}
 	
 	Error _resize(size_t p_size) { 
 				
@@ -104,10 +130,15 @@ friend class MID_Lock;
 			data = (Data*)MemoryPoolStatic::get_singleton()->alloc(sizeof(Data),"MID::Data");
 			ERR_FAIL_COND_V( !data,ERR_OUT_OF_MEMORY );
 			data->refcount.init();
+			data->locks.init();
 			data->id=MemoryPoolDynamic::INVALID_ID;			
+			data->size=0;
+			data->ptr=NULL;
 		}
 		
-		if (p_size==0 && data && data->id==MemoryPoolDynamic::INVALID_ID) {
+		ERR_FAIL_COND_V( is_locked(), ERR_LOCKED );
+
+		if (p_size==0 && data && data->id!=MemoryPoolDynamic::INVALID_ID) {
 		
 			MemoryPoolDynamic::get_singleton()->free(data->id);
 			data->id=MemoryPoolDynamic::INVALID_ID;
@@ -122,12 +153,16 @@ friend class MID_Lock;
 
 			} else {
 			
-				MemoryPoolDynamic::get_singleton()->realloc(data->id,p_size);
-				ERR_FAIL_COND_V( data->id==MemoryPoolDynamic::INVALID_ID, ERR_OUT_OF_MEMORY );
+				Error err = MemoryPoolDynamic::get_singleton()->realloc(data->id,p_size);
+				if (err!=OK) {
+					_update_cache();
+					ERR_FAIL_V(err);
+				}
 			
 			}
 		}				
 		
+		_update_cache();
 		return OK;
 	}
 friend class Memory;
@@ -136,7 +171,9 @@ friend class Memory;
 	
 		data = (Data*)MemoryPoolStatic::get_singleton()->alloc(sizeof(Data),"MID::Data");
 		data->refcount.init();
+		data->locks.init();
 		data->id=p_id;
+		_update_cache();
 	}
 public:	
 
@@ -144,10 +181,15 @@ public:
 	operator bool() const { return data; }
 	
 		
-	size_t get_size() const { return (data && data->id!=MemoryPoolDynamic::INVALID_ID) ? MemoryPoolDynamic::get_singleton()->get_size(data->id) : 0; }
+	size_t get_size() const { return data ? data->size : 0; }
 	Error resize(size_t p_size) { return _resize(p_size); }
 	inline void operator=(const MID& p_mid) { ref( p_mid.data ); }
-	inline bool is_locked() const { return (data && data->id!=MemoryPoolDynamic::INVALID_ID) ? MemoryPoolDynamic::get_singleton()->is_locked(data->id) : false; }
+	inline bool is_locked() const {
+
+		if (data && data->ptr)
+			return data->locks.get()>1;
+		return (data && data->id!=MemoryPoolDynamic::INVALID_ID) ? MemoryPoolDynamic::get_singleton()->is_locked(data->id) : false;
+	}
 	inline MID(const MID& p_mid) { data=NULL; ref( p_mid.data ); }
 	inline MID() { data = NULL; }
 	~MID() { unref(); }
@@ -60,6 +60,7 @@ friend class MID;
 	virtual void * get(ID p_ID)=0;
 	virtual Error unlock(ID p_id)=0;
 	virtual bool is_locked(ID p_id) const=0;
+	virtual bool can_move() const { return true; } ///< false if allocations never move, so they can be accessed without locking
 	
 	virtual size_t get_available_mem() const=0;
 	virtual size_t get_total_usage() const=0;
@@ -74,6 +74,7 @@ public:
 	virtual Error lock(ID p_id);
 	virtual void * get(ID p_ID);
 	virtual Error unlock(ID p_id);
+	virtual bool can_move() const { return false; }
 
 	virtual size_t get_available_mem() const;
 	virtual size_t get_total_usage() const;
@@ -0,0 +1,171 @@
+/*************************************************************************/
+/*  thread_work_pool.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "thread_work_pool.h"
+#include "os/os.h"
+#include "os/memory.h"
+#include "error_macros.h"
+
+bool ThreadWorkPool::_fetch(int &r_from,int &r_to) {
+
+	mutex->lock();
+	r_from=work_index;
+	work_index+=work_batch;
+	if (work_index>work_count)
+		work_index=work_count;
+	r_to=work_index;
+	mutex->unlock();
+
+	return r_from<r_to;
+}
+
+void ThreadWorkPool::_process() {
+
+	int from,to;
+	while(_fetch(from,to)) {
+
+		for(int i=from;i<to;i++)
+			work_callback(work_userdata,i);
+	}
+}
+
+void ThreadWorkPool::_thread_function(void *p_user) {
+
+	ThreadData *td=(ThreadData*)p_user;
+	ThreadWorkPool *pool=td->pool;
+
+	while(true) {
+
+		td->start->wait();
+		if (pool->exit)
+			break;
+		pool->_process();
+		pool->done->post();
+	}
+}
+
+void ThreadWorkPool::init(int p_thread_count) {
+
+	ERR_FAIL_COND(threads!=NULL);
+
+#ifdef NO_THREADS
+	p_thread_count=1;
+#endif
+	if (p_thread_count<=0)
+		p_thread_count=OS::get_singleton()->get_processor_count();
+
+	thread_count=p_thread_count-1;
+	if (thread_count<=0) {
+		thread_count=0;
+		return;
+	}
+
+	exit=false;
+	mutex=Mutex::create(false);
+	done=Semaphore::create();
+	threads=memnew_arr(ThreadData,thread_count);
+
+	for(int i=0;i<thread_count;i++) {
+
+		threads[i].pool=this;
+		threads[i].start=Semaphore::create();
+		threads[i].thread=Thread::create(_thread_function,&threads[i]);
+	}
+}
+
+void ThreadWorkPool::finish() {
+
+	if (!threads)
+		return;
+
+	exit=true;
+	for(int i=0;i<thread_count;i++)
+		threads[i].start->post();
+
+	for(int i=0;i<thread_count;i++) {
+
+		Thread::wait_to_finish(threads[i].thread);
+		memdelete(threads[i].thread);
+		memdelete(threads[i].start);
+	}
+
+	memdelete_arr(threads);
+	memdelete(done);
+	memdelete(mutex);
+	threads=NULL;
+	thread_count=0;
+}
+
+void ThreadWorkPool::do_work(int p_count,ThreadWorkCallback p_callback,void *p_userdata) {
+
+	if (p_count<=0)
+		return;
+
+	if (thread_count==0 || p_count==1) {
+
+		for(int i=0;i<p_count;i++)
+			p_callback(p_userdata,i);
+		return;
+	}
+
+	work_callback=p_callback;
+	work_userdata=p_userdata;
+	work_count=p_count;
+	work_index=0;
+	//small batches balance uneven work (islands vary a lot in size) without hammering the mutex
+	work_batch=p_count/((thread_count+1)*8);
+	if (work_batch<1)
+		work_batch=1;
+
+	for(int i=0;i<thread_count;i++)
+		threads[i].start->post();
+
+	_process();
+
+	for(int i=0;i<thread_count;i++)
+		done->wait();
+}
+
+ThreadWorkPool::ThreadWorkPool() {
+
+	threads=NULL;
+	thread_count=0;
+	mutex=NULL;
+	done=NULL;
+	exit=false;
+	work_callback=NULL;
+	work_userdata=NULL;
+	work_count=0;
+	work_index=0;
+	work_batch=1;
+}
+
+ThreadWorkPool::~ThreadWorkPool() {
+
+	finish();
+}
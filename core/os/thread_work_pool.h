@@ -0,0 +1,87 @@
+/*************************************************************************/
+/*  thread_work_pool.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef THREAD_WORK_POOL_H
+#define THREAD_WORK_POOL_H
+
+#include "os/thread.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+
+/**
+ * @class ThreadWorkPool
+ * Small pool of worker threads used to run a loop of independent work items
+ * in parallel (physics islands, per body integration, batched queries, etc).
+ * The calling thread takes part in the work, and do_work() returns only once
+ * every item has been processed, so callers need no further synchronization.
+ * With a thread count of 1 (or no thread support) everything runs inline.
+ */
+
+typedef void (*ThreadWorkCallback)(void *p_userdata,int p_index);
+
+class ThreadWorkPool {
+
+	struct ThreadData {
+
+		ThreadWorkPool *pool;
+		Thread *thread;
+		Semaphore *start;
+	};
+
+	ThreadData *threads;
+	int thread_count;
+
+	Mutex *mutex;
+	Semaphore *done;
+	bool exit;
+
+	ThreadWorkCallback work_callback;
+	void *work_userdata;
+	int work_count;
+	int work_index;
+	int work_batch;
+
+	bool _fetch(int &r_from,int &r_to);
+	void _process();
+	static void _thread_function(void *p_user);
+
+public:
+
+	void init(int p_thread_count); ///< total threads used, including the caller. 0 means one per processor
+	void finish();
+
+	_FORCE_INLINE_ int get_thread_count() const { return thread_count+1; }
+	_FORCE_INLINE_ bool is_threaded() const { return thread_count>0; }
+
+	void do_work(int p_count,ThreadWorkCallback p_callback,void *p_userdata);
+
+	ThreadWorkPool();
+	~ThreadWorkPool();
+};
+
+#endif // THREAD_WORK_POOL_H
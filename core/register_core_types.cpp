@@ -82,6 +82,8 @@ extern Mutex *_global_mutex;
 
 extern void register_variant_methods();
 extern void unregister_variant_methods();
+extern void register_variant_members();
+extern void unregister_variant_members();
 
 
 void register_core_types() {
@@ -94,6 +96,7 @@ void register_core_types() {
 
 
 	register_variant_methods();
+	register_variant_members();
 
 
 	CoreStringNames::create();
@@ -232,6 +235,7 @@ void unregister_core_types() {
 		memdelete(ip);
 
 	unregister_variant_methods();
+	unregister_variant_members();
 
 	CoreStringNames::free();
 	ObjectTypeDB::cleanup();
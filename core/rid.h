@@ -35,6 +35,7 @@
 #include "os/memory.h"
 #include "hash_map.h"
 #include "list.h"
+#include "vector.h"
 
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
@@ -47,6 +48,7 @@ typedef uint32_t ID;
 class RID {	
 friend class RID_OwnerBase;	
 	ID _id;
+	uint32_t _slot; // where the owner keeps it, only meaningful to the owner
 	RID_OwnerBase *owner;
 public:
 
@@ -79,6 +81,7 @@ public:
 
 	_FORCE_INLINE_ RID() {
 		_id = 0;
+		_slot = 0;
 		owner=0;
 	}
 };
@@ -89,6 +92,9 @@ protected:
 friend class RID;
 	void set_id(RID& p_rid, ID p_id) const { p_rid._id=p_id; }
 	void set_ownage(RID& p_rid) const { p_rid.owner=const_cast<RID_OwnerBase*>(this); }
+	_FORCE_INLINE_ void set_slot(RID& p_rid, uint32_t p_slot) const { p_rid._slot=p_slot; }
+	_FORCE_INLINE_ uint32_t get_slot(const RID& p_rid) const { return p_rid._slot; }
+	_FORCE_INLINE_ bool is_ownage(const RID& p_rid) const { return p_rid.owner==this; }
 	ID new_ID();
 public:
 		
@@ -100,6 +106,21 @@ public:
 	virtual ~RID_OwnerBase() {}
 };
 
+#if defined(__GNUC__) && !defined(NO_THREADS)
+#define RID_WRITE_BARRIER() __sync_synchronize()
+#else
+#define RID_WRITE_BARRIER()
+#endif
+
+/**
+ * Handle table. Every RID carries the index of its slot, and the slot keeps
+ * the (globally unique) ID it was given, so lookups are an array access plus a
+ * compare, and a freed or reused slot never resolves a stale RID.
+ * Slots live in chunks that double in size and never move, so the thread safe
+ * variant only locks to create and free, lookups are lock free.
+ * Owned pointers are also kept packed for iteration (get_owned_count/get_owned).
+ */
+
 template<class T,bool thread_safe=false>
 class RID_Owner : public RID_OwnerBase {
 public:
@@ -107,8 +128,96 @@ public:
 	typedef void (*ReleaseNotifyFunc)(void*user,T *p_data);
 private:	
 
+	enum {
+		CHUNK_BASE_SHIFT=6, // first chunk holds 64 slots
+		MAX_CHUNKS=20
+	};
+
+	struct Slot {
+
+		volatile ID id; // 0 when free
+		T *data;
+		uint32_t owned_index;
+	};
+
+	struct Owned {
+
+		T *data;
+		uint32_t slot;
+	};
+
+	Slot * volatile chunks[MAX_CHUNKS];
+	uint32_t slot_count;
+	Vector<uint32_t> free_slots;
+	Vector<Owned> owned;
+
 	Mutex *mutex;
-	mutable HashMap<ID,T*> id_map;
+
+	static _FORCE_INLINE_ uint32_t _get_chunk(uint32_t p_slot) {
+
+		uint32_t v=(p_slot>>CHUNK_BASE_SHIFT)+1;
+#ifdef __GNUC__
+		return 31-__builtin_clz(v);
+#else
+		uint32_t c=0;
+		while(v>>=1)
+			c++;
+		return c;
+#endif
+	}
+
+	_FORCE_INLINE_ Slot& _get_slot(uint32_t p_slot) const {
+
+		uint32_t c=_get_chunk(p_slot);
+		return chunks[c][p_slot-((((uint32_t)1<<c)-1)<<CHUNK_BASE_SHIFT)];
+	}
+
+	// later loads can't be moved before this one
+	template<class V>
+	static _FORCE_INLINE_ V _load_acquire(const volatile V& p_var) {
+#if defined(__GNUC__) && defined(__ATOMIC_ACQUIRE) && !defined(NO_THREADS)
+		return __atomic_load_n(&p_var,__ATOMIC_ACQUIRE);
+#else
+		V v=p_var;
+		RID_WRITE_BARRIER();
+		return v;
+#endif
+	}
+
+	_FORCE_INLINE_ bool _owns(const RID& p_rid) const {
+
+		return is_ownage(p_rid) && _get_slot(get_slot(p_rid)).id==p_rid.get_id();
+	}
+
+	uint32_t _alloc_slot() {
+
+		if (free_slots.size()) {
+
+			uint32_t slot=free_slots[free_slots.size()-1];
+			free_slots.resize(free_slots.size()-1);
+			return slot;
+		}
+
+		uint32_t slot=slot_count;
+		uint32_t c=_get_chunk(slot);
+		ERR_FAIL_COND_V(c>=MAX_CHUNKS,0xFFFFFFFF);
+
+		if (!chunks[c]) {
+
+			uint32_t size=(1<<CHUNK_BASE_SHIFT)<<c;
+			Slot *chunk=(Slot*)memalloc(sizeof(Slot)*size);
+			for(uint32_t i=0;i<size;i++) {
+				chunk[i].id=0;
+				chunk[i].data=NULL;
+				chunk[i].owned_index=0;
+			}
+			RID_WRITE_BARRIER(); // chunk must be cleared before lock free readers can see it
+			chunks[c]=chunk;
+		}
+
+		slot_count++;
+		return slot;
+	}
 		
 public:
 
@@ -117,12 +226,31 @@ public:
 		if (thread_safe) {
 			mutex->lock();
 		}
-		
-		ID id = new_ID();
-		id_map[id]=p_data;
+
 		RID rid;
-		set_id(rid,id);
-		set_ownage(rid);
+		uint32_t slot=_alloc_slot();
+
+		if (slot!=0xFFFFFFFF) {
+
+			ID id = new_ID();
+
+			Owned o;
+			o.data=p_data;
+			o.slot=slot;
+			owned.push_back(o);
+
+			Slot &s=_get_slot(slot);
+			s.data=p_data;
+			s.owned_index=owned.size()-1;
+			if (thread_safe) {
+				RID_WRITE_BARRIER(); // data must be visible before the id
+			}
+			s.id=id;
+
+			set_id(rid,id);
+			set_slot(rid,slot);
+			set_ownage(rid);
+		}
 		
 		if (thread_safe) {
 			mutex->unlock();
@@ -132,36 +260,30 @@ public:
 	}
 	
 	_FORCE_INLINE_ T * get(const RID& p_rid) {
-	
-		if (thread_safe) {
-			mutex->lock();
-		}
-	
-		T**elem = id_map.getptr(p_rid.get_id());
-		
-		if (thread_safe) {
-			mutex->unlock();
+
+		ERR_FAIL_COND_V(!is_ownage(p_rid),NULL);
+
+		const Slot &s=_get_slot(get_slot(p_rid));
+
+		if (!thread_safe) {
+
+			ERR_FAIL_COND_V(s.id!=p_rid.get_id(),NULL);
+			return s.data;
 		}
 
-		ERR_FAIL_COND_V(!elem,NULL);
-		
-		return *elem;
+		//not locked, so read the id before the data and check it again after it
+		ID id=_load_acquire(s.id);
+		ERR_FAIL_COND_V(id!=p_rid.get_id(),NULL);
+		T *data=_load_acquire(s.data);
+		ERR_FAIL_COND_V(s.id!=id,NULL); // freed (or reused) while reading
+
+		return data;
 
 	}
 	
 	virtual bool owns(const RID& p_rid) const {
 	
-		if (thread_safe) {
-			mutex->lock();
-		}
-	
-		T**elem = id_map.getptr(p_rid.get_id());
-		
-		if (thread_safe) {
-			mutex->lock();
-		}
-		
-		return elem!=NULL;
+		return _owns(p_rid);
 	}
 	
 	virtual void free(RID p_rid) { 
@@ -169,32 +291,72 @@ public:
 		if (thread_safe) {
 			mutex->lock();
 		}
-		ERR_FAIL_COND(!owns(p_rid));
-		id_map.erase(p_rid.get_id());
+
+		if (!_owns(p_rid)) {
+
+			if (thread_safe) {
+				mutex->unlock();
+			}
+			ERR_FAIL();
+		}
+
+		uint32_t slot=get_slot(p_rid);
+		Slot &s=_get_slot(slot);
+		s.id=0;
+		if (thread_safe) {
+			RID_WRITE_BARRIER(); // id must be cleared before data
+		}
+
+		//keep owned list packed, last one takes the place of the freed one
+		int last=owned.size()-1;
+		if ((int)s.owned_index!=last) {
+			owned[s.owned_index]=owned[last];
+			_get_slot(owned[s.owned_index].slot).owned_index=s.owned_index;
+		}
+		owned.resize(last);
+
+		s.data=NULL;
+		free_slots.push_back(slot);
+
+		if (thread_safe) {
+			mutex->unlock();
+		}
 	}
+
 	virtual void get_owned_list(List<RID> *p_owned) const {
 	
 		if (thread_safe) {
 			mutex->lock();
 		}
 	
-		const ID*id=NULL;
-		while((id=id_map.next(id))) {
-		
+		for(int i=0;i<owned.size();i++) {
+
+			uint32_t slot=owned[i].slot;
 			RID rid;
-			set_id(rid,*id);
+			set_id(rid,_get_slot(slot).id);
+			set_slot(rid,slot);
 			set_ownage(rid);
 			p_owned->push_back(rid);
-		
 		}
 	
 		if (thread_safe) {
-			mutex->lock();
+			mutex->unlock();
 		}
 
 	}
+
+	/* packed access to the owned pointers, indices change when freeing */
+
+	_FORCE_INLINE_ int get_owned_count() const { return owned.size(); }
+	_FORCE_INLINE_ T *get_owned(int p_index) const { return owned[p_index].data; }
+
 	RID_Owner() {
 	
+		for(int i=0;i<MAX_CHUNKS;i++)
+			chunks[i]=NULL;
+		slot_count=0;
+		mutex=NULL;
+
 		if (thread_safe) {
 		
 			mutex = Mutex::create();
@@ -204,6 +366,11 @@ public:
 	
 	
 	~RID_Owner() {
+
+		for(int i=0;i<MAX_CHUNKS;i++) {
+			if (chunks[i])
+				memfree(chunks[i]);
+		}
 	
 		if (thread_safe) {
 		
@@ -331,6 +331,12 @@ void ScriptDebuggerRemote::_poll_events() {
 
 			if (request_scene_tree)
 				request_scene_tree(request_scene_tree_ud);
+		} else if (command=="start_profiling") {
+
+			_set_profiling(true);
+		} else if (command=="stop_profiling") {
+
+			_set_profiling(false);
 		}
 
 	}
@@ -371,10 +377,62 @@ void ScriptDebuggerRemote::idle_poll() {
 		}
 	    }
 
+	    if (profiling)
+		    _send_profiling_data();
+
 	    _poll_events();
 
 }
 
+void ScriptDebuggerRemote::_set_profiling(bool p_enable) {
+
+	if (p_enable==profiling)
+		return;
+
+	profiling=p_enable;
+
+	for(int i=0;i<ScriptServer::get_language_count();i++) {
+
+		if (profiling)
+			ScriptServer::get_language(i)->profiling_start();
+		else
+			ScriptServer::get_language(i)->profiling_stop();
+	}
+
+	if (profiling && profile_info.size()==0)
+		profile_info.resize(GLOBAL_DEF("debug/profiler_max_functions",16384));
+}
+
+void ScriptDebuggerRemote::_send_profiling_data() {
+
+	int count=0;
+
+	for(int i=0;i<ScriptServer::get_language_count() && count<profile_info.size();i++) {
+
+		count+=ScriptServer::get_language(i)->profiling_get_frame_data(&profile_info[count],profile_info.size()-count);
+	}
+
+	if (count==0)
+		return;
+
+	// flattened as signature, calls, total, self, native, times in usec
+	Array arr;
+	arr.resize(count*5);
+	for(int i=0;i<count;i++) {
+
+		const ScriptLanguage::ProfilingInfo &pi=profile_info[i];
+		arr[i*5+0]=pi.signature;
+		arr[i*5+1]=int(pi.call_count);
+		arr[i*5+2]=int(pi.total_time);
+		arr[i*5+3]=int(pi.self_time);
+		arr[i*5+4]=int(pi.native_time);
+	}
+
+	packet_peer_stream->put_var("profile_frame");
+	packet_peer_stream->put_var(1);
+	packet_peer_stream->put_var(arr);
+}
+
 
 void ScriptDebuggerRemote::send_message(const String& p_message, const Array &p_args) {
 
@@ -429,11 +487,13 @@ ScriptDebuggerRemote::ScriptDebuggerRemote() {
 	last_perf_time=0;
 	poll_every=0;
 	request_scene_tree=NULL;
+	profiling=false;
 
 }
 
 ScriptDebuggerRemote::~ScriptDebuggerRemote() {
 
+	_set_profiling(false);
 	remove_print_handler(&phl);
 	memdelete(mutex);
 
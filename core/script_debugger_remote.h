@@ -65,6 +65,12 @@ class ScriptDebuggerRemote : public ScriptDebugger {
 	RequestSceneTreeMessageFunc request_scene_tree;
 	void *request_scene_tree_ud;
 
+	bool profiling;
+	Vector<ScriptLanguage::ProfilingInfo> profile_info;
+
+	void _set_profiling(bool p_enable);
+	void _send_profiling_data();
+
 
 public:
 
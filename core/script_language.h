@@ -114,6 +114,8 @@ public:
 
 	virtual Ref<Script> get_script() const=0;
 
+	virtual bool is_placeholder() const { return false; }
+
 	virtual ScriptLanguage *get_language()=0;
 	virtual ~ScriptInstance();
 };
@@ -160,6 +162,24 @@ public:
 	virtual void get_public_functions(List<MethodInfo> *p_functions) const=0;
 	virtual void get_public_constants(List<Pair<String,Variant> > *p_constants) const=0;
 
+	/* PROFILING FUNCTIONS */
+
+	struct ProfilingInfo {
+
+		StringName signature;
+		uint64_t call_count;
+		uint64_t total_time; //usec, including callees
+		uint64_t self_time; //usec, excluding other script functions
+		uint64_t native_time; //usec, spent in engine calls made by the function
+	};
+
+	virtual void profiling_start() {}
+	virtual void profiling_stop() {}
+	virtual bool is_profiling() const { return false; }
+	//both return the amount of functions written, only those called since start or during the last frame
+	virtual int profiling_get_accumulated_data(ProfilingInfo *p_info_arr,int p_info_max) { return 0; }
+	virtual int profiling_get_frame_data(ProfilingInfo *p_info_arr,int p_info_max) { return 0; }
+
 	virtual void frame();
 
 	virtual ~ScriptLanguage() {};	
@@ -190,6 +210,8 @@ public:
 
 	virtual Ref<Script> get_script() const { return script; }
 
+	virtual bool is_placeholder() const { return true; }
+
 	virtual ScriptLanguage *get_language() { return language; }
 
 	Object *get_owner() { return owner; }
@@ -178,6 +178,19 @@ public:
 	bool is_ref() const;
 	_FORCE_INLINE_ bool is_num() const { return type==INT || type==REAL; };
 	_FORCE_INLINE_ bool is_array() const { return type>=ARRAY; };
+
+	/* fast access for script interpreters, getters don't check the type (test get_type() first) */
+
+	_FORCE_INLINE_ int get_int_unchecked() const { return _data._int; }
+	_FORCE_INLINE_ double get_real_unchecked() const { return _data._real; }
+	_FORCE_INLINE_ const Vector2& get_vector2_unchecked() const { return *reinterpret_cast<const Vector2*>(_data._mem); }
+	_FORCE_INLINE_ const Vector3& get_vector3_unchecked() const { return *reinterpret_cast<const Vector3*>(_data._mem); }
+
+	_FORCE_INLINE_ void assign_bool(bool p_bool) { if (type!=BOOL) { clear(); type=BOOL; } _data._bool=p_bool; }
+	_FORCE_INLINE_ void assign_int(int p_int) { if (type!=INT) { clear(); type=INT; } _data._int=p_int; }
+	_FORCE_INLINE_ void assign_real(double p_real) { if (type!=REAL) { clear(); type=REAL; } _data._real=p_real; }
+	_FORCE_INLINE_ void assign_vector2(const Vector2& p_vector2) { if (type!=VECTOR2) { clear(); type=VECTOR2; } memnew_placement( _data._mem, Vector2( p_vector2 ) ); }
+	_FORCE_INLINE_ void assign_vector3(const Vector3& p_vector3) { if (type!=VECTOR3) { clear(); type=VECTOR3; } memnew_placement( _data._mem, Vector3( p_vector3 ) ); }
 	bool is_shared() const;
 	bool is_zero() const;
 
@@ -388,6 +401,46 @@ public:
 
 	void get_method_list(List<MethodInfo> *p_list) const;
 
+	/* built-in methods of the non object types, resolved to an index once so callers
+	   that know the receiver type skip the name lookup on every call */
+
+	static int get_method_index(Type p_type,const StringName& p_method); ///< -1 if p_type has no such method
+	Variant call_index(int p_index,const Variant** p_args,int p_argcount,CallError &r_error); ///< p_index must come from get_method_index() for this type
+
+	/* named members of the math types (VECTOR2 to COLOR), resolved by StringName pointer
+	   so scripts can skip the String conversion and compares done by get()/set() */
+
+	enum Member {
+
+		MEMBER_X,
+		MEMBER_Y,
+		MEMBER_Z,
+		MEMBER_W,
+		MEMBER_D,
+		MEMBER_O,
+		MEMBER_WIDTH,
+		MEMBER_HEIGHT,
+		MEMBER_NORMAL,
+		MEMBER_POS,
+		MEMBER_SIZE,
+		MEMBER_END,
+		MEMBER_BASIS,
+		MEMBER_ORIGIN,
+		MEMBER_R,
+		MEMBER_G,
+		MEMBER_B,
+		MEMBER_A,
+		MEMBER_H,
+		MEMBER_S,
+		MEMBER_V,
+		MEMBER_MAX
+	};
+
+	static Member get_member_by_name(const StringName& p_name); ///< MEMBER_MAX if no math type has it
+	static Member find_member(Type p_type,const StringName& p_name); ///< MEMBER_MAX if p_type has no such member
+	void set_member(Member p_member, const Variant& p_value, bool *r_valid=NULL);
+	Variant get_member(Member p_member, bool *r_valid=NULL) const;
+
 	void set_named(const StringName& p_index, const Variant& p_value, bool *r_valid=NULL);
 	Variant get_named(const StringName& p_index, bool *r_valid=NULL) const;
 
@@ -51,6 +51,7 @@ struct _VariantCall {
 
 	struct FuncData {
 
+		StringName name;
 		int arg_count;
 		Vector<Variant> default_args;
 		Vector<Variant::Type> arg_types;
@@ -62,12 +63,12 @@ struct _VariantCall {
 #endif
 		VariantFunc func;
 
-		_FORCE_INLINE_ bool verify_arguments(const Variant **p_args,Variant::CallError &r_error) {
+		_FORCE_INLINE_ bool verify_arguments(const Variant **p_args,Variant::CallError &r_error) const {
 
 			if (arg_count==0)
 				return true;
 
-			Variant::Type *tptr = &arg_types[0];
+			const Variant::Type *tptr = arg_types.ptr();
 
 			for(int i=0;i<arg_count;i++) {
 
@@ -84,7 +85,7 @@ struct _VariantCall {
 			return true;
 		}
 
-		_FORCE_INLINE_ void call(Variant& r_ret,Variant& p_self,const Variant** p_args,int p_argcount,Variant::CallError &r_error) {
+		_FORCE_INLINE_ void call(Variant& r_ret,Variant& p_self,const Variant** p_args,int p_argcount,Variant::CallError &r_error) const {
 #ifdef DEBUG_ENABLED
 			if(p_argcount>arg_count) {
 				r_error.error=Variant::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
@@ -107,8 +108,9 @@ struct _VariantCall {
 				for(int i=0;i<p_argcount;i++)
 					newargs[i]=p_args[i];
 				int defargcount=def_argcount;
+				const Variant *defargs=default_args.ptr();
 				for(int i=p_argcount;i<arg_count;i++)
-					newargs[i]=&default_args[defargcount-(i-p_argcount)-1]; //default arguments
+					newargs[i]=&defargs[defargcount-(i-p_argcount)-1]; //default arguments
 #ifdef DEBUG_ENABLED
 				if (!verify_arguments(newargs,r_error))
 					return;
@@ -129,7 +131,8 @@ struct _VariantCall {
 
 	struct TypeFunc {
 
-		Map<StringName,FuncData> functions;
+		Vector<FuncData> functions; //in registration order, indexed by Variant::get_method_index()
+		HashMap<StringName,int,StringNameHasher> function_index;
 	};
 
 	static TypeFunc* type_funcs;
@@ -202,7 +205,16 @@ struct _VariantCall {
 		end:
 
 		funcdata.arg_count=funcdata.arg_types.size();
-		type_funcs[p_type].functions[p_name]=funcdata;
+		funcdata.name=p_name;
+
+		TypeFunc &tf=type_funcs[p_type];
+		const int *idx=tf.function_index.getptr(p_name);
+		if (idx) {
+			tf.functions[*idx]=funcdata;
+		} else {
+			tf.function_index[p_name]=tf.functions.size();
+			tf.functions.push_back(funcdata);
+		}
 
 	}
 
@@ -861,20 +873,43 @@ Variant Variant::call(const StringName& p_method,const Variant** p_args,int p_ar
 
 		r_error.error=Variant::CallError::CALL_OK;
 
-		Map<StringName,_VariantCall::FuncData>::Element *E=_VariantCall::type_funcs[type].functions.find(p_method);
-#ifdef DEBUG_ENABLED
-		if (!E) {
+		const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[type];
+		const int *idx=tf.function_index.getptr(p_method);
+		if (!idx) {
 			r_error.error=Variant::CallError::CALL_ERROR_INVALID_METHOD;
 			return Variant();
 		}
-#endif
-		_VariantCall::FuncData& funcdata = E->get();
-		funcdata.call(ret,*this,p_args,p_argcount,r_error);
+		tf.functions[*idx].call(ret,*this,p_args,p_argcount,r_error);
 	}
 
 	return ret;
 }
 
+int Variant::get_method_index(Type p_type,const StringName& p_method) {
+
+	ERR_FAIL_INDEX_V(p_type,VARIANT_MAX,-1);
+	if (p_type==OBJECT)
+		return -1; //objects resolve their own methods
+
+	const int *idx=_VariantCall::type_funcs[p_type].function_index.getptr(p_method);
+	return idx ? *idx : -1;
+}
+
+Variant Variant::call_index(int p_index,const Variant** p_args,int p_argcount,CallError &r_error) {
+
+	Variant ret;
+	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[type];
+#ifdef DEBUG_ENABLED
+	if (type==OBJECT || p_index<0 || p_index>=tf.functions.size()) {
+		r_error.error=Variant::CallError::CALL_ERROR_INVALID_METHOD;
+		ERR_FAIL_V(ret);
+	}
+#endif
+	r_error.error=Variant::CallError::CALL_OK;
+	tf.functions[p_index].call(ret,*this,p_args,p_argcount,r_error);
+	return ret;
+}
+
 #define VCALL(m_type,m_method) _VariantCall::_call_##m_type##_##m_method
 
 
@@ -1003,14 +1038,14 @@ Variant Variant::construct(const Variant::Type p_type,const Variant** p_args,int
 void Variant::get_method_list(List<MethodInfo> *p_list) const {
 
 
-	const _VariantCall::TypeFunc &fd = _VariantCall::type_funcs[type];
+	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[type];
 
-	for (const Map<StringName,_VariantCall::FuncData>::Element *E=fd.functions.front();E;E=E->next()) {
+	for (int f=0;f<tf.functions.size();f++) {
 
-		const _VariantCall::FuncData &fd = E->get();
+		const _VariantCall::FuncData &fd = tf.functions[f];
 
 		MethodInfo mi;
-		mi.name=E->key();
+		mi.name=fd.name;
 
 		for(int i=0;i<fd.arg_types.size();i++) {
 
@@ -1409,8 +1444,8 @@ _VariantCall::addfunc(Variant::m_vtype,Variant::m_ret,_SCS(#m_method),VCALL(m_cl
 	ADDFUNC1(TRANSFORM,NIL,Transform,xform_inv,NIL,"v",varray());
 
 #ifdef DEBUG_ENABLED	
-	_VariantCall::type_funcs[Variant::TRANSFORM].functions["xform"].returns=true;
-	_VariantCall::type_funcs[Variant::TRANSFORM].functions["xform_inv"].returns=true;
+	_VariantCall::type_funcs[Variant::TRANSFORM].functions[Variant::get_method_index(Variant::TRANSFORM,"xform")].returns=true;
+	_VariantCall::type_funcs[Variant::TRANSFORM].functions[Variant::get_method_index(Variant::TRANSFORM,"xform_inv")].returns=true;
 #endif	
 
 	ADDFUNC0(INPUT_EVENT,BOOL,InputEvent,is_pressed,varray());
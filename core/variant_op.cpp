@@ -855,6 +855,386 @@ void Variant::evaluate(const Operator& p_op, const Variant& p_a, const Variant&
 	r_valid=false;
 }
 
+struct _VariantMembers {
+
+	static StringName *names;
+	static Variant::Member type_members[Variant::VARIANT_MAX][8]; // terminated by MEMBER_MAX
+
+	static void add(Variant::Type p_type,Variant::Member p_member) {
+
+		Variant::Member *m=type_members[p_type];
+		while(*m!=Variant::MEMBER_MAX)
+			m++;
+		*m=p_member;
+	}
+};
+
+StringName *_VariantMembers::names=NULL;
+Variant::Member _VariantMembers::type_members[Variant::VARIANT_MAX][8];
+
+void register_variant_members() {
+
+	_VariantMembers::names = memnew_arr(StringName,Variant::MEMBER_MAX);
+
+	static const char* member_names[Variant::MEMBER_MAX]={
+		"x","y","z","w","d","o","width","height","normal","pos","size","end","basis","origin",
+		"r","g","b","a","h","s","v"
+	};
+
+	for(int i=0;i<Variant::MEMBER_MAX;i++)
+		_VariantMembers::names[i]=StaticCString::create(member_names[i]);
+
+	for(int i=0;i<Variant::VARIANT_MAX;i++) {
+		for(int j=0;j<8;j++)
+			_VariantMembers::type_members[i][j]=Variant::MEMBER_MAX;
+	}
+
+	// most used first, lookup is linear
+
+	_VariantMembers::add(Variant::VECTOR2,Variant::MEMBER_X);
+	_VariantMembers::add(Variant::VECTOR2,Variant::MEMBER_Y);
+	_VariantMembers::add(Variant::VECTOR2,Variant::MEMBER_WIDTH);
+	_VariantMembers::add(Variant::VECTOR2,Variant::MEMBER_HEIGHT);
+
+	_VariantMembers::add(Variant::RECT2,Variant::MEMBER_POS);
+	_VariantMembers::add(Variant::RECT2,Variant::MEMBER_SIZE);
+	_VariantMembers::add(Variant::RECT2,Variant::MEMBER_END);
+
+	_VariantMembers::add(Variant::VECTOR3,Variant::MEMBER_X);
+	_VariantMembers::add(Variant::VECTOR3,Variant::MEMBER_Y);
+	_VariantMembers::add(Variant::VECTOR3,Variant::MEMBER_Z);
+
+	_VariantMembers::add(Variant::MATRIX32,Variant::MEMBER_X);
+	_VariantMembers::add(Variant::MATRIX32,Variant::MEMBER_Y);
+	_VariantMembers::add(Variant::MATRIX32,Variant::MEMBER_O);
+
+	_VariantMembers::add(Variant::PLANE,Variant::MEMBER_NORMAL);
+	_VariantMembers::add(Variant::PLANE,Variant::MEMBER_D);
+	_VariantMembers::add(Variant::PLANE,Variant::MEMBER_X);
+	_VariantMembers::add(Variant::PLANE,Variant::MEMBER_Y);
+	_VariantMembers::add(Variant::PLANE,Variant::MEMBER_Z);
+
+	_VariantMembers::add(Variant::QUAT,Variant::MEMBER_X);
+	_VariantMembers::add(Variant::QUAT,Variant::MEMBER_Y);
+	_VariantMembers::add(Variant::QUAT,Variant::MEMBER_Z);
+	_VariantMembers::add(Variant::QUAT,Variant::MEMBER_W);
+
+	_VariantMembers::add(Variant::_AABB,Variant::MEMBER_POS);
+	_VariantMembers::add(Variant::_AABB,Variant::MEMBER_SIZE);
+	_VariantMembers::add(Variant::_AABB,Variant::MEMBER_END);
+
+	_VariantMembers::add(Variant::TRANSFORM,Variant::MEMBER_ORIGIN);
+	_VariantMembers::add(Variant::TRANSFORM,Variant::MEMBER_BASIS);
+
+	_VariantMembers::add(Variant::COLOR,Variant::MEMBER_R);
+	_VariantMembers::add(Variant::COLOR,Variant::MEMBER_G);
+	_VariantMembers::add(Variant::COLOR,Variant::MEMBER_B);
+	_VariantMembers::add(Variant::COLOR,Variant::MEMBER_A);
+	_VariantMembers::add(Variant::COLOR,Variant::MEMBER_H);
+	_VariantMembers::add(Variant::COLOR,Variant::MEMBER_S);
+	_VariantMembers::add(Variant::COLOR,Variant::MEMBER_V);
+}
+
+void unregister_variant_members() {
+
+	memdelete_arr(_VariantMembers::names);
+	_VariantMembers::names=NULL;
+}
+
+Variant::Member Variant::get_member_by_name(const StringName& p_name) {
+
+	if (!_VariantMembers::names)
+		return MEMBER_MAX;
+
+	for(int i=0;i<MEMBER_MAX;i++) {
+
+		if (_VariantMembers::names[i]==p_name)
+			return Member(i);
+	}
+
+	return MEMBER_MAX;
+}
+
+Variant::Member Variant::find_member(Type p_type,const StringName& p_name) {
+
+	if (!_VariantMembers::names)
+		return MEMBER_MAX;
+
+	for(const Member *m=_VariantMembers::type_members[p_type];*m!=MEMBER_MAX;m++) {
+
+		if (_VariantMembers::names[*m]==p_name)
+			return *m;
+	}
+
+	return MEMBER_MAX;
+}
+
+void Variant::set_member(Member p_member, const Variant& p_value, bool *r_valid) {
+
+	static bool _dummy=false;
+
+	bool &valid = r_valid ? *r_valid : _dummy;
+	valid=false;
+
+	switch(type) {
+
+		case VECTOR2: {
+
+			if (p_value.type!=Variant::INT && p_value.type!=Variant::REAL)
+				return;
+
+			Vector2 *v=reinterpret_cast<Vector2*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_X:
+				case MEMBER_WIDTH: v->x=p_value; break;
+				case MEMBER_Y:
+				case MEMBER_HEIGHT: v->y=p_value; break;
+				default: return;
+			}
+		} break;
+		case RECT2: {
+
+			if (p_value.type!=Variant::VECTOR2)
+				return;
+
+			Rect2 *v=reinterpret_cast<Rect2*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_POS: v->pos=p_value; break;
+				case MEMBER_SIZE: v->size=p_value; break;
+				case MEMBER_END: v->size=Vector2(p_value) - v->pos; break;
+				default: return;
+			}
+		} break;
+		case VECTOR3: {
+
+			if (p_value.type!=Variant::INT && p_value.type!=Variant::REAL)
+				return;
+
+			Vector3 *v=reinterpret_cast<Vector3*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_X: v->x=p_value; break;
+				case MEMBER_Y: v->y=p_value; break;
+				case MEMBER_Z: v->z=p_value; break;
+				default: return;
+			}
+		} break;
+		case MATRIX32: {
+
+			if (p_value.type!=Variant::VECTOR2)
+				return;
+
+			Matrix32 *v=_data._matrix32;
+			switch(p_member) {
+				case MEMBER_X: v->elements[0]=p_value; break;
+				case MEMBER_Y: v->elements[1]=p_value; break;
+				case MEMBER_O: v->elements[2]=p_value; break;
+				default: return;
+			}
+		} break;
+		case PLANE: {
+
+			Plane *v=reinterpret_cast<Plane*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_X:
+				case MEMBER_Y:
+				case MEMBER_Z: {
+
+					if (p_value.type!=Variant::INT && p_value.type!=Variant::REAL)
+						return;
+					v->normal[p_member-MEMBER_X]=p_value;
+				} break;
+				case MEMBER_NORMAL: {
+
+					if (p_value.type!=Variant::VECTOR3)
+						return;
+					v->normal=p_value;
+				} break;
+				case MEMBER_D: v->d=p_value; break;
+				default: return;
+			}
+		} break;
+		case QUAT: {
+
+			if (p_value.type!=Variant::INT && p_value.type!=Variant::REAL)
+				return;
+
+			Quat *v=reinterpret_cast<Quat*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_X: v->x=p_value; break;
+				case MEMBER_Y: v->y=p_value; break;
+				case MEMBER_Z: v->z=p_value; break;
+				case MEMBER_W: v->w=p_value; break;
+				default: return;
+			}
+		} break;
+		case _AABB: {
+
+			if (p_value.type!=Variant::VECTOR3)
+				return;
+
+			AABB *v=_data._aabb;
+			switch(p_member) {
+				case MEMBER_POS: v->pos=p_value; break;
+				case MEMBER_SIZE: v->size=p_value; break;
+				case MEMBER_END: v->size=Vector3(p_value) - v->pos; break;
+				default: return;
+			}
+		} break;
+		case TRANSFORM: {
+
+			Transform *v=_data._transform;
+			switch(p_member) {
+				case MEMBER_BASIS: {
+
+					if (p_value.type!=Variant::MATRIX3)
+						return;
+					v->basis=p_value;
+				} break;
+				case MEMBER_ORIGIN: {
+
+					if (p_value.type!=Variant::VECTOR3)
+						return;
+					v->origin=p_value;
+				} break;
+				default: return;
+			}
+		} break;
+		case COLOR: {
+
+			if (p_value.type!=Variant::INT && p_value.type!=Variant::REAL)
+				return;
+
+			Color *v=reinterpret_cast<Color*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_R: v->r=p_value; break;
+				case MEMBER_G: v->g=p_value; break;
+				case MEMBER_B: v->b=p_value; break;
+				case MEMBER_A: v->a=p_value; break;
+				case MEMBER_H: v->set_hsv(p_value,v->get_s(),v->get_v()); break;
+				case MEMBER_S: v->set_hsv(v->get_h(),p_value,v->get_v()); break;
+				case MEMBER_V: v->set_hsv(v->get_h(),v->get_s(),p_value); break;
+				default: return;
+			}
+		} break;
+		default: return;
+	}
+
+	valid=true;
+}
+
+Variant Variant::get_member(Member p_member, bool *r_valid) const {
+
+	static bool _dummy=false;
+
+	bool &valid = r_valid ? *r_valid : _dummy;
+	valid=true;
+
+	switch(type) {
+
+		case VECTOR2: {
+
+			const Vector2 *v=reinterpret_cast<const Vector2*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_X:
+				case MEMBER_WIDTH: return v->x;
+				case MEMBER_Y:
+				case MEMBER_HEIGHT: return v->y;
+				default: {}
+			}
+		} break;
+		case RECT2: {
+
+			const Rect2 *v=reinterpret_cast<const Rect2*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_POS: return v->pos;
+				case MEMBER_SIZE: return v->size;
+				case MEMBER_END: return v->size+v->pos;
+				default: {}
+			}
+		} break;
+		case VECTOR3: {
+
+			const Vector3 *v=reinterpret_cast<const Vector3*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_X: return v->x;
+				case MEMBER_Y: return v->y;
+				case MEMBER_Z: return v->z;
+				default: {}
+			}
+		} break;
+		case MATRIX32: {
+
+			const Matrix32 *v=_data._matrix32;
+			switch(p_member) {
+				case MEMBER_X: return v->elements[0];
+				case MEMBER_Y: return v->elements[1];
+				case MEMBER_O: return v->elements[2];
+				default: {}
+			}
+		} break;
+		case PLANE: {
+
+			const Plane *v=reinterpret_cast<const Plane*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_X: return v->normal.x;
+				case MEMBER_Y: return v->normal.y;
+				case MEMBER_Z: return v->normal.z;
+				case MEMBER_NORMAL: return v->normal;
+				case MEMBER_D: return v->d;
+				default: {}
+			}
+		} break;
+		case QUAT: {
+
+			const Quat *v=reinterpret_cast<const Quat*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_X: return v->x;
+				case MEMBER_Y: return v->y;
+				case MEMBER_Z: return v->z;
+				case MEMBER_W: return v->w;
+				default: {}
+			}
+		} break;
+		case _AABB: {
+
+			const AABB *v=_data._aabb;
+			switch(p_member) {
+				case MEMBER_POS: return v->pos;
+				case MEMBER_SIZE: return v->size;
+				case MEMBER_END: return v->size+v->pos;
+				default: {}
+			}
+		} break;
+		case TRANSFORM: {
+
+			const Transform *v=_data._transform;
+			switch(p_member) {
+				case MEMBER_BASIS: return v->basis;
+				case MEMBER_ORIGIN: return v->origin;
+				default: {}
+			}
+		} break;
+		case COLOR: {
+
+			const Color *v=reinterpret_cast<const Color*>(_data._mem);
+			switch(p_member) {
+				case MEMBER_R: return v->r;
+				case MEMBER_G: return v->g;
+				case MEMBER_B: return v->b;
+				case MEMBER_A: return v->a;
+				case MEMBER_H: return v->get_h();
+				case MEMBER_S: return v->get_s();
+				case MEMBER_V: return v->get_v();
+				default: {}
+			}
+		} break;
+		default: {}
+	}
+
+	valid=false;
+	return Variant();
+}
+
 void Variant::set_named(const StringName& p_index, const Variant& p_value, bool *r_valid) {
 
 	if (type==OBJECT) {
@@ -879,6 +1259,12 @@ void Variant::set_named(const StringName& p_index, const Variant& p_value, bool
 		return;
 	}
 
+	Member member=find_member(type,p_index);
+	if (member!=MEMBER_MAX) {
+		set_member(member,p_value,r_valid);
+		return;
+	}
+
 	set(p_index.operator String(),p_value,r_valid);
 }
 
@@ -905,6 +1291,10 @@ Variant Variant::get_named(const StringName& p_index, bool *r_valid) const {
 		return _get_obj().obj->get(p_index,r_valid);
 	}
 
+	Member member=find_member(type,p_index);
+	if (member!=MEMBER_MAX)
+		return get_member(member,r_valid);
+
 	return get(p_index.operator String(),r_valid);
 }
 
@@ -6732,6 +6732,35 @@ void RasterizerGLES2::canvas_set_transform(const Matrix32& p_transform) {
 	//canvas_transform = Variant(p_transform);
 }
 
+void RasterizerGLES2::canvas_draw_rect_batch(int p_quads, const Vector2* p_vertices, const Vector2* p_uvs, const Color* p_colors, RID p_texture) {
+
+	ERR_FAIL_COND(p_quads<=0 || p_quads>CANVAS_BATCH_MAX_QUADS);
+
+	_bind_canvas_texture(p_texture);
+
+#ifndef GLES_NO_CLIENT_ARRAYS
+
+	glEnableVertexAttribArray(VS::ARRAY_VERTEX);
+	glVertexAttribPointer( VS::ARRAY_VERTEX, 2 ,GL_FLOAT, false, sizeof(Vector2), p_vertices );
+	glEnableVertexAttribArray(VS::ARRAY_COLOR);
+	glVertexAttribPointer( VS::ARRAY_COLOR, 4 ,GL_FLOAT, false, sizeof(Color), p_colors );
+	glEnableVertexAttribArray(VS::ARRAY_TEX_UV);
+	glVertexAttribPointer( VS::ARRAY_TEX_UV, 2 ,GL_FLOAT, false, sizeof(Vector2), p_uvs );
+
+	glDrawElements(GL_TRIANGLES, p_quads*6, GL_UNSIGNED_SHORT, canvas_quad_indices );
+
+	glDisableVertexAttribArray(VS::ARRAY_COLOR);
+	_rinfo.ci_draw_commands++;
+#else
+	//no client arrays, go through the quad buffer
+	for(int i=0;i<p_quads;i++) {
+
+		_draw_gui_primitive(4,&p_vertices[i*4],&p_colors[i*4],&p_uvs[i*4]);
+	}
+#endif
+
+}
+
 /* ENVIRONMENT */
 
 RID RasterizerGLES2::environment_create() {
@@ -7546,6 +7575,17 @@ void RasterizerGLES2::init() {
 	skinned_buffer_size = GLOBAL_DEF("rasterizer/skinned_buffer_size",DEFAULT_SKINNED_BUFFER_SIZE);
 	skinned_buffer = memnew_arr( uint8_t, skinned_buffer_size );
 
+	canvas_quad_indices = memnew_arr( uint16_t, CANVAS_BATCH_MAX_QUADS*6 );
+	for(int i=0;i<CANVAS_BATCH_MAX_QUADS;i++) {
+
+		canvas_quad_indices[i*6+0]=i*4+0;
+		canvas_quad_indices[i*6+1]=i*4+1;
+		canvas_quad_indices[i*6+2]=i*4+2;
+		canvas_quad_indices[i*6+3]=i*4+2;
+		canvas_quad_indices[i*6+4]=i*4+3;
+		canvas_quad_indices[i*6+5]=i*4+0;
+	}
+
 	glGenTextures(1, &white_tex);
 	unsigned char whitetexdata[8*8*3];
 	for(int i=0;i<8*8*3;i++) {
@@ -7678,6 +7718,7 @@ void RasterizerGLES2::finish() {
 
 
 	memdelete_arr(skinned_buffer);
+	memdelete_arr(canvas_quad_indices);
 }
 
 int RasterizerGLES2::get_render_info(VS::RenderInfo p_info) {
@@ -7724,6 +7765,14 @@ int RasterizerGLES2::get_render_info(VS::RenderInfo p_info) {
 
 			return 0;
 		} break;
+		case VS::INFO_CANVAS_BATCHES_IN_FRAME:
+		case VS::INFO_CANVAS_BATCHED_COMMANDS_IN_FRAME:
+		case VS::INFO_CULL_INSTANCES_IN_FRAME:
+		case VS::INFO_CULL_VISIBLE_IN_FRAME:
+		case VS::INFO_CULL_USEC_IN_FRAME: {
+
+			return 0; //counted by the visual server
+		} break;
 	}
 
 	return 0;
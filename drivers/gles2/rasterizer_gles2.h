@@ -72,6 +72,7 @@ class RasterizerGLES2 : public Rasterizer {
 
 	uint8_t *skinned_buffer;
 	int skinned_buffer_size;
+	uint16_t *canvas_quad_indices;
 	bool pvr_supported;
 	bool s3tc_supported;
 	bool etc_supported;
@@ -1382,6 +1383,7 @@ public:
 	virtual void canvas_draw_primitive(const Vector<Point2>& p_points, const Vector<Color>& p_colors,const Vector<Point2>& p_uvs, RID p_texture,float p_width);
 	virtual void canvas_draw_polygon(int p_vertex_count, const int* p_indices, const Vector2* p_vertices, const Vector2* p_uvs, const Color* p_colors,const RID& p_texture,bool p_singlecolor);
 	virtual void canvas_set_transform(const Matrix32& p_transform);
+	virtual void canvas_draw_rect_batch(int p_quads, const Vector2* p_vertices, const Vector2* p_uvs, const Color* p_colors, RID p_texture);
 
 	/* ENVIRONMENT */
 
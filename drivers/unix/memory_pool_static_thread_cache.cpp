@@ -0,0 +1,455 @@
+/*************************************************************************/
+/*  memory_pool_static_thread_cache.cpp                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "memory_pool_static_thread_cache.h"
+#include "error_macros.h"
+#include "os/copymem.h"
+#include "os/os.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifndef NO_PTHREADS
+#define CENTRAL_LOCK(m_class) pthread_mutex_lock(&central[m_class].mutex)
+#define CENTRAL_UNLOCK(m_class) pthread_mutex_unlock(&central[m_class].mutex)
+#else
+#define CENTRAL_LOCK(m_class)
+#define CENTRAL_UNLOCK(m_class)
+#endif
+
+MemoryPoolStaticThreadCache *MemoryPoolStaticThreadCache::pool=NULL;
+
+#ifdef DEBUG_MEMORY_ENABLED
+
+void MemoryPoolStaticThreadCache::_account(size_t p_add,size_t p_sub,int p_pointers) {
+
+#ifndef NO_PTHREADS
+	size_t mem = __sync_add_and_fetch(&total_mem,p_add-p_sub);
+	int pointers = __sync_add_and_fetch(&total_pointers,p_pointers);
+#else
+	size_t mem = (total_mem+=p_add-p_sub);
+	int pointers = (total_pointers+=p_pointers);
+#endif
+	//maximums are only statistics, a lost update does not matter
+	if (mem > max_mem)
+		max_mem=mem;
+	if (pointers > max_pointers)
+		max_pointers=pointers;
+}
+
+#endif
+
+uint32_t MemoryPoolStaticThreadCache::_get_size_class(size_t p_bytes) {
+
+	if (p_bytes<=SMALL_MAX)
+		return (p_bytes+SMALL_STEP-1)/SMALL_STEP-1;
+	if (p_bytes>LARGE_MAX)
+		return CLASS_NONE;
+
+	uint32_t size_class=SMALL_CLASSES;
+	size_t size=SMALL_MAX*2;
+	while(size<p_bytes) {
+		size<<=1;
+		size_class++;
+	}
+
+	return size_class;
+}
+
+MemoryPoolStaticThreadCache::ThreadCache *MemoryPoolStaticThreadCache::_get_thread_cache() {
+
+#ifndef NO_PTHREADS
+	ThreadCache *cache = (ThreadCache*)pthread_getspecific(cache_key);
+	if (!cache) {
+		//can't come from the pool itself
+		cache = (ThreadCache*)::calloc(1,sizeof(ThreadCache));
+		if (cache)
+			pthread_setspecific(cache_key,cache);
+	}
+	return cache;
+#else
+	return &single_cache;
+#endif
+}
+
+void MemoryPoolStaticThreadCache::_fetch_from_central(ThreadCache *p_cache,uint32_t p_class) {
+
+	int count=transfer[p_class];
+	FreeList &cl=central[p_class].list;
+
+	CENTRAL_LOCK(p_class);
+
+	if (cl.count<count) {
+		//carve a new chunk, the first HEADER_SIZE bytes link it to the others
+		size_t bsize=block_size[p_class];
+		size_t csize=MAX((size_t)CHUNK_SIZE,bsize*count)+HEADER_SIZE;
+		void *chunk=NULL;
+		if (posix_memalign(&chunk,HEADER_SIZE,csize)!=0)
+			chunk=NULL;
+
+		if (chunk) {
+
+#ifndef NO_PTHREADS
+			pthread_mutex_lock(&chunk_mutex);
+#endif
+			*(void**)chunk=chunks;
+			chunks=chunk;
+#ifndef NO_PTHREADS
+			pthread_mutex_unlock(&chunk_mutex);
+#endif
+			uint8_t *blocks=(uint8_t*)chunk+HEADER_SIZE;
+			int block_count=(csize-HEADER_SIZE)/bsize;
+			for(int i=block_count-1;i>=0;i--) {
+
+				FreeBlock *b=(FreeBlock*)&blocks[i*bsize];
+				b->next=cl.first;
+				cl.first=b;
+			}
+			cl.count+=block_count;
+		}
+	}
+
+	FreeList &tl=p_cache->lists[p_class];
+	for(int i=0;i<count && cl.first;i++) {
+
+		FreeBlock *b=cl.first;
+		cl.first=b->next;
+		cl.count--;
+		b->next=tl.first;
+		tl.first=b;
+		tl.count++;
+	}
+
+	CENTRAL_UNLOCK(p_class);
+}
+
+void MemoryPoolStaticThreadCache::_release_to_central(ThreadCache *p_cache,uint32_t p_class,int p_count) {
+
+	FreeList &tl=p_cache->lists[p_class];
+	if (!tl.first || p_count<=0)
+		return;
+
+	//detach outside of the lock, then splice
+	FreeBlock *first=tl.first;
+	FreeBlock *last=first;
+	int moved=1;
+	while(moved<p_count && last->next) {
+		last=last->next;
+		moved++;
+	}
+	tl.first=last->next;
+	tl.count-=moved;
+
+	FreeList &cl=central[p_class].list;
+
+	CENTRAL_LOCK(p_class);
+	last->next=cl.first;
+	cl.first=first;
+	cl.count+=moved;
+	CENTRAL_UNLOCK(p_class);
+}
+
+void MemoryPoolStaticThreadCache::_thread_exit(void *p_cache) {
+
+	ThreadCache *cache=(ThreadCache*)p_cache;
+
+	if (pool) {
+		for(int i=0;i<CLASS_COUNT;i++)
+			pool->_release_to_central(cache,i,cache->lists[i].count);
+	}
+
+	::free(cache);
+}
+
+void *MemoryPoolStaticThreadCache::_alloc(size_t p_bytes) {
+
+	uint32_t size_class=_get_size_class(p_bytes);
+	Header *header;
+
+	if (size_class==CLASS_NONE) {
+
+		void *mem=NULL;
+		if (posix_memalign(&mem,HEADER_SIZE,p_bytes+HEADER_SIZE)!=0)
+			mem=NULL;
+		ERR_FAIL_COND_V(!mem,NULL); //out of memory, or unreasonable request
+		header=(Header*)mem;
+
+	} else {
+
+		ThreadCache *cache=_get_thread_cache();
+		ERR_FAIL_COND_V(!cache,NULL);
+
+		FreeList &list=cache->lists[size_class];
+		if (!list.first) {
+			_fetch_from_central(cache,size_class);
+			ERR_FAIL_COND_V(!list.first,NULL); //out of memory
+		}
+
+		FreeBlock *b=list.first;
+		list.first=b->next;
+		list.count--;
+		header=(Header*)b;
+	}
+
+	header->size=p_bytes;
+	header->size_class=size_class;
+
+#ifdef DEBUG_MEMORY_ENABLED
+	_account(p_bytes,0,1);
+#endif
+
+	return (uint8_t*)header+HEADER_SIZE;
+}
+
+void MemoryPoolStaticThreadCache::_free(Header *p_header) {
+
+	uint32_t size_class=p_header->size_class;
+	ERR_FAIL_COND(size_class>CLASS_NONE); //not from this pool, or corrupted
+
+#ifdef DEBUG_MEMORY_ENABLED
+	_account(0,p_header->size,-1);
+	// catch more errors
+	zeromem((uint8_t*)p_header+HEADER_SIZE,p_header->size);
+#endif
+
+	if (size_class==CLASS_NONE) {
+
+		::free(p_header);
+		return;
+	}
+
+	FreeBlock *b=(FreeBlock*)p_header;
+	ThreadCache *cache=_get_thread_cache();
+
+	if (!cache) {
+		//no memory for a cache, give it back directly
+		CENTRAL_LOCK(size_class);
+		b->next=central[size_class].list.first;
+		central[size_class].list.first=b;
+		central[size_class].list.count++;
+		CENTRAL_UNLOCK(size_class);
+		return;
+	}
+
+	FreeList &list=cache->lists[size_class];
+	b->next=list.first;
+	list.first=b;
+	list.count++;
+
+	if (list.count>transfer[size_class]*2)
+		_release_to_central(cache,size_class,transfer[size_class]);
+}
+
+void* MemoryPoolStaticThreadCache::alloc(size_t p_bytes,const char *p_description) {
+
+	ERR_FAIL_COND_V(p_bytes==0,0);
+	return _alloc(p_bytes);
+}
+
+void MemoryPoolStaticThreadCache::free(void *p_ptr) {
+
+	ERR_FAIL_COND(p_ptr==0);
+	_free((Header*)((uint8_t*)p_ptr-HEADER_SIZE));
+}
+
+void* MemoryPoolStaticThreadCache::realloc(void *p_memory,size_t p_bytes) {
+
+	if (p_memory==NULL)
+		return alloc(p_bytes);
+
+	if (p_bytes==0) {
+
+		this->free(p_memory);
+		return NULL;
+	}
+
+	Header *header=(Header*)((uint8_t*)p_memory-HEADER_SIZE);
+	uint32_t size_class=header->size_class;
+	uint32_t new_class=_get_size_class(p_bytes);
+
+	if (size_class!=CLASS_NONE && size_class==new_class) {
+		//still fits in the block
+#ifdef DEBUG_MEMORY_ENABLED
+		_account(p_bytes,header->size,0);
+#endif
+		header->size=p_bytes;
+		return p_memory;
+	}
+
+	if (size_class==CLASS_NONE && new_class==CLASS_NONE) {
+
+		size_t old_size=header->size;
+		Header *new_header=(Header*)::realloc(header,p_bytes+HEADER_SIZE);
+		ERR_FAIL_COND_V(!new_header,NULL);
+
+		if (((uintptr_t)new_header)&(HEADER_SIZE-1)) {
+			//system realloc does not keep the alignment, move it
+			void *mem=NULL;
+			if (posix_memalign(&mem,HEADER_SIZE,p_bytes+HEADER_SIZE)!=0)
+				mem=NULL;
+			if (!mem) {
+				::free(new_header);
+				ERR_FAIL_V(NULL);
+			}
+			copymem(mem,new_header,MIN(old_size,p_bytes)+HEADER_SIZE);
+			::free(new_header);
+			new_header=(Header*)mem;
+		}
+
+#ifdef DEBUG_MEMORY_ENABLED
+		_account(p_bytes,old_size,0);
+#endif
+		new_header->size=p_bytes;
+		return (uint8_t*)new_header+HEADER_SIZE;
+	}
+
+	void *mem=_alloc(p_bytes);
+	ERR_FAIL_COND_V(!mem,NULL);
+	copymem(mem,p_memory,MIN(header->size,p_bytes));
+	_free(header);
+	return mem;
+}
+
+size_t MemoryPoolStaticThreadCache::get_available_mem() const {
+
+	return 0xffffffff;
+}
+
+size_t MemoryPoolStaticThreadCache::get_total_usage() {
+
+#ifdef DEBUG_MEMORY_ENABLED
+	return total_mem;
+#else
+	return 0;
+#endif
+}
+
+size_t MemoryPoolStaticThreadCache::get_max_usage() {
+
+#ifdef DEBUG_MEMORY_ENABLED
+	return max_mem;
+#else
+	return 0;
+#endif
+}
+
+/* Most likely available only if memory debugger was compiled in */
+int MemoryPoolStaticThreadCache::get_alloc_count() {
+
+	return 0;
+}
+void * MemoryPoolStaticThreadCache::get_alloc_ptr(int p_alloc_idx) {
+
+	return 0;
+}
+const char* MemoryPoolStaticThreadCache::get_alloc_description(int p_alloc_idx) {
+
+	return "";
+}
+size_t MemoryPoolStaticThreadCache::get_alloc_size(int p_alloc_idx) {
+
+	return 0;
+}
+
+void MemoryPoolStaticThreadCache::dump_mem_to_file(const char* p_file) {
+
+#ifdef DEBUG_MEMORY_ENABLED
+
+	FILE *f = fopen(p_file,"wb");
+	ERR_FAIL_COND(!f);
+	fprintf(f,"allocations: %i (max %i)\n",total_pointers,max_pointers);
+	fprintf(f,"bytes: %i (max %i)\n",(int)total_mem,(int)max_mem);
+	fclose(f);
+#endif
+}
+
+MemoryPoolStaticThreadCache::MemoryPoolStaticThreadCache() {
+
+#ifdef DEBUG_MEMORY_ENABLED
+	total_mem=0;
+	total_pointers=0;
+	max_mem=0;
+	max_pointers=0;
+#endif
+
+	for(int i=0;i<CLASS_COUNT;i++) {
+
+		size_t size = i<SMALL_CLASSES ? (i+1)*SMALL_STEP : (size_t)(SMALL_MAX*2)<<(i-SMALL_CLASSES);
+		block_size[i]=size+HEADER_SIZE;
+		transfer[i]=CLAMP(TRANSFER_BYTES/(int)block_size[i],2,MAX_TRANSFER);
+		central[i].list.first=NULL;
+		central[i].list.count=0;
+#ifndef NO_PTHREADS
+		pthread_mutex_init(&central[i].mutex,NULL);
+#endif
+	}
+
+	chunks=NULL;
+
+#ifndef NO_PTHREADS
+	pthread_mutex_init(&chunk_mutex,NULL);
+	pthread_key_create(&cache_key,_thread_exit);
+#else
+	zeromem(&single_cache,sizeof(ThreadCache));
+#endif
+	pool=this;
+}
+
+MemoryPoolStaticThreadCache::~MemoryPoolStaticThreadCache() {
+
+#ifdef DEBUG_MEMORY_ENABLED
+
+	if (OS::get_singleton()->is_stdout_verbose()) {
+		if (total_mem > 0 ) {
+			printf("**ERROR: STATIC ALLOC: ** MEMORY LEAKS DETECTED **\n");
+			printf("**ERROR: STATIC ALLOC: %i bytes of memory in use at exit in %i allocations.\n",(int)total_mem,total_pointers);
+		}
+	}
+#endif
+
+	pool=NULL;
+
+#ifndef NO_PTHREADS
+	void *cache = pthread_getspecific(cache_key);
+	pthread_key_delete(cache_key);
+	if (cache)
+		::free(cache);
+#endif
+
+	while(chunks) {
+
+		void *next=*(void**)chunks;
+		::free(chunks);
+		chunks=next;
+	}
+
+#ifndef NO_PTHREADS
+	for(int i=0;i<CLASS_COUNT;i++)
+		pthread_mutex_destroy(&central[i].mutex);
+	pthread_mutex_destroy(&chunk_mutex);
+#endif
+}
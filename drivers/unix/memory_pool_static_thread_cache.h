@@ -0,0 +1,147 @@
+/*************************************************************************/
+/*  memory_pool_static_thread_cache.h                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef MEMORY_POOL_STATIC_THREAD_CACHE_H
+#define MEMORY_POOL_STATIC_THREAD_CACHE_H
+
+#include "os/memory_pool_static.h"
+
+#ifndef NO_PTHREADS
+#include <pthread.h>
+#endif
+
+/**
+ * Static memory pool that keeps freed blocks in per thread lists by size class,
+ * so most allocations and frees do not take a lock. Threads move blocks to and
+ * from shared central lists in batches, central lists carve new blocks from
+ * chunks that are only given back to the system when the pool is destroyed.
+ * Requests bigger than the largest class go straight to the system.
+ *
+ * Debug accounting (DEBUG_MEMORY_ENABLED) keeps totals only, there is no list
+ * of live allocations like in MemoryPoolStaticMalloc.
+ */
+
+class MemoryPoolStaticThreadCache : public MemoryPoolStatic {
+
+	enum {
+		HEADER_SIZE=16, // keeps blocks aligned to DEFAULT_ALIGNMENT
+		SMALL_STEP=16, // classes grow by this up to SMALL_MAX,
+		SMALL_MAX=256,
+		LARGE_MAX=32768, // then double up to LARGE_MAX
+		SMALL_CLASSES=SMALL_MAX/SMALL_STEP,
+		CLASS_COUNT=SMALL_CLASSES+7, // 512 to 32768
+		CLASS_NONE=CLASS_COUNT, // allocated from the system
+		TRANSFER_BYTES=32768, // moved between a thread and the central lists at once
+		MAX_TRANSFER=64,
+		CHUNK_SIZE=131072
+	};
+
+	struct Header {
+
+		size_t size; // as requested
+		uint32_t size_class;
+	};
+
+	struct FreeBlock {
+
+		FreeBlock *next;
+	};
+
+	struct FreeList {
+
+		FreeBlock *first;
+		int count;
+	};
+
+	struct ThreadCache {
+
+		FreeList lists[CLASS_COUNT];
+	};
+
+	struct Central {
+
+		FreeList list;
+#ifndef NO_PTHREADS
+		pthread_mutex_t mutex;
+#endif
+	};
+
+	Central central[CLASS_COUNT];
+	uint32_t block_size[CLASS_COUNT]; // including the header
+	int transfer[CLASS_COUNT]; // blocks moved at once
+
+	void *chunks; // linked through their first word
+#ifndef NO_PTHREADS
+	pthread_mutex_t chunk_mutex;
+	pthread_key_t cache_key;
+#else
+	ThreadCache single_cache;
+#endif
+
+#ifdef DEBUG_MEMORY_ENABLED
+	size_t total_mem;
+	int total_pointers;
+	size_t max_mem;
+	int max_pointers;
+	_FORCE_INLINE_ void _account(size_t p_add,size_t p_sub,int p_pointers);
+#endif
+
+	static MemoryPoolStaticThreadCache *pool; // for the thread exit callback
+
+	_FORCE_INLINE_ static uint32_t _get_size_class(size_t p_bytes);
+	_FORCE_INLINE_ ThreadCache *_get_thread_cache();
+	void _fetch_from_central(ThreadCache *p_cache,uint32_t p_class);
+	void _release_to_central(ThreadCache *p_cache,uint32_t p_class,int p_count);
+	static void _thread_exit(void *p_cache);
+
+	void *_alloc(size_t p_bytes);
+	void _free(Header *p_header);
+
+public:
+
+	virtual void* alloc(size_t p_bytes,const char *p_description=""); ///< Pointer in p_description shold be to a const char const like "hello"
+	virtual void free(void *p_ptr); ///< Pointer in p_description shold be to a const char const
+	virtual void* realloc(void *p_memory,size_t p_bytes); ///< Pointer in
+	virtual size_t get_available_mem() const;
+	virtual size_t get_total_usage();
+	virtual size_t get_max_usage();
+
+	/* Most likely available only if memory debugger was compiled in */
+	virtual int get_alloc_count();
+	virtual void * get_alloc_ptr(int p_alloc_idx);
+	virtual const char* get_alloc_description(int p_alloc_idx);
+	virtual size_t get_alloc_size(int p_alloc_idx);
+
+	void dump_mem_to_file(const char* p_file);
+
+	MemoryPoolStaticThreadCache();
+	~MemoryPoolStaticThreadCache();
+
+};
+
+#endif
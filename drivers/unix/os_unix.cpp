@@ -31,6 +31,7 @@
 #ifdef UNIX_ENABLED
 
 #include "memory_pool_static_malloc.h"
+#include "memory_pool_static_thread_cache.h"
 #include "os/memory_pool_dynamic_static.h"
 #include "thread_posix.h"
 #include "semaphore_posix.h"
@@ -89,7 +90,11 @@ int OS_Unix::unix_initialize_audio(int p_audio_driver) {
 	return 0;
 }
 	
+#ifdef THREAD_CACHE_ALLOC_ENABLED
+static MemoryPoolStaticThreadCache *mempool_static=NULL;
+#else
 static MemoryPoolStaticMalloc *mempool_static=NULL;
+#endif
 static MemoryPoolDynamicStatic *mempool_dynamic=NULL;
 	
 	
@@ -117,7 +122,11 @@ void OS_Unix::initialize_core() {
 	StreamPeerTCPPosix::make_default();
 	IP_Unix::make_default();
 #endif
+#ifdef THREAD_CACHE_ALLOC_ENABLED
+	mempool_static = new MemoryPoolStaticThreadCache;
+#else
 	mempool_static = new MemoryPoolStaticMalloc;
+#endif
 	mempool_dynamic = memnew( MemoryPoolDynamicStatic );
 
 	ticks_start=0;
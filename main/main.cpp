@@ -76,6 +76,8 @@
 #include "version.h"
 
 #include "performance.h"
+#include "os/file_access.h"
+#include "sort.h"
 
 static Globals *globals=NULL;
 static InputMap *input_map=NULL;
@@ -93,6 +95,7 @@ static OS::VideoMode video_mode;
 static int video_driver_idx=-1;
 static int audio_driver_idx=-1;
 static String locale;
+static String script_profile_file;
 
 static String unescape_cmdline(const String& p_str) {
 
@@ -152,6 +155,7 @@ void Main::print_help(const char* p_binary) {
 	OS::get_singleton()->print("\t-d,-debug : Debug (local stdout debugger).\n");
 	OS::get_singleton()->print("\t-rdebug ADDRESS : Remote debug (<ip>:<port> host address).\n");
 	OS::get_singleton()->print("\t-fdelay [msec]: Simulate high CPU load (delay each frame by [msec]).\n");
+	OS::get_singleton()->print("\t-profile FILE : Profile script functions, write the results to FILE on exit (debug builds).\n");
 	OS::get_singleton()->print("\t-bp : breakpoint list as source::line comma separated pairs, no spaces (%%20,%%2C,etc instead).\n");
 	OS::get_singleton()->print("\t-v : Verbose stdout mode\n");
 	OS::get_singleton()->print("\t-lang [locale]: Use a specific locale\n");
@@ -437,6 +441,16 @@ Error Main::setup(const char *execpath,int argc, char *argv[],bool p_second_phas
 
 			}
 
+		} else if (I->get()=="-profile") {
+
+			if (I->next()) {
+
+				script_profile_file=I->next()->get();
+				N=I->next()->next();
+			} else {
+				goto error;
+
+			}
 		} else if (I->get()=="-rdebug") {
 			if (I->next()) {
 
@@ -767,6 +781,12 @@ Error Main::setup2() {
 	register_module_types();
 	register_driver_types();
 
+	if (script_profile_file!="") {
+
+		for(int i=0;i<ScriptServer::get_language_count();i++)
+			ScriptServer::get_language(i)->profiling_start();
+	}
+
 	MAIN_PRINT("Main: Load Translations");
 
 	translation_server->setup(); //register translations, load them, etc.
@@ -1352,10 +1372,53 @@ void Main::force_redraw() {
 };
 
 
+struct _ScriptProfileSort {
+
+	_FORCE_INLINE_ bool operator()(const ScriptLanguage::ProfilingInfo& a,const ScriptLanguage::ProfilingInfo& b) const { return a.self_time>b.self_time; }
+};
+
+static void _dump_script_profile(const String& p_file) {
+
+	Vector<ScriptLanguage::ProfilingInfo> info;
+	info.resize(GLOBAL_DEF("debug/profiler_max_functions",16384));
+
+	int count=0;
+	for(int i=0;i<ScriptServer::get_language_count() && count<info.size();i++) {
+
+		ScriptServer::get_language(i)->profiling_stop();
+		count+=ScriptServer::get_language(i)->profiling_get_accumulated_data(&info[count],info.size()-count);
+	}
+
+	SortArray<ScriptLanguage::ProfilingInfo,_ScriptProfileSort> sorter;
+	sorter.sort(info.ptr(),count);
+
+	FileAccess *f = FileAccess::open(p_file,FileAccess::WRITE);
+	if (!f) {
+		ERR_EXPLAIN("Can't write script profile to: "+p_file);
+		ERR_FAIL();
+	}
+
+	f->store_line("# self_usec total_usec native_usec calls function");
+	for(int i=0;i<count;i++) {
+
+		const ScriptLanguage::ProfilingInfo &pi=info[i];
+		f->store_line(itos(pi.self_time)+" "+itos(pi.total_time)+" "+itos(pi.native_time)+" "+itos(pi.call_count)+" "+String(pi.signature));
+	}
+
+	memdelete(f);
+	print_line("Script profile written to: "+p_file);
+}
+
 void Main::cleanup() {
 
 	ERR_FAIL_COND(!_start_success);
 
+	if (script_profile_file!="") {
+
+		_dump_script_profile(script_profile_file);
+		script_profile_file=String();
+	}
+
 	if (script_debugger)
 		memdelete(script_debugger);
 
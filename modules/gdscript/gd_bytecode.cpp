@@ -0,0 +1,850 @@
+/*************************************************************************/
+/*  gd_bytecode.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "gd_bytecode.h"
+#include "gd_compiler.h"
+#include "gd_functions.h"
+#include "io/marshalls.h"
+#include "io/resource_loader.h"
+#include "hashfuncs.h"
+#include "version.h"
+
+
+class GDBytecode::Writer {
+public:
+
+	Vector<uint8_t> data;
+	const GDScript *root;
+	Map<int,StringName> global_names; //global index -> name, for relocation when loading
+
+	void put_u32(uint32_t p_value) {
+
+		int ofs=data.size();
+		data.resize(ofs+4);
+		encode_uint32(p_value,&data[ofs]);
+	}
+
+	void put_string(const String& p_string) {
+
+		CharString cs=p_string.utf8();
+		int len=cs.length();
+		put_u32(len);
+		int ofs=data.size();
+		data.resize(ofs+len);
+		for(int i=0;i<len;i++)
+			data[ofs+i]=cs[i];
+	}
+
+	bool has_objects(const Variant& p_value) const {
+
+		switch(p_value.get_type()) {
+
+			case Variant::OBJECT: return true;
+			case Variant::ARRAY: {
+
+				Array a=p_value;
+				for(int i=0;i<a.size();i++) {
+					if (has_objects(a[i]))
+						return true;
+				}
+			} break;
+			case Variant::DICTIONARY: {
+
+				Dictionary d=p_value;
+				List<Variant> keys;
+				d.get_key_list(&keys);
+				for(List<Variant>::Element *E=keys.front();E;E=E->next()) {
+					if (has_objects(E->get()) || has_objects(d[E->get()]))
+						return true;
+				}
+			} break;
+			default: {}
+		}
+
+		return false;
+	}
+
+	Error put_subclass_path(const GDScript *p_script,String& r_file,Vector<StringName>& r_chain) {
+
+		const GDScript *s=p_script;
+		while(s->_owner) {
+			r_chain.insert(0,s->name);
+			s=s->_owner;
+		}
+
+		if (s==root) {
+			r_file="";
+			ERR_FAIL_COND_V(r_chain.size()==0,ERR_CANT_RESOLVE);
+		} else {
+			r_file=s->get_path();
+			ERR_FAIL_COND_V(r_file=="" || r_file.find("::")!=-1,ERR_CANT_RESOLVE);
+		}
+		return OK;
+	}
+
+	Error put_constant(const Variant& p_value) {
+
+		if (p_value.get_type()!=Variant::OBJECT || !(Object*)p_value) {
+
+			if (has_objects(p_value))
+				return ERR_UNAVAILABLE; //nested objects can't be written
+
+			int len;
+			Error err = encode_variant(p_value,NULL,len);
+			if (err)
+				return err;
+			put_u32(GDBytecode::CONSTANT_VARIANT);
+			put_u32(len);
+			int ofs=data.size();
+			data.resize(ofs+len);
+			return encode_variant(p_value,&data[ofs],len);
+		}
+
+		Object *obj=p_value;
+
+		if (obj->cast_to<GDNativeClass>()) {
+
+			put_u32(GDBytecode::CONSTANT_NATIVE_CLASS);
+			put_string(obj->cast_to<GDNativeClass>()->get_name());
+			return OK;
+		}
+
+		GDScript *script=obj->cast_to<GDScript>();
+		if (script && script->_owner) {
+
+			String file;
+			Vector<StringName> chain;
+			Error err = put_subclass_path(script,file,chain);
+			if (err)
+				return err;
+			if (file!="")
+				return ERR_UNAVAILABLE; //only inner classes of this same script are constants
+			put_u32(GDBytecode::CONSTANT_SUBCLASS);
+			put_u32(chain.size());
+			for(int i=0;i<chain.size();i++)
+				put_string(chain[i]);
+			return OK;
+		}
+
+		Resource *res=obj->cast_to<Resource>();
+		if (res && res->get_path()!="" && res->get_path().find("::")==-1) {
+
+			put_u32(GDBytecode::CONSTANT_RESOURCE);
+			put_string(res->get_path());
+			return OK;
+		}
+
+		return ERR_UNAVAILABLE;
+	}
+
+	Error put_function(const GDFunction *p_func,bool p_initializer) {
+
+		put_string(p_func->name);
+		put_u32(p_func->_static);
+		put_u32(p_initializer);
+		put_u32(p_func->_argument_count);
+		put_u32(p_func->_stack_size);
+		put_u32(p_func->_call_size);
+		put_u32(p_func->_initial_line);
+		put_u32(p_func->_call_cache_count);
+
+		put_u32(p_func->default_arguments.size());
+		for(int i=0;i<p_func->default_arguments.size();i++)
+			put_u32(p_func->default_arguments[i]);
+
+		put_u32(p_func->constants.size());
+		for(int i=0;i<p_func->constants.size();i++) {
+			Error err = put_constant(p_func->constants[i]);
+			if (err)
+				return err;
+		}
+
+		put_u32(p_func->global_names.size());
+		for(int i=0;i<p_func->global_names.size();i++)
+			put_string(p_func->global_names[i]);
+
+		//global addresses depend on what the engine registered, store their names
+		Set<int> globals;
+		for(int i=0;i<p_func->code.size();i++) {
+
+			int w=p_func->code[i];
+			if (w>=0 && (w>>GDFunction::ADDR_BITS)==GDFunction::ADDR_TYPE_GLOBAL)
+				globals.insert(w&GDFunction::ADDR_MASK);
+		}
+
+		put_u32(globals.size());
+		for(Set<int>::Element *E=globals.front();E;E=E->next()) {
+
+			ERR_FAIL_COND_V(!global_names.has(E->get()),ERR_BUG);
+			put_u32(E->get());
+			put_string(global_names[E->get()]);
+		}
+
+		put_u32(p_func->code.size());
+		for(int i=0;i<p_func->code.size();i++)
+			put_u32(p_func->code[i]);
+
+		put_u32(p_func->stack_debug.size());
+		for(const List<GDFunction::StackDebug>::Element *E=p_func->stack_debug.front();E;E=E->next()) {
+
+			put_u32(E->get().line);
+			put_u32(E->get().pos);
+			put_u32(E->get().added);
+			put_string(E->get().identifier);
+		}
+
+		return OK;
+	}
+
+	Error put_class(const GDScript *p_script) {
+
+		put_string(p_script->name);
+		put_u32(p_script->tool);
+
+		//inheritance, stored the same way an extends clause resolves it
+		String file;
+		Vector<StringName> chain;
+		if (p_script->base.is_valid()) {
+
+			Error err = put_subclass_path(p_script->base.ptr(),file,chain);
+			if (err)
+				return err;
+			put_u32(1);
+		} else if (p_script->native.is_valid()) {
+
+			chain.push_back(p_script->native->get_name());
+			put_u32(1);
+		} else {
+			put_u32(0);
+		}
+
+		if (file!="" || chain.size()) {
+			put_string(file);
+			put_u32(chain.size());
+			for(int i=0;i<chain.size();i++)
+				put_string(chain[i]);
+		}
+
+		//own members, in index order
+		Vector<StringName> members;
+		members.resize(p_script->members.size());
+		int base_count=p_script->member_indices.size()-members.size();
+		for(const Set<StringName>::Element *E=p_script->members.front();E;E=E->next()) {
+
+			int idx=p_script->member_indices[E->get()]-base_count;
+			ERR_FAIL_INDEX_V(idx,members.size(),ERR_BUG);
+			members[idx]=E->get();
+		}
+
+		put_u32(members.size());
+		for(int i=0;i<members.size();i++) {
+
+			put_string(members[i]);
+			const Map<StringName,PropertyInfo>::Element *I=p_script->member_info.find(members[i]);
+			put_u32(I!=NULL);
+			if (I) {
+				put_u32(I->get().type);
+				put_u32(I->get().hint);
+				put_string(I->get().hint_string);
+				put_u32(I->get().usage);
+			}
+#ifdef TOOLS_ENABLED
+			const Map<StringName,Variant>::Element *D=p_script->member_default_values.find(members[i]);
+			put_u32(D!=NULL);
+			if (D) {
+				Error err = put_constant(D->get());
+				if (err)
+					return err;
+			}
+#else
+			put_u32(0);
+#endif
+		}
+
+		//subclasses go before constants and functions, which may refer to them. they are
+		//loaded in declaration order, same as they compiled, so bases are found
+		ERR_FAIL_COND_V(p_script->subclass_order.size()!=p_script->subclasses.size(),ERR_BUG);
+		put_u32(p_script->subclass_order.size());
+		for(int i=0;i<p_script->subclass_order.size();i++) {
+
+			const StringName &name=p_script->subclass_order[i];
+			put_string(name);
+			Error err = put_class(p_script->subclasses[name].ptr());
+			if (err)
+				return err;
+		}
+
+		put_u32(p_script->constants.size());
+		for(const Map<StringName,Variant>::Element *E=p_script->constants.front();E;E=E->next()) {
+
+			put_string(E->key());
+			Error err = put_constant(E->get());
+			if (err)
+				return err;
+		}
+
+		put_u32(p_script->member_functions.size());
+		for(const Map<StringName,GDFunction>::Element *E=p_script->member_functions.front();E;E=E->next()) {
+
+			Error err = put_function(&E->get(),p_script->initializer==&E->get());
+			if (err)
+				return err;
+		}
+
+		return OK;
+	}
+};
+
+
+class GDBytecode::Reader {
+public:
+
+	const uint8_t *data;
+	int len;
+	int pos;
+	bool error;
+	GDScript *root;
+	String source;
+
+	uint32_t get_u32() {
+
+		if (error || pos+4>len) {
+			error=true;
+			return 0;
+		}
+		uint32_t v=decode_uint32(&data[pos]);
+		pos+=4;
+		return v;
+	}
+
+	String get_string() {
+
+		int slen=get_u32();
+		if (error || slen<0 || pos+slen>len) {
+			error=true;
+			return String();
+		}
+		String s;
+		s.parse_utf8((const char*)&data[pos],slen);
+		pos+=slen;
+		return s;
+	}
+
+	Error get_constant(Variant& r_value) {
+
+		int type=get_u32();
+		if (error)
+			return ERR_FILE_CORRUPT;
+
+		switch(type) {
+
+			case GDBytecode::CONSTANT_VARIANT: {
+
+				int vlen=get_u32();
+				if (error || vlen<0 || pos+vlen>len)
+					return ERR_FILE_CORRUPT;
+				Error err = decode_variant(r_value,&data[pos],vlen);
+				if (err)
+					return err;
+				pos+=vlen;
+			} break;
+			case GDBytecode::CONSTANT_RESOURCE: {
+
+				String path=get_string();
+				if (error)
+					return ERR_FILE_CORRUPT;
+				RES res = ResourceLoader::load(path);
+				if (res.is_null())
+					return ERR_CANT_RESOLVE;
+				r_value=res;
+			} break;
+			case GDBytecode::CONSTANT_NATIVE_CLASS: {
+
+				StringName name=get_string();
+				if (error)
+					return ERR_FILE_CORRUPT;
+				const Map<StringName,int> &gmap=GDScriptLanguage::get_singleton()->get_global_map();
+				if (!gmap.has(name))
+					return ERR_CANT_RESOLVE;
+				Variant v=GDScriptLanguage::get_singleton()->get_global_array()[gmap[name]];
+				Object *obj=v;
+				if (!obj || !obj->cast_to<GDNativeClass>())
+					return ERR_CANT_RESOLVE;
+				r_value=v;
+			} break;
+			case GDBytecode::CONSTANT_SUBCLASS: {
+
+				int count=get_u32();
+				Ref<GDScript> sc;
+				for(int i=0;i<count && !error;i++) {
+
+					StringName name=get_string();
+					const Map<StringName,Ref<GDScript> > &subclasses = i==0 ? root->subclasses : sc->subclasses;
+					if (!subclasses.has(name))
+						return ERR_CANT_RESOLVE;
+					sc=subclasses[name];
+				}
+				if (error || sc.is_null())
+					return ERR_FILE_CORRUPT;
+				r_value=sc;
+			} break;
+			default: {
+				return ERR_FILE_CORRUPT;
+			}
+		}
+
+		return OK;
+	}
+
+	bool check_call_caches(const Vector<int>& p_code,int p_call_cache_count) {
+
+		//walk the code like the VM does, every call site must point to a cache the function has
+		int size=p_code.size();
+		int ip=0;
+
+		while(ip<size) {
+
+			int argc=0;
+			int op_len=0;
+
+			switch(p_code[ip]) {
+
+				case GDFunction::OPCODE_OPERATOR:
+				case GDFunction::OPCODE_OPERATOR_INT:
+				case GDFunction::OPCODE_OPERATOR_REAL:
+				case GDFunction::OPCODE_OPERATOR_VECTOR2:
+				case GDFunction::OPCODE_OPERATOR_VECTOR3:
+				case GDFunction::OPCODE_SET_MEMBER:
+				case GDFunction::OPCODE_GET_MEMBER:
+				case GDFunction::OPCODE_ITERATE_BEGIN:
+				case GDFunction::OPCODE_ITERATE: op_len=5; break;
+				case GDFunction::OPCODE_EXTENDS_TEST:
+				case GDFunction::OPCODE_SET:
+				case GDFunction::OPCODE_GET:
+				case GDFunction::OPCODE_SET_NAMED:
+				case GDFunction::OPCODE_GET_NAMED: op_len=4; break;
+				case GDFunction::OPCODE_ASSIGN:
+				case GDFunction::OPCODE_JUMP_IF:
+				case GDFunction::OPCODE_JUMP_IF_NOT: op_len=3; break;
+				case GDFunction::OPCODE_ASSIGN_TRUE:
+				case GDFunction::OPCODE_ASSIGN_FALSE:
+				case GDFunction::OPCODE_JUMP:
+				case GDFunction::OPCODE_RETURN:
+				case GDFunction::OPCODE_ASSERT:
+				case GDFunction::OPCODE_LINE: op_len=2; break;
+				case GDFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+				case GDFunction::OPCODE_END: op_len=1; break;
+				case GDFunction::OPCODE_ITERATE_RANGE_BEGIN:
+				case GDFunction::OPCODE_ITERATE_RANGE: op_len=6; break;
+				case GDFunction::OPCODE_CONSTRUCT:
+				case GDFunction::OPCODE_CALL_BUILT_IN:
+				case GDFunction::OPCODE_CALL_SELF_BASE: {
+
+					if (ip+2>=size)
+						return false;
+					argc=p_code[ip+2];
+					op_len=4+argc;
+				} break;
+				case GDFunction::OPCODE_CONSTRUCT_ARRAY:
+				case GDFunction::OPCODE_CONSTRUCT_DICTIONARY: {
+
+					if (ip+1>=size)
+						return false;
+					argc=p_code[ip+1];
+					op_len=3+(p_code[ip]==GDFunction::OPCODE_CONSTRUCT_DICTIONARY ? argc*2 : argc);
+				} break;
+				case GDFunction::OPCODE_CALL:
+				case GDFunction::OPCODE_CALL_RETURN: {
+
+					if (ip+4>=size)
+						return false;
+					argc=p_code[ip+1];
+					op_len=6+argc;
+					int cache=p_code[ip+4];
+					if (cache<0 || cache>=p_call_cache_count)
+						return false;
+				} break;
+				default: {
+					return false; //includes OPCODE_CALL_SELF, which is never generated
+				}
+			}
+
+			if (argc<0 || argc>size || op_len>size-ip)
+				return false;
+			ip+=op_len;
+		}
+
+		return true;
+	}
+
+	Error get_function(GDScript *p_script) {
+
+		StringName name=get_string();
+		if (error)
+			return ERR_FILE_CORRUPT;
+
+		GDFunction *gdfunc=&p_script->member_functions[name];
+		gdfunc->name=name;
+		gdfunc->_static=get_u32();
+		bool initializer=get_u32();
+		gdfunc->_argument_count=get_u32();
+		gdfunc->_stack_size=get_u32();
+		gdfunc->_call_size=get_u32();
+		gdfunc->_initial_line=get_u32();
+		int call_cache_count=get_u32();
+		if (error || call_cache_count<0 || call_cache_count>(len-pos)/4) //each cache has a call site operand in the code below
+			return ERR_FILE_CORRUPT;
+
+		int count=get_u32();
+		if (error || count<0 || count>len)
+			return ERR_FILE_CORRUPT;
+		gdfunc->default_arguments.resize(count);
+		for(int i=0;i<count;i++)
+			gdfunc->default_arguments[i]=get_u32();
+
+		count=get_u32();
+		if (error || count<0 || count>len)
+			return ERR_FILE_CORRUPT;
+		gdfunc->constants.resize(count);
+		for(int i=0;i<count;i++) {
+			Error err = get_constant(gdfunc->constants[i]);
+			if (err)
+				return err;
+		}
+
+		count=get_u32();
+		if (error || count<0 || count>len)
+			return ERR_FILE_CORRUPT;
+		gdfunc->global_names.resize(count);
+		for(int i=0;i<count;i++)
+			gdfunc->global_names[i]=get_string();
+
+		Map<int,int> globals;
+		count=get_u32();
+		for(int i=0;i<count && !error;i++) {
+
+			int idx=get_u32();
+			StringName gname=get_string();
+			const Map<StringName,int> &gmap=GDScriptLanguage::get_singleton()->get_global_map();
+			if (!gmap.has(gname))
+				return ERR_CANT_RESOLVE;
+			globals[idx]=gmap[gname];
+		}
+
+		count=get_u32();
+		if (error || count<0 || count>len)
+			return ERR_FILE_CORRUPT;
+		gdfunc->code.resize(count);
+		for(int i=0;i<count;i++) {
+
+			int w=get_u32();
+			if (w>=0 && (w>>GDFunction::ADDR_BITS)==GDFunction::ADDR_TYPE_GLOBAL) {
+				//relocate to the index the global has in this engine
+				Map<int,int>::Element *E=globals.find(w&GDFunction::ADDR_MASK);
+				if (!E)
+					return ERR_FILE_CORRUPT;
+				w=E->get()|(GDFunction::ADDR_TYPE_GLOBAL<<GDFunction::ADDR_BITS);
+			}
+			gdfunc->code[i]=w;
+		}
+
+		if (error || !check_call_caches(gdfunc->code,call_cache_count))
+			return ERR_FILE_CORRUPT;
+
+		count=get_u32();
+		for(int i=0;i<count && !error;i++) {
+
+			GDFunction::StackDebug sd;
+			sd.line=get_u32();
+			sd.pos=get_u32();
+			sd.added=get_u32();
+			sd.identifier=get_string();
+			gdfunc->stack_debug.push_back(sd);
+		}
+
+		if (error)
+			return ERR_FILE_CORRUPT;
+
+		gdfunc->_constant_count=gdfunc->constants.size();
+		gdfunc->_constants_ptr=gdfunc->constants.size() ? &gdfunc->constants[0] : NULL;
+		gdfunc->_global_names_count=gdfunc->global_names.size();
+		gdfunc->_global_names_ptr=gdfunc->global_names.size() ? &gdfunc->global_names[0] : NULL;
+		gdfunc->_code_size=gdfunc->code.size();
+		gdfunc->_code_ptr=gdfunc->code.size() ? &gdfunc->code[0] : NULL;
+		gdfunc->_default_arg_count=gdfunc->default_arguments.size();
+		gdfunc->_default_arg_ptr=gdfunc->default_arguments.size() ? &gdfunc->default_arguments[0] : NULL;
+
+		if (call_cache_count) {
+
+			gdfunc->call_caches.resize(call_cache_count);
+			for(int i=0;i<call_cache_count;i++) {
+				gdfunc->call_caches[i].version=0;
+				gdfunc->call_caches[i].builtin_type=Variant::VARIANT_MAX;
+				gdfunc->call_caches[i].builtin_method=-1;
+			}
+			gdfunc->_call_caches_ptr=&gdfunc->call_caches[0];
+		} else {
+			gdfunc->_call_caches_ptr=NULL;
+		}
+		gdfunc->_call_cache_count=call_cache_count;
+		gdfunc->_script=p_script;
+		gdfunc->source=source;
+
+#ifdef DEBUG_ENABLED
+		gdfunc->profile.signature=(source!="" ? source : String("<built-in>"))+"::"+itos(gdfunc->_initial_line)+"::"+String(name);
+		GDScriptLanguage::get_singleton()->profiling_add_function(gdfunc);
+#endif
+
+		if (initializer)
+			p_script->initializer=gdfunc;
+
+		return OK;
+	}
+
+	Error get_class(GDScript *p_script,GDScript *p_owner) {
+
+		p_script->native=Ref<GDNativeClass>();
+		p_script->base=Ref<GDScript>();
+		p_script->_base=NULL;
+		p_script->members.clear();
+		p_script->constants.clear();
+		p_script->member_functions.clear();
+		p_script->member_indices.clear();
+		p_script->member_info.clear();
+		p_script->initializer=NULL;
+		p_script->subclasses.clear();
+		p_script->subclass_order.clear();
+		p_script->_owner=p_owner;
+
+		p_script->name=get_string();
+		p_script->tool=get_u32();
+
+		if (get_u32()) {
+
+			StringName file=get_string();
+			Vector<StringName> chain;
+			int count=get_u32();
+			for(int i=0;i<count && !error;i++)
+				chain.push_back(get_string());
+			if (error)
+				return ERR_FILE_CORRUPT;
+
+			String err_text;
+			Error err = GDCompiler::resolve_base(p_script,p_owner,file,chain,err_text);
+			if (err) {
+				ERR_PRINT(("Loading compiled script: "+err_text).utf8().get_data());
+				return err;
+			}
+		}
+
+		int count=get_u32();
+		for(int i=0;i<count && !error;i++) {
+
+			StringName name=get_string();
+			if (p_script->member_indices.has(name))
+				return ERR_ALREADY_EXISTS;
+
+			if (get_u32()) {
+
+				PropertyInfo pi;
+				pi.name=name;
+				pi.type=Variant::Type(get_u32());
+				pi.hint=PropertyHint(get_u32());
+				pi.hint_string=get_string();
+				pi.usage=get_u32();
+				p_script->member_info[name]=pi;
+			}
+
+			if (get_u32()) {
+
+				Variant value;
+				Error err = get_constant(value);
+				if (err)
+					return err;
+#ifdef TOOLS_ENABLED
+				p_script->member_default_values[name]=value;
+#endif
+			}
+
+			int new_idx = p_script->member_indices.size();
+			p_script->member_indices[name]=new_idx;
+			p_script->members.insert(name);
+		}
+
+		count=get_u32();
+		for(int i=0;i<count && !error;i++) {
+
+			StringName name=get_string();
+			if (error || p_script->subclasses.has(name))
+				return ERR_FILE_CORRUPT;
+			Ref<GDScript> subclass = memnew( GDScript );
+			//inserted before loading, so functions can refer to it through the root
+			p_script->subclasses.insert(name,subclass);
+			p_script->subclass_order.push_back(name);
+			Error err = get_class(subclass.ptr(),p_script);
+			if (err)
+				return err;
+		}
+
+		count=get_u32();
+		for(int i=0;i<count && !error;i++) {
+
+			StringName name=get_string();
+			Variant value;
+			Error err = get_constant(value);
+			if (err)
+				return err;
+			p_script->constants.insert(name,value);
+		}
+
+		count=get_u32();
+		for(int i=0;i<count && !error;i++) {
+
+			Error err = get_function(p_script);
+			if (err)
+				return err;
+		}
+
+		return error ? ERR_FILE_CORRUPT : OK;
+	}
+};
+
+
+uint32_t GDBytecode::get_fingerprint() {
+
+	//anything that changes what the compiled code means
+	uint32_t h = hash_djb2_one_32(FORMAT_VERSION);
+	h = hash_djb2_one_32(VERSION_MAJOR,h);
+	h = hash_djb2_one_32(VERSION_MINOR,h);
+	h = hash_djb2_one_32(GDFunction::OPCODE_END,h);
+	h = hash_djb2_one_32(GDFunction::ADDR_BITS,h);
+	h = hash_djb2_one_32(GDFunctions::FUNC_MAX,h);
+	h = hash_djb2_one_32(Variant::VARIANT_MAX,h);
+	h = hash_djb2_one_32(Variant::OP_MAX,h);
+	h = hash_djb2_one_32(Variant::MEMBER_MAX,h);
+	return h;
+}
+
+bool GDBytecode::is_container(const Vector<uint8_t>& p_file) {
+
+	return p_file.size()>=4 && p_file[0]=='G' && p_file[1]=='D' && p_file[2]=='B' && p_file[3]=='C';
+}
+
+Vector<uint8_t> GDBytecode::make_container(const Vector<uint8_t>& p_bytecode,const Vector<uint8_t>& p_tokens) {
+
+	Vector<uint8_t> buf;
+	buf.resize(20+p_bytecode.size()+p_tokens.size());
+
+	buf[0]='G';
+	buf[1]='D';
+	buf[2]='B';
+	buf[3]='C';
+	encode_uint32(FORMAT_VERSION,&buf[4]);
+	encode_uint32(get_fingerprint(),&buf[8]);
+	encode_uint32(p_bytecode.size(),&buf[12]);
+	int ofs=16;
+	for(int i=0;i<p_bytecode.size();i++)
+		buf[ofs+i]=p_bytecode[i];
+	ofs+=p_bytecode.size();
+	encode_uint32(p_tokens.size(),&buf[ofs]);
+	ofs+=4;
+	for(int i=0;i<p_tokens.size();i++)
+		buf[ofs+i]=p_tokens[i];
+
+	return buf;
+}
+
+Error GDBytecode::open_container(const Vector<uint8_t>& p_file,Vector<uint8_t>& r_bytecode,Vector<uint8_t>& r_tokens) {
+
+	ERR_FAIL_COND_V(!is_container(p_file),ERR_FILE_UNRECOGNIZED);
+	ERR_FAIL_COND_V(p_file.size()<20,ERR_FILE_CORRUPT);
+
+	const uint8_t *buf=p_file.ptr();
+	uint32_t version=decode_uint32(&buf[4]);
+	uint32_t fingerprint=decode_uint32(&buf[8]);
+	int bc_len=decode_uint32(&buf[12]);
+	ERR_FAIL_COND_V(bc_len<0 || 16+bc_len+4>p_file.size(),ERR_FILE_CORRUPT);
+	int tk_len=decode_uint32(&buf[16+bc_len]);
+	ERR_FAIL_COND_V(tk_len<0 || 20+bc_len+tk_len>p_file.size(),ERR_FILE_CORRUPT);
+
+	r_bytecode.clear();
+	if (version==FORMAT_VERSION && fingerprint==get_fingerprint()) {
+
+		r_bytecode.resize(bc_len);
+		for(int i=0;i<bc_len;i++)
+			r_bytecode[i]=buf[16+i];
+	}
+
+	r_tokens.resize(tk_len);
+	for(int i=0;i<tk_len;i++)
+		r_tokens[i]=buf[20+bc_len+i];
+
+	return OK;
+}
+
+Error GDBytecode::save(const GDScript *p_script,Vector<uint8_t>& r_bytecode) {
+
+	Writer w;
+	w.root=p_script;
+
+	const Map<StringName,int> &gmap=GDScriptLanguage::get_singleton()->get_global_map();
+	for(const Map<StringName,int>::Element *E=gmap.front();E;E=E->next()) {
+		w.global_names[E->get()]=E->key();
+	}
+
+	Error err = w.put_class(p_script);
+	if (err)
+		return err;
+
+	r_bytecode=w.data;
+	return OK;
+}
+
+Error GDBytecode::load(GDScript *p_script,const Vector<uint8_t>& p_bytecode) {
+
+	ERR_FAIL_COND_V(p_bytecode.size()==0,ERR_FILE_CORRUPT);
+
+	Reader r;
+	r.data=p_bytecode.ptr();
+	r.len=p_bytecode.size();
+	r.pos=0;
+	r.error=false;
+	r.root=p_script;
+	r.source=p_script->get_path();
+
+	//functions are about to be replaced, call sites that resolved to them must look again
+	GDScriptLanguage::get_singleton()->invalidate_call_caches();
+
+	Error err = r.get_class(p_script,NULL);
+	GDScriptLanguage::get_singleton()->update_script_tables(p_script); //same as GDCompiler::compile()
+	if (err)
+		return err;
+
+	ERR_FAIL_COND_V(r.pos!=r.len,ERR_FILE_CORRUPT);
+	return OK;
+}
@@ -0,0 +1,68 @@
+/*************************************************************************/
+/*  gd_bytecode.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef GD_BYTECODE_H
+#define GD_BYTECODE_H
+
+#include "gd_script.h"
+
+/* Ahead of time compiled scripts. Export stores the compiled functions of a
+ * script together with its token buffer in a "GDBC" container. When loading,
+ * the compiled functions are used as-is if the engine that wrote them has the
+ * same bytecode format (see get_fingerprint()), otherwise the tokens are
+ * parsed and compiled again, as with a regular .gdc file. */
+
+class GDBytecode {
+
+	class Writer;
+	class Reader;
+public:
+
+	enum {
+		FORMAT_VERSION=2
+	};
+
+	enum ConstantType {
+		CONSTANT_VARIANT, // any value not containing objects
+		CONSTANT_RESOURCE, // resource with a path, loaded again
+		CONSTANT_NATIVE_CLASS, // engine class, by name
+		CONSTANT_SUBCLASS, // inner class of the script being loaded
+	};
+
+	static uint32_t get_fingerprint();
+
+	static bool is_container(const Vector<uint8_t>& p_file);
+	static Vector<uint8_t> make_container(const Vector<uint8_t>& p_bytecode,const Vector<uint8_t>& p_tokens);
+	//r_bytecode is left empty if it was written by an incompatible engine
+	static Error open_container(const Vector<uint8_t>& p_file,Vector<uint8_t>& r_bytecode,Vector<uint8_t>& r_tokens);
+
+	static Error save(const GDScript *p_script,Vector<uint8_t>& r_bytecode);
+	static Error load(GDScript *p_script,const Vector<uint8_t>& p_bytecode);
+};
+
+#endif // GD_BYTECODE_H
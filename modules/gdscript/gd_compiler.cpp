@@ -49,6 +49,222 @@ void GDCompiler::_set_error(const String& p_error,const GDParser::Node *p_node)
 	err_column=p_node->column;
 }
 
+Variant::Operator GDCompiler::_get_variant_operator(GDParser::OperatorNode::Operator p_op) {
+
+	switch(p_op) {
+
+		case GDParser::OperatorNode::OP_NEG: return Variant::OP_NEGATE;
+		case GDParser::OperatorNode::OP_NOT: return Variant::OP_NOT;
+		case GDParser::OperatorNode::OP_BIT_INVERT: return Variant::OP_BIT_NEGATE;
+		case GDParser::OperatorNode::OP_IN: return Variant::OP_IN;
+		case GDParser::OperatorNode::OP_EQUAL: return Variant::OP_EQUAL;
+		case GDParser::OperatorNode::OP_NOT_EQUAL: return Variant::OP_NOT_EQUAL;
+		case GDParser::OperatorNode::OP_LESS: return Variant::OP_LESS;
+		case GDParser::OperatorNode::OP_LESS_EQUAL: return Variant::OP_LESS_EQUAL;
+		case GDParser::OperatorNode::OP_GREATER: return Variant::OP_GREATER;
+		case GDParser::OperatorNode::OP_GREATER_EQUAL: return Variant::OP_GREATER_EQUAL;
+		case GDParser::OperatorNode::OP_AND: return Variant::OP_AND;
+		case GDParser::OperatorNode::OP_OR: return Variant::OP_OR;
+		case GDParser::OperatorNode::OP_ADD:
+		case GDParser::OperatorNode::OP_ASSIGN_ADD: return Variant::OP_ADD;
+		case GDParser::OperatorNode::OP_SUB:
+		case GDParser::OperatorNode::OP_ASSIGN_SUB: return Variant::OP_SUBSTRACT;
+		case GDParser::OperatorNode::OP_MUL:
+		case GDParser::OperatorNode::OP_ASSIGN_MUL: return Variant::OP_MULTIPLY;
+		case GDParser::OperatorNode::OP_DIV:
+		case GDParser::OperatorNode::OP_ASSIGN_DIV: return Variant::OP_DIVIDE;
+		case GDParser::OperatorNode::OP_MOD:
+		case GDParser::OperatorNode::OP_ASSIGN_MOD: return Variant::OP_MODULE;
+		case GDParser::OperatorNode::OP_SHIFT_LEFT:
+		case GDParser::OperatorNode::OP_ASSIGN_SHIFT_LEFT: return Variant::OP_SHIFT_LEFT;
+		case GDParser::OperatorNode::OP_SHIFT_RIGHT:
+		case GDParser::OperatorNode::OP_ASSIGN_SHIFT_RIGHT: return Variant::OP_SHIFT_RIGHT;
+		case GDParser::OperatorNode::OP_BIT_AND:
+		case GDParser::OperatorNode::OP_ASSIGN_BIT_AND: return Variant::OP_BIT_AND;
+		case GDParser::OperatorNode::OP_BIT_OR:
+		case GDParser::OperatorNode::OP_ASSIGN_BIT_OR: return Variant::OP_BIT_OR;
+		case GDParser::OperatorNode::OP_BIT_XOR:
+		case GDParser::OperatorNode::OP_ASSIGN_BIT_XOR: return Variant::OP_BIT_XOR;
+		default: {}
+	}
+
+	return Variant::OP_MAX;
+}
+
+Variant::Type GDCompiler::_guess_operator_type(Variant::Operator p_op,Variant::Type p_a,Variant::Type p_b) {
+
+	bool num_a = p_a==Variant::INT || p_a==Variant::REAL;
+	bool num_b = p_b==Variant::INT || p_b==Variant::REAL;
+	bool vec_a = p_a==Variant::VECTOR2 || p_a==Variant::VECTOR3;
+
+	switch(p_op) {
+
+		case Variant::OP_EQUAL:
+		case Variant::OP_NOT_EQUAL:
+		case Variant::OP_LESS:
+		case Variant::OP_LESS_EQUAL:
+		case Variant::OP_GREATER:
+		case Variant::OP_GREATER_EQUAL:
+		case Variant::OP_AND:
+		case Variant::OP_OR:
+		case Variant::OP_NOT:
+		case Variant::OP_IN: {
+
+			return Variant::BOOL;
+		} break;
+		case Variant::OP_ADD:
+		case Variant::OP_SUBSTRACT:
+		case Variant::OP_MULTIPLY:
+		case Variant::OP_DIVIDE: {
+
+			if (p_a==Variant::INT && p_b==Variant::INT)
+				return Variant::INT;
+			if (num_a && num_b)
+				return Variant::REAL;
+			if (vec_a && (p_b==p_a || (num_b && (p_op==Variant::OP_MULTIPLY || p_op==Variant::OP_DIVIDE))))
+				return p_a;
+		} break;
+		case Variant::OP_NEGATE: {
+
+			if (num_a || vec_a)
+				return p_a;
+		} break;
+		case Variant::OP_MODULE:
+		case Variant::OP_SHIFT_LEFT:
+		case Variant::OP_SHIFT_RIGHT:
+		case Variant::OP_BIT_AND:
+		case Variant::OP_BIT_OR:
+		case Variant::OP_BIT_XOR: {
+
+			if (p_a==Variant::INT && p_b==Variant::INT)
+				return Variant::INT;
+		} break;
+		case Variant::OP_BIT_NEGATE: {
+
+			if (p_a==Variant::INT)
+				return Variant::INT;
+		} break;
+		default: {}
+	}
+
+	return Variant::NIL;
+}
+
+GDFunction::Opcode GDCompiler::_get_operator_opcode(Variant::Operator p_op,Variant::Type p_a,Variant::Type p_b) {
+
+	//one side unknown, bet on it being like the other one, the opcode checks anyway
+	if (p_a==Variant::NIL)
+		p_a=p_b;
+	if (p_b==Variant::NIL)
+		p_b=p_a;
+
+	bool num_a = p_a==Variant::INT || p_a==Variant::REAL;
+	bool num_b = p_b==Variant::INT || p_b==Variant::REAL;
+
+	switch(p_op) {
+
+		case Variant::OP_EQUAL:
+		case Variant::OP_NOT_EQUAL:
+		case Variant::OP_ADD:
+		case Variant::OP_SUBSTRACT:
+		case Variant::OP_MULTIPLY:
+		case Variant::OP_DIVIDE:
+		case Variant::OP_LESS:
+		case Variant::OP_LESS_EQUAL:
+		case Variant::OP_GREATER:
+		case Variant::OP_GREATER_EQUAL: {
+
+			if (p_a==Variant::INT && p_b==Variant::INT)
+				return GDFunction::OPCODE_OPERATOR_INT;
+			if (num_a && num_b)
+				return GDFunction::OPCODE_OPERATOR_REAL;
+
+			if (p_op>=Variant::OP_LESS && p_op<=Variant::OP_GREATER_EQUAL)
+				break; //vectors are not ordered here
+			if (p_a==Variant::VECTOR2 && (p_b==Variant::VECTOR2 || num_b))
+				return GDFunction::OPCODE_OPERATOR_VECTOR2;
+			if (p_a==Variant::VECTOR3 && (p_b==Variant::VECTOR3 || num_b))
+				return GDFunction::OPCODE_OPERATOR_VECTOR3;
+		} break;
+		case Variant::OP_MODULE:
+		case Variant::OP_SHIFT_LEFT:
+		case Variant::OP_SHIFT_RIGHT:
+		case Variant::OP_BIT_AND:
+		case Variant::OP_BIT_OR:
+		case Variant::OP_BIT_XOR: {
+
+			if (p_a==Variant::INT && p_b==Variant::INT)
+				return GDFunction::OPCODE_OPERATOR_INT;
+		} break;
+		default: {}
+	}
+
+	return GDFunction::OPCODE_OPERATOR;
+}
+
+Variant::Type GDCompiler::_guess_expression_type(CodeGen& codegen,const GDParser::Node *p_expression) const {
+
+	switch(p_expression->type) {
+
+		case GDParser::Node::TYPE_CONSTANT: {
+
+			return static_cast<const GDParser::ConstantNode*>(p_expression)->value.get_type();
+		} break;
+		case GDParser::Node::TYPE_ARRAY: {
+
+			return Variant::ARRAY;
+		} break;
+		case GDParser::Node::TYPE_DICTIONARY: {
+
+			return Variant::DICTIONARY;
+		} break;
+		case GDParser::Node::TYPE_IDENTIFIER: {
+
+			//only locals, members can be changed from anywhere
+			StringName identifier = static_cast<const GDParser::IdentifierNode*>(p_expression)->name;
+			if (codegen.stack_identifiers.has(identifier)) {
+
+				const Map<StringName,Variant::Type>::Element *E=codegen.stack_identifier_types.find(identifier);
+				if (E)
+					return E->get();
+			}
+		} break;
+		case GDParser::Node::TYPE_OPERATOR: {
+
+			const GDParser::OperatorNode *on = static_cast<const GDParser::OperatorNode*>(p_expression);
+
+			switch(on->op) {
+
+				case GDParser::OperatorNode::OP_CALL: {
+
+					if (on->arguments.size() && on->arguments[0]->type==GDParser::Node::TYPE_TYPE)
+						return static_cast<const GDParser::TypeNode*>(on->arguments[0])->vtype; //constructor
+				} break;
+				case GDParser::OperatorNode::OP_EXTENDS: {
+
+					return Variant::BOOL;
+				} break;
+				case GDParser::OperatorNode::OP_ASSIGN: {
+
+					return _guess_expression_type(codegen,on->arguments[1]);
+				} break;
+				default: {
+
+					Variant::Operator op = _get_variant_operator(on->op);
+					if (op==Variant::OP_MAX)
+						break;
+					Variant::Type a = on->arguments.size()>0 ? _guess_expression_type(codegen,on->arguments[0]) : Variant::NIL;
+					Variant::Type b = on->arguments.size()>1 ? _guess_expression_type(codegen,on->arguments[1]) : Variant::NIL;
+					return _guess_operator_type(op,a,b);
+				} break;
+			}
+		} break;
+		default: {}
+	}
+
+	return Variant::NIL;
+}
+
 bool GDCompiler::_create_unary_operator(CodeGen& codegen,const GDParser::OperatorNode *on,Variant::Operator op, int p_stack_level) {
 
 	ERR_FAIL_COND_V(on->arguments.size()!=1,false);
@@ -60,7 +276,7 @@ bool GDCompiler::_create_unary_operator(CodeGen& codegen,const GDParser::Operato
 	codegen.opcodes.push_back(GDFunction::OPCODE_OPERATOR); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
-	codegen.opcodes.push_back(GDFunction::ADDR_TYPE_NIL); // argument 2 (unary only takes one parameter)
+	codegen.opcodes.push_back(GDFunction::ADDR_TYPE_NIL<<GDFunction::ADDR_BITS); // argument 2 (unary only takes one parameter)
 	return true;
 }
 
@@ -79,8 +295,10 @@ bool GDCompiler::_create_binary_operator(CodeGen& codegen,const GDParser::Operat
 	if (src_address_b<0)
 		return false;
 
+	//typed version if the operands can be guessed, they still fall back to the generic path
+	GDFunction::Opcode opcode = _get_operator_opcode(op,_guess_expression_type(codegen,on->arguments[0]),_guess_expression_type(codegen,on->arguments[1]));
 
-	codegen.opcodes.push_back(GDFunction::OPCODE_OPERATOR); // perform operator
+	codegen.opcodes.push_back(opcode); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
@@ -487,11 +705,27 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 
 						}
 
+						//resolve the method now if the receiver is a built-in type, the cache still checks it on every call
+						Variant::Type instance_type = _guess_expression_type(codegen,instance);
+						if (instance_type!=Variant::NIL && instance_type!=Variant::OBJECT) {
+
+							int method = Variant::get_method_index(instance_type,static_cast<const GDParser::IdentifierNode*>(on->arguments[1])->name);
+							if (method>=0) {
+								CodeGen::CallCacheHint hint;
+								hint.type=instance_type;
+								hint.method=method;
+								codegen.call_cache_hints[codegen.call_cache_count]=hint;
+							}
+						}
+
 						codegen.opcodes.push_back(p_root?GDFunction::OPCODE_CALL:GDFunction::OPCODE_CALL_RETURN); // perform operator
 						codegen.opcodes.push_back(on->arguments.size()-2);
 						codegen.alloc_call(on->arguments.size()-2);
-						for(int i=0;i<arguments.size();i++)
+						for(int i=0;i<arguments.size();i++) {
 							codegen.opcodes.push_back(arguments[i]);
+							if (i==1)
+								codegen.opcodes.push_back(codegen.call_cache_count++); //call site cache, after base and name
+						}
 					}
 				} break;
 				//indexing operator
@@ -508,9 +742,12 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 						return from;
 
 					int index;
+					Variant::Member member=Variant::MEMBER_MAX;
 					if (named) {
 
-						index=codegen.get_name_map_pos(static_cast<GDParser::IdentifierNode*>(on->arguments[1])->name);
+						StringName name = static_cast<GDParser::IdentifierNode*>(on->arguments[1])->name;
+						index=codegen.get_name_map_pos(name);
+						member=Variant::get_member_by_name(name);
 
 					} else {
 
@@ -518,6 +755,7 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 							//also, somehow, named (speed up anyway)
 							StringName name = static_cast<const GDParser::ConstantNode*>(on->arguments[1])->value;
 							index=codegen.get_name_map_pos(name);
+							member=Variant::get_member_by_name(name);
 							named=true;
 
 						} else {
@@ -533,6 +771,15 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 						}
 					}
 
+					if (member!=Variant::MEMBER_MAX) {
+						//could be a built-in type member, resolve the name now
+						codegen.opcodes.push_back(GDFunction::OPCODE_GET_MEMBER);
+						codegen.opcodes.push_back(from);
+						codegen.opcodes.push_back(index);
+						codegen.opcodes.push_back(member);
+						break;
+					}
+
 					codegen.opcodes.push_back(named?GDFunction::OPCODE_GET_NAMED:GDFunction::OPCODE_GET); // perform operator
 					codegen.opcodes.push_back(from); // argument 1
 					codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
@@ -697,11 +944,14 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 								break;
 
 							bool named = E->get()->op==GDParser::OperatorNode::OP_INDEX_NAMED;
+							Variant::Member member=Variant::MEMBER_MAX;
 							int key_idx;
 
 							if (named) {
 
-								key_idx = codegen.get_name_map_pos(static_cast<const GDParser::IdentifierNode*>(E->get()->arguments[1])->name);
+								StringName name = static_cast<const GDParser::IdentifierNode*>(E->get()->arguments[1])->name;
+								key_idx = codegen.get_name_map_pos(name);
+								member = Variant::get_member_by_name(name);
 							} else {
 
 								GDParser::Node *key = E->get()->arguments[1];
@@ -716,9 +966,18 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 							if (key_idx<0)
 								return key_idx;
 
-							codegen.opcodes.push_back(named ? GDFunction::OPCODE_GET_NAMED : GDFunction::OPCODE_GET);
-							codegen.opcodes.push_back(prev_pos);
-							codegen.opcodes.push_back(key_idx);
+							if (member!=Variant::MEMBER_MAX) {
+
+								codegen.opcodes.push_back(GDFunction::OPCODE_GET_MEMBER);
+								codegen.opcodes.push_back(prev_pos);
+								codegen.opcodes.push_back(key_idx);
+								codegen.opcodes.push_back(member);
+							} else {
+
+								codegen.opcodes.push_back(named ? GDFunction::OPCODE_GET_NAMED : GDFunction::OPCODE_GET);
+								codegen.opcodes.push_back(prev_pos);
+								codegen.opcodes.push_back(key_idx);
+							}
 							slevel++;
 							codegen.alloc_stack(slevel);
 							int dst_pos = (GDFunction::ADDR_TYPE_STACK<<GDFunction::ADDR_BITS)|slevel;
@@ -726,9 +985,14 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 
 							//add in reverse order, since it will be reverted
 							setchain.push_back(dst_pos);
+							if (member!=Variant::MEMBER_MAX)
+								setchain.push_back(member);
 							setchain.push_back(key_idx);
 							setchain.push_back(prev_pos);
-							setchain.push_back(named ? GDFunction::OPCODE_SET_NAMED : GDFunction::OPCODE_SET);
+							if (member!=Variant::MEMBER_MAX)
+								setchain.push_back(GDFunction::OPCODE_SET_MEMBER);
+							else
+								setchain.push_back(named ? GDFunction::OPCODE_SET_NAMED : GDFunction::OPCODE_SET);
 
 							prev_pos=dst_pos;
 
@@ -739,12 +1003,15 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 
 						int set_index;
 						bool named=false;
+						Variant::Member set_member=Variant::MEMBER_MAX;
 
 
 						if (static_cast<const GDParser::OperatorNode*>(op)->op==GDParser::OperatorNode::OP_INDEX_NAMED) {
 
 
-							set_index=codegen.get_name_map_pos(static_cast<const GDParser::IdentifierNode*>(op->arguments[1])->name);
+							StringName name = static_cast<const GDParser::IdentifierNode*>(op->arguments[1])->name;
+							set_index=codegen.get_name_map_pos(name);
+							set_member=Variant::get_member_by_name(name);
 							named=true;
 						} else {
 
@@ -766,18 +1033,28 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 						if (set_value<0)
 							return set_value;
 
-						codegen.opcodes.push_back(named?GDFunction::OPCODE_SET_NAMED:GDFunction::OPCODE_SET);
-						codegen.opcodes.push_back(prev_pos);
-						codegen.opcodes.push_back(set_index);
-						codegen.opcodes.push_back(set_value);
+						if (set_member!=Variant::MEMBER_MAX) {
 
-						for(int i=0;i<setchain.size();i+=4) {
+							codegen.opcodes.push_back(GDFunction::OPCODE_SET_MEMBER);
+							codegen.opcodes.push_back(prev_pos);
+							codegen.opcodes.push_back(set_index);
+							codegen.opcodes.push_back(set_member);
+							codegen.opcodes.push_back(set_value);
+						} else {
 
+							codegen.opcodes.push_back(named?GDFunction::OPCODE_SET_NAMED:GDFunction::OPCODE_SET);
+							codegen.opcodes.push_back(prev_pos);
+							codegen.opcodes.push_back(set_index);
+							codegen.opcodes.push_back(set_value);
+						}
 
-							codegen.opcodes.push_back(setchain[i+0]);
-							codegen.opcodes.push_back(setchain[i+1]);
-							codegen.opcodes.push_back(setchain[i+2]);
-							codegen.opcodes.push_back(setchain[i+3]);
+						for(int i=0;i<setchain.size();) {
+
+							//set member carries one extra operand
+							int len = setchain[i]==GDFunction::OPCODE_SET_MEMBER ? 5 : 4;
+							for(int j=0;j<len;j++)
+								codegen.opcodes.push_back(setchain[i+j]);
+							i+=len;
 						}
 
 						return retval;
@@ -797,10 +1074,22 @@ int GDCompiler::_parse_expression(CodeGen& codegen,const GDParser::Node *p_expre
 							codegen.alloc_stack(slevel);
 						}
 
+						Variant::Type assigned_type = _guess_expression_type(codegen,on);
+
 						int src_address_b = _parse_assign_right_expression(codegen,on,slevel);
 						if (src_address_b<0)
 							return -1;
 
+						if (on->arguments[0]->type==GDParser::Node::TYPE_IDENTIFIER) {
+							//remember what a local holds now
+							StringName identifier = static_cast<const GDParser::IdentifierNode*>(on->arguments[0])->name;
+							if (codegen.stack_identifiers.has(identifier)) {
+								if (assigned_type!=Variant::NIL)
+									codegen.stack_identifier_types[identifier]=assigned_type;
+								else
+									codegen.stack_identifier_types.erase(identifier);
+							}
+						}
 
 
 
@@ -933,7 +1222,18 @@ Error GDCompiler::_parse_block(CodeGen& codegen,const GDParser::BlockNode *p_blo
 					} break;
 					case GDParser::ControlFlowNode::CF_FOR: {
 
+						if (cf->arguments[1]->type==GDParser::Node::TYPE_OPERATOR) {
 
+							//for in range(), counts without creating the array
+							const GDParser::OperatorNode *on = static_cast<const GDParser::OperatorNode*>(cf->arguments[1]);
+							if (on->op==GDParser::OperatorNode::OP_CALL && on->arguments.size()>=2 && on->arguments.size()<=4 && on->arguments[0]->type==GDParser::Node::TYPE_BUILT_IN_FUNCTION && static_cast<const GDParser::BuiltInFunctionNode*>(on->arguments[0])->function==GDFunctions::GEN_RANGE) {
+
+								Error err = _parse_for_range(codegen,cf,on,p_stack_level);
+								if (err)
+									return err;
+								break;
+							}
+						}
 
 						int slevel=p_stack_level;
 						int iter_stack_pos=slevel;
@@ -1097,6 +1397,92 @@ Error GDCompiler::_parse_block(CodeGen& codegen,const GDParser::BlockNode *p_blo
 }
 
 
+Error GDCompiler::_parse_for_range(CodeGen& codegen,const GDParser::ControlFlowNode *p_for,const GDParser::OperatorNode *p_range,int p_stack_level) {
+
+	int slevel=p_stack_level;
+	int iter_stack_pos=slevel;
+	int iterator_pos = (slevel++)|(GDFunction::ADDR_TYPE_STACK<<GDFunction::ADDR_BITS);
+	int counter_pos = (slevel++)|(GDFunction::ADDR_TYPE_STACK<<GDFunction::ADDR_BITS);
+	int to_pos = (slevel++)|(GDFunction::ADDR_TYPE_STACK<<GDFunction::ADDR_BITS);
+	int step_pos = (slevel++)|(GDFunction::ADDR_TYPE_STACK<<GDFunction::ADDR_BITS);
+	codegen.alloc_stack(slevel);
+
+	codegen.push_stack_identifiers();
+	StringName iterator_name = static_cast<const GDParser::IdentifierNode*>(p_for->arguments[0])->name;
+	codegen.add_stack_identifier(iterator_name,iter_stack_pos);
+	codegen.stack_identifier_types[iterator_name]=Variant::INT;
+
+	//range(to), range(from,to) or range(from,to,step)
+	const GDParser::Node *args[3]={NULL,NULL,NULL};
+	int argc=p_range->arguments.size()-1;
+	if (argc==1) {
+		args[1]=p_range->arguments[1];
+	} else {
+		args[0]=p_range->arguments[1];
+		args[1]=p_range->arguments[2];
+		if (argc==3)
+			args[2]=p_range->arguments[3];
+	}
+
+	int dst[3]={counter_pos,to_pos,step_pos};
+	int defaults[3]={0,0,1};
+
+	for(int i=0;i<3;i++) {
+
+		int src;
+		if (args[i]) {
+			src = _parse_expression(codegen,args[i],slevel,false);
+			if (src<0)
+				return ERR_COMPILATION_FAILED;
+		} else {
+			src = codegen.get_constant_pos(defaults[i])|(GDFunction::ADDR_TYPE_LOCAL_CONSTANT<<GDFunction::ADDR_BITS);
+		}
+
+		codegen.opcodes.push_back(GDFunction::OPCODE_ASSIGN);
+		codegen.opcodes.push_back(dst[i]);
+		codegen.opcodes.push_back(src);
+	}
+
+	//begin loop
+	codegen.opcodes.push_back(GDFunction::OPCODE_ITERATE_RANGE_BEGIN);
+	codegen.opcodes.push_back(counter_pos);
+	codegen.opcodes.push_back(to_pos);
+	codegen.opcodes.push_back(step_pos);
+	int begin_exit_pos=codegen.opcodes.size();
+	codegen.opcodes.push_back(0);
+	codegen.opcodes.push_back(iterator_pos);
+	codegen.opcodes.push_back(GDFunction::OPCODE_JUMP); //skip code for next
+	int skip_pos=codegen.opcodes.size();
+	codegen.opcodes.push_back(0);
+	//break loop
+	int break_pos=codegen.opcodes.size();
+	codegen.opcodes.push_back(GDFunction::OPCODE_JUMP);
+	codegen.opcodes.push_back(0);
+	//next loop
+	int continue_pos=codegen.opcodes.size();
+	codegen.opcodes.push_back(GDFunction::OPCODE_ITERATE_RANGE);
+	codegen.opcodes.push_back(counter_pos);
+	codegen.opcodes.push_back(to_pos);
+	codegen.opcodes.push_back(step_pos);
+	codegen.opcodes.push_back(break_pos);
+	codegen.opcodes.push_back(iterator_pos);
+
+	codegen.opcodes[begin_exit_pos]=break_pos;
+	codegen.opcodes[skip_pos]=codegen.opcodes.size();
+
+	Error err = _parse_block(codegen,p_for->body,slevel,break_pos,continue_pos);
+	if (err)
+		return err;
+
+	codegen.opcodes.push_back(GDFunction::OPCODE_JUMP);
+	codegen.opcodes.push_back(continue_pos);
+	codegen.opcodes[break_pos+1]=codegen.opcodes.size();
+
+	codegen.pop_stack_identifiers();
+
+	return OK;
+}
+
 Error GDCompiler::_parse_function(GDScript *p_script,const GDParser::ClassNode *p_class,const GDParser::FunctionNode *p_func) {
 
 	Vector<int> bytecode;
@@ -1108,6 +1494,7 @@ Error GDCompiler::_parse_function(GDScript *p_script,const GDParser::ClassNode *
 	codegen.stack_max=0;
 	codegen.current_line=0;
 	codegen.call_max=0;
+	codegen.call_cache_count=0;
 	codegen.debug_stack=ScriptDebugger::get_singleton()!=NULL;
 
 	int stack_level=0;
@@ -1247,6 +1634,24 @@ Error GDCompiler::_parse_function(GDScript *p_script,const GDParser::ClassNode *
 	gdfunc->_argument_count=p_func ? p_func->arguments.size() : 0;
 	gdfunc->_stack_size=codegen.stack_max;
 	gdfunc->_call_size=codegen.call_max;
+
+	if (codegen.call_cache_count) {
+
+		gdfunc->call_caches.resize(codegen.call_cache_count);
+		for(int i=0;i<codegen.call_cache_count;i++) {
+			gdfunc->call_caches[i].version=0;
+			gdfunc->call_caches[i].builtin_type=Variant::VARIANT_MAX;
+			gdfunc->call_caches[i].builtin_method=-1;
+		}
+		for(Map<int,CodeGen::CallCacheHint>::Element *E=codegen.call_cache_hints.front();E;E=E->next()) {
+			gdfunc->call_caches[E->key()].builtin_type=E->get().type;
+			gdfunc->call_caches[E->key()].builtin_method=E->get().method;
+		}
+		gdfunc->_call_caches_ptr=&gdfunc->call_caches[0];
+	} else {
+		gdfunc->_call_caches_ptr=NULL;
+	}
+	gdfunc->_call_cache_count=codegen.call_cache_count;
 	gdfunc->name=func_name;
 	gdfunc->_script=p_script;
 	gdfunc->source=source;
@@ -1259,6 +1664,11 @@ Error GDCompiler::_parse_function(GDScript *p_script,const GDParser::ClassNode *
 	if (codegen.debug_stack)
 		gdfunc->stack_debug=codegen.stack_debug;
 
+#ifdef DEBUG_ENABLED
+	gdfunc->profile.signature=(String(source)!="" ? String(source) : String("<built-in>"))+"::"+itos(gdfunc->_initial_line)+"::"+String(func_name);
+	GDScriptLanguage::get_singleton()->profiling_add_function(gdfunc);
+#endif
+
 	if (is_initializer)
 		p_script->initializer=gdfunc;
 
@@ -1268,140 +1678,151 @@ Error GDCompiler::_parse_function(GDScript *p_script,const GDParser::ClassNode *
 
 
 
-Error GDCompiler::_parse_class(GDScript *p_script,GDScript *p_owner,const GDParser::ClassNode *p_class) {
+Error GDCompiler::resolve_base(GDScript *p_script,GDScript *p_owner,const StringName& p_extends_file,const Vector<StringName>& p_extends_class,String& r_error) {
 
+	String path = p_extends_file;
 
-	p_script->native=Ref<GDNativeClass>();
-	p_script->base=Ref<GDScript>();
-	p_script->_base=NULL;
-	p_script->members.clear();
-	p_script->constants.clear();
-	p_script->member_functions.clear();
-	p_script->member_indices.clear();
-	p_script->member_info.clear();
-	p_script->initializer=NULL;
-	p_script->subclasses.clear();
-	p_script->_owner=p_owner;
-	p_script->tool=p_class->tool;
-	p_script->name=p_class->name;
+	Ref<GDScript> script;
+	Ref<GDNativeClass> native;
 
+	if (path!="") {
+		//path (and optionally subclasses)
 
-	int index_from=0;
+		script = ResourceLoader::load(path);
+		if (script.is_null()) {
+			r_error="Could not load base class: "+path;
+			return ERR_FILE_NOT_FOUND;
+		}
 
-	if (p_class->extends_used) {
-		//do inheritance
-		String path = p_class->extends_file;
+		if (p_extends_class.size()) {
 
-		Ref<GDScript> script;
-		Ref<GDNativeClass> native;
+			for(int i=0;i<p_extends_class.size();i++) {
 
-		if (path!="") {
-			//path (and optionally subclasses)
+				String sub = p_extends_class[i];
+				if (script->subclasses.has(sub)) {
 
-			script = ResourceLoader::load(path);
-			if (script.is_null()) {
-				_set_error("Could not load base class: "+path,p_class);
-				return ERR_FILE_NOT_FOUND;
+					script=script->subclasses[sub];
+				} else {
+
+					r_error="Could not find subclass: "+sub;
+					return ERR_FILE_NOT_FOUND;
+				}
 			}
+		}
 
-			if (p_class->extends_class.size()) {
+	} else {
 
-				for(int i=0;i<p_class->extends_class.size();i++) {
+		ERR_FAIL_COND_V(p_extends_class.size()==0,ERR_BUG);
+		//look around for the subclasses
 
-					String sub = p_class->extends_class[i];
-					if (script->subclasses.has(sub)) {
+		String base=p_extends_class[0];
+		GDScript *p = p_owner;
+		Ref<GDScript> base_class;
 
-						script=script->subclasses[sub];
-					} else {
+		while(p) {
 
-						_set_error("Could not find subclass: "+sub,p_class);
-						return ERR_FILE_NOT_FOUND;
-					}
-				}
+			if (p->subclasses.has(base)) {
+
+				base_class=p->subclasses[base];
+				break;
 			}
+			p=p->_owner;
+		}
 
-		} else {
+		if (base_class.is_valid()) {
 
-			ERR_FAIL_COND_V(p_class->extends_class.size()==0,ERR_BUG);
-			//look around for the subclasses
+			for(int i=1;i<p_extends_class.size();i++) {
 
-			String base=p_class->extends_class[0];
-			GDScript *p = p_owner;
-			Ref<GDScript> base_class;
+				String subclass=p_extends_class[i];
 
-			while(p) {
+				if (base_class->subclasses.has(subclass)) {
 
-				if (p->subclasses.has(base)) {
+					base_class=base_class->subclasses[subclass];
+				} else {
 
-					base_class=p->subclasses[base];
-					break;
+					r_error="Could not find subclass: "+subclass;
+					return ERR_FILE_NOT_FOUND;
 				}
-				p=p->_owner;
 			}
 
-			if (base_class.is_valid()) {
+			script=base_class;
 
-				for(int i=1;i<p_class->extends_class.size();i++) {
 
-					String subclass=p_class->extends_class[i];
+		} else {
 
-					if (base_class->subclasses.has(subclass)) {
+			if (p_extends_class.size()>1) {
 
-						base_class=base_class->subclasses[subclass];
-					} else {
-
-						_set_error("Could not find subclass: "+subclass,p_class);
-						return ERR_FILE_NOT_FOUND;
-					}
-				}
+				r_error="Invalid inheritance (unknown class+subclasses)";
+				return ERR_FILE_NOT_FOUND;
 
-				script=base_class;
+			}
+			//if not found, try engine classes
+			if (!GDScriptLanguage::get_singleton()->get_global_map().has(base)) {
 
+				r_error="Unknown class: '"+base+"'";
+				return ERR_FILE_NOT_FOUND;
+			}
 
-			} else {
+			int base_idx = GDScriptLanguage::get_singleton()->get_global_map()[base];
+			native = GDScriptLanguage::get_singleton()->get_global_array()[base_idx];
+			if (!native.is_valid()) {
 
-				if (p_class->extends_class.size()>1) {
+				r_error="Global not a class: '"+base+"'";
 
-					_set_error("Invalid inheritance (unknown class+subclasses)",p_class);
-					return ERR_FILE_NOT_FOUND;
+				return ERR_FILE_NOT_FOUND;
+			}
+		}
 
-				}
-				//if not found, try engine classes
-				if (!GDScriptLanguage::get_singleton()->get_global_map().has(base)) {
 
-					_set_error("Unknown class: '"+base+"'",p_class);
-					return ERR_FILE_NOT_FOUND;
-				}
+	}
 
-				int base_idx = GDScriptLanguage::get_singleton()->get_global_map()[base];
-				native = GDScriptLanguage::get_singleton()->get_global_array()[base_idx];
-				if (!native.is_valid()) {
+	if (script.is_valid()) {
 
-					_set_error("Global not a class: '"+base+"'",p_class);
+		p_script->base=script;
+		p_script->_base=p_script->base.ptr();
+		p_script->member_indices=script->member_indices;
 
-					return ERR_FILE_NOT_FOUND;
-				}
-			}
+	} else if (native.is_valid()) {
 
+		p_script->native=native;
+	} else {
 
-		}
+		r_error="Could not determine inheritance";
+		return ERR_FILE_NOT_FOUND;
+	}
 
-		if (script.is_valid()) {
+	return OK;
+}
 
-			p_script->base=script;
-			p_script->_base=p_script->base.ptr();
-			p_script->member_indices=script->member_indices;
+Error GDCompiler::_parse_class(GDScript *p_script,GDScript *p_owner,const GDParser::ClassNode *p_class) {
 
-		} else if (native.is_valid()) {
 
-			p_script->native=native;
-		} else {
+	p_script->native=Ref<GDNativeClass>();
+	p_script->base=Ref<GDScript>();
+	p_script->_base=NULL;
+	p_script->members.clear();
+	p_script->constants.clear();
+	p_script->member_functions.clear();
+	p_script->member_indices.clear();
+	p_script->member_info.clear();
+	p_script->initializer=NULL;
+	p_script->subclasses.clear();
+	p_script->subclass_order.clear();
+	p_script->_owner=p_owner;
+	p_script->tool=p_class->tool;
+	p_script->name=p_class->name;
 
-			_set_error("Could not determine inheritance",p_class);
-			return ERR_FILE_NOT_FOUND;
-		}
 
+	int index_from=0;
 
+	if (p_class->extends_used) {
+		//do inheritance
+		String err_text;
+		Error err = resolve_base(p_script,p_owner,p_class->extends_file,p_class->extends_class,err_text);
+		if (err) {
+			_set_error(err_text,p_class);
+			return err;
+		}
 	}
 
 
@@ -1453,6 +1874,7 @@ Error GDCompiler::_parse_class(GDScript *p_script,GDScript *p_owner,const GDPars
 		if (err)
 			return err;
 		p_script->subclasses.insert(name,subclass);
+		p_script->subclass_order.push_back(name);
 
 	}
 
@@ -1500,10 +1922,15 @@ Error GDCompiler::compile(const GDParser *p_parser,GDScript *p_script) {
 
 	source=p_script->get_path();
 
+	//functions are about to be replaced, call sites that resolved to them must look again
+	GDScriptLanguage::get_singleton()->invalidate_call_caches();
 
 
 	Error err = _parse_class(p_script,NULL,static_cast<const GDParser::ClassNode*>(root));
 
+	//instances read the lookup tables unchecked, so they are rebuilt here, even if the class is half done
+	GDScriptLanguage::get_singleton()->update_script_tables(p_script);
+
 	if (err)
 		return err;
 
@@ -49,6 +49,15 @@ class GDCompiler {
 
         List< Map<StringName,int> > stack_id_stack;
 		Map<StringName,int> stack_identifiers;
+		List< Map<StringName,Variant::Type> > stack_type_stack;
+		Map<StringName,Variant::Type> stack_identifier_types; //guessed from the last assignment, to pick typed operators
+
+		struct CallCacheHint {
+			Variant::Type type;
+			int method;
+		};
+
+		Map<int,CallCacheHint> call_cache_hints; //call sites whose receiver is a built-in type known when compiling
 
         List<GDFunction::StackDebug> stack_debug;
         List< Map<StringName,int> > block_identifier_stack;
@@ -58,6 +67,7 @@ class GDCompiler {
         void add_stack_identifier(const StringName& p_id,int p_stackpos) {
 
             stack_identifiers[p_id]=p_stackpos;
+            stack_identifier_types.erase(p_id);
             if (debug_stack) {
 
                 block_identifiers[p_id]=p_stackpos;
@@ -73,6 +83,7 @@ class GDCompiler {
         void push_stack_identifiers() {
 
             stack_id_stack.push_back( stack_identifiers );
+            stack_type_stack.push_back( stack_identifier_types );
             if (debug_stack) {
 
                 block_identifier_stack.push_back(block_identifiers);
@@ -84,6 +95,8 @@ class GDCompiler {
 
             stack_identifiers = stack_id_stack.back()->get();
             stack_id_stack.pop_back();
+            stack_identifier_types = stack_type_stack.back()->get();
+            stack_type_stack.pop_back();
 
             if (debug_stack) {
                 for (Map<StringName,int>::Element *E=block_identifiers.front();E;E=E->next()) {
@@ -137,6 +150,7 @@ class GDCompiler {
         int current_line;
 		int stack_max;
 		int call_max;
+		int call_cache_count;
 	};
 
 #if 0
@@ -152,6 +166,11 @@ class GDCompiler {
 
 	void _set_error(const String& p_error,const GDParser::Node *p_node);
 
+	static Variant::Operator _get_variant_operator(GDParser::OperatorNode::Operator p_op);
+	static Variant::Type _guess_operator_type(Variant::Operator p_op,Variant::Type p_a,Variant::Type p_b);
+	static GDFunction::Opcode _get_operator_opcode(Variant::Operator p_op,Variant::Type p_a,Variant::Type p_b);
+	Variant::Type _guess_expression_type(CodeGen& codegen,const GDParser::Node *p_expression) const; //NIL if unknown
+
 	bool _create_unary_operator(CodeGen& codegen,const GDParser::OperatorNode *on,Variant::Operator op, int p_stack_level);
 	bool _create_binary_operator(CodeGen& codegen,const GDParser::OperatorNode *on,Variant::Operator op, int p_stack_level);
 
@@ -159,6 +178,7 @@ class GDCompiler {
 	int _parse_assign_right_expression(CodeGen& codegen,const GDParser::OperatorNode *p_expression, int p_stack_level);
 	int _parse_expression(CodeGen& codegen,const GDParser::Node *p_expression, int p_stack_level,bool p_root=false);
 	Error _parse_block(CodeGen& codegen,const GDParser::BlockNode *p_block,int p_stack_level=0,int p_break_addr=-1,int p_continue_addr=-1);
+	Error _parse_for_range(CodeGen& codegen,const GDParser::ControlFlowNode *p_for,const GDParser::OperatorNode *p_range,int p_stack_level);
 	Error _parse_function(GDScript *p_script,const GDParser::ClassNode *p_class,const GDParser::FunctionNode *p_func);
 	Error _parse_class(GDScript *p_script,GDScript *p_owner,const GDParser::ClassNode *p_class);
 	int err_line;
@@ -170,6 +190,9 @@ public:
 
 	Error compile(const GDParser *p_parser,GDScript *p_script);
 
+	//sets the base script or native class of p_script from an extends clause, also used when loading compiled bytecode
+	static Error resolve_base(GDScript *p_script,GDScript *p_owner,const StringName& p_extends_file,const Vector<StringName>& p_extends_class,String& r_error);
+
 	String get_error() const;
 	int get_error_line() const;
 	int get_error_column() const;
@@ -30,7 +30,15 @@
 #include "globals.h"
 #include "global_constants.h"
 #include "gd_compiler.h"
+#include "gd_bytecode.h"
 #include "os/file_access.h"
+#include "core_string_names.h"
+#include "os/os.h"
+
+//GCC and Clang can take the address of labels, the VM uses it to dispatch opcodes
+#if defined(__GNUC__) && !defined(GDSCRIPT_SWITCH_DISPATCH)
+#define GDSCRIPT_COMPUTED_GOTO
+#endif
 
 /* TODO:
 
@@ -67,6 +75,7 @@ Variant *GDFunction::_get_variant(int p_address,GDInstance *p_instance,GDScript
 				r_error="Cannot access member without instance.";
 				return NULL;
 			}
+			ERR_FAIL_INDEX_V(address,p_instance->members.size(),NULL);
 			return &p_instance->members[address];
 		} break;
 		case ADDR_TYPE_CLASS_CONSTANT: {
@@ -173,6 +182,102 @@ static String _get_var_type(const Variant* p_type) {
 
 }
 
+void GDFunction::_resolve_call_cache(CallCache &p_cache,Object *p_obj,GDScript *p_script,const StringName& p_method) {
+
+	GDFunction *function=NULL;
+	MethodBind *method=NULL;
+
+	// free is handled by Object::call before anything else, and GDScript overrides call() for its static functions
+	if (p_method!=CoreStringNames::get_singleton()->_free && !p_obj->cast_to<GDScript>()) {
+
+		const Vector<GDFunction*> *chain = p_script ? p_script->_get_method_chain(p_method) : NULL;
+		if (chain)
+			function=(*chain)[0];
+
+		if (!function)
+			method=ObjectTypeDB::get_method(p_obj->get_type_name(),p_method);
+	}
+
+	p_cache.version=GDScriptLanguage::get_singleton()->call_cache_version;
+	p_cache.type=p_obj->get_type_ptr();
+	p_cache.script=p_script;
+	p_cache.function=function;
+	p_cache.method=method;
+}
+
+void GDFunction::_call_cached(CallCache &p_cache,Variant *p_base,const StringName& p_method,const Variant **p_args,int p_argcount,Variant *r_ret,Variant::CallError &r_err) {
+
+	if (p_base->get_type()==Variant::OBJECT) {
+
+		Object *obj = *p_base;
+		bool cacheable=obj!=NULL;
+
+#ifdef DEBUG_ENABLED
+		if (cacheable && ScriptDebugger::get_singleton() && !p_base->is_ref() && !ObjectDB::instance_validate(obj))
+			cacheable=false; //let Variant::call report it
+#endif
+		ScriptInstance *si = cacheable ? obj->get_script_instance() : NULL;
+		GDScript *script=NULL;
+
+		if (si) {
+
+			//placeholders (tool mode) share the language but are not GDInstances
+			if (si->get_language()==GDScriptLanguage::get_singleton() && !si->is_placeholder())
+				script=static_cast<GDInstance*>(si)->script.ptr();
+			else
+				cacheable=false; //other languages resolve their own methods
+		}
+
+		if (cacheable) {
+
+			OBJ_DEBUG_LOCK(obj) //same as Object::call(), the callee can't free it
+
+			if (p_cache.version!=GDScriptLanguage::get_singleton()->call_cache_version || p_cache.script!=script || p_cache.type!=obj->get_type_ptr()) {
+
+				_resolve_call_cache(p_cache,obj,script,p_method);
+			}
+
+			if (p_cache.function) {
+
+				Variant ret = p_cache.function->call(static_cast<GDInstance*>(si),p_args,p_argcount,r_err);
+				if (r_ret)
+					*r_ret=ret;
+				return;
+
+			} else if (p_cache.method) {
+
+				r_err.error=Variant::CallError::CALL_OK;
+				Variant ret = p_cache.method->call(obj,p_args,p_argcount,r_err);
+				if (r_ret)
+					*r_ret=ret;
+				return;
+			}
+		}
+	} else {
+
+		//built-in method indices never change, so these only depend on the receiver type
+		if (p_cache.builtin_type!=p_base->get_type()) {
+
+			p_cache.builtin_type=p_base->get_type();
+			p_cache.builtin_method=Variant::get_method_index(p_cache.builtin_type,p_method);
+		}
+
+		if (p_cache.builtin_method>=0) {
+
+			if (r_ret)
+				*r_ret = p_base->call_index(p_cache.builtin_method,p_args,p_argcount,r_err);
+			else
+				p_base->call_index(p_cache.builtin_method,p_args,p_argcount,r_err);
+			return;
+		}
+	}
+
+	if (r_ret)
+		*r_ret = p_base->call(p_method,p_args,p_argcount,r_err);
+	else
+		p_base->call(p_method,p_args,p_argcount,r_err);
+}
+
 Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_argcount,Variant::CallError& r_err) {
 
 
@@ -271,41 +376,184 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
     if (ScriptDebugger::get_singleton())
         GDScriptLanguage::get_singleton()->enter_function(p_instance,this,stack,&ip,&line);
 
+	bool profiling=GDScriptLanguage::get_singleton()->profiling;
+	uint64_t function_start_time=0;
+	uint64_t function_script_time=0;
+	uint64_t function_native_time=0;
+
+	if (profiling) {
+
+		function_start_time=OS::get_singleton()->get_ticks_usec();
+		function_script_time=GDScriptLanguage::get_singleton()->profiling_script_time;
+		profile.call_count++;
+		profile.frame_call_count++;
+	}
+
 #define CHECK_SPACE(m_space)\
-	ERR_BREAK((ip+m_space)>_code_size)
+	GD_ERR_BREAK((ip+m_space)>_code_size)
+
+// time spent in a call that was not spent in other script functions is native time
+#define PROFILE_CALL_BEGIN \
+	uint64_t call_begin_time=0,call_script_time=0;\
+	if (profiling) {\
+		call_begin_time=OS::get_singleton()->get_ticks_usec();\
+		call_script_time=GDScriptLanguage::get_singleton()->profiling_script_time;\
+	}
 
+#define PROFILE_CALL_END \
+	if (profiling) {\
+		uint64_t call_time=OS::get_singleton()->get_ticks_usec()-call_begin_time;\
+		uint64_t script_time=GDScriptLanguage::get_singleton()->profiling_script_time-call_script_time;\
+		if (call_time>script_time)\
+			function_native_time+=call_time-script_time;\
+	}
+
+//out of range indices fall back to _get_variant(), which reports them
 #define GET_VARIANT_PTR(m_v,m_code_ofs) \
 	Variant *m_v; \
-	m_v = _get_variant(_code_ptr[ip+m_code_ofs],p_instance,_class,self,stack,err_text);\
+	{\
+		int addr_=_code_ptr[ip+m_code_ofs];\
+		int addr_type_=(addr_>>ADDR_BITS)&ADDR_TYPE_NIL;\
+		Variant *addr_base_=addr_bases[addr_type_];\
+		m_v = (addr_base_ && (addr_&ADDR_MASK)<addr_counts[addr_type_]) ? addr_base_+(addr_&ADDR_MASK) : _get_variant(addr_,p_instance,_class,self,stack,err_text);\
+	}\
 	if (!m_v)\
-		break;
+		OPCODE_BREAK;
 
 
 #else
 #define CHECK_SPACE(m_space)
+#define PROFILE_CALL_BEGIN
+#define PROFILE_CALL_END
 #define GET_VARIANT_PTR(m_v,m_code_ofs) \
 	Variant *m_v; \
-	m_v = _get_variant(_code_ptr[ip+m_code_ofs],p_instance,_class,self,stack,err_text);
+	{\
+		int addr_=_code_ptr[ip+m_code_ofs];\
+		Variant *addr_base_=addr_bases[(addr_>>ADDR_BITS)&ADDR_TYPE_NIL];\
+		m_v = addr_base_ ? addr_base_+(addr_&ADDR_MASK) : _get_variant(addr_,p_instance,_class,self,stack,err_text);\
+	}
 
 #endif
 
+// same as ERR_BREAK, but leaves the dispatch loop instead of the innermost loop or switch
+#define GD_ERR_BREAK(m_cond) \
+	{ if ( m_cond ) {	\
+		_err_print_error(FUNCTION_STR,__FILE__,__LINE__,"Condition ' "_STR(m_cond)" ' is true. Breaking..:");	\
+		OPCODE_BREAK;\
+	} else _err_error_exists=false;}
+
+#ifdef GDSCRIPT_COMPUTED_GOTO
+
+	// jump straight from one handler to the next, saves the range check and
+	// gives the branch predictor one indirect jump per opcode instead of a shared one
+
+	static const void *switch_table_ops[OPCODE_END+1]={
+		&&OPCODE_OPERATOR,
+		&&OPCODE_OPERATOR_INT,
+		&&OPCODE_OPERATOR_REAL,
+		&&OPCODE_OPERATOR_VECTOR2,
+		&&OPCODE_OPERATOR_VECTOR3,
+		&&OPCODE_EXTENDS_TEST,
+		&&OPCODE_SET,
+		&&OPCODE_GET,
+		&&OPCODE_SET_NAMED,
+		&&OPCODE_GET_NAMED,
+		&&OPCODE_SET_MEMBER,
+		&&OPCODE_GET_MEMBER,
+		&&OPCODE_ASSIGN,
+		&&OPCODE_ASSIGN_TRUE,
+		&&OPCODE_ASSIGN_FALSE,
+		&&OPCODE_CONSTRUCT,
+		&&OPCODE_CONSTRUCT_ARRAY,
+		&&OPCODE_CONSTRUCT_DICTIONARY,
+		&&OPCODE_CALL,
+		&&OPCODE_CALL_RETURN,
+		&&OPCODE_CALL_BUILT_IN,
+		&&OPCODE_CALL_SELF,
+		&&OPCODE_CALL_SELF_BASE,
+		&&OPCODE_JUMP,
+		&&OPCODE_JUMP_IF,
+		&&OPCODE_JUMP_IF_NOT,
+		&&OPCODE_JUMP_TO_DEF_ARGUMENT,
+		&&OPCODE_RETURN,
+		&&OPCODE_ITERATE_BEGIN,
+		&&OPCODE_ITERATE,
+		&&OPCODE_ITERATE_RANGE_BEGIN,
+		&&OPCODE_ITERATE_RANGE,
+		&&OPCODE_ASSERT,
+		&&OPCODE_LINE,
+		&&OPCODE_END
+	};
+
+#define OPCODE(m_op) m_op:
+#define OPCODE_WHILE(m_test)
+#define OPCODES_END OPSEXIT:
+#define OPCODES_OUT OPSOUT:
+#define OPCODE_SWITCH(m_test) DISPATCH_OPCODE;
+#define DISPATCH_OPCODE goto *switch_table_ops[_code_ptr[ip]]
+#define OPCODE_BREAK goto OPSEXIT
+#define OPCODE_OUT goto OPSOUT
+#else
+#define OPCODE(m_op) case m_op:
+#define OPCODE_WHILE(m_test) while (m_test)
+#define OPCODES_END OPSEXIT:
+#define OPCODES_OUT
+#define OPCODE_SWITCH(m_test) switch (m_test)
+#define DISPATCH_OPCODE continue
+#define OPCODE_BREAK goto OPSEXIT //a plain break would only leave argument loops
+#define OPCODE_OUT break
+#endif
+
+	//operands are decoded by indexing these with the address type, the ones left NULL
+	//are looked up by name or validated in _get_variant()
+	Variant *addr_bases[ADDR_TYPE_NIL+1];
+	addr_bases[ADDR_TYPE_SELF]=p_instance ? &self : NULL;
+	addr_bases[ADDR_TYPE_MEMBER]=(p_instance && p_instance->members.size()) ? &p_instance->members[0] : NULL;
+	addr_bases[ADDR_TYPE_CLASS_CONSTANT]=NULL;
+	addr_bases[ADDR_TYPE_LOCAL_CONSTANT]=_constant_count ? _constants_ptr : NULL;
+	addr_bases[ADDR_TYPE_STACK]=stack;
+	addr_bases[ADDR_TYPE_STACK_VARIABLE]=stack;
+	addr_bases[ADDR_TYPE_GLOBAL]=NULL;
+	addr_bases[ADDR_TYPE_NIL]=&nil;
+#ifdef DEBUG_ENABLED
+	int addr_counts[ADDR_TYPE_NIL+1];
+	addr_counts[ADDR_TYPE_SELF]=1;
+	addr_counts[ADDR_TYPE_MEMBER]=p_instance ? p_instance->members.size() : 0;
+	addr_counts[ADDR_TYPE_CLASS_CONSTANT]=0;
+	addr_counts[ADDR_TYPE_LOCAL_CONSTANT]=_constant_count;
+	addr_counts[ADDR_TYPE_STACK]=_stack_size;
+	addr_counts[ADDR_TYPE_STACK_VARIABLE]=_stack_size;
+	addr_counts[ADDR_TYPE_GLOBAL]=0;
+	addr_counts[ADDR_TYPE_NIL]=1;
+#endif
+
 
 
 	bool exit_ok=false;
 
-	while(ip<_code_size) {
+#ifdef GDSCRIPT_COMPUTED_GOTO
+	//every function ends in OPCODE_END, so after this handlers never check the code size
+	if (_code_size==0)
+		OPCODE_OUT;
+#endif
 
+	OPCODE_WHILE(ip<_code_size) {
 
+#ifdef GDSCRIPT_COMPUTED_GOTO
+		int last_opcode=-1; //only known on error, see below
+#else
 		int last_opcode=_code_ptr[ip];
-		switch(_code_ptr[ip]) {
+#endif
+		OPCODE_SWITCH(_code_ptr[ip]) {
 
-			case OPCODE_OPERATOR: {
+			OPCODE(OPCODE_OPERATOR)
+			generic_operator: {
 
 				CHECK_SPACE(5);
 
 				bool valid;
 				Variant::Operator op = (Variant::Operator)_code_ptr[ip+1];
-				ERR_BREAK(op>=Variant::OP_MAX);
+				GD_ERR_BREAK(op>=Variant::OP_MAX);
 
 				GET_VARIANT_PTR(a,2);
 				GET_VARIANT_PTR(b,3);
@@ -319,13 +567,188 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 					} else {
 						err_text="Invalid operands '"+Variant::get_type_name(a->get_type())+"' and '"+Variant::get_type_name(b->get_type())+"' in operator '"+Variant::get_operator_name(op)+"'.";
 					}
-					break;
+					OPCODE_BREAK;
+				}
+
+				ip+=5;
+
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_OPERATOR_INT) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a,2);
+				GET_VARIANT_PTR(b,3);
+
+				if (a->get_type()!=Variant::INT || b->get_type()!=Variant::INT)
+					goto generic_operator; //guessed wrong
+
+				int ia = a->get_int_unchecked();
+				int ib = b->get_int_unchecked();
+
+				GET_VARIANT_PTR(dst,4);
+
+				switch(_code_ptr[ip+1]) {
+
+					case Variant::OP_EQUAL: dst->assign_bool(ia==ib); break;
+					case Variant::OP_NOT_EQUAL: dst->assign_bool(ia!=ib); break;
+					case Variant::OP_LESS: dst->assign_bool(ia<ib); break;
+					case Variant::OP_LESS_EQUAL: dst->assign_bool(ia<=ib); break;
+					case Variant::OP_GREATER: dst->assign_bool(ia>ib); break;
+					case Variant::OP_GREATER_EQUAL: dst->assign_bool(ia>=ib); break;
+					case Variant::OP_ADD: dst->assign_int(ia+ib); break;
+					case Variant::OP_SUBSTRACT: dst->assign_int(ia-ib); break;
+					case Variant::OP_MULTIPLY: dst->assign_int(ia*ib); break;
+					case Variant::OP_DIVIDE: {
+						if (ib==0)
+							goto generic_operator; //let it report the error
+						dst->assign_int(ia/ib);
+					} break;
+					case Variant::OP_MODULE: {
+						if (ib==0)
+							goto generic_operator;
+						dst->assign_int(ia%ib);
+					} break;
+					case Variant::OP_SHIFT_LEFT: dst->assign_int(ia<<ib); break;
+					case Variant::OP_SHIFT_RIGHT: dst->assign_int(ia>>ib); break;
+					case Variant::OP_BIT_AND: dst->assign_int(ia&ib); break;
+					case Variant::OP_BIT_OR: dst->assign_int(ia|ib); break;
+					case Variant::OP_BIT_XOR: dst->assign_int(ia^ib); break;
+					default: goto generic_operator;
+				}
+
+				ip+=5;
+
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_OPERATOR_REAL) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a,2);
+				GET_VARIANT_PTR(b,3);
+
+				//int operands are promoted, as long as one of them is real
+				Variant::Type ta = a->get_type();
+				Variant::Type tb = b->get_type();
+				if (!(ta==Variant::REAL && (tb==Variant::REAL || tb==Variant::INT)) && !(ta==Variant::INT && tb==Variant::REAL))
+					goto generic_operator;
+
+				double ra = ta==Variant::REAL ? a->get_real_unchecked() : double(a->get_int_unchecked());
+				double rb = tb==Variant::REAL ? b->get_real_unchecked() : double(b->get_int_unchecked());
+
+				GET_VARIANT_PTR(dst,4);
+
+				switch(_code_ptr[ip+1]) {
+
+					case Variant::OP_EQUAL: dst->assign_bool(ra==rb); break;
+					case Variant::OP_NOT_EQUAL: dst->assign_bool(ra!=rb); break;
+					case Variant::OP_LESS: dst->assign_bool(ra<rb); break;
+					case Variant::OP_LESS_EQUAL: dst->assign_bool(ra<=rb); break;
+					case Variant::OP_GREATER: dst->assign_bool(ra>rb); break;
+					case Variant::OP_GREATER_EQUAL: dst->assign_bool(ra>=rb); break;
+					case Variant::OP_ADD: dst->assign_real(ra+rb); break;
+					case Variant::OP_SUBSTRACT: dst->assign_real(ra-rb); break;
+					case Variant::OP_MULTIPLY: dst->assign_real(ra*rb); break;
+					case Variant::OP_DIVIDE: dst->assign_real(ra/rb); break;
+					default: goto generic_operator;
+				}
+
+				ip+=5;
+
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_OPERATOR_VECTOR2) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a,2);
+				GET_VARIANT_PTR(b,3);
+
+				if (a->get_type()!=Variant::VECTOR2)
+					goto generic_operator;
+
+				const Vector2 &va = a->get_vector2_unchecked();
+				Variant::Type tb = b->get_type();
+
+				GET_VARIANT_PTR(dst,4);
+
+				if (tb==Variant::VECTOR2) {
+
+					const Vector2 &vb = b->get_vector2_unchecked();
+					switch(_code_ptr[ip+1]) {
+
+						case Variant::OP_EQUAL: dst->assign_bool(va==vb); break;
+						case Variant::OP_NOT_EQUAL: dst->assign_bool(va!=vb); break;
+						case Variant::OP_ADD: dst->assign_vector2(va+vb); break;
+						case Variant::OP_SUBSTRACT: dst->assign_vector2(va-vb); break;
+						case Variant::OP_MULTIPLY: dst->assign_vector2(va*vb); break;
+						case Variant::OP_DIVIDE: dst->assign_vector2(va/vb); break;
+						default: goto generic_operator;
+					}
+
+				} else if (tb==Variant::REAL || tb==Variant::INT) {
+
+					real_t s = tb==Variant::REAL ? real_t(b->get_real_unchecked()) : real_t(b->get_int_unchecked());
+					switch(_code_ptr[ip+1]) {
+
+						case Variant::OP_MULTIPLY: dst->assign_vector2(va*s); break;
+						case Variant::OP_DIVIDE: dst->assign_vector2(va/s); break;
+						default: goto generic_operator;
+					}
+
+				} else {
+					goto generic_operator;
 				}
 
 				ip+=5;
 
-			} continue;
-			case OPCODE_EXTENDS_TEST: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_OPERATOR_VECTOR3) {
+
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(a,2);
+				GET_VARIANT_PTR(b,3);
+
+				if (a->get_type()!=Variant::VECTOR3)
+					goto generic_operator;
+
+				const Vector3 &va = a->get_vector3_unchecked();
+				Variant::Type tb = b->get_type();
+
+				GET_VARIANT_PTR(dst,4);
+
+				if (tb==Variant::VECTOR3) {
+
+					const Vector3 &vb = b->get_vector3_unchecked();
+					switch(_code_ptr[ip+1]) {
+
+						case Variant::OP_EQUAL: dst->assign_bool(va==vb); break;
+						case Variant::OP_NOT_EQUAL: dst->assign_bool(va!=vb); break;
+						case Variant::OP_ADD: dst->assign_vector3(va+vb); break;
+						case Variant::OP_SUBSTRACT: dst->assign_vector3(va-vb); break;
+						case Variant::OP_MULTIPLY: dst->assign_vector3(va*vb); break;
+						case Variant::OP_DIVIDE: dst->assign_vector3(va/vb); break;
+						default: goto generic_operator;
+					}
+
+				} else if (tb==Variant::REAL || tb==Variant::INT) {
+
+					real_t s = tb==Variant::REAL ? real_t(b->get_real_unchecked()) : real_t(b->get_int_unchecked());
+					switch(_code_ptr[ip+1]) {
+
+						case Variant::OP_MULTIPLY: dst->assign_vector3(va*s); break;
+						case Variant::OP_DIVIDE: dst->assign_vector3(va/s); break;
+						default: goto generic_operator;
+					}
+
+				} else {
+					goto generic_operator;
+				}
+
+				ip+=5;
+
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_EXTENDS_TEST) {
 
 				CHECK_SPACE(4);
 
@@ -338,13 +761,13 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				if (a->get_type()!=Variant::OBJECT || a->operator Object*()==NULL) {
 
 					err_text="Left operand of 'extends' is not an instance of anything.";
-					break;
+					OPCODE_BREAK;
 
 				}
 				if (b->get_type()!=Variant::OBJECT || b->operator Object*()==NULL) {
 
 					err_text="Right operand of 'extends' is not a class.";
-					break;
+					OPCODE_BREAK;
 
 				}
 #endif
@@ -387,7 +810,7 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 					if (!nc) {
 
 						err_text="Right operand of 'extends' is not a class (type: '"+obj_B->get_type()+"').";
-						break;
+						OPCODE_BREAK;
 					}
 
 					extends_ok=ObjectTypeDB::is_type(obj_A->get_type_name(),nc->get_name());
@@ -396,8 +819,8 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				*dst=extends_ok;
 				ip+=4;
 
-			} continue;
-			case OPCODE_SET: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_SET) {
 
 				CHECK_SPACE(3);
 
@@ -416,12 +839,12 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 						v="of type '"+_get_var_type(index)+"'";
 					}
 					err_text="Invalid set index "+v+" (on base: '"+_get_var_type(dst)+"').";
-					break;
+					OPCODE_BREAK;
 				}
 
 				ip+=4;
-			} continue;
-			case OPCODE_GET: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_GET) {
 
 				CHECK_SPACE(3);
 
@@ -440,11 +863,11 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 						v="of type '"+_get_var_type(index)+"'";
 					}
 					err_text="Invalid get index "+v+" (on base: '"+_get_var_type(src)+"').";
-					break;
+					OPCODE_BREAK;
 				}
 				ip+=4;
-			} continue;
-			case OPCODE_SET_NAMED: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_SET_NAMED) {
 
 				CHECK_SPACE(3);
 
@@ -453,7 +876,7 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 
 				int indexname = _code_ptr[ip+2];
 
-				ERR_BREAK(indexname<0 || indexname>=_global_names_count);
+				GD_ERR_BREAK(indexname<0 || indexname>=_global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
 				bool valid;
@@ -462,12 +885,12 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				if (!valid) {
 					String err_type;
 					err_text="Invalid set index '"+String(*index)+"' (on base: '"+_get_var_type(dst)+"').";
-					break;
+					OPCODE_BREAK;
 				}
 
 				ip+=4;
-			} continue;
-			case OPCODE_GET_NAMED: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_GET_NAMED) {
 
 
 				CHECK_SPACE(3);
@@ -477,7 +900,7 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 
 				int indexname = _code_ptr[ip+2];
 
-				ERR_BREAK(indexname<0 || indexname>=_global_names_count);
+				GD_ERR_BREAK(indexname<0 || indexname>=_global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
 				bool valid;
@@ -485,12 +908,69 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 
 				if (!valid) {
 					err_text="Invalid get index '"+index->operator String()+"' (on base: '"+_get_var_type(src)+"').";
-					break;
+					OPCODE_BREAK;
 				}
 
 				ip+=4;
-			} continue;
-			case OPCODE_ASSIGN: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_SET_MEMBER) {
+
+				CHECK_SPACE(4);
+
+				GET_VARIANT_PTR(dst,1);
+				GET_VARIANT_PTR(value,4);
+
+				int indexname = _code_ptr[ip+2];
+				int member = _code_ptr[ip+3];
+
+				GD_ERR_BREAK(indexname<0 || indexname>=_global_names_count);
+				GD_ERR_BREAK(member<0 || member>=Variant::MEMBER_MAX);
+
+				bool valid;
+				Variant::Type type=dst->get_type();
+
+				//only math types have members, anything else (objects, dictionaries) goes by name
+				if (type>=Variant::VECTOR2 && type<=Variant::COLOR)
+					dst->set_member(Variant::Member(member),*value,&valid);
+				else
+					dst->set_named(_global_names_ptr[indexname],*value,&valid);
+
+				if (!valid) {
+					err_text="Invalid set index '"+String(_global_names_ptr[indexname])+"' (on base: '"+_get_var_type(dst)+"').";
+					OPCODE_BREAK;
+				}
+
+				ip+=5;
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_GET_MEMBER) {
+
+				CHECK_SPACE(4);
+
+				GET_VARIANT_PTR(src,1);
+				GET_VARIANT_PTR(dst,4);
+
+				int indexname = _code_ptr[ip+2];
+				int member = _code_ptr[ip+3];
+
+				GD_ERR_BREAK(indexname<0 || indexname>=_global_names_count);
+				GD_ERR_BREAK(member<0 || member>=Variant::MEMBER_MAX);
+
+				bool valid;
+				Variant::Type type=src->get_type();
+
+				if (type>=Variant::VECTOR2 && type<=Variant::COLOR)
+					*dst = src->get_member(Variant::Member(member),&valid);
+				else
+					*dst = src->get_named(_global_names_ptr[indexname],&valid);
+
+				if (!valid) {
+					err_text="Invalid get index '"+String(_global_names_ptr[indexname])+"' (on base: '"+_get_var_type(src)+"').";
+					OPCODE_BREAK;
+				}
+
+				ip+=5;
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_ASSIGN) {
 
 				CHECK_SPACE(3);
 				GET_VARIANT_PTR(dst,1);
@@ -500,8 +980,8 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 
 				ip+=3;
 
-			} continue;
-			case OPCODE_ASSIGN_TRUE: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_ASSIGN_TRUE) {
 
 				CHECK_SPACE(2);
 				GET_VARIANT_PTR(dst,1);
@@ -509,8 +989,8 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				*dst = true;
 
 				ip+=2;
-			} continue;
-			case OPCODE_ASSIGN_FALSE: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_ASSIGN_FALSE) {
 
 				CHECK_SPACE(2);
 				GET_VARIANT_PTR(dst,1);
@@ -518,8 +998,8 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				*dst = false;
 
 				ip+=2;
-			} continue;
-			case OPCODE_CONSTRUCT: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_CONSTRUCT) {
 
 				CHECK_SPACE(2);
 				Variant::Type t=Variant::Type(_code_ptr[ip+1]);
@@ -538,13 +1018,13 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				if (err.error!=Variant::CallError::CALL_OK) {
 
 					err_text=_get_call_error(err,"'"+Variant::get_type_name(t)+"' constructor",(const Variant**)argptrs);
-					break;
+					OPCODE_BREAK;
 				}
 
 				ip+=4+argc;
 				//construct a basic type
-			} continue;
-			case OPCODE_CONSTRUCT_ARRAY: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_CONSTRUCT_ARRAY) {
 
 				CHECK_SPACE(1);
 				int argc=_code_ptr[ip+1];
@@ -564,8 +1044,8 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 
 				ip+=3+argc;
 
-			} continue;
-			case OPCODE_CONSTRUCT_DICTIONARY: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_CONSTRUCT_DICTIONARY) {
 
 				CHECK_SPACE(1);
 				int argc=_code_ptr[ip+1];
@@ -587,23 +1067,25 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 
 				ip+=3+argc*2;
 
-			} continue;
-			case OPCODE_CALL_RETURN:
-			case OPCODE_CALL: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_CALL_RETURN)
+			OPCODE(OPCODE_CALL) {
 
 
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 				bool call_ret = _code_ptr[ip]==OPCODE_CALL_RETURN;
 
 				int argc=_code_ptr[ip+1];
 				GET_VARIANT_PTR(base,2);
 				int nameg=_code_ptr[ip+3];
+				int cachei=_code_ptr[ip+4];
 
-				ERR_BREAK(nameg<0 || nameg>=_global_names_count);
+				GD_ERR_BREAK(nameg<0 || nameg>=_global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
-				ERR_BREAK(argc<0);
-				ip+=4;
+				GD_ERR_BREAK(cachei<0 || cachei>=_call_cache_count);
+				GD_ERR_BREAK(argc<0);
+				ip+=5;
 				CHECK_SPACE(argc+1);
 				Variant **argptrs = call_args;
 
@@ -613,14 +1095,16 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				}
 
 				Variant::CallError err;
+				PROFILE_CALL_BEGIN
 				if (call_ret) {
 
 					GET_VARIANT_PTR(ret,argc);
-					*ret = base->call(*methodname,(const Variant**)argptrs,argc,err);
+					_call_cached(_call_caches_ptr[cachei],base,*methodname,(const Variant**)argptrs,argc,ret,err);
 				} else {
 
-					base->call(*methodname,(const Variant**)argptrs,argc,err);
+					_call_cached(_call_caches_ptr[cachei],base,*methodname,(const Variant**)argptrs,argc,NULL,err);
 				}
+				PROFILE_CALL_END
 
 				if (err.error!=Variant::CallError::CALL_OK) {
 
@@ -637,20 +1121,20 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 						}
 					}
 					err_text=_get_call_error(err,"function '"+methodstr+"' in base '"+basestr+"'",(const Variant**)argptrs);
-					break;
+					OPCODE_BREAK;
 				}
 
 				//_call_func(NULL,base,*methodname,ip,argc,p_instance,stack);
 				ip+=argc+1;
 
-			} continue;
-			case OPCODE_CALL_BUILT_IN: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_CALL_BUILT_IN) {
 
 				CHECK_SPACE(4);
 
 				GDFunctions::Function func = GDFunctions::Function(_code_ptr[ip+1]);
 				int argc=_code_ptr[ip+2];
-				ERR_BREAK(argc<0);
+				GD_ERR_BREAK(argc<0);
 
 				ip+=3;
 				CHECK_SPACE(argc+1);
@@ -665,23 +1149,25 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 
 				Variant::CallError err;
 
+				PROFILE_CALL_BEGIN
 				GDFunctions::call(func,(const Variant**)argptrs,argc,*dst,err);
+				PROFILE_CALL_END
 
 				if (err.error!=Variant::CallError::CALL_OK) {
 
 
 					String methodstr = GDFunctions::get_func_name(func);
 					err_text=_get_call_error(err,"built-in function '"+methodstr+"'",(const Variant**)argptrs);
-					break;
+					OPCODE_BREAK;
 				}
 				ip+=argc+1;
 
-			} continue;
-			case OPCODE_CALL_SELF: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_CALL_SELF) {
 
 
-			} break;
-			case OPCODE_CALL_SELF_BASE: {
+			} OPCODE_BREAK;
+			OPCODE(OPCODE_CALL_SELF_BASE) {
 
 				CHECK_SPACE(2);
 				int self_fun = _code_ptr[ip+1];
@@ -690,7 +1176,7 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				if (self_fun<0 || self_fun>=_global_names_count) {
 
 					err_text="compiler bug, function name not found";
-					break;
+					OPCODE_BREAK;
 				}
 #endif
 				const StringName *methodname = &_global_names_ptr[self_fun];
@@ -710,20 +1196,25 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 
 				const GDScript *gds = _script;
 
+				GDFunction *base_func=NULL;
+				if (_script->_base) {
+					const Vector<GDFunction*> *chain = _script->_base->_get_method_chain(*methodname);
+					if (chain)
+						base_func=(*chain)[0];
+				}
 
-				const Map<StringName,GDFunction>::Element *E=NULL;
-				while (gds->base.ptr()) {
-					gds=gds->base.ptr();
-					E=gds->member_functions.find(*methodname);
-					if (E)
-						break;
+				if (!base_func) {
+					//fall back to the native class of the topmost script
+					while (gds->_base)
+						gds=gds->_base;
 				}
 
 				Variant::CallError err;
 
-				if (E) {
+				PROFILE_CALL_BEGIN
+				if (base_func) {
 
-					*dst=((GDFunction*)&E->get())->call(p_instance,(const Variant**)argptrs,argc,err);
+					*dst=base_func->call(p_instance,(const Variant**)argptrs,argc,err);
 				} else if (gds->native.ptr()) {
 
 					if (*methodname!=GDScriptLanguage::get_singleton()->strings._init) {
@@ -745,6 +1236,7 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 						err.error=Variant::CallError::CALL_OK;
 					}
 				}
+				PROFILE_CALL_END
 
 
 				if (err.error!=Variant::CallError::CALL_OK) {
@@ -753,22 +1245,22 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 					String methodstr = *methodname;
 					err_text=_get_call_error(err,"function '"+methodstr+"'",(const Variant**)argptrs);
 
-					break;
+					OPCODE_BREAK;
 				}
 
 				ip+=4+argc;
 
-			} continue;
-			case OPCODE_JUMP: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_JUMP) {
 
 				CHECK_SPACE(2);
 				int to = _code_ptr[ip+1];
 
-				ERR_BREAK(to<0 || to>_code_size);
+				GD_ERR_BREAK(to<0 || to>=_code_size);
 				ip=to;
 
-			} continue;
-			case OPCODE_JUMP_IF: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_JUMP_IF) {
 
 				CHECK_SPACE(3);
 
@@ -780,18 +1272,18 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				if (!valid) {
 
 					err_text="cannot evaluate conditional expression of type: "+Variant::get_type_name(test->get_type());
-					break;
+					OPCODE_BREAK;
 				}
 #endif
 				if (result) {
 					int to = _code_ptr[ip+2];
-					ERR_BREAK(to<0 || to>_code_size);
+					GD_ERR_BREAK(to<0 || to>=_code_size);
 					ip=to;
-					continue;
+					DISPATCH_OPCODE;
 				}
 				ip+=3;
-			} continue;
-			case OPCODE_JUMP_IF_NOT: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_JUMP_IF_NOT) {
 
 				CHECK_SPACE(3);
 
@@ -803,32 +1295,32 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				if (!valid) {
 
 					err_text="cannot evaluate conditional expression of type: "+Variant::get_type_name(test->get_type());
-					break;
+					OPCODE_BREAK;
 				}
 #endif
 				if (!result) {
 					int to = _code_ptr[ip+2];
-					ERR_BREAK(to<0 || to>_code_size);
+					GD_ERR_BREAK(to<0 || to>=_code_size);
 					ip=to;
-					continue;
+					DISPATCH_OPCODE;
 				}
 				ip+=3;
-			} continue;
-			case OPCODE_JUMP_TO_DEF_ARGUMENT: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_JUMP_TO_DEF_ARGUMENT) {
 
 				CHECK_SPACE(2);
 				ip=_default_arg_ptr[defarg];
 
-			} continue;
-			case OPCODE_RETURN: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_RETURN) {
 
 				CHECK_SPACE(2);
 				GET_VARIANT_PTR(r,1);
 				retvalue=*r;
 				exit_ok=true;
 
-			} break;
-			case OPCODE_ITERATE_BEGIN: {
+			} OPCODE_BREAK;
+			OPCODE(OPCODE_ITERATE_BEGIN) {
 
 				CHECK_SPACE(8); //space for this an regular iterate
 
@@ -839,12 +1331,12 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				if (!container->iter_init(*counter,valid)) {
 					if (!valid) {
 						err_text="Unable to iterate on object of type  "+Variant::get_type_name(container->get_type())+"'.";
-						break;
+						OPCODE_BREAK;
 					}
 					int jumpto=_code_ptr[ip+3];
-					ERR_BREAK(jumpto<0 || jumpto>_code_size);
+					GD_ERR_BREAK(jumpto<0 || jumpto>=_code_size);
 					ip=jumpto;
-					continue;
+					DISPATCH_OPCODE;
 				}
 				GET_VARIANT_PTR(iterator,4);
 
@@ -852,14 +1344,14 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				*iterator=container->iter_get(*counter,valid);
 				if (!valid) {
 					err_text="Unable to obtain iterator object of type  "+Variant::get_type_name(container->get_type())+"'.";
-					break;
+					OPCODE_BREAK;
 				}
 
 
 				ip+=5; //skip regular iterate which is always next
 
-			} continue;
-			case OPCODE_ITERATE: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_ITERATE) {
 
 				CHECK_SPACE(4);
 
@@ -870,24 +1362,87 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				if (!container->iter_next(*counter,valid)) {
 					if (!valid) {
 						err_text="Unable to iterate on object of type  "+Variant::get_type_name(container->get_type())+"' (type changed since first iteration?).";
-						break;
+						OPCODE_BREAK;
 					}
 					int jumpto=_code_ptr[ip+3];
-					ERR_BREAK(jumpto<0 || jumpto>_code_size);
+					GD_ERR_BREAK(jumpto<0 || jumpto>=_code_size);
 					ip=jumpto;
-					continue;
+					DISPATCH_OPCODE;
 				}
 				GET_VARIANT_PTR(iterator,4);
 
 				*iterator=container->iter_get(*counter,valid);
 				if (!valid) {
 					err_text="Unable to obtain iterator object of type  "+Variant::get_type_name(container->get_type())+"' (but was obtained on first iteration?).";
-					break;
+					OPCODE_BREAK;
 				}
 
 				ip+=5; //loop again
-			} continue;
-			case OPCODE_ASSERT: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_ITERATE_RANGE_BEGIN) {
+
+				CHECK_SPACE(6);
+
+				GET_VARIANT_PTR(counter,1);
+				GET_VARIANT_PTR(to,2);
+				GET_VARIANT_PTR(step,3);
+
+				if (!counter->is_num() || !to->is_num() || !step->is_num()) {
+					err_text="Invalid arguments for range(), numbers expected.";
+					OPCODE_BREAK;
+				}
+
+				//from here on they are ints, so the loop doesn't need to check
+				int from=*counter;
+				counter->assign_int(from);
+				to->assign_int(*to);
+				step->assign_int(*step);
+
+				int s=step->get_int_unchecked();
+				if (s==0) {
+					err_text="range() step argument is zero!";
+					OPCODE_BREAK;
+				}
+
+				if (s>0 ? from>=to->get_int_unchecked() : from<=to->get_int_unchecked()) {
+					int jumpto=_code_ptr[ip+4];
+					GD_ERR_BREAK(jumpto<0 || jumpto>=_code_size);
+					ip=jumpto;
+					DISPATCH_OPCODE;
+				}
+
+				GET_VARIANT_PTR(iterator,5);
+				iterator->assign_int(from);
+
+				ip+=6;
+
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_ITERATE_RANGE) {
+
+				CHECK_SPACE(6);
+
+				GET_VARIANT_PTR(counter,1);
+				GET_VARIANT_PTR(to,2);
+				GET_VARIANT_PTR(step,3);
+
+				int s=step->get_int_unchecked();
+				int c=counter->get_int_unchecked()+s;
+				counter->assign_int(c);
+
+				if (s>0 ? c>=to->get_int_unchecked() : c<=to->get_int_unchecked()) {
+					int jumpto=_code_ptr[ip+4];
+					GD_ERR_BREAK(jumpto<0 || jumpto>=_code_size);
+					ip=jumpto;
+					DISPATCH_OPCODE;
+				}
+
+				GET_VARIANT_PTR(iterator,5);
+				iterator->assign_int(c);
+
+				ip+=6;
+
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_ASSERT) {
 				CHECK_SPACE(2);
 				GET_VARIANT_PTR(test,1);
 
@@ -899,21 +1454,21 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 				if (!valid) {
 
 					err_text="cannot evaluate conditional expression of type: "+Variant::get_type_name(test->get_type());
-					break;
+					OPCODE_BREAK;
 				}
 
 
 				if (!result) {
 
 					err_text="Assertion failed.";
-					break;
+					OPCODE_BREAK;
 				}
 
 #endif
 
 				ip+=2;
-			} continue;
-			case OPCODE_LINE: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_LINE) {
 				CHECK_SPACE(2);
 
 				line=_code_ptr[ip+1];
@@ -941,22 +1496,30 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
 					ScriptDebugger::get_singleton()->line_poll();
 
 				}
-			} continue;
-			case OPCODE_END: {
+			} DISPATCH_OPCODE;
+			OPCODE(OPCODE_END) {
 
 				exit_ok=true;
-				break;
+				OPCODE_BREAK;
 
-			} break;
+			} OPCODE_BREAK;
+#ifndef GDSCRIPT_COMPUTED_GOTO
 			default: {
 
 				err_text="Illegal opcode "+itos(_code_ptr[ip])+" at address "+itos(ip);
 			} break;
+#endif
 
 		}
 
+		OPCODES_END
+
 		if (exit_ok)
-			break;
+			OPCODE_OUT;
+#ifdef GDSCRIPT_COMPUTED_GOTO
+		if (ip>=0 && ip<_code_size)
+			last_opcode=_code_ptr[ip];
+#endif
 		//error
 		// function, file, line, error, explanation
 		String err_file;
@@ -981,12 +1544,35 @@ Variant GDFunction::call(GDInstance *p_instance,const Variant **p_args, int p_ar
         }
 
 
-		break;
+		OPCODE_OUT;
 	}
 
+	OPCODES_OUT
+
     if (ScriptDebugger::get_singleton())
         GDScriptLanguage::get_singleton()->exit_function();
 
+#ifdef DEBUG_ENABLED
+	if (profiling) {
+
+		GDScriptLanguage *lang=GDScriptLanguage::get_singleton();
+		uint64_t time_taken=OS::get_singleton()->get_ticks_usec()-function_start_time;
+		//script functions called from here already added themselves to the script time
+		uint64_t callee_time=lang->profiling_script_time-function_script_time;
+		uint64_t self_time=time_taken>callee_time ? time_taken-callee_time : 0;
+
+		profile.total_time+=time_taken;
+		profile.self_time+=self_time;
+		profile.native_time+=function_native_time;
+		profile.frame_total_time+=time_taken;
+		profile.frame_self_time+=self_time;
+		profile.frame_native_time+=function_native_time;
+
+		//callers only see this function's total, not what it called
+		lang->profiling_script_time=function_script_time+time_taken;
+	}
+#endif
+
 
 	if (_stack_size) {
 		//free stack
@@ -1136,8 +1722,30 @@ GDFunction::GDFunction() {
 
 	_stack_size=0;
 	_call_size=0;
+	_call_caches_ptr=NULL;
+	_call_cache_count=0;
 	name="<anonymous>";
 
+	profile.call_count=0;
+	profile.self_time=0;
+	profile.total_time=0;
+	profile.native_time=0;
+	profile.frame_call_count=0;
+	profile.frame_self_time=0;
+	profile.frame_total_time=0;
+	profile.frame_native_time=0;
+	profile.last_frame_call_count=0;
+	profile.last_frame_self_time=0;
+	profile.last_frame_total_time=0;
+	profile.last_frame_native_time=0;
+	profile.registered=false;
+
+}
+
+GDFunction::~GDFunction() {
+
+	if (profile.registered && GDScriptLanguage::get_singleton())
+		GDScriptLanguage::get_singleton()->profiling_remove_function(this);
 }
 
 GDNativeClass::GDNativeClass(const StringName& p_name) {
@@ -1399,6 +2007,40 @@ void GDScript::set_source_code(const String& p_code) {
 
 }
 
+void GDScript::_build_tables() {
+
+	method_table.clear();
+	member_table.clear();
+	constant_table.clear();
+
+	for(GDScript *s=this;s;s=s->_base) {
+
+		for(Map<StringName,GDFunction>::Element *E=s->member_functions.front();E;E=E->next()) {
+
+			Vector<GDFunction*> *chain = method_table.getptr(E->key());
+			if (chain) {
+				chain->push_back(&E->get());
+			} else {
+				Vector<GDFunction*> new_chain;
+				new_chain.push_back(&E->get());
+				method_table[E->key()]=new_chain;
+			}
+		}
+
+		for(Map<StringName,Variant>::Element *E=s->constants.front();E;E=E->next()) {
+
+			if (!constant_table.has(E->key()))
+				constant_table[E->key()]=&E->get();
+		}
+	}
+
+	//indices already include the inherited members
+	for(Map<StringName,int>::Element *E=member_indices.front();E;E=E->next()) {
+
+		member_table[E->key()]=E->get();
+	}
+}
+
 void GDScript::_set_subclass_path(Ref<GDScript>& p_sc,const String& p_path) {
 
 	p_sc->path=p_path;
@@ -1475,19 +2117,15 @@ ScriptLanguage *GDScript::get_language() const {
 Variant GDScript::call(const StringName& p_method,const Variant** p_args,int p_argcount,Variant::CallError &r_error) {
 
 
-	GDScript *top=this;
-	while(top) {
-
-		Map<StringName,GDFunction>::Element *E=top->member_functions.find(p_method);
-		if (E) {
-
-			if (!E->get().is_static()) {
-				WARN_PRINT(String("Can't call non-static function: '"+String(p_method)+"' in script.").utf8().get_data());
-			}
+	const Vector<GDFunction*> *chain = _get_method_chain(p_method);
+	if (chain) {
 
-			return E->get().call(NULL,p_args,p_argcount,r_error);
+		GDFunction *func = (*chain)[0];
+		if (!func->is_static()) {
+			WARN_PRINT(String("Can't call non-static function: '"+String(p_method)+"' in script.").utf8().get_data());
 		}
-		top=top->_base;
+
+		return func->call(NULL,p_args,p_argcount,r_error);
 	}
 
 	//none found, regular
@@ -1577,6 +2215,34 @@ Error GDScript::load_byte_code(const String& p_path) {
 		basedir=basedir.get_base_dir();
 
 	valid=false;
+
+	if (GDBytecode::is_container(bytecode)) {
+		//compiled ahead of time, falls back to the tokens if it can't be used
+		Vector<uint8_t> compiled;
+		Vector<uint8_t> tokens;
+		Error err = GDBytecode::open_container(bytecode,compiled,tokens);
+		ERR_FAIL_COND_V(err,err);
+
+		if (compiled.size()) {
+
+			err = GDBytecode::load(this,compiled);
+			if (err==OK) {
+
+				valid=true;
+				for(Map<StringName,Ref<GDScript> >::Element *E=subclasses.front();E;E=E->next()) {
+
+					_set_subclass_path(E->get(),path);
+				}
+				return OK;
+			}
+
+			WARN_PRINT(("Could not use compiled code of '"+path+"', compiling it again.").utf8().get_data());
+		}
+
+		bytecode=tokens;
+		ERR_FAIL_COND_V(bytecode.size()==0,ERR_PARSE_ERROR);
+	}
+
 	GDParser parser;
 	Error err = parser.parse_bytecode(bytecode,basedir);
 	if (err) {
@@ -1662,7 +2328,7 @@ Ref<GDScript> GDScript::get_base() const {
 	return base;
 }
 
-GDScript::GDScript() {
+GDScript::GDScript() : script_list(this) {
 
 
 	valid=false;
@@ -1671,6 +2337,17 @@ GDScript::GDScript() {
 	_base=NULL;
 	_owner=NULL;
 	tool=false;
+	if (GDScriptLanguage::get_singleton())
+		GDScriptLanguage::get_singleton()->add_script(&script_list);
+}
+
+GDScript::~GDScript() {
+
+	//another script may be created at the same address
+	if (GDScriptLanguage::get_singleton()) {
+		GDScriptLanguage::get_singleton()->invalidate_call_caches();
+		GDScriptLanguage::get_singleton()->remove_script(&script_list);
+	}
 }
 
 
@@ -1686,30 +2363,28 @@ bool GDInstance::set(const StringName& p_name, const Variant& p_value) {
 
 	//member
 	{
-		const Map<StringName,int>::Element *E = script->member_indices.find(p_name);
-		if (E) {
-			members[E->get()]=p_value;
+		const int *idx = script->member_table.getptr(p_name);
+		if (idx) {
+			members[*idx]=p_value;
 			return true;
 
 		}
 	}
 
-	GDScript *sptr=script.ptr();
-	while(sptr) {
-
+	const Vector<GDFunction*> *chainptr = script->method_table.getptr(GDScriptLanguage::get_singleton()->strings._set);
+	if (chainptr) {
 
-		 Map<StringName,GDFunction>::Element *E = sptr->member_functions.find(GDScriptLanguage::get_singleton()->strings._set);
-		if (E) {
+		Vector<GDFunction*> chain = *chainptr; //tables may be rebuilt during the calls
+		Variant name=p_name;
+		const Variant *args[2]={&name,&p_value};
 
-			Variant name=p_name;
-			const Variant *args[2]={&name,&p_value};
+		for(int i=0;i<chain.size();i++) {
 
 			Variant::CallError err;
-			Variant ret = E->get().call(this,(const Variant**)args,2,err);
+			Variant ret = chain[i]->call(this,(const Variant**)args,2,err);
 			if (err.error==Variant::CallError::CALL_OK && ret.get_type()==Variant::BOOL && ret.operator bool())
 				return true;
 		}
-		sptr = sptr->_base;
 	}
 
 	return false;
@@ -1719,43 +2394,40 @@ bool GDInstance::get(const StringName& p_name, Variant &r_ret) const {
 
 
 
-	const GDScript *sptr=script.ptr();
-	while(sptr) {
-
-		{
-			const Map<StringName,int>::Element *E = script->member_indices.find(p_name);
-			if (E) {
-				r_ret=members[E->get()];
-				return true; //index found
+	{
+		const int *idx = script->member_table.getptr(p_name);
+		if (idx) {
+			r_ret=members[*idx];
+			return true; //index found
 
-			}
 		}
+	}
 
-		{
-			const Map<StringName,Variant>::Element *E = script->constants.find(p_name);
-			if (E) {
-				r_ret=E->get();
-				return true; //index found
+	{
+		const Variant * const *constant = script->constant_table.getptr(p_name);
+		if (constant) {
+			r_ret=**constant;
+			return true; //index found
 
-			}
 		}
+	}
 
-		{
-			const Map<StringName,GDFunction>::Element *E = sptr->member_functions.find(GDScriptLanguage::get_singleton()->strings._get);
-			if (E) {
+	const Vector<GDFunction*> *chainptr = script->method_table.getptr(GDScriptLanguage::get_singleton()->strings._get);
+	if (chainptr) {
 
-				Variant name=p_name;
-				const Variant *args[1]={&name};
+		Vector<GDFunction*> chain = *chainptr; //tables may be rebuilt during the calls
+		Variant name=p_name;
+		const Variant *args[1]={&name};
 
-				Variant::CallError err;
-				Variant ret = const_cast<GDFunction*>(&E->get())->call(const_cast<GDInstance*>(this),(const Variant**)args,1,err);
-				if (err.error==Variant::CallError::CALL_OK && ret.get_type()!=Variant::NIL) {
-					r_ret=ret;
-					return true;
-				}
+		for(int i=0;i<chain.size();i++) {
+
+			Variant::CallError err;
+			Variant ret = chain[i]->call(const_cast<GDInstance*>(this),(const Variant**)args,1,err);
+			if (err.error==Variant::CallError::CALL_OK && ret.get_type()!=Variant::NIL) {
+				r_ret=ret;
+				return true;
 			}
 		}
-		sptr = sptr->_base;
 	}
 
 	return false;
@@ -1901,27 +2573,15 @@ void GDInstance::get_method_list(List<MethodInfo> *p_list) const {
 
 bool GDInstance::has_method(const StringName& p_method) const {
 
-	const GDScript *sptr=script.ptr();
-	while(sptr) {
-		const Map<StringName,GDFunction>::Element *E = sptr->member_functions.find(p_method);
-		if (E)
-			return true;
-		sptr = sptr->_base;
-	}
-
-	return false;
+	return script->_get_method_chain(p_method)!=NULL;
 }
 Variant GDInstance::call(const StringName& p_method,const Variant** p_args,int p_argcount,Variant::CallError &r_error) {
 
 	//printf("calling %ls:%i method %ls\n", script->get_path().c_str(), -1, String(p_method).c_str());
 
-	GDScript *sptr=script.ptr();
-	while(sptr) {
-		Map<StringName,GDFunction>::Element *E = sptr->member_functions.find(p_method);
-		if (E) {
-			return E->get().call(this,p_args,p_argcount,r_error);
-		}
-		sptr = sptr->_base;
+	const Vector<GDFunction*> *chain = script->_get_method_chain(p_method);
+	if (chain) {
+		return (*chain)[0]->call(this,p_args,p_argcount,r_error);
 	}
 	r_error.error=Variant::CallError::CALL_ERROR_INVALID_METHOD;
 	return Variant();
@@ -1929,38 +2589,34 @@ Variant GDInstance::call(const StringName& p_method,const Variant** p_args,int p
 
 void GDInstance::call_multilevel(const StringName& p_method,const Variant** p_args,int p_argcount) {
 
-	GDScript *sptr=script.ptr();
+	const Vector<GDFunction*> *chainptr = script->_get_method_chain(p_method);
+	if (!chainptr)
+		return;
+
+	Vector<GDFunction*> chain = *chainptr; //tables may be rebuilt during the calls
 	Variant::CallError ce;
 
-	while(sptr) {
-		Map<StringName,GDFunction>::Element *E = sptr->member_functions.find(p_method);
-		if (E) {
-			E->get().call(this,p_args,p_argcount,ce);
-		}
-		sptr = sptr->_base;
+	for(int i=0;i<chain.size();i++) {
+		chain[i]->call(this,p_args,p_argcount,ce);
 	}
 
 }
 
 
-void GDInstance::_ml_call_reversed(GDScript *sptr,const StringName& p_method,const Variant** p_args,int p_argcount) {
-
-	if (sptr->_base)
-		_ml_call_reversed(sptr->_base,p_method,p_args,p_argcount);
-
-	Variant::CallError ce;
+void GDInstance::call_multilevel_reversed(const StringName& p_method,const Variant** p_args,int p_argcount) {
 
-	Map<StringName,GDFunction>::Element *E = sptr->member_functions.find(p_method);
-	if (E) {
-		E->get().call(this,p_args,p_argcount,ce);
-	}
+	if (!script.ptr())
+		return;
 
-}
+	const Vector<GDFunction*> *chainptr = script->_get_method_chain(p_method);
+	if (!chainptr)
+		return;
 
-void GDInstance::call_multilevel_reversed(const StringName& p_method,const Variant** p_args,int p_argcount) {
+	Vector<GDFunction*> chain = *chainptr; //tables may be rebuilt during the calls
+	Variant::CallError ce;
 
-	if (script.ptr()) {
-		_ml_call_reversed(script.ptr(),p_method,p_args,p_argcount);
+	for(int i=chain.size()-1;i>=0;i--) {
+		chain[i]->call(this,p_args,p_argcount,ce);
 	}
 }
 
@@ -1970,18 +2626,18 @@ void GDInstance::notification(int p_notification) {
 	Variant value=p_notification;
 	const Variant *args[1]={&value };
 
-	GDScript *sptr=script.ptr();
-	while(sptr) {
-		Map<StringName,GDFunction>::Element *E = sptr->member_functions.find(GDScriptLanguage::get_singleton()->strings._notification);
-		if (E) {
-			Variant::CallError err;
-			E->get().call(this,args,1,err);
-			if (err.error!=Variant::CallError::CALL_OK) {
-				//print error about notification call
+	const Vector<GDFunction*> *chainptr = script->_get_method_chain(GDScriptLanguage::get_singleton()->strings._notification);
+	if (!chainptr)
+		return;
+
+	Vector<GDFunction*> chain = *chainptr; //tables may be rebuilt during the calls
+	for(int i=0;i<chain.size();i++) {
+		Variant::CallError err;
+		chain[i]->call(this,args,1,err);
+		if (err.error!=Variant::CallError::CALL_OK) {
+			//print error about notification call
 
-			}
 		}
-		sptr = sptr->_base;
 	}
 
 }
@@ -2095,10 +2751,210 @@ void GDScriptLanguage::finish()  {
 }
 
 
+void GDScriptLanguage::add_script(SelfList<GDScript> *p_script) {
+
+	if (lock)
+		lock->lock();
+
+	script_list.add(p_script);
+
+	if (lock)
+		lock->unlock();
+}
+
+void GDScriptLanguage::remove_script(SelfList<GDScript> *p_script) {
+
+	if (lock)
+		lock->lock();
+
+	if (p_script->in_list())
+		script_list.remove(p_script);
+
+	if (lock)
+		lock->unlock();
+}
+
+void GDScriptLanguage::update_script_tables(GDScript *p_compiled) {
+
+	if (lock)
+		lock->lock();
+
+	for(SelfList<GDScript> *E=script_list.first();E;E=E->next()) {
+
+		GDScript *script=E->self();
+		bool affected=false;
+
+		for(GDScript *b=script;b && !affected;b=b->_base) {
+
+			//inner classes are compiled together with the script that contains them
+			for(GDScript *o=b;o;o=o->_owner) {
+				if (o==p_compiled) {
+					affected=true;
+					break;
+				}
+			}
+		}
+
+		if (affected)
+			script->_build_tables();
+	}
+
+	if (lock)
+		lock->unlock();
+}
+
+void GDScriptLanguage::profiling_add_function(GDFunction *p_function) {
+
+	if (lock)
+		lock->lock();
+
+	function_list.insert(p_function);
+	p_function->profile.registered=true;
+
+	if (lock)
+		lock->unlock();
+}
+
+void GDScriptLanguage::profiling_remove_function(GDFunction *p_function) {
+
+	if (lock)
+		lock->lock();
+
+	function_list.erase(p_function);
+	p_function->profile.registered=false;
+
+	if (lock)
+		lock->unlock();
+}
+
+void GDScriptLanguage::profiling_start() {
+
+#ifdef DEBUG_ENABLED
+	if (lock)
+		lock->lock();
+
+	for (Set<GDFunction*>::Element *E=function_list.front();E;E=E->next()) {
+
+		GDFunction::Profile &p=E->get()->profile;
+		p.call_count=0;
+		p.self_time=0;
+		p.total_time=0;
+		p.native_time=0;
+		p.frame_call_count=0;
+		p.frame_self_time=0;
+		p.frame_total_time=0;
+		p.frame_native_time=0;
+		p.last_frame_call_count=0;
+		p.last_frame_self_time=0;
+		p.last_frame_total_time=0;
+		p.last_frame_native_time=0;
+	}
+
+	profiling=true;
+
+	if (lock)
+		lock->unlock();
+#else
+	WARN_PRINT("Script profiling needs a debug build.");
+#endif
+}
+
+void GDScriptLanguage::profiling_stop() {
+
+	if (lock)
+		lock->lock();
+
+	profiling=false;
+
+	if (lock)
+		lock->unlock();
+}
+
+bool GDScriptLanguage::is_profiling() const {
+
+	return profiling;
+}
+
+int GDScriptLanguage::profiling_get_accumulated_data(ProfilingInfo *p_info_arr,int p_info_max) {
+
+	int current=0;
+
+	if (lock)
+		lock->lock();
+
+	for (Set<GDFunction*>::Element *E=function_list.front();E && current<p_info_max;E=E->next()) {
+
+		const GDFunction::Profile &p=E->get()->profile;
+		if (p.call_count==0)
+			continue;
+
+		p_info_arr[current].signature=p.signature;
+		p_info_arr[current].call_count=p.call_count;
+		p_info_arr[current].total_time=p.total_time;
+		p_info_arr[current].self_time=p.self_time;
+		p_info_arr[current].native_time=p.native_time;
+		current++;
+	}
+
+	if (lock)
+		lock->unlock();
+
+	return current;
+}
+
+int GDScriptLanguage::profiling_get_frame_data(ProfilingInfo *p_info_arr,int p_info_max) {
+
+	int current=0;
+
+	if (lock)
+		lock->lock();
+
+	for (Set<GDFunction*>::Element *E=function_list.front();E && current<p_info_max;E=E->next()) {
+
+		const GDFunction::Profile &p=E->get()->profile;
+		if (p.last_frame_call_count==0)
+			continue;
+
+		p_info_arr[current].signature=p.signature;
+		p_info_arr[current].call_count=p.last_frame_call_count;
+		p_info_arr[current].total_time=p.last_frame_total_time;
+		p_info_arr[current].self_time=p.last_frame_self_time;
+		p_info_arr[current].native_time=p.last_frame_native_time;
+		current++;
+	}
+
+	if (lock)
+		lock->unlock();
+
+	return current;
+}
+
 void GDScriptLanguage::frame() {
 
 //	print_line("calls: "+itos(calls));
 	calls=0;
+
+	if (profiling) {
+
+		if (lock)
+			lock->lock();
+
+		for (Set<GDFunction*>::Element *E=function_list.front();E;E=E->next()) {
+
+			GDFunction::Profile &p=E->get()->profile;
+			p.last_frame_call_count=p.frame_call_count;
+			p.last_frame_self_time=p.frame_self_time;
+			p.last_frame_total_time=p.frame_total_time;
+			p.last_frame_native_time=p.frame_native_time;
+			p.frame_call_count=0;
+			p.frame_self_time=0;
+			p.frame_total_time=0;
+			p.frame_native_time=0;
+		}
+
+		if (lock)
+			lock->unlock();
+	}
 }
 
 /* EDITOR FUNCTIONS */
@@ -2151,6 +3007,10 @@ void GDScriptLanguage::get_reserved_words(List<String> *p_words) const  {
 GDScriptLanguage::GDScriptLanguage() {
 
 	calls=0;
+	call_cache_version=1;
+	profiling=false;
+	profiling_script_time=0;
+	lock=Mutex::create();
 	ERR_FAIL_COND(singleton);
 	singleton=this;
 	strings._init = StaticCString::create("_init");
@@ -2185,6 +3045,11 @@ GDScriptLanguage::~GDScriptLanguage() {
     if (_call_stack)  {
         memdelete_arr(_call_stack);
     }
+	while(script_list.first())
+		script_list.remove(script_list.first()); //scripts still alive must not point to it
+
+	if (lock)
+		memdelete(lock);
     singleton=NULL;
 }
 
@@ -34,19 +34,28 @@
 #include "io/resource_saver.h"
 #include "os/thread.h"
 #include "pair.h"
+#include "hash_map.h"
+#include "self_list.h"
 class GDInstance;
 class GDScript;
+class MethodBind;
 
 class GDFunction {
 public:
 
-	enum Opcode {
+	enum Opcode { //keep in sync with switch_table_ops in GDFunction::call()
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_INT, //same layout as OPCODE_OPERATOR, operands guessed to be of these types
+		OPCODE_OPERATOR_REAL,
+		OPCODE_OPERATOR_VECTOR2,
+		OPCODE_OPERATOR_VECTOR3,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_SET,
 		OPCODE_GET,
 		OPCODE_SET_NAMED,
 		OPCODE_GET_NAMED,
+		OPCODE_SET_MEMBER, //named access known to be a built-in type member
+		OPCODE_GET_MEMBER,
 		OPCODE_ASSIGN,
 		OPCODE_ASSIGN_TRUE,
 		OPCODE_ASSIGN_FALSE,
@@ -65,6 +74,8 @@ public:
 		OPCODE_RETURN,
 		OPCODE_ITERATE_BEGIN,
 		OPCODE_ITERATE,
+		OPCODE_ITERATE_RANGE_BEGIN, //for in range(), without creating the array
+		OPCODE_ITERATE_RANGE,
 		OPCODE_ASSERT,
 		OPCODE_LINE,
 		OPCODE_END
@@ -94,6 +105,38 @@ public:
 
 private:
 friend class GDCompiler;
+friend class GDScriptLanguage;
+friend class GDBytecode;
+
+	struct Profile {
+
+		StringName signature;
+		uint64_t call_count;
+		uint64_t self_time;
+		uint64_t total_time;
+		uint64_t native_time;
+		uint64_t frame_call_count;
+		uint64_t frame_self_time;
+		uint64_t frame_total_time;
+		uint64_t frame_native_time;
+		uint64_t last_frame_call_count;
+		uint64_t last_frame_self_time;
+		uint64_t last_frame_total_time;
+		uint64_t last_frame_native_time;
+		bool registered; // in GDScriptLanguage's function list
+	} profile;
+
+	// one per OPCODE_CALL, remembers what the method resolved to for the last receiver type
+	struct CallCache {
+
+		uint32_t version; // GDScriptLanguage::call_cache_version when resolved, 0 if never
+		void *type; // Object::get_type_ptr() of the receiver
+		GDScript *script; // script of the receiver, NULL if it has none
+		GDFunction *function; // resolved to a script function,
+		MethodBind *method; // or to a native method, if both are NULL the call is not cached
+		Variant::Type builtin_type; // receiver type for non object receivers, VARIANT_MAX if never resolved
+		int builtin_method; // Variant::get_method_index() for it, -1 if the type has no such method
+	};
 
 	StringName source;
 
@@ -104,6 +147,8 @@ friend class GDCompiler;
 	int _global_names_count;
 	const int *_default_arg_ptr;
 	int _default_arg_count;
+	CallCache *_call_caches_ptr;
+	int _call_cache_count;
 	const int *_code_ptr;
 	int _code_size;
 	int _argument_count;
@@ -117,6 +162,7 @@ friend class GDCompiler;
 	Vector<Variant> constants;
 	Vector<StringName> global_names;
 	Vector<int> default_arguments;
+	Vector<CallCache> call_caches;
 
 	Vector<int> code;
 
@@ -124,6 +170,8 @@ friend class GDCompiler;
 
 	_FORCE_INLINE_ Variant *_get_variant(int p_address,GDInstance *p_instance,GDScript *p_script,Variant &self,Variant *p_stack,String& r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Variant::CallError& p_err, const String& p_where,const Variant**argptrs) const;
+	_FORCE_INLINE_ void _call_cached(CallCache &p_cache,Variant *p_base,const StringName& p_method,const Variant **p_args,int p_argcount,Variant *r_ret,Variant::CallError &r_err);
+	static void _resolve_call_cache(CallCache &p_cache,Object *p_obj,GDScript *p_script,const StringName& p_method);
 
 
 public:
@@ -149,6 +197,7 @@ public:
 	Variant call(GDInstance *p_instance,const Variant **p_args, int p_argcount,Variant::CallError& r_err);
 
 	GDFunction();
+	~GDFunction();
 };
 
 
@@ -183,6 +232,8 @@ friend class GDInstance;
 friend class GDFunction;
 friend class GDCompiler;
 friend class GDFunctions;
+friend class GDBytecode;
+friend class GDScriptLanguage;
 	Ref<GDNativeClass> native;
 	Ref<GDScript> base;
 	GDScript *_base; //fast pointer access
@@ -193,12 +244,23 @@ friend class GDFunctions;
 	Map<StringName,GDFunction> member_functions;
 	Map<StringName,int> member_indices; //members are just indices to the instanced script.
 	Map<StringName,Ref<GDScript> > subclasses;	
+	Vector<StringName> subclass_order; //as declared, subclasses may only extend the ones before them
 
 #ifdef TOOLS_ENABLED
 	Map<StringName,Variant> member_default_values;
 #endif
 	Map<StringName,PropertyInfo> member_info;
 
+	//own and inherited entries, so instances don't walk the bases. built after this script or one of its bases is compiled, read only otherwise
+	HashMap<StringName,Vector<GDFunction*>,StringNameHasher> method_table; //every level defining it, most derived first
+	HashMap<StringName,int,StringNameHasher> member_table;
+	HashMap<StringName,const Variant*,StringNameHasher> constant_table;
+
+	void _build_tables();
+	_FORCE_INLINE_ const Vector<GDFunction*>* _get_method_chain(const StringName& p_method) const { return method_table.getptr(p_method); }
+
+	SelfList<GDScript> script_list;
+
 	GDFunction *initializer; //direct pointer to _init , faster to locate
 
 	int subclass_count;
@@ -266,6 +328,7 @@ public:
 	virtual ScriptLanguage *get_language() const;
 
 	GDScript();
+	~GDScript();
 };
 
 class GDInstance : public ScriptInstance {
@@ -278,7 +341,6 @@ friend class GDFunctions;
 	Vector<Variant> members;
 	bool base_ref;
 
-	void _ml_call_reversed(GDScript *sptr,const StringName& p_method,const Variant** p_args,int p_argcount);
 
 public:
 
@@ -335,12 +397,29 @@ class GDScriptLanguage : public ScriptLanguage {
     int _debug_max_call_stack;
     CallLevel *_call_stack;
 
+	Mutex *lock;
+	Set<GDFunction*> function_list; //compiled functions, for the profiler
+	SelfList<GDScript>::List script_list;
+
 	void _add_global(const StringName& p_name,const Variant& p_value);
 
 
 public:
 
 	int calls;
+	uint32_t call_cache_version; // call site caches resolved with an older version are stale
+
+	_FORCE_INLINE_ void invalidate_call_caches() { call_cache_version++; }
+
+	void add_script(SelfList<GDScript> *p_script);
+	void remove_script(SelfList<GDScript> *p_script);
+	void update_script_tables(GDScript *p_compiled); //after compiling, for it and every script inheriting from it
+
+	bool profiling; // checked by every call, keep it cheap
+	uint64_t profiling_script_time; // usec spent in script functions while profiling, lets callers tell it apart from native time
+
+	void profiling_add_function(GDFunction *p_function);
+	void profiling_remove_function(GDFunction *p_function);
 
     bool debug_break(const String& p_error,bool p_allow_continue=true);
     bool debug_break_parse(const String& p_file, int p_line,const String& p_error);
@@ -438,6 +517,14 @@ public:
 	virtual void debug_get_globals(List<String> *p_locals, List<Variant> *p_values, int p_max_subitems=-1,int p_max_depth=-1);
 	virtual String debug_parse_stack_level_expression(int p_level,const String& p_expression,int p_max_subitems=-1,int p_max_depth=-1);
 
+	/* PROFILING FUNCTIONS */
+
+	virtual void profiling_start();
+	virtual void profiling_stop();
+	virtual bool is_profiling() const;
+	virtual int profiling_get_accumulated_data(ProfilingInfo *p_info_arr,int p_info_max);
+	virtual int profiling_get_frame_data(ProfilingInfo *p_info_arr,int p_info_max);
+
 	virtual void frame();
 
 	virtual void get_public_functions(List<MethodInfo> *p_functions) const;
@@ -24,12 +24,40 @@ ResourceFormatSaverGDScript *resource_saver_gd=NULL;
 
 #include "tools/editor/editor_import_export.h"
 #include "gd_tokenizer.h"
+#include "gd_compiler.h"
+#include "gd_bytecode.h"
 #include "tools/editor/editor_node.h"
 
 class EditorExportGDScript : public EditorExportPlugin {
 
 	OBJ_TYPE(EditorExportGDScript,EditorExportPlugin);
 
+	Vector<uint8_t> _compile(const String& p_path,const String& p_code) {
+
+		//compile here so loading the exported game skips parsing
+		Ref<GDScript> script = memnew( GDScript );
+		script->set_script_path(p_path);
+
+		GDParser parser;
+		Error err = parser.parse(p_code,p_path.get_base_dir());
+		if (err)
+			return Vector<uint8_t>();
+
+		GDCompiler compiler;
+		err = compiler.compile(&parser,script.ptr());
+		if (err)
+			return Vector<uint8_t>();
+
+		Vector<uint8_t> compiled;
+		err = GDBytecode::save(script.ptr(),compiled);
+		if (err) {
+			print_line("Can't export compiled code for "+p_path+", exporting tokens only.");
+			return Vector<uint8_t>();
+		}
+
+		return compiled;
+	}
+
 public:
 
 	virtual Vector<uint8_t> custom_export(String& p_path,const Ref<EditorExportPlatform> &p_platform) {
@@ -42,6 +70,9 @@ public:
 			txt.parse_utf8((const char*)file.ptr(),file.size());
 			file = GDTokenizerBuffer::parse_code_string(txt);
 			if (!file.empty()) {
+				Vector<uint8_t> compiled = _compile(p_path,txt);
+				if (!compiled.empty())
+					file = GDBytecode::make_container(compiled,file);
 				print_line("PREV: "+p_path);
 				p_path=p_path.basename()+".gdc";
 				print_line("NOW: "+p_path);
@@ -33,6 +33,9 @@
 #include <stdlib.h>
 #include "print_string.h"
 #include "servers/physics/physics_server_sw.h"
+#include "servers/physics/physics_server_wrap_mt.h"
+#include "servers/physics_2d/physics_2d_server_wrap_mt.h"
+#include "globals.h"
 
 #include "main/main.h"
 
@@ -83,8 +86,12 @@ void OS_Server::initialize(const VideoMode& p_desired,int p_video_driver,int p_a
 	visual_server->init();
 	//
 	physics_server = memnew( PhysicsServerSW );
+	if (GLOBAL_DEF("physics/separate_thread",false))
+		physics_server = memnew( PhysicsServerWrapMT(physics_server,true) );
 	physics_server->init();
 	physics_2d_server = memnew( Physics2DServerSW );
+	if (GLOBAL_DEF("physics_2d/separate_thread",false))
+		physics_2d_server = memnew( Physics2DServerWrapMT(physics_2d_server,true) );
 	physics_2d_server->init();
 
 	input = memnew( InputDefault );
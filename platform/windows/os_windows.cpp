@@ -43,6 +43,8 @@
 #include "servers/visual/visual_server_raster.h"
 #include "servers/audio/audio_server_sw.h"
 #include "servers/visual/visual_server_wrap_mt.h"
+#include "servers/physics/physics_server_wrap_mt.h"
+#include "servers/physics_2d/physics_2d_server_wrap_mt.h"
 
 #include "tcp_server_winsock.h"
 #include "stream_peer_winsock.h"
@@ -926,9 +928,13 @@ void OS_Windows::initialize(const VideoMode& p_desired,int p_video_driver,int p_
 
 	//
 	physics_server = memnew( PhysicsServerSW );
+	if (GLOBAL_DEF("physics/separate_thread",false))
+		physics_server = memnew( PhysicsServerWrapMT(physics_server,true) );
 	physics_server->init();
 
 	physics_2d_server = memnew( Physics2DServerSW );
+	if (GLOBAL_DEF("physics_2d/separate_thread",false))
+		physics_2d_server = memnew( Physics2DServerWrapMT(physics_2d_server,true) );
 	physics_2d_server->init();
 
 	if (!is_no_window_mode_enabled()) {
@@ -113,6 +113,65 @@ Ref<Mesh> MeshInstance::get_mesh() const {
 	return mesh;
 }
 
+void MeshInstance::_update_lods() {
+
+	// only the levels that are complete and sorted so far, the rest is ignored until fixed
+	Vector<RID> meshes;
+	Vector<float> distances;
+
+	DVector<float>::Read r = lod_distances.read();
+	int count=MIN(lod_meshes.size(),lod_distances.size());
+
+	for(int i=0;i<count;i++) {
+
+		if (lod_meshes[i].is_null() || (i>0 && r[i]<r[i-1]))
+			break;
+		meshes.push_back(lod_meshes[i]->get_rid());
+		distances.push_back(r[i]);
+	}
+
+	VS::get_singleton()->instance_geometry_set_lod_meshes(get_instance(),meshes,distances);
+}
+
+void MeshInstance::set_lod_meshes(const Array& p_meshes) {
+
+	lod_meshes.resize(p_meshes.size());
+	for(int i=0;i<p_meshes.size();i++)
+		lod_meshes[i]=p_meshes[i];
+	_update_lods();
+}
+
+Array MeshInstance::get_lod_meshes() const {
+
+	Array ret;
+	ret.resize(lod_meshes.size());
+	for(int i=0;i<lod_meshes.size();i++)
+		ret[i]=lod_meshes[i];
+	return ret;
+}
+
+void MeshInstance::set_lod_distances(const DVector<float>& p_distances) {
+
+	lod_distances=p_distances;
+	_update_lods();
+}
+
+DVector<float> MeshInstance::get_lod_distances() const {
+
+	return lod_distances;
+}
+
+void MeshInstance::set_lod_hysteresis(float p_margin) {
+
+	lod_hysteresis=p_margin;
+	VS::get_singleton()->instance_geometry_set_lod_hysteresis(get_instance(),lod_hysteresis);
+}
+
+float MeshInstance::get_lod_hysteresis() const {
+
+	return lod_hysteresis;
+}
+
 
 AABB MeshInstance::get_aabb() const {
 
@@ -201,13 +260,23 @@ void MeshInstance::_bind_methods() {
 	ObjectTypeDB::set_method_flags("MeshInstance","create_trimesh_collision",METHOD_FLAGS_DEFAULT|METHOD_FLAG_EDITOR);
 	ObjectTypeDB::bind_method(_MD("create_convex_collision"),&MeshInstance::create_convex_collision);
 	ObjectTypeDB::set_method_flags("MeshInstance","create_convex_collision",METHOD_FLAGS_DEFAULT|METHOD_FLAG_EDITOR);
+	ObjectTypeDB::bind_method(_MD("set_lod_meshes","meshes"),&MeshInstance::set_lod_meshes);
+	ObjectTypeDB::bind_method(_MD("get_lod_meshes"),&MeshInstance::get_lod_meshes);
+	ObjectTypeDB::bind_method(_MD("set_lod_distances","distances"),&MeshInstance::set_lod_distances);
+	ObjectTypeDB::bind_method(_MD("get_lod_distances"),&MeshInstance::get_lod_distances);
+	ObjectTypeDB::bind_method(_MD("set_lod_hysteresis","margin"),&MeshInstance::set_lod_hysteresis);
+	ObjectTypeDB::bind_method(_MD("get_lod_hysteresis"),&MeshInstance::get_lod_hysteresis);
 	ADD_PROPERTY( PropertyInfo( Variant::OBJECT, "mesh/mesh", PROPERTY_HINT_RESOURCE_TYPE, "Mesh" ), _SCS("set_mesh"), _SCS("get_mesh"));
+	ADD_PROPERTY( PropertyInfo( Variant::ARRAY, "lod/meshes" ), _SCS("set_lod_meshes"), _SCS("get_lod_meshes"));
+	ADD_PROPERTY( PropertyInfo( Variant::REAL_ARRAY, "lod/distances" ), _SCS("set_lod_distances"), _SCS("get_lod_distances"));
+	ADD_PROPERTY( PropertyInfo( Variant::REAL, "lod/hysteresis", PROPERTY_HINT_RANGE,"0,1024,0.01" ), _SCS("set_lod_hysteresis"), _SCS("get_lod_hysteresis"));
 	
 	
 }
 
 MeshInstance::MeshInstance()
 {
+	lod_hysteresis=0;
 }
 
 
@@ -50,6 +50,11 @@ class MeshInstance : public GeometryInstance {
 
 	Map<StringName,MorphTrack> morph_tracks;
 
+	Vector< Ref<Mesh> > lod_meshes;
+	DVector<float> lod_distances;
+	float lod_hysteresis;
+
+	void _update_lods();
 
 protected:
 
@@ -63,6 +68,15 @@ public:
 
 	void set_mesh(const Ref<Mesh>& p_mesh);
 	Ref<Mesh> get_mesh() const;
+
+	void set_lod_meshes(const Array& p_meshes);
+	Array get_lod_meshes() const;
+
+	void set_lod_distances(const DVector<float>& p_distances);
+	DVector<float> get_lod_distances() const;
+
+	void set_lod_hysteresis(float p_margin);
+	float get_lod_hysteresis() const;
 	
 	Node* create_trimesh_collision_node();
 	void create_trimesh_collision();
@@ -537,6 +537,10 @@ void Control::_notification(int p_notification) {
 			if (parent && data.theme.is_null() && parent->data.theme_owner)
 				_propagate_theme_changed(parent->data.theme_owner);
 
+			//a themed branch now falls back to the themes above it
+			if (parent && data.theme.is_valid() && parent->data.theme_owner)
+				_invalidate_theme_caches();
+
 		} break;
 		case NOTIFICATION_UNPARENTED: {
 
@@ -544,6 +548,9 @@ void Control::_notification(int p_notification) {
 			if (data.theme.is_null() && data.theme_owner)
 				_propagate_theme_changed(NULL);
 
+			if (data.theme.is_valid())
+				_invalidate_theme_caches(); //same as when parented
+
 		} break;
 		 case NOTIFICATION_MOVED_IN_PARENT: {
 			 // some parents need to know the order of the childrens to draw (like TabContainer)
@@ -591,6 +598,7 @@ void Control::_notification(int p_notification) {
 		} break;
 		case NOTIFICATION_THEME_CHANGED: {
 
+			_clear_theme_cache();
 			update();
 		} break;
 		case NOTIFICATION_VISIBILITY_CHANGED: {
@@ -1335,21 +1343,42 @@ Size2 Control::get_minimum_size() const {
 }
 
 
-Ref<Texture> Control::get_icon(const StringName& p_name,const StringName& p_type) const {
-	
-	const Ref<Texture>* tex = data.icon_override.getptr(p_name);
-	if (tex)
-		return *tex;	
+Control::ThemeCache *Control::_get_theme_cache() const {
 
-	StringName type = p_type?p_type:get_type_name();
+	if (data.theme_cache && data.theme_cache->version!=Theme::get_version())
+		_clear_theme_cache();
+
+	if (!data.theme_cache) {
+
+		data.theme_cache = memnew( ThemeCache );
+		data.theme_cache->version=Theme::get_version();
+	}
+
+	return data.theme_cache;
+}
+
+void Control::_clear_theme_cache() const {
+
+	if (data.theme_cache) {
+
+		data.theme_cache->icons.clear();
+		data.theme_cache->styles.clear();
+		data.theme_cache->fonts.clear();
+		data.theme_cache->colors.clear();
+		data.theme_cache->constants.clear();
+		data.theme_cache->version=Theme::get_version();
+	}
+}
+
+Ref<Texture> Control::_find_theme_icon(const StringName& p_name,const StringName& p_type) const {
 
 	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
 	while(theme_owner) {
 
-		if (theme_owner->data.theme->has_icon(p_name, type ) )
-			return data.theme_owner->data.theme->get_icon(p_name, type );
+		if (theme_owner->data.theme->has_icon(p_name, p_type ) )
+			return theme_owner->data.theme->get_icon(p_name, p_type );
 		Control *parent = theme_owner->get_parent()?theme_owner->get_parent()->cast_to<Control>():NULL;
 
 		if (parent)
@@ -1359,54 +1388,39 @@ Ref<Texture> Control::get_icon(const StringName& p_name,const StringName& p_type
 
 	}
 
-	return Theme::get_default()->get_icon( p_name, type );
-
+	return Theme::get_default()->get_icon( p_name, p_type );
 }
 
-Ref<StyleBox> Control::get_stylebox(const StringName& p_name,const StringName& p_type) const {
-		
-	
-	const Ref<StyleBox>* style = data.style_override.getptr(p_name);
-	
-	
-	if (style)
-		return *style;	
-
-	StringName type = p_type?p_type:get_type_name();
+Ref<StyleBox> Control::_find_theme_stylebox(const StringName& p_name,const StringName& p_type) const {
 
 	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
 	while(theme_owner) {
 
-		if (theme_owner->data.theme->has_stylebox(p_name, type ) )
-			return data.theme_owner->data.theme->get_stylebox(p_name, type );
+		if (theme_owner->data.theme->has_stylebox(p_name, p_type ) )
+			return theme_owner->data.theme->get_stylebox(p_name, p_type );
 		Control *parent = theme_owner->get_parent()?theme_owner->get_parent()->cast_to<Control>():NULL;
 
 		if (parent)
 			theme_owner=parent->data.theme_owner;
 		else
 			theme_owner=NULL;
-	}
 
-	return Theme::get_default()->get_stylebox( p_name, type );
+	}
 
+	return Theme::get_default()->get_stylebox( p_name, p_type );
 }
-Ref<Font> Control::get_font(const StringName& p_name,const StringName& p_type) const {
-	
-	const Ref<Font>* font = data.font_override.getptr(p_name);
-	if (font)
-		return *font;	
 
-	StringName type = p_type?p_type:get_type_name();
+Ref<Font> Control::_find_theme_font(const StringName& p_name,const StringName& p_type) const {
 
 	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
 	while(theme_owner) {
 
-		if (theme_owner->data.theme->has_font(p_name, type ) )
-			return data.theme_owner->data.theme->get_font(p_name, type );
+		if (theme_owner->data.theme->has_font(p_name, p_type ) )
+			return theme_owner->data.theme->get_font(p_name, p_type );
 		if (theme_owner->data.theme->get_default_theme_font().is_valid())
 			return theme_owner->data.theme->get_default_theme_font();
 		Control *parent = theme_owner->get_parent()?theme_owner->get_parent()->cast_to<Control>():NULL;
@@ -1418,23 +1432,18 @@ Ref<Font> Control::get_font(const StringName& p_name,const StringName& p_type) c
 
 	}
 
-	return Theme::get_default()->get_font( p_name, type );
-
+	return Theme::get_default()->get_font( p_name, p_type );
 }
-Color Control::get_color(const StringName& p_name,const StringName& p_type) const {
-	
-	const Color* color = data.color_override.getptr(p_name);
-	if (color)
-		return *color;	
 
-	StringName type = p_type?p_type:get_type_name();
+Color Control::_find_theme_color(const StringName& p_name,const StringName& p_type) const {
+
 	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
 	while(theme_owner) {
 
-		if (theme_owner->data.theme->has_color(p_name, type ) )
-			return data.theme_owner->data.theme->get_color(p_name, type );
+		if (theme_owner->data.theme->has_color(p_name, p_type ) )
+			return theme_owner->data.theme->get_color(p_name, p_type );
 		Control *parent = theme_owner->get_parent()?theme_owner->get_parent()->cast_to<Control>():NULL;
 
 		if (parent)
@@ -1444,24 +1453,18 @@ Color Control::get_color(const StringName& p_name,const StringName& p_type) cons
 
 	}
 
-	return Theme::get_default()->get_color( p_name, type );
-
+	return Theme::get_default()->get_color( p_name, p_type );
 }
 
-int Control::get_constant(const StringName& p_name,const StringName& p_type) const {
-	
-	const int* constant = data.constant_override.getptr(p_name);
-	if (constant)
-		return *constant;	
+int Control::_find_theme_constant(const StringName& p_name,const StringName& p_type) const {
 
-	StringName type = p_type?p_type:get_type_name();
-		// try with custom themes
+	// try with custom themes
 	Control *theme_owner = data.theme_owner;
 
 	while(theme_owner) {
 
-		if (theme_owner->data.theme->has_constant(p_name, type ) )
-			return data.theme_owner->data.theme->get_constant(p_name, type );
+		if (theme_owner->data.theme->has_constant(p_name, p_type ) )
+			return theme_owner->data.theme->get_constant(p_name, p_type );
 		Control *parent = theme_owner->get_parent()?theme_owner->get_parent()->cast_to<Control>():NULL;
 
 		if (parent)
@@ -1471,9 +1474,107 @@ int Control::get_constant(const StringName& p_name,const StringName& p_type) con
 
 	}
 
-	return Theme::get_default()->get_constant( p_name, type );
+	return Theme::get_default()->get_constant( p_name, p_type );
+}
+
+Ref<Texture> Control::get_icon(const StringName& p_name,const StringName& p_type) const {
 
-	
+	const Ref<Texture>* tex = data.icon_override.getptr(p_name);
+	if (tex)
+		return *tex;
+
+	//only lookups of the own type are cached
+	if (p_type && p_type!=get_type_name())
+		return _find_theme_icon(p_name,p_type);
+
+	ThemeCache *cache = _get_theme_cache();
+	const Ref<Texture>* cached = cache->icons.getptr(p_name);
+	if (cached)
+		return *cached;
+
+	Ref<Texture> ret = _find_theme_icon(p_name,get_type_name());
+	cache->icons[p_name]=ret;
+	return ret;
+}
+
+Ref<StyleBox> Control::get_stylebox(const StringName& p_name,const StringName& p_type) const {
+
+	const Ref<StyleBox>* style = data.style_override.getptr(p_name);
+	if (style)
+		return *style;
+
+	//only lookups of the own type are cached
+	if (p_type && p_type!=get_type_name())
+		return _find_theme_stylebox(p_name,p_type);
+
+	ThemeCache *cache = _get_theme_cache();
+	const Ref<StyleBox>* cached = cache->styles.getptr(p_name);
+	if (cached)
+		return *cached;
+
+	Ref<StyleBox> ret = _find_theme_stylebox(p_name,get_type_name());
+	cache->styles[p_name]=ret;
+	return ret;
+}
+
+Ref<Font> Control::get_font(const StringName& p_name,const StringName& p_type) const {
+
+	const Ref<Font>* font = data.font_override.getptr(p_name);
+	if (font)
+		return *font;
+
+	//only lookups of the own type are cached
+	if (p_type && p_type!=get_type_name())
+		return _find_theme_font(p_name,p_type);
+
+	ThemeCache *cache = _get_theme_cache();
+	const Ref<Font>* cached = cache->fonts.getptr(p_name);
+	if (cached)
+		return *cached;
+
+	Ref<Font> ret = _find_theme_font(p_name,get_type_name());
+	cache->fonts[p_name]=ret;
+	return ret;
+}
+
+Color Control::get_color(const StringName& p_name,const StringName& p_type) const {
+
+	const Color* color = data.color_override.getptr(p_name);
+	if (color)
+		return *color;
+
+	//only lookups of the own type are cached
+	if (p_type && p_type!=get_type_name())
+		return _find_theme_color(p_name,p_type);
+
+	ThemeCache *cache = _get_theme_cache();
+	const Color* cached = cache->colors.getptr(p_name);
+	if (cached)
+		return *cached;
+
+	Color ret = _find_theme_color(p_name,get_type_name());
+	cache->colors[p_name]=ret;
+	return ret;
+}
+
+int Control::get_constant(const StringName& p_name,const StringName& p_type) const {
+
+	const int* constant = data.constant_override.getptr(p_name);
+	if (constant)
+		return *constant;
+
+	//only lookups of the own type are cached
+	if (p_type && p_type!=get_type_name())
+		return _find_theme_constant(p_name,p_type);
+
+	ThemeCache *cache = _get_theme_cache();
+	const int* cached = cache->constants.getptr(p_name);
+	if (cached)
+		return *cached;
+
+	int ret = _find_theme_constant(p_name,get_type_name());
+	cache->constants[p_name]=ret;
+	return ret;
 }
 
 
@@ -2301,8 +2402,12 @@ void Control::_propagate_theme_changed(Control *p_owner) {
 	for(int i=0;i<get_child_count();i++) {
 
 		Control *child = get_child(i)->cast_to<Control>();
-		if (child && child->data.theme.is_null()) //has no theme, propagate
+		if (!child)
+			continue;
+		if (child->data.theme.is_null()) //has no theme, propagate
 			child->_propagate_theme_changed(p_owner);
+		else
+			child->_invalidate_theme_caches(); //keeps its theme, but falls back to the ones above
 	}
 
 	data.theme_owner=p_owner;
@@ -2310,6 +2415,19 @@ void Control::_propagate_theme_changed(Control *p_owner) {
 	update();
 }
 
+void Control::_invalidate_theme_caches() {
+
+	for(int i=0;i<get_child_count();i++) {
+
+		Control *child = get_child(i)->cast_to<Control>();
+		if (child)
+			child->_invalidate_theme_caches();
+	}
+
+	_clear_theme_cache();
+	update();
+}
+
 void Control::set_theme(const Ref<Theme>& p_theme) {
 
 	data.theme=p_theme;
@@ -2860,6 +2978,7 @@ Control::Control() {
 	data.MI=NULL;
 	data.modal=false;
 	data.theme_owner=NULL;
+	data.theme_cache=NULL;
 	data.modal_exclusive=false;
 	data.default_cursor = CURSOR_ARROW;
 	data.h_size_flags=SIZE_FILL;
@@ -2884,6 +3003,8 @@ Control::Control() {
 
 Control::~Control()
 {
+	if (data.theme_cache)
+		memdelete(data.theme_cache);
 }
 
 
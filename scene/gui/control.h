@@ -99,6 +99,18 @@ private:
 		bool operator()(const Control* p_a, const Control* p_b) const { return p_b->is_greater_than(p_a); }
 	};
 
+	// theme items resolved for the control's own type, so drawing does not walk the
+	// theme owners every time. Cleared on NOTIFICATION_THEME_CHANGED, when a themed branch above moves or when any theme changes
+	struct ThemeCache {
+
+		uint32_t version; // Theme::get_version() when created
+		HashMap<StringName, Ref<Texture>, StringNameHasher > icons;
+		HashMap<StringName, Ref<StyleBox>, StringNameHasher > styles;
+		HashMap<StringName, Ref<Font>, StringNameHasher > fonts;
+		HashMap<StringName, Color, StringNameHasher > colors;
+		HashMap<StringName, int, StringNameHasher > constants;
+	};
+
 	struct Data {
 			
 		Point2 pos_cache;
@@ -125,6 +137,7 @@ private:
 		bool modal_exclusive;
 		Ref<Theme> theme;
 		Control *theme_owner;		
+		mutable ThemeCache *theme_cache; // created on first lookup
 		String tooltip;
 		CursorShape default_cursor;
 
@@ -197,6 +210,15 @@ private:
 	float _a2s(float p_val, AnchorType p_anchor,float p_range) const;
 	void _modal_stack_remove();
 	void _propagate_theme_changed(Control *p_owner);
+	void _invalidate_theme_caches();
+
+	ThemeCache *_get_theme_cache() const;
+	void _clear_theme_cache() const;
+	Ref<Texture> _find_theme_icon(const StringName& p_name,const StringName& p_type) const;
+	Ref<StyleBox> _find_theme_stylebox(const StringName& p_name,const StringName& p_type) const;
+	Ref<Font> _find_theme_font(const StringName& p_name,const StringName& p_type) const;
+	Color _find_theme_color(const StringName& p_name,const StringName& p_type) const;
+	int _find_theme_constant(const StringName& p_name,const StringName& p_type) const;
 
 	void _change_notify_margins();
 	void _window_cancel_tooltip();
@@ -114,6 +114,7 @@
 
 #include "scene/resources/surface_tool.h"
 #include "scene/resources/mesh_data_tool.h"
+#include "scene/resources/mesh_simplifier.h"
 #include "scene/resources/scene_preloader.h"
 
 #include "scene/main/timer.h"
@@ -508,6 +509,7 @@ void register_scene_types() {
 
 	ObjectTypeDB::register_type<SurfaceTool>();
 	ObjectTypeDB::register_type<MeshDataTool>();
+	ObjectTypeDB::register_type<MeshSimplifier>();
 
 	OS::get_singleton()->yield(); //may take time to init
 
@@ -29,6 +29,7 @@
 #include "mesh.h"
 #include "scene/resources/concave_polygon_shape.h"
 #include "scene/resources/convex_polygon_shape.h"
+#include "math_simd.h"
 
 static const char*_array_name[]={
 	"vertex_array",
@@ -241,14 +242,7 @@ void Mesh::add_surface(PrimitiveType p_primitive,const Array& p_arrays,const Arr
 		const Vector3 *vtx=r.ptr();
 
 		// check AABB
-		AABB aabb;
-		for (int i=0;i<len;i++) {
-
-			if (i==0)
-				aabb.pos=vtx[i];
-			else
-				aabb.expand_to(vtx[i]);
-		}
+		AABB aabb=MathSIMD::aabb_from_points(vtx,len);
 
 		surfaces[surfaces.size()-1].aabb=aabb;
 		surfaces[surfaces.size()-1].alphasort=p_alphasort;
@@ -0,0 +1,511 @@
+/*************************************************************************/
+/*  mesh_simplifier.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "mesh_simplifier.h"
+#include "scene/resources/mesh_data_tool.h"
+#include "scene/resources/surface_tool.h"
+
+// symmetric 4x4 matrix, sum of squared distances to a set of planes
+struct _SimplifyQuadric {
+
+	double m[10];
+
+	void add_plane(const Plane& p_plane) {
+
+		double a=p_plane.normal.x,b=p_plane.normal.y,c=p_plane.normal.z,d=-p_plane.d;
+		m[0]+=a*a; m[1]+=a*b; m[2]+=a*c; m[3]+=a*d;
+		m[4]+=b*b; m[5]+=b*c; m[6]+=b*d;
+		m[7]+=c*c; m[8]+=c*d;
+		m[9]+=d*d;
+	}
+
+	void add(const _SimplifyQuadric& p_q) {
+
+		for(int i=0;i<10;i++)
+			m[i]+=p_q.m[i];
+	}
+
+	double error(const Vector3& p_v) const {
+
+		double x=p_v.x,y=p_v.y,z=p_v.z;
+		return m[0]*x*x + 2*m[1]*x*y + 2*m[2]*x*z + 2*m[3]*x
+			+ m[4]*y*y + 2*m[5]*y*z + 2*m[6]*y
+			+ m[7]*z*z + 2*m[8]*z
+			+ m[9];
+	}
+
+	_SimplifyQuadric() { for(int i=0;i<10;i++) m[i]=0; }
+};
+
+/* Vertices sharing a position form a group, groups are what gets collapsed. A group
+ * with more than one distinct vertex sits on a seam, those and the ones on a border
+ * edge are locked. */
+struct _SimplifyData {
+
+	struct Face {
+
+		int v[3];
+		bool removed;
+	};
+
+	Vector<Face> faces;
+	Vector<int> vertex_group;
+	Vector<Vector3> group_pos; // normalized to the mesh size
+	Vector<_SimplifyQuadric> group_quadric;
+	Vector< Vector<int> > group_faces;
+	Vector<bool> group_locked;
+	Vector<uint32_t> group_pass;
+	Vector<uint32_t> group_mark;
+	uint32_t mark;
+	int alive;
+
+	_FORCE_INLINE_ int corner(const Face& p_face,int p_group) const {
+
+		for(int i=0;i<3;i++) {
+			if (vertex_group[p_face.v[i]]==p_group)
+				return i;
+		}
+		return -1;
+	}
+
+	bool collapse(int p_remove,int p_keep);
+};
+
+bool _SimplifyData::collapse(int p_remove,int p_keep) {
+
+	const Vector<int> &rfaces=group_faces[p_remove];
+
+	// the edge must be shared by exactly two faces, both using the same vertex of the kept group
+	int keep_vertex=-1;
+	int shared=0;
+	for(int i=0;i<rfaces.size();i++) {
+
+		const Face &f=faces[rfaces[i]];
+		if (f.removed)
+			continue;
+		int c=corner(f,p_keep);
+		if (c<0)
+			continue;
+		if (keep_vertex!=-1 && f.v[c]!=keep_vertex)
+			return false;
+		keep_vertex=f.v[c];
+		shared++;
+	}
+
+	if (shared!=2)
+		return false;
+
+	// link condition, only the two opposite groups may be neighbours of both ends (or the mesh folds)
+	mark+=2;
+	const Vector<int> &kfaces=group_faces[p_keep];
+	for(int i=0;i<kfaces.size();i++) {
+
+		const Face &f=faces[kfaces[i]];
+		if (f.removed)
+			continue;
+		for(int j=0;j<3;j++)
+			group_mark[vertex_group[f.v[j]]]=mark-1;
+	}
+
+	int common=0;
+	for(int i=0;i<rfaces.size();i++) {
+
+		const Face &f=faces[rfaces[i]];
+		if (f.removed)
+			continue;
+		for(int j=0;j<3;j++) {
+			int g=vertex_group[f.v[j]];
+			if (g==p_remove || g==p_keep || group_mark[g]!=mark-1)
+				continue;
+			group_mark[g]=mark;
+			common++;
+		}
+	}
+
+	if (common!=2)
+		return false;
+
+	// faces that stay must not flip or degenerate
+	const Vector3 &to=group_pos[p_keep];
+	for(int i=0;i<rfaces.size();i++) {
+
+		const Face &f=faces[rfaces[i]];
+		if (f.removed || corner(f,p_keep)>=0)
+			continue;
+
+		int c=corner(f,p_remove);
+		Vector3 p[3];
+		for(int j=0;j<3;j++)
+			p[j]=group_pos[vertex_group[f.v[j]]];
+
+		Vector3 n=(p[1]-p[0]).cross(p[2]-p[0]);
+		p[c]=to;
+		Vector3 nn=(p[1]-p[0]).cross(p[2]-p[0]);
+		float len=nn.length();
+		if (len<CMP_EPSILON)
+			return false;
+		if (n.dot(nn)<0.2*n.length()*len)
+			return false;
+	}
+
+	// go
+	for(int i=0;i<rfaces.size();i++) {
+
+		int fi=rfaces[i];
+		Face &f=faces[fi];
+		if (f.removed)
+			continue;
+		if (corner(f,p_keep)>=0) {
+			f.removed=true;
+			alive--;
+		} else {
+			f.v[corner(f,p_remove)]=keep_vertex;
+			group_faces[p_keep].push_back(fi);
+		}
+	}
+
+	group_faces[p_remove].clear();
+	group_quadric[p_keep].add(group_quadric[p_remove]);
+	return true;
+}
+
+template<class T>
+static bool _same_array(const Vector<T>& p_a,const Vector<T>& p_b) {
+
+	if (p_a.size()!=p_b.size())
+		return false;
+	for(int i=0;i<p_a.size();i++) {
+		if (p_a[i]!=p_b[i])
+			return false;
+	}
+	return true;
+}
+
+static bool _same_attributes(const Ref<MeshDataTool>& p_mdt,int p_a,int p_b,int p_format) {
+
+	if (p_format&Mesh::ARRAY_FORMAT_NORMAL && p_mdt->get_vertex_normal(p_a)!=p_mdt->get_vertex_normal(p_b))
+		return false;
+	if (p_format&Mesh::ARRAY_FORMAT_TANGENT && p_mdt->get_vertex_tangent(p_a)!=p_mdt->get_vertex_tangent(p_b))
+		return false;
+	if (p_format&Mesh::ARRAY_FORMAT_COLOR && p_mdt->get_vertex_color(p_a)!=p_mdt->get_vertex_color(p_b))
+		return false;
+	if (p_format&Mesh::ARRAY_FORMAT_TEX_UV && p_mdt->get_vertex_uv(p_a)!=p_mdt->get_vertex_uv(p_b))
+		return false;
+	if (p_format&Mesh::ARRAY_FORMAT_TEX_UV2 && p_mdt->get_vertex_uv2(p_a)!=p_mdt->get_vertex_uv2(p_b))
+		return false;
+	if (p_format&Mesh::ARRAY_FORMAT_BONES && !_same_array(p_mdt->get_vertex_bones(p_a),p_mdt->get_vertex_bones(p_b)))
+		return false;
+	if (p_format&Mesh::ARRAY_FORMAT_WEIGHTS && !_same_array(p_mdt->get_vertex_weights(p_a),p_mdt->get_vertex_weights(p_b)))
+		return false;
+
+	return true;
+}
+
+Error MeshSimplifier::simplify_surface(const Ref<Mesh>& p_mesh,int p_surface,float p_ratio,const Ref<Mesh>& p_to) {
+
+	ERR_FAIL_COND_V(p_mesh.is_null(),ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_to.is_null(),ERR_INVALID_PARAMETER);
+	ERR_FAIL_INDEX_V(p_surface,p_mesh->get_surface_count(),ERR_INVALID_PARAMETER);
+
+	Ref<MeshDataTool> mdt = memnew( MeshDataTool );
+	Error err = mdt->create_from_surface(p_mesh,p_surface);
+	if (err)
+		return err;
+
+	int format=mdt->get_format();
+	int vcount=mdt->get_vertex_count();
+	int fcount=mdt->get_face_count();
+
+	_SimplifyData data;
+
+	/* weld by position, merging vertices that are equal */
+
+	Vector<int> vertex_remap;
+	vertex_remap.resize(vcount);
+	data.vertex_group.resize(vcount);
+
+	Map<Vector3,int> group_map;
+	Vector< Vector<int> > group_vertices;
+	Vector<Vector3> group_pos;
+
+	for(int i=0;i<vcount;i++) {
+
+		Vector3 pos=mdt->get_vertex(i);
+		int g;
+		Map<Vector3,int>::Element *E=group_map.find(pos);
+		if (E) {
+			g=E->get();
+		} else {
+			g=group_pos.size();
+			group_map[pos]=g;
+			group_pos.push_back(pos);
+			group_vertices.push_back(Vector<int>());
+		}
+
+		data.vertex_group[i]=g;
+		vertex_remap[i]=i;
+
+		Vector<int> &gv=group_vertices[g];
+		for(int j=0;j<gv.size();j++) {
+
+			if (_same_attributes(mdt,gv[j],i,format)) {
+				vertex_remap[i]=gv[j];
+				break;
+			}
+		}
+
+		if (vertex_remap[i]==i)
+			gv.push_back(i);
+	}
+
+	int gcount=group_pos.size();
+
+	// positions relative to the mesh size, so errors don't depend on scale
+	AABB aabb;
+	for(int i=0;i<gcount;i++) {
+		if (i==0)
+			aabb.pos=group_pos[i];
+		else
+			aabb.expand_to(group_pos[i]);
+	}
+	float scale=1.0/MAX(aabb.get_longest_axis_size(),CMP_EPSILON);
+
+	data.group_pos.resize(gcount);
+	for(int i=0;i<gcount;i++)
+		data.group_pos[i]=(group_pos[i]-aabb.pos)*scale;
+
+	data.group_quadric.resize(gcount);
+	data.group_faces.resize(gcount);
+	data.group_locked.resize(gcount);
+	data.group_pass.resize(gcount);
+	data.group_mark.resize(gcount);
+	for(int i=0;i<gcount;i++) {
+		data.group_locked[i]=group_vertices[i].size()>1;
+		data.group_pass[i]=0;
+		data.group_mark[i]=0;
+	}
+	data.mark=0;
+
+	/* faces, quadrics and borders */
+
+	HashMap<uint64_t,int> edge_faces;
+
+	for(int i=0;i<fcount;i++) {
+
+		_SimplifyData::Face f;
+		for(int j=0;j<3;j++)
+			f.v[j]=vertex_remap[mdt->get_face_vertex(i,j)];
+		f.removed=false;
+
+		int g[3];
+		for(int j=0;j<3;j++)
+			g[j]=data.vertex_group[f.v[j]];
+
+		if (g[0]==g[1] || g[1]==g[2] || g[2]==g[0])
+			continue; // degenerate already
+
+		const Vector3 &a=data.group_pos[g[0]];
+		Vector3 n=(data.group_pos[g[1]]-a).cross(data.group_pos[g[2]]-a);
+		if (n.length()>CMP_EPSILON) {
+			Plane plane(a,n.normalized());
+			for(int j=0;j<3;j++)
+				data.group_quadric[g[j]].add_plane(plane);
+		}
+
+		for(int j=0;j<3;j++) {
+			int ga=g[j],gb=g[(j+1)%3];
+			uint64_t key=ga<gb?(uint64_t(ga)<<32)|gb:(uint64_t(gb)<<32)|ga;
+			int *c=edge_faces.getptr(key);
+			if (c)
+				(*c)++;
+			else
+				edge_faces[key]=1;
+			data.group_faces[g[j]].push_back(data.faces.size());
+		}
+
+		data.faces.push_back(f);
+	}
+
+	const uint64_t *k=NULL;
+	while((k=edge_faces.next(k))) {
+
+		if (edge_faces[*k]!=2) {
+			data.group_locked[int(*k>>32)]=true;
+			data.group_locked[int(*k&0xFFFFFFFF)]=true;
+		}
+	}
+
+	/* collapse the cheapest edges first, raising the allowed error until the target is met */
+
+	data.alive=data.faces.size();
+	int target=MAX(int(data.faces.size()*p_ratio),1);
+	double max=max_error*max_error;
+	uint32_t pass=0;
+
+	for(int iteration=0;iteration<100 && data.alive>target;iteration++) {
+
+		double threshold=MIN(0.000000001*Math::pow(double(iteration+3),7.0),max);
+		pass++;
+
+		for(int i=0;i<data.faces.size() && data.alive>target;i++) {
+
+			const _SimplifyData::Face &f=data.faces[i];
+			if (f.removed)
+				continue;
+
+			for(int j=0;j<3;j++) {
+
+				int ga=data.vertex_group[f.v[j]];
+				int gb=data.vertex_group[f.v[(j+1)%3]];
+				if (data.group_pass[ga]==pass || data.group_pass[gb]==pass)
+					continue;
+
+				_SimplifyQuadric q=data.group_quadric[ga];
+				q.add(data.group_quadric[gb]);
+
+				int remove=-1,keep=-1;
+				double cost=threshold;
+				if (!data.group_locked[gb] && q.error(data.group_pos[ga])<=cost) {
+					cost=q.error(data.group_pos[ga]);
+					remove=gb;
+					keep=ga;
+				}
+				if (!data.group_locked[ga] && q.error(data.group_pos[gb])<=cost) {
+					remove=ga;
+					keep=gb;
+				}
+
+				if (remove==-1 || !data.collapse(remove,keep))
+					continue;
+
+				data.group_pass[remove]=pass;
+				data.group_pass[keep]=pass;
+				break;
+			}
+		}
+
+		if (threshold>=max)
+			break;
+	}
+
+	/* write what is left */
+
+	Ref<SurfaceTool> st = memnew( SurfaceTool );
+	st->begin(Mesh::PRIMITIVE_TRIANGLES);
+	st->set_material(mdt->get_material());
+
+	Vector<int> vertex_index;
+	vertex_index.resize(vcount);
+	for(int i=0;i<vcount;i++)
+		vertex_index[i]=-1;
+
+	int used=0;
+	for(int i=0;i<data.faces.size();i++) {
+
+		const _SimplifyData::Face &f=data.faces[i];
+		if (f.removed)
+			continue;
+
+		for(int j=0;j<3;j++) {
+
+			int v=f.v[j];
+			if (vertex_index[v]==-1) {
+
+				if (format&Mesh::ARRAY_FORMAT_NORMAL)
+					st->add_normal(mdt->get_vertex_normal(v));
+				if (format&Mesh::ARRAY_FORMAT_TANGENT)
+					st->add_tangent(mdt->get_vertex_tangent(v));
+				if (format&Mesh::ARRAY_FORMAT_COLOR)
+					st->add_color(mdt->get_vertex_color(v));
+				if (format&Mesh::ARRAY_FORMAT_TEX_UV)
+					st->add_uv(mdt->get_vertex_uv(v));
+				if (format&Mesh::ARRAY_FORMAT_TEX_UV2)
+					st->add_uv2(mdt->get_vertex_uv2(v));
+				if (format&Mesh::ARRAY_FORMAT_BONES)
+					st->add_bones(mdt->get_vertex_bones(v));
+				if (format&Mesh::ARRAY_FORMAT_WEIGHTS)
+					st->add_weights(mdt->get_vertex_weights(v));
+				st->add_vertex(mdt->get_vertex(v));
+				vertex_index[v]=used++;
+			}
+
+			st->add_index(vertex_index[v]);
+		}
+	}
+
+	ERR_FAIL_COND_V(used==0,ERR_BUG);
+
+	Ref<Mesh> ncmesh=p_to;
+	st->commit(ncmesh);
+	ncmesh->surface_set_name(ncmesh->get_surface_count()-1,p_mesh->surface_get_name(p_surface));
+
+	return OK;
+}
+
+Ref<Mesh> MeshSimplifier::simplify(const Ref<Mesh>& p_mesh,float p_ratio) {
+
+	ERR_FAIL_COND_V(p_mesh.is_null(),Ref<Mesh>());
+
+	Ref<Mesh> mesh = memnew( Mesh );
+
+	for(int i=0;i<p_mesh->get_surface_count();i++) {
+
+		if (p_mesh->surface_get_primitive_type(i)==Mesh::PRIMITIVE_TRIANGLES && simplify_surface(p_mesh,i,p_ratio,mesh)==OK)
+			continue;
+
+		// can't simplify, keep it as is
+		mesh->add_surface(p_mesh->surface_get_primitive_type(i),p_mesh->surface_get_arrays(i));
+		mesh->surface_set_material(i,p_mesh->surface_get_material(i));
+		mesh->surface_set_name(i,p_mesh->surface_get_name(i));
+	}
+
+	return mesh;
+}
+
+void MeshSimplifier::set_max_error(float p_error) {
+
+	max_error=p_error;
+}
+
+float MeshSimplifier::get_max_error() const {
+
+	return max_error;
+}
+
+void MeshSimplifier::_bind_methods() {
+
+	ObjectTypeDB::bind_method(_MD("set_max_error","error"),&MeshSimplifier::set_max_error);
+	ObjectTypeDB::bind_method(_MD("get_max_error"),&MeshSimplifier::get_max_error);
+	ObjectTypeDB::bind_method(_MD("simplify_surface","mesh:Mesh","surface","ratio","to:Mesh"),&MeshSimplifier::simplify_surface);
+	ObjectTypeDB::bind_method(_MD("simplify:Mesh","mesh:Mesh","ratio"),&MeshSimplifier::simplify);
+}
+
+MeshSimplifier::MeshSimplifier() {
+
+	max_error=0.05;
+}
@@ -0,0 +1,59 @@
+/*************************************************************************/
+/*  mesh_simplifier.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include "scene/resources/mesh.h"
+
+/* Reduces the triangle count of a mesh by collapsing edges (cheapest first, using
+ * error quadrics), meant to generate lod levels offline. Vertices are never moved,
+ * a collapse just drops one end of the edge, so normals, uvs and bone weights stay
+ * valid. Borders and uv/normal seams are kept as they are. */
+
+class MeshSimplifier : public Reference {
+
+	OBJ_TYPE(MeshSimplifier,Reference);
+
+	float max_error;
+
+protected:
+
+	static void _bind_methods();
+public:
+
+	void set_max_error(float p_error);
+	float get_max_error() const;
+
+	Error simplify_surface(const Ref<Mesh>& p_mesh,int p_surface,float p_ratio,const Ref<Mesh>& p_to);
+	Ref<Mesh> simplify(const Ref<Mesh>& p_mesh,float p_ratio);
+
+	MeshSimplifier();
+};
+
+#endif // MESH_SIMPLIFIER_H
@@ -103,6 +103,7 @@ void SurfaceTool::add_vertex( const Vector3& p_vertex) {
 	vtx.color=last_color;
 	vtx.normal=last_normal;
 	vtx.uv=last_uv;
+	vtx.uv2=last_uv2;
 	vtx.weights=last_weights;
 	vtx.bones=last_bones;
 	vtx.tangent=last_tangent.normal;
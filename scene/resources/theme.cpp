@@ -32,6 +32,7 @@
 
 
 Ref<Theme> Theme::default_theme;
+uint32_t Theme::version=1;
 
 
 bool Theme::_set(const StringName& p_name, const Variant& p_value) {
@@ -176,6 +177,7 @@ Ref<Theme> Theme::get_default() {
 
 void Theme::set_default_theme_font( const Ref<Font>& p_default_font ) {
 
+	version++;
 	default_theme_font=p_default_font;
 }
 
@@ -186,6 +188,7 @@ Ref<Font> Theme::get_default_theme_font() const {
 
 void Theme::set_default(const Ref<Theme>& p_default) {
 	
+	version++;
 	default_theme=p_default;
 }
 
@@ -196,14 +199,17 @@ Ref<Font> Theme::default_font;
 
 void Theme::set_default_icon( const Ref<Texture>& p_icon ) {
 
+	version++;
 	default_icon=p_icon;
 }
 void Theme::set_default_style( const Ref<StyleBox>& p_style) {
 
+	version++;
 	default_style=p_style;
 }
 void Theme::set_default_font( const Ref<Font>& p_font ) {
 
+	version++;
 	default_font=p_font;
 }
 
@@ -211,6 +217,8 @@ void Theme::set_icon(const StringName& p_name,const StringName& p_type,const Ref
 
 	ERR_FAIL_COND(p_icon.is_null());
 
+	version++;
+
 	bool new_value=!icon_map.has(p_type) || !icon_map[p_type].has(p_name);
 
 	icon_map[p_type][p_name]=p_icon;	
@@ -241,6 +249,8 @@ void Theme::clear_icon(const StringName& p_name,const StringName& p_type) {
 	ERR_FAIL_COND(!icon_map.has(p_type));
 	ERR_FAIL_COND(!icon_map[p_type].has(p_name));
 
+	version++;
+
 	icon_map[p_type].erase(p_name);
 	_change_notify();
 	emit_changed();;
@@ -266,6 +276,8 @@ void Theme::set_stylebox(const StringName& p_name,const StringName& p_type,const
 
 	ERR_FAIL_COND(p_style.is_null());
 
+	version++;
+
 	bool new_value=!style_map.has(p_type) || !style_map[p_type].has(p_name);
 
 	style_map[p_type][p_name]=p_style;
@@ -297,6 +309,8 @@ void Theme::clear_stylebox(const StringName& p_name,const StringName& p_type) {
 	ERR_FAIL_COND(!style_map.has(p_type));
 	ERR_FAIL_COND(!style_map[p_type].has(p_name));
 
+	version++;
+
 	style_map[p_type].erase(p_name);
 	_change_notify();
 	emit_changed();;
@@ -321,6 +335,8 @@ void Theme::set_font(const StringName& p_name,const StringName& p_type,const Ref
 
 	ERR_FAIL_COND(p_font.is_null());
 
+	version++;
+
 	bool new_value=!font_map.has(p_type) || !font_map[p_type].has(p_name);
 	font_map[p_type][p_name]=p_font;
 
@@ -351,6 +367,8 @@ void Theme::clear_font(const StringName& p_name,const StringName& p_type) {
 	ERR_FAIL_COND(!font_map.has(p_type));
 	ERR_FAIL_COND(!font_map[p_type].has(p_name));
 
+	version++;
+
 	font_map[p_type].erase(p_name);
 	_change_notify();
 	emit_changed();;
@@ -373,6 +391,7 @@ void Theme::get_font_list(StringName p_type, List<StringName> *p_list) const {
 
 void Theme::set_color(const StringName& p_name,const StringName& p_type,const Color& p_color) {
 	
+	version++;
 	bool new_value=!color_map.has(p_type) || !color_map[p_type].has(p_name);
 
 	color_map[p_type][p_name]=p_color;
@@ -405,6 +424,8 @@ void Theme::clear_color(const StringName& p_name,const StringName& p_type) {
 	ERR_FAIL_COND(!color_map.has(p_type));
 	ERR_FAIL_COND(!color_map[p_type].has(p_name));
 
+	version++;
+
 	color_map[p_type].erase(p_name);
 	_change_notify();
 	emit_changed();;
@@ -427,6 +448,7 @@ void Theme::get_color_list(StringName p_type, List<StringName> *p_list) const {
 
 void Theme::set_constant(const StringName& p_name,const StringName& p_type,int p_constant) {
 	
+	version++;
 	bool new_value=!constant_map.has(p_type) || !constant_map[p_type].has(p_name);
 	constant_map[p_type][p_name]=p_constant;
 
@@ -456,6 +478,8 @@ void Theme::clear_constant(const StringName& p_name,const StringName& p_type) {
 	ERR_FAIL_COND(!constant_map.has(p_type));
 	ERR_FAIL_COND(!constant_map[p_type].has(p_name));
 
+	version++;
+
 	constant_map[p_type].erase(p_name);
 	_change_notify();
 	emit_changed();;
@@ -479,6 +503,7 @@ void Theme::get_constant_list(StringName p_type, List<StringName> *p_list) const
 
 void Theme::copy_default_theme() {
 
+	version++;
 	Ref<Theme> default_theme=get_default();
 
 	icon_map=default_theme->icon_map;
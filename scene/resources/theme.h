@@ -44,6 +44,7 @@ class Theme : public Resource {
 	RES_BASE_EXTENSION("thm");
 	
 	static Ref<Theme> default_theme;
+	static uint32_t version; //bumped when any theme changes, so controls know when their resolved items are stale
 	
 	HashMap<StringName,HashMap<StringName,Ref<Texture>,StringNameHasher >, StringNameHasher >  icon_map;
 	HashMap<StringName,HashMap<StringName,Ref<StyleBox>,StringNameHasher >,StringNameHasher > style_map;
@@ -73,6 +74,8 @@ public:
 	
 	static Ref<Theme> get_default();
 	static void set_default(const Ref<Theme>& p_default);
+
+	_FORCE_INLINE_ static uint32_t get_version() { return version; }
 	
 	static void set_default_icon( const Ref<Texture>& p_icon );
 	static void set_default_style( const Ref<StyleBox>& p_default_style);
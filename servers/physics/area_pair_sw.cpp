@@ -73,6 +73,7 @@ AreaPairSW::AreaPairSW(BodySW *p_body,int p_body_shape, AreaSW *p_area,int p_are
 	body_shape=p_body_shape;
 	area_shape=p_area_shape;
 	colliding=false;
+	set_serial_setup(true);
 	body->add_constraint(this,0);
 	area->add_constraint(this);
 
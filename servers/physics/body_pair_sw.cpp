@@ -174,6 +174,7 @@ void BodyPairSW::validate_contacts() {
 
 bool BodyPairSW::setup(float p_step) {
 
+	report_deferred=-1;
 
 	offset_B = B->get_transform().get_origin() - A->get_transform().get_origin();
 
@@ -202,6 +203,15 @@ bool BodyPairSW::setup(float p_step) {
 		return false;
 	}
 
+	if (space->is_threaded_setup()) {
+
+		//static bodies are shared between islands, the step reports to them serially afterwards
+		if (A->get_mode()==PhysicsServer::BODY_MODE_STATIC)
+			report_deferred=0;
+		else if (B->get_mode()==PhysicsServer::BODY_MODE_STATIC)
+			report_deferred=1;
+	}
+
 	real_t max_penetration = space->get_contact_max_allowed_penetration();
 
 	float bias = 0.3f;
@@ -256,12 +266,24 @@ bool BodyPairSW::setup(float p_step) {
 
 		if (A->can_report_contacts()) {
 			Vector3 crB = A->get_angular_velocity().cross( c.rA ) + A->get_linear_velocity();
-			A->add_contact(global_A,-c.normal,depth,shape_A,global_B,shape_B,B->get_instance_id(),B->get_self(),crB);
+			if (report_deferred==0) {
+				c.report_A=global_A;
+				c.report_B=global_B;
+				c.report_velocity=crB;
+			} else {
+				A->add_contact(global_A,-c.normal,depth,shape_A,global_B,shape_B,B->get_instance_id(),B->get_self(),crB);
+			}
 		}
 
 		if (B->can_report_contacts()) {
 			Vector3 crA = A->get_angular_velocity().cross( c.rB ) + A->get_linear_velocity();
-			B->add_contact(global_B,c.normal,depth,shape_B,global_A,shape_A,A->get_instance_id(),A->get_self(),crA);
+			if (report_deferred==1) {
+				c.report_A=global_A;
+				c.report_B=global_B;
+				c.report_velocity=crA;
+			} else {
+				B->add_contact(global_B,c.normal,depth,shape_B,global_A,shape_A,A->get_instance_id(),A->get_self(),crA);
+			}
 		}
 
 		c.active=true;
@@ -300,6 +322,28 @@ bool BodyPairSW::setup(float p_step) {
 	return true;
 }
 
+void BodyPairSW::report_deferred_contacts() {
+
+	if (report_deferred==-1)
+		return;
+
+	BodySW *body=_arr[report_deferred];
+	if (!body->can_report_contacts())
+		return;
+
+	for(int i=0;i<contact_count;i++) {
+
+		const Contact &c = contacts[i];
+		if (!c.active)
+			continue;
+
+		if (report_deferred==0)
+			A->add_contact(c.report_A,-c.normal,c.depth,shape_A,c.report_B,shape_B,B->get_instance_id(),B->get_self(),c.report_velocity);
+		else
+			B->add_contact(c.report_B,c.normal,c.depth,shape_B,c.report_A,shape_A,A->get_instance_id(),A->get_self(),c.report_velocity);
+	}
+}
+
 void BodyPairSW::solve(float p_step) {
 
 	if (!collided)
@@ -430,6 +474,7 @@ BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A,BodySW *p_B, int p_shape_B) :
 	B->add_constraint(this,1);
 	contact_count=0;
 	collided=false;
+	report_deferred=-1;
 
 }
 
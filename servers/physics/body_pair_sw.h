@@ -65,6 +65,7 @@ class BodyPairSW : public ConstraintSW {
 		real_t depth;
 		bool active;
 		Vector3 rA,rB;
+		Vector3 report_A,report_B,report_velocity; //kept while the report is deferred
 	};
 
 	Vector3 offset_B; //use local A coordinates to avoid numerical issues on collision detection
@@ -74,6 +75,7 @@ class BodyPairSW : public ConstraintSW {
 	int contact_count;
 	bool collided;
 	int cc;
+	int report_deferred; //body (0 is A, 1 is B) whose contact reports wait for report_deferred_contacts(), or -1
 
 
 	static void _contact_added_callback(const Vector3& p_point_A,const Vector3& p_point_B,void *p_userdata);
@@ -87,6 +89,7 @@ class BodyPairSW : public ConstraintSW {
 public:
 
 	bool setup(float p_step);
+	void report_deferred_contacts();
 	void solve(float p_step);
 
 	BodyPairSW(BodySW *p_A, int p_shape_A,BodySW *p_B, int p_shape_B);
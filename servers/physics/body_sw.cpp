@@ -352,6 +352,12 @@ void BodySW::_compute_area_gravity(const AreaSW *p_area) {
 
 void BodySW::integrate_forces(real_t p_step) {
 
+	integrate_forces_local(p_step);
+	integrate_forces_sync(p_step);
+}
+
+void BodySW::integrate_forces_local(real_t p_step) {
+
 
 	if (mode==PhysicsServer::BODY_MODE_STATIC || mode==PhysicsServer::BODY_MODE_KINEMATIC)
 		return;
@@ -406,24 +412,30 @@ void BodySW::integrate_forces(real_t p_step) {
 	biased_angular_velocity=Vector3();
 	biased_linear_velocity=Vector3();
 
-	if (continuous_cd) //shapes temporarily extend for raycast
-		_update_shapes_with_motion(linear_velocity*p_step);
-
 	current_area=NULL; // clear the area, so it is set in the next frame
 	contact_count=0;
 
 }
 
-void BodySW::integrate_velocities(real_t p_step) {
+void BodySW::integrate_forces_sync(real_t p_step) {
 
-	if (mode==PhysicsServer::BODY_MODE_STATIC)
+	if (mode==PhysicsServer::BODY_MODE_STATIC || mode==PhysicsServer::BODY_MODE_KINEMATIC)
 		return;
 
-	if (mode==PhysicsServer::BODY_MODE_KINEMATIC) {
-		if (fi_callback)
-			get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	if (continuous_cd) //shapes temporarily extend for raycast
+		_update_shapes_with_motion(linear_velocity*p_step);
+}
+
+void BodySW::integrate_velocities(real_t p_step) {
+
+	integrate_velocities_local(p_step);
+	integrate_velocities_sync(p_step);
+}
+
+void BodySW::integrate_velocities_local(real_t p_step) {
+
+	if (mode==PhysicsServer::BODY_MODE_STATIC || mode==PhysicsServer::BODY_MODE_KINEMATIC)
 		return;
-	}
 
 	Vector3 total_angular_velocity = angular_velocity+biased_angular_velocity;
 
@@ -445,11 +457,21 @@ void BodySW::integrate_velocities(real_t p_step) {
 
 	transform.origin+=total_linear_velocity * p_step;
 
-	_set_transform(transform);
+	_set_transform(transform,false);
 	_set_inv_transform(get_transform().inverse());
 
 	_update_inertia_tensor();
 
+}
+
+void BodySW::integrate_velocities_sync(real_t p_step) {
+
+	if (mode==PhysicsServer::BODY_MODE_STATIC)
+		return;
+
+	if (mode!=PhysicsServer::BODY_MODE_KINEMATIC)
+		_update_shapes();
+
 	if (fi_callback) {
 
 		get_space()->body_add_to_state_query_list(&direct_state_query_list);
@@ -173,12 +173,16 @@ public:
 
 	_FORCE_INLINE_ void apply_impulse(const Vector3& p_pos, const Vector3& p_j) {
 
+		if (mode==PhysicsServer::BODY_MODE_STATIC)
+			return; //no effect anyway, and islands solved in parallel share static bodies
 		linear_velocity += p_j * _inv_mass;
 		angular_velocity += _inv_inertia_tensor.xform( p_pos.cross(p_j) );
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector3& p_pos, const Vector3& p_j) {
 
+		if (mode==PhysicsServer::BODY_MODE_STATIC)
+			return;
 		biased_linear_velocity += p_j * _inv_mass;
 		biased_angular_velocity += _inv_inertia_tensor.xform( p_pos.cross(p_j) );
 	}
@@ -230,6 +234,13 @@ public:
 	void integrate_forces(real_t p_step);
 	void integrate_velocities(real_t p_step);
 
+	//split versions for the multithreaded step, the first half only touches the body and can run in any thread,
+	//the second half updates the broadphase and query lists of the space and must be called serially
+	void integrate_forces_local(real_t p_step);
+	void integrate_forces_sync(real_t p_step);
+	void integrate_velocities_local(real_t p_step);
+	void integrate_velocities_sync(real_t p_step);
+
 	void simulate_motion(const Transform& p_xform,real_t p_step);
 	void call_queries();
 	void wakeup_neighbours();
@@ -0,0 +1,622 @@
+/*************************************************************************/
+/*  broad_phase_bvh.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "broad_phase_bvh.h"
+#include "collision_object_sw.h"
+#include "os/memory.h"
+
+
+static _FORCE_INLINE_ real_t _aabb_cost(const AABB& p_aabb) {
+
+	//surface area heuristic
+	const Vector3 &s=p_aabb.size;
+	return (s.x*s.y + s.y*s.z + s.z*s.x)*2.0;
+}
+
+/* TREE */
+
+int BroadPhaseBVH::Tree::alloc_node() {
+
+	if (free_list==-1) {
+
+		int new_capacity=node_capacity?node_capacity*2:64;
+		nodes=(Node*)memrealloc(nodes,sizeof(Node)*new_capacity);
+		for(int i=node_capacity;i<new_capacity;i++) {
+			nodes[i].parent=i+1<new_capacity?i+1:-1;
+			nodes[i].height=-1;
+		}
+		free_list=node_capacity;
+		node_capacity=new_capacity;
+	}
+
+	int idx=free_list;
+	Node &n=nodes[idx];
+	free_list=n.parent;
+	n.parent=-1;
+	n.children[0]=-1;
+	n.children[1]=-1;
+	n.height=0;
+	n.element=0;
+	return idx;
+}
+
+void BroadPhaseBVH::Tree::free_node(int p_node) {
+
+	nodes[p_node].parent=free_list;
+	nodes[p_node].height=-1;
+	free_list=p_node;
+}
+
+void BroadPhaseBVH::Tree::insert_leaf(int p_leaf) {
+
+	if (root==-1) {
+		root=p_leaf;
+		nodes[p_leaf].parent=-1;
+		return;
+	}
+
+	//find the best sibling, descending where the cost of growing the tree is lower
+	AABB leaf_aabb=nodes[p_leaf].aabb;
+	int index=root;
+
+	while(!nodes[index].is_leaf()) {
+
+		const Node &n=nodes[index];
+
+		real_t area=_aabb_cost(n.aabb);
+		real_t combined_area=_aabb_cost(n.aabb.merge(leaf_aabb));
+
+		real_t cost=2.0*combined_area; //make a new parent for this node and the leaf
+		real_t inheritance_cost=2.0*(combined_area-area); //minimum cost of pushing the leaf down
+
+		real_t child_cost[2];
+		for(int i=0;i<2;i++) {
+
+			const Node &c=nodes[n.children[i]];
+			real_t merged=_aabb_cost(c.aabb.merge(leaf_aabb));
+			child_cost[i]=(c.is_leaf()?merged:merged-_aabb_cost(c.aabb))+inheritance_cost;
+		}
+
+		if (cost<child_cost[0] && cost<child_cost[1])
+			break;
+
+		index=child_cost[0]<child_cost[1]?n.children[0]:n.children[1];
+	}
+
+	int sibling=index;
+	int old_parent=nodes[sibling].parent;
+	int new_parent=alloc_node();
+
+	Node &np=nodes[new_parent];
+	np.parent=old_parent;
+	np.aabb=nodes[sibling].aabb.merge(leaf_aabb);
+	np.height=nodes[sibling].height+1;
+	np.children[0]=sibling;
+	np.children[1]=p_leaf;
+
+	if (old_parent!=-1) {
+		Node &op=nodes[old_parent];
+		if (op.children[0]==sibling)
+			op.children[0]=new_parent;
+		else
+			op.children[1]=new_parent;
+	} else {
+		root=new_parent;
+	}
+
+	nodes[sibling].parent=new_parent;
+	nodes[p_leaf].parent=new_parent;
+
+	refit(new_parent);
+}
+
+void BroadPhaseBVH::Tree::remove_leaf(int p_leaf) {
+
+	if (p_leaf==root) {
+		root=-1;
+		return;
+	}
+
+	int parent=nodes[p_leaf].parent;
+	int grand_parent=nodes[parent].parent;
+	int sibling=nodes[parent].children[0]==p_leaf?nodes[parent].children[1]:nodes[parent].children[0];
+
+	if (grand_parent!=-1) {
+
+		Node &gp=nodes[grand_parent];
+		if (gp.children[0]==parent)
+			gp.children[0]=sibling;
+		else
+			gp.children[1]=sibling;
+		nodes[sibling].parent=grand_parent;
+		free_node(parent);
+		refit(grand_parent);
+
+	} else {
+
+		root=sibling;
+		nodes[sibling].parent=-1;
+		free_node(parent);
+	}
+
+	nodes[p_leaf].parent=-1;
+}
+
+void BroadPhaseBVH::Tree::refit(int p_node) {
+
+	//only the path to the root is updated
+	int index=p_node;
+	while(index!=-1) {
+
+		index=balance(index);
+
+		Node &n=nodes[index];
+		const Node &c0=nodes[n.children[0]];
+		const Node &c1=nodes[n.children[1]];
+		n.height=1+MAX(c0.height,c1.height);
+		n.aabb=c0.aabb.merge(c1.aabb);
+
+		index=n.parent;
+	}
+}
+
+int BroadPhaseBVH::Tree::balance(int p_node) {
+
+	//rotate the higher child up if the subtree is unbalanced, returns the new subtree root
+	Node *a=&nodes[p_node];
+	if (a->is_leaf() || a->height<2)
+		return p_node;
+
+	int ib=a->children[0];
+	int ic=a->children[1];
+	Node *b=&nodes[ib];
+	Node *c=&nodes[ic];
+
+	int bal=c->height-b->height;
+
+	if (bal<-1 || bal>1) {
+
+		//rotate 'up' (the higher child) into the place of 'a', 'other' stays as a child of 'a'
+		int up_side=bal>1?1:0;
+		int iu=a->children[up_side];
+		Node *up=&nodes[iu];
+		Node *other=&nodes[a->children[1-up_side]];
+
+		int iu0=up->children[0];
+		int iu1=up->children[1];
+		Node *u0=&nodes[iu0];
+		Node *u1=&nodes[iu1];
+
+		up->children[0]=p_node;
+		up->parent=a->parent;
+		a->parent=iu;
+
+		if (up->parent!=-1) {
+			Node &p=nodes[up->parent];
+			if (p.children[0]==p_node)
+				p.children[0]=iu;
+			else
+				p.children[1]=iu;
+		} else {
+			root=iu;
+		}
+
+		//the higher grandchild stays under 'up', the other one replaces 'up' under 'a'
+		int ikeep,imove;
+		if (u0->height>u1->height) {
+			ikeep=iu0;
+			imove=iu1;
+		} else {
+			ikeep=iu1;
+			imove=iu0;
+		}
+
+		up->children[1]=ikeep;
+		a->children[up_side]=imove;
+		nodes[imove].parent=p_node;
+
+		a->aabb=other->aabb.merge(nodes[imove].aabb);
+		a->height=1+MAX(other->height,nodes[imove].height);
+		up->aabb=a->aabb.merge(nodes[ikeep].aabb);
+		up->height=1+MAX(a->height,nodes[ikeep].height);
+
+		return iu;
+	}
+
+	return p_node;
+}
+
+BroadPhaseBVH::Tree::Tree() {
+
+	nodes=NULL;
+	node_capacity=0;
+	free_list=-1;
+	root=-1;
+}
+
+BroadPhaseBVH::Tree::~Tree() {
+
+	if (nodes)
+		memfree(nodes);
+}
+
+/* BROADPHASE */
+
+void BroadPhaseBVH::_insert(ID p_id,const AABB& p_fat_aabb) {
+
+	Element &e=elements[p_id-1];
+	Tree &tree=_get_tree(e);
+	e.leaf=tree.alloc_node();
+	tree.nodes[e.leaf].aabb=p_fat_aabb;
+	tree.nodes[e.leaf].element=p_id;
+	tree.insert_leaf(e.leaf);
+}
+
+void BroadPhaseBVH::_remove_leaf(ID p_id) {
+
+	Element &e=elements[p_id-1];
+	if (e.leaf==-1)
+		return;
+	Tree &tree=_get_tree(e);
+	tree.remove_leaf(e.leaf);
+	tree.free_node(e.leaf);
+	e.leaf=-1;
+}
+
+void BroadPhaseBVH::_pair(ID p_a,ID p_b) {
+
+	Element &a=elements[p_a-1];
+	Element &b=elements[p_b-1];
+
+	void *data=NULL;
+	if (pair_callback)
+		data=pair_callback(a.owner,a.subindex,b.owner,b.subindex,pair_userdata);
+
+	pair_map.set(_pair_key(p_a,p_b),data);
+	a.paired.push_back(p_b);
+	b.paired.push_back(p_a);
+}
+
+void BroadPhaseBVH::_unpair(ID p_a,ID p_b) {
+
+	Element &a=elements[p_a-1];
+	Element &b=elements[p_b-1];
+
+	uint64_t key=_pair_key(p_a,p_b);
+	void **data=pair_map.getptr(key);
+	ERR_FAIL_COND(!data);
+
+	if (unpair_callback)
+		unpair_callback(a.owner,a.subindex,b.owner,b.subindex,*data,unpair_userdata);
+	pair_map.erase(key);
+
+	int idx=a.paired.find(p_b);
+	a.paired[idx]=a.paired[a.paired.size()-1];
+	a.paired.resize(a.paired.size()-1);
+
+	idx=b.paired.find(p_a);
+	b.paired[idx]=b.paired[b.paired.size()-1];
+	b.paired.resize(b.paired.size()-1);
+}
+
+void BroadPhaseBVH::_pair_moved(ID p_id) {
+
+	Element &e=elements[p_id-1];
+
+	//drop pairs that stopped overlapping
+	for(int i=0;i<e.paired.size();i++) {
+
+		ID other=e.paired[i];
+		const Element &o=elements[other-1];
+		if (!e.aabb.intersects(o.aabb) || (e._static && o._static)) {
+			_unpair(p_id,other);
+			i--;
+		}
+	}
+
+	//and find new ones, static elements only check against the dynamic tree
+	int stack[STACK_SIZE];
+
+	for(int t=0;t<TREE_MAX;t++) {
+
+		if (t==TREE_STATIC && e._static)
+			continue;
+
+		const Tree &tree=trees[t];
+		if (tree.root==-1)
+			continue;
+
+		int sp=0;
+		stack[sp++]=tree.root;
+
+		while(sp) {
+
+			const Node &n=tree.nodes[stack[--sp]];
+			if (!n.aabb.intersects(e.aabb))
+				continue;
+
+			if (!n.is_leaf()) {
+				ERR_CONTINUE(sp+2>STACK_SIZE);
+				stack[sp++]=n.children[0];
+				stack[sp++]=n.children[1];
+				continue;
+			}
+
+			ID other=n.element;
+			if (other==p_id)
+				continue;
+
+			const Element &o=elements[other-1];
+			if (o.owner==e.owner || !o.aabb.intersects(e.aabb))
+				continue;
+
+			if (pair_map.has(_pair_key(p_id,other)))
+				continue;
+
+			_pair(p_id,other);
+		}
+	}
+}
+
+BroadPhaseSW::ID BroadPhaseBVH::create(CollisionObjectSW *p_object, int p_subindex) {
+
+	ID id;
+	if (free_ids.size()) {
+		id=free_ids[free_ids.size()-1];
+		free_ids.resize(free_ids.size()-1);
+	} else {
+		elements.resize(elements.size()+1);
+		id=elements.size();
+	}
+
+	Element &e=elements[id-1];
+	e.owner=p_object;
+	e.subindex=p_subindex;
+	e._static=false;
+	e.aabb=AABB();
+	e.leaf=-1;
+
+	return id;
+}
+
+void BroadPhaseBVH::move(ID p_id, const AABB& p_aabb) {
+
+	ERR_FAIL_INDEX(p_id-1,elements.size());
+	Element &e=elements[p_id-1];
+	ERR_FAIL_COND(!e.owner);
+
+	Vector3 motion=p_aabb.pos-e.aabb.pos;
+	bool first=e.leaf==-1;
+	e.aabb=p_aabb;
+
+	if (!first) {
+
+		Tree &tree=_get_tree(e);
+		if (tree.nodes[e.leaf].aabb.encloses(p_aabb)) {
+			//still inside the fat aabb, the tree is left alone
+			_pair_moved(p_id);
+			return;
+		}
+		_remove_leaf(p_id);
+	}
+
+	AABB fat=p_aabb;
+	if (!e._static) {
+
+		fat.grow_by(p_aabb.get_longest_axis_size()*fat_margin);
+
+		if (!first) {
+			//extend in the direction of motion, so the body can keep going before being reinserted
+			for(int i=0;i<3;i++) {
+				real_t d=motion[i]*2.0;
+				if (d<0)
+					fat.pos[i]+=d;
+				fat.size[i]+=Math::abs(d);
+			}
+		}
+	}
+
+	_insert(p_id,fat);
+	_pair_moved(p_id); //pair right away, like the octree, so contacts are not a step late
+}
+
+void BroadPhaseBVH::set_static(ID p_id, bool p_static) {
+
+	ERR_FAIL_INDEX(p_id-1,elements.size());
+	Element &e=elements[p_id-1];
+	ERR_FAIL_COND(!e.owner);
+
+	if (e._static==p_static)
+		return;
+
+	bool had_leaf=e.leaf!=-1;
+	_remove_leaf(p_id);
+	e._static=p_static;
+
+	if (had_leaf) {
+		_insert(p_id,e.aabb);
+		_pair_moved(p_id);
+	}
+}
+
+void BroadPhaseBVH::remove(ID p_id) {
+
+	ERR_FAIL_INDEX(p_id-1,elements.size());
+	Element &e=elements[p_id-1];
+	ERR_FAIL_COND(!e.owner);
+
+	while(e.paired.size())
+		_unpair(p_id,e.paired[e.paired.size()-1]);
+
+	_remove_leaf(p_id);
+	e.owner=NULL;
+	free_ids.push_back(p_id);
+}
+
+CollisionObjectSW *BroadPhaseBVH::get_object(ID p_id) const {
+
+	ERR_FAIL_INDEX_V(p_id-1,elements.size(),NULL);
+	const Element &e=elements[p_id-1];
+	ERR_FAIL_COND_V(!e.owner,NULL);
+	return e.owner;
+}
+
+bool BroadPhaseBVH::is_static(ID p_id) const {
+
+	ERR_FAIL_INDEX_V(p_id-1,elements.size(),false);
+	return elements[p_id-1]._static;
+}
+
+int BroadPhaseBVH::get_subindex(ID p_id) const {
+
+	ERR_FAIL_INDEX_V(p_id-1,elements.size(),-1);
+	return elements[p_id-1].subindex;
+}
+
+int BroadPhaseBVH::cull_segment(const Vector3& p_from, const Vector3& p_to,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices) {
+
+	int count=0;
+	int stack[STACK_SIZE];
+
+	for(int t=0;t<TREE_MAX;t++) {
+
+		const Tree &tree=trees[t];
+		if (tree.root==-1)
+			continue;
+
+		int sp=0;
+		stack[sp++]=tree.root;
+
+		while(sp) {
+
+			const Node &n=tree.nodes[stack[--sp]];
+			if (!n.aabb.intersects_segment(p_from,p_to))
+				continue;
+
+			if (!n.is_leaf()) {
+				ERR_CONTINUE(sp+2>STACK_SIZE);
+				stack[sp++]=n.children[0];
+				stack[sp++]=n.children[1];
+				continue;
+			}
+
+			const Element &e=elements[n.element-1];
+			if (!e.aabb.intersects_segment(p_from,p_to))
+				continue;
+
+			if (count>=p_max_results)
+				return count;
+
+			p_results[count]=e.owner;
+			if (p_result_indices)
+				p_result_indices[count]=e.subindex;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+int BroadPhaseBVH::cull_aabb(const AABB& p_aabb,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices) {
+
+	int count=0;
+	int stack[STACK_SIZE];
+
+	for(int t=0;t<TREE_MAX;t++) {
+
+		const Tree &tree=trees[t];
+		if (tree.root==-1)
+			continue;
+
+		int sp=0;
+		stack[sp++]=tree.root;
+
+		while(sp) {
+
+			const Node &n=tree.nodes[stack[--sp]];
+			if (!n.aabb.intersects(p_aabb))
+				continue;
+
+			if (!n.is_leaf()) {
+				ERR_CONTINUE(sp+2>STACK_SIZE);
+				stack[sp++]=n.children[0];
+				stack[sp++]=n.children[1];
+				continue;
+			}
+
+			const Element &e=elements[n.element-1];
+			if (!e.aabb.intersects(p_aabb))
+				continue;
+
+			if (count>=p_max_results)
+				return count;
+
+			p_results[count]=e.owner;
+			if (p_result_indices)
+				p_result_indices[count]=e.subindex;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+void BroadPhaseBVH::set_pair_callback(PairCallback p_pair_callback,void *p_userdata) {
+
+	pair_callback=p_pair_callback;
+	pair_userdata=p_userdata;
+}
+
+void BroadPhaseBVH::set_unpair_callback(UnpairCallback p_unpair_callback,void *p_userdata) {
+
+	unpair_callback=p_unpair_callback;
+	unpair_userdata=p_userdata;
+}
+
+void BroadPhaseBVH::update() {
+
+	//pairs are kept up to date in move() and set_static()
+}
+
+BroadPhaseSW *BroadPhaseBVH::_create() {
+
+	return memnew( BroadPhaseBVH );
+}
+
+BroadPhaseBVH::BroadPhaseBVH() {
+
+	fat_margin=0.1;
+	pair_callback=NULL;
+	pair_userdata=NULL;
+	unpair_callback=NULL;
+	unpair_userdata=NULL;
+}
+
+BroadPhaseBVH::~BroadPhaseBVH() {
+
+}
@@ -0,0 +1,141 @@
+/*************************************************************************/
+/*  broad_phase_bvh.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef BROAD_PHASE_BVH_H
+#define BROAD_PHASE_BVH_H
+
+#include "broad_phase_sw.h"
+#include "hash_map.h"
+#include "vector.h"
+
+/**
+ * Broadphase using two dynamic AABB trees, one for static and one for
+ * moving elements, so static vs static is never tested. Leaves in the
+ * dynamic tree hold a fattened AABB, so small motions don't touch the
+ * tree at all, and larger ones reinsert the leaf and refit only the path
+ * to the root. Pairs are updated as soon as an element moves, like the
+ * octree broadphase does.
+ */
+
+class BroadPhaseBVH : public BroadPhaseSW {
+
+	enum {
+		TREE_DYNAMIC,
+		TREE_STATIC,
+		TREE_MAX,
+		STACK_SIZE=256 //node heights are kept balanced, this is never reached
+	};
+
+	struct Node {
+
+		AABB aabb;
+		int parent; //also next in free list
+		int children[2];
+		int height;
+		ID element;
+
+		_FORCE_INLINE_ bool is_leaf() const { return children[0]==-1; }
+	};
+
+	struct Tree {
+
+		Node *nodes;
+		int node_capacity;
+		int free_list;
+		int root;
+
+		int alloc_node();
+		void free_node(int p_node);
+		void insert_leaf(int p_leaf);
+		void remove_leaf(int p_leaf);
+		int balance(int p_node);
+		void refit(int p_node);
+
+		Tree();
+		~Tree();
+	};
+
+	struct Element {
+
+		CollisionObjectSW *owner;
+		int subindex;
+		bool _static;
+		AABB aabb;
+		int leaf;
+		Vector<ID> paired;
+	};
+
+	Tree trees[TREE_MAX];
+
+	Vector<Element> elements;
+	Vector<ID> free_ids;
+
+	HashMap<uint64_t,void*> pair_map;
+
+	real_t fat_margin;
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
+
+	_FORCE_INLINE_ static uint64_t _pair_key(ID p_a,ID p_b) { return p_a<p_b ? (uint64_t(p_a)<<32)|p_b : (uint64_t(p_b)<<32)|p_a; }
+	_FORCE_INLINE_ Tree& _get_tree(const Element& p_elem) { return trees[p_elem._static?TREE_STATIC:TREE_DYNAMIC]; }
+
+	void _insert(ID p_id,const AABB& p_fat_aabb);
+	void _remove_leaf(ID p_id);
+	void _pair(ID p_a,ID p_b);
+	void _unpair(ID p_a,ID p_b);
+	void _pair_moved(ID p_id);
+
+public:
+
+	// 0 is an invalid ID
+	virtual ID create(CollisionObjectSW *p_object_, int p_subindex=0);
+	virtual void move(ID p_id, const AABB& p_aabb);
+	virtual void set_static(ID p_id, bool p_static);
+	virtual void remove(ID p_id);
+
+	virtual CollisionObjectSW *get_object(ID p_id) const;
+	virtual bool is_static(ID p_id) const;
+	virtual int get_subindex(ID p_id) const;
+
+	virtual int cull_segment(const Vector3& p_from, const Vector3& p_to,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices=NULL);
+	virtual int cull_aabb(const AABB& p_aabb,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices=NULL);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback,void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback,void *p_userdata);
+
+	virtual void update();
+
+	static BroadPhaseSW *_create();
+	BroadPhaseBVH();
+	~BroadPhaseBVH();
+};
+
+#endif // BROAD_PHASE_BVH_H
@@ -29,6 +29,8 @@
 #include "physics_server_sw.h"
 #include "broad_phase_basic.h"
 #include "broad_phase_octree.h"
+#include "broad_phase_bvh.h"
+#include "globals.h"
 
 RID PhysicsServerSW::shape_create(ShapeType p_shape) {
 
@@ -131,6 +133,8 @@ RID PhysicsServerSW::space_create() {
 	SpaceSW *space = memnew( SpaceSW );
 	RID id = space_owner.make_rid(space);
 	space->set_self(id);
+	space->set_work_pool(stepper->get_work_pool());
+	space->set_shape_owner(&shape_owner);
 	RID area_id = area_create();
 	AreaSW *area = area_owner.get(area_id);
 	ERR_FAIL_COND_V(!area,RID());
@@ -985,7 +989,16 @@ void PhysicsServerSW::init() {
 	doing_sync=true;
 	last_step=0.001;
 	iterations=8;// 8?
+
+	String broad_phase=GLOBAL_DEF("physics/broad_phase","octree");
+	Globals::get_singleton()->set_custom_property_info("physics/broad_phase",PropertyInfo(Variant::STRING,"physics/broad_phase",PROPERTY_HINT_ENUM,"octree,bvh,basic"));
+	if (broad_phase=="bvh")
+		BroadPhaseSW::create_func=BroadPhaseBVH::_create;
+	else if (broad_phase=="basic")
+		BroadPhaseSW::create_func=BroadPhaseBasic::_create;
+
 	stepper = memnew( StepSW );
+	stepper->set_thread_count(GLOBAL_DEF("physics/thread_count",1));
 	direct_state = memnew( PhysicsDirectBodyStateSW );
 };
 
@@ -0,0 +1,156 @@
+/*************************************************************************/
+/*  physics_server_wrap_mt.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "physics_server_wrap_mt.h"
+#include "os/os.h"
+
+void PhysicsServerWrapMT::thread_exit() {
+
+	exit=true;
+}
+
+void PhysicsServerWrapMT::thread_step(float p_step) {
+
+	physics_server->step(p_step);
+}
+
+void PhysicsServerWrapMT::thread_sync() {
+
+	//nothing to do, pushing it and waiting for it is enough
+}
+
+void PhysicsServerWrapMT::_sync_step() const {
+
+	command_queue.push_and_sync( const_cast<PhysicsServerWrapMT*>(this), &PhysicsServerWrapMT::thread_sync);
+	stepping=false;
+}
+
+void PhysicsServerWrapMT::_thread_callback(void *_instance) {
+
+	PhysicsServerWrapMT *psmt = reinterpret_cast<PhysicsServerWrapMT*>(_instance);
+
+	psmt->thread_loop();
+}
+
+void PhysicsServerWrapMT::thread_loop() {
+
+	server_thread=Thread::get_caller_ID();
+
+	exit=false;
+	step_thread_up=true;
+	while(!exit) {
+		// flush commands one by one, until exit is requested
+		command_queue.wait_and_flush_one();
+	}
+
+	command_queue.flush_all(); // flush all
+}
+
+/* EVENT QUEUING */
+
+void PhysicsServerWrapMT::step(float p_step) {
+
+	if (create_thread) {
+
+		stepping=true;
+		command_queue.push( this, &PhysicsServerWrapMT::thread_step,p_step);
+	} else {
+
+		command_queue.flush_all(); //flush all pending from other threads
+		physics_server->step(p_step);
+	}
+}
+
+void PhysicsServerWrapMT::sync() {
+
+	if (create_thread) {
+
+		if (stepping)
+			_sync_step();
+	} else {
+
+		command_queue.flush_all(); //flush all pending from other threads
+	}
+
+	physics_server->sync();
+}
+
+void PhysicsServerWrapMT::flush_queries() {
+
+	_wait_step();
+	physics_server->flush_queries();
+}
+
+void PhysicsServerWrapMT::init() {
+
+	physics_server->init();
+
+	if (create_thread) {
+
+		thread = Thread::create( _thread_callback, this );
+		while(!step_thread_up) {
+			OS::get_singleton()->delay_usec(1000);
+		}
+	}
+}
+
+void PhysicsServerWrapMT::finish() {
+
+	if (thread) {
+
+		command_queue.push( this, &PhysicsServerWrapMT::thread_exit);
+		Thread::wait_to_finish( thread );
+		memdelete(thread);
+		thread=NULL;
+		stepping=false;
+	}
+
+	physics_server->finish();
+}
+
+
+PhysicsServerWrapMT::PhysicsServerWrapMT(PhysicsServer* p_contained,bool p_create_thread) : command_queue(p_create_thread) {
+
+	physics_server=p_contained;
+	create_thread=p_create_thread;
+	thread=NULL;
+	step_thread_up=false;
+	stepping=false;
+	exit=false;
+	if (!p_create_thread) {
+		server_thread=Thread::get_caller_ID();
+	} else {
+		server_thread=0;
+	}
+}
+
+
+PhysicsServerWrapMT::~PhysicsServerWrapMT() {
+
+	memdelete(physics_server);
+}
@@ -0,0 +1,217 @@
+/*************************************************************************/
+/*  physics_server_wrap_mt.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef PHYSICS_SERVER_WRAP_MT_H
+#define PHYSICS_SERVER_WRAP_MT_H
+
+#include "servers/physics_server.h"
+#include "servers/physics_wrap_mt_common.h"
+#include "command_queue_mt.h"
+#include "os/thread.h"
+
+/**
+ * Runs PhysicsServer::step() in its own thread, so it overlaps idle and drawing.
+ * step() hands the step to the thread and returns. Until sync(), setters are queued
+ * and run after the step, in order, while any call returning data (including the
+ * direct space state) waits for the thread to finish first. After that the server is
+ * used directly again until the next step, so direct states obtained then stay valid.
+ * Force integration and state callbacks are not affected, they are still called from
+ * flush_queries() in the main thread, after sync().
+ */
+
+class PhysicsServerWrapMT : public PhysicsServer {
+
+	// the real physics server
+	mutable PhysicsServer *physics_server;
+
+	mutable CommandQueueMT command_queue;
+
+	static void _thread_callback(void *_instance);
+	void thread_loop();
+
+	Thread::ID server_thread;
+	volatile bool exit;
+	Thread *thread;
+	volatile bool step_thread_up;
+	bool create_thread;
+
+	mutable bool stepping; // only changed from the thread calling step() and sync()
+
+	void thread_step(float p_step);
+	void thread_sync();
+	void thread_exit();
+
+	void _sync_step() const;
+
+	_FORCE_INLINE_ bool _must_queue() const { return Thread::get_caller_ID()!=server_thread && stepping; }
+	_FORCE_INLINE_ void _wait_step() const { if (_must_queue()) _sync_step(); }
+
+public:
+
+#define server_name physics_server
+#define ServerName PhysicsServer
+
+	/* SHAPE API */
+
+	PFUNC1R(RID,shape_create,ShapeType);
+	PFUNC2(shape_set_data,RID,const Variant&);
+	PFUNC2(shape_set_custom_solver_bias,RID,real_t);
+
+	PFUNC1RC(ShapeType,shape_get_type,RID);
+	PFUNC1RC(Variant,shape_get_data,RID);
+	PFUNC1RC(real_t,shape_get_custom_solver_bias,RID);
+
+	/* SPACE API */
+
+	PFUNC0R(RID,space_create);
+	PFUNC2(space_set_active,RID,bool);
+	PFUNC1RC(bool,space_is_active,RID);
+
+	PFUNC3(space_set_param,RID,SpaceParameter,real_t);
+	PFUNC2RC(real_t,space_get_param,RID,SpaceParameter);
+
+	// this returns a pointer, the caller must only use it until the next step
+	PFUNC1R(PhysicsDirectSpaceState*,space_get_direct_state,RID);
+
+	/* AREA API */
+
+	PFUNC0R(RID,area_create);
+
+	PFUNC2(area_set_space,RID,RID);
+	PFUNC1RC(RID,area_get_space,RID);
+
+	PFUNC2(area_set_space_override_mode,RID,AreaSpaceOverrideMode);
+	PFUNC1RC(AreaSpaceOverrideMode,area_get_space_override_mode,RID);
+
+	PFUNC3(area_add_shape,RID,RID,const Transform&);
+	PFUNC3(area_set_shape,RID,int,RID);
+	PFUNC3(area_set_shape_transform,RID,int,const Transform&);
+
+	PFUNC1RC(int,area_get_shape_count,RID);
+	PFUNC2RC(RID,area_get_shape,RID,int);
+	PFUNC2RC(Transform,area_get_shape_transform,RID,int);
+
+	PFUNC2(area_remove_shape,RID,int);
+	PFUNC1(area_clear_shapes,RID);
+
+	PFUNC2(area_attach_object_instance_ID,RID,ObjectID);
+	PFUNC1RC(ObjectID,area_get_object_instance_ID,RID);
+
+	PFUNC3(area_set_param,RID,AreaParameter,const Variant&);
+	PFUNC2(area_set_transform,RID,const Transform&);
+
+	PFUNC2RC(Variant,area_get_param,RID,AreaParameter);
+	PFUNC1RC(Transform,area_get_transform,RID);
+
+	PFUNC3(area_set_monitor_callback,RID,Object*,const StringName&);
+
+	/* BODY API */
+
+	PFUNC2R(RID,body_create,BodyMode,bool);
+
+	PFUNC2(body_set_space,RID,RID);
+	PFUNC1RC(RID,body_get_space,RID);
+
+	PFUNC2(body_set_mode,RID,BodyMode);
+	PFUNC2RC(BodyMode,body_get_mode,RID,BodyMode);
+
+	PFUNC3(body_add_shape,RID,RID,const Transform&);
+	PFUNC3(body_set_shape,RID,int,RID);
+	PFUNC3(body_set_shape_transform,RID,int,const Transform&);
+
+	PFUNC1RC(int,body_get_shape_count,RID);
+	PFUNC2RC(RID,body_get_shape,RID,int);
+	PFUNC2RC(Transform,body_get_shape_transform,RID,int);
+
+	PFUNC3(body_set_shape_as_trigger,RID,int,bool);
+	PFUNC2RC(bool,body_is_shape_set_as_trigger,RID,int);
+
+	PFUNC2(body_remove_shape,RID,int);
+	PFUNC1(body_clear_shapes,RID);
+
+	PFUNC2(body_attach_object_instance_ID,RID,uint32_t);
+	PFUNC1RC(uint32_t,body_get_object_instance_ID,RID);
+
+	PFUNC2(body_set_enable_continuous_collision_detection,RID,bool);
+	PFUNC1RC(bool,body_is_continuous_collision_detection_enabled,RID);
+
+	PFUNC2(body_set_user_flags,RID,uint32_t);
+	PFUNC2RC(uint32_t,body_get_user_flags,RID,uint32_t);
+
+	PFUNC3(body_set_param,RID,BodyParameter,float);
+	PFUNC2RC(float,body_get_param,RID,BodyParameter);
+
+	PFUNC2(body_static_simulate_motion,RID,const Transform&);
+
+	PFUNC3(body_set_state,RID,BodyState,const Variant&);
+	PFUNC2RC(Variant,body_get_state,RID,BodyState);
+
+	PFUNC2(body_set_applied_force,RID,const Vector3&);
+	PFUNC1RC(Vector3,body_get_applied_force,RID);
+
+	PFUNC2(body_set_applied_torque,RID,const Vector3&);
+	PFUNC1RC(Vector3,body_get_applied_torque,RID);
+
+	PFUNC3(body_apply_impulse,RID,const Vector3&,const Vector3&);
+	PFUNC2(body_set_axis_velocity,RID,const Vector3&);
+
+	PFUNC2(body_add_collision_exception,RID,RID);
+	PFUNC2(body_remove_collision_exception,RID,RID);
+	PFUNC2S(body_get_collision_exceptions,RID,List<RID>*);
+
+	PFUNC2(body_set_max_contacts_reported,RID,int);
+	PFUNC1RC(int,body_get_max_contacts_reported,RID);
+
+	PFUNC2(body_set_contacts_reported_depth_treshold,RID,float);
+	PFUNC1RC(float,body_get_contacts_reported_depth_treshold,RID);
+
+	PFUNC2(body_set_omit_force_integration,RID,bool);
+	PFUNC1RC(bool,body_is_omitting_force_integration,RID);
+
+	PFUNC4(body_set_force_integration_callback,RID,Object*,const StringName&,const Variant&);
+
+	/* MISC */
+
+	PFUNC1(free,RID);
+	PFUNC1(set_active,bool);
+
+	virtual void init();
+	virtual void step(float p_step);
+	virtual void sync();
+	virtual void flush_queries();
+	virtual void finish();
+
+#undef server_name
+#undef ServerName
+
+	PhysicsServerWrapMT(PhysicsServer* p_contained,bool p_create_thread);
+	~PhysicsServerWrapMT();
+
+};
+
+#endif
@@ -29,12 +29,10 @@
 #include "space_sw.h"
 #include "collision_solver_sw.h"
 #include "physics_server_sw.h"
+#include "sort.h"
 
 
-bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3& p_from, const Vector3& p_to,RayResult &r_result,const Set<RID>& p_exclude,uint32_t p_user_mask) {
-
-
-	ERR_FAIL_COND_V(space->locked,false);
+bool PhysicsDirectSpaceStateSW::_intersect_ray_candidates(const Vector3& p_from, const Vector3& p_to,CollisionObjectSW **p_objects,const int *p_subindices,int p_amount,bool p_test_aabb,const Set<RID>& p_exclude,RayHit &r_hit) {
 
 	Vector3 begin,end;
 	Vector3 normal;
@@ -42,30 +40,27 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3& p_from, const Vecto
 	end=p_to;
 	normal=(end-begin).normalized();
 
-
-	int amount = space->broadphase->cull_segment(begin,end,space->intersection_query_results,SpaceSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
-
-
 	//todo, create another array tha references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided=false;
-	Vector3 res_point,res_normal;
-	int res_shape;
-	const CollisionObjectSW *res_obj;
 	real_t min_d=1e10;
 
 
-	for(int i=0;i<amount;i++) {
+	for(int i=0;i<p_amount;i++) {
 
-		if (space->intersection_query_results[i]->get_type()==CollisionObjectSW::TYPE_AREA)
+		if (p_objects[i]->get_type()==CollisionObjectSW::TYPE_AREA)
 			continue; //ignore area
 
-		if (p_exclude.has( space->intersection_query_results[i]->get_self()))
+		if (p_exclude.has( p_objects[i]->get_self()))
 			continue;
 
-		const CollisionObjectSW *col_obj=space->intersection_query_results[i];
+		const CollisionObjectSW *col_obj=p_objects[i];
+
+		int shape_idx=p_subindices[i];
+
+		if (p_test_aabb && !col_obj->get_shape_aabb(shape_idx).intersects_segment(begin,end))
+			continue;
 
-		int shape_idx=space->intersection_query_subindex_results[i];
 		Transform inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -86,39 +81,213 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3& p_from, const Vecto
 			if (ld<min_d) {
 
 				min_d=ld;
-				res_point=shape_point;
-				res_normal=inv_xform.basis.xform_inv(shape_normal).normalized();
-				res_shape=shape_idx;
-				res_obj=col_obj;
+				r_hit.position=shape_point;
+				r_hit.normal=inv_xform.basis.xform_inv(shape_normal).normalized();
+				r_hit.shape=shape_idx;
+				r_hit.object=col_obj;
 				collided=true;
 			}
 		}
 
 	}
 
-	if (!collided)
+	return collided;
+}
+
+bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3& p_from, const Vector3& p_to,RayResult &r_result,const Set<RID>& p_exclude,uint32_t p_user_mask) {
+
+
+	ERR_FAIL_COND_V(space->locked,false);
+
+	int amount = space->broadphase->cull_segment(p_from,p_to,space->intersection_query_results,SpaceSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
+
+	RayHit hit;
+	if (!_intersect_ray_candidates(p_from,p_to,space->intersection_query_results,space->intersection_query_subindex_results,amount,false,p_exclude,hit))
 		return false;
 
 
-	r_result.collider_id=res_obj->get_instance_id();
+	r_result.collider_id=hit.object->get_instance_id();
 	if (r_result.collider_id!=0)
 		r_result.collider=ObjectDB::get_instance(r_result.collider_id);
-	r_result.normal=res_normal;
-	r_result.position=res_point;
-	r_result.rid=res_obj->get_self();
-	r_result.shape=res_shape;
+	r_result.normal=hit.normal;
+	r_result.position=hit.position;
+	r_result.rid=hit.object->get_self();
+	r_result.shape=hit.shape;
 
 	return true;
 
 }
 
+static _FORCE_INLINE_ uint32_t _morton_spread_3(uint32_t p_val) {
+
+	uint32_t x=p_val&0x3FF;
+	x = (x | (x << 16)) & 0x030000FF;
+	x = (x | (x << 8)) & 0x0300F00F;
+	x = (x | (x << 4)) & 0x030C30C3;
+	x = (x | (x << 2)) & 0x09249249;
+	return x;
+}
+
+struct PhysicsDirectSpaceStateSW::IntersectRaysWork {
+
+	const PhysicsDirectSpaceState::RayQuery *queries;
+	const SpaceSW::RayBatchItem *items;
+	CollisionObjectSW **objects;
+	const int *subindices;
+	const Set<RID> *exclude;
+	PhysicsDirectSpaceStateSW::RayHit *hits;
+	bool *hit;
+};
+
+void PhysicsDirectSpaceStateSW::_intersect_rays_work(void *p_userdata,int p_index) {
+
+	IntersectRaysWork *work = (IntersectRaysWork*)p_userdata;
+	const SpaceSW::RayBatchItem &item = work->items[p_index];
+	const RayQuery &q = work->queries[item.query];
+
+	work->hit[item.query]=_intersect_ray_candidates(q.from,q.to,&work->objects[item.from],&work->subindices[item.from],item.amount,item.shared,*work->exclude,work->hits[item.query]);
+}
+
+int PhysicsDirectSpaceStateSW::intersect_rays(const RayQuery *p_queries,int p_query_count,RayResult *r_results,bool *r_hits,const Set<RID>& p_exclude,uint32_t p_user_mask) {
+
+	ERR_FAIL_COND_V(space->locked,0);
+
+	if (p_query_count<=0)
+		return 0;
+
+	/* sort rays along a morton curve through their midpoints, so rays close
+	   to each other land in the same group and share one broadphase query */
+
+	AABB bounds;
+	for(int i=0;i<p_query_count;i++) {
+
+		Vector3 mid = (p_queries[i].from+p_queries[i].to)*0.5;
+		if (i==0)
+			bounds=AABB(mid,Vector3());
+		else
+			bounds.expand_to(mid);
+	}
+
+	Vector3 scale;
+	for(int i=0;i<3;i++)
+		scale[i] = bounds.size[i]>0 ? 1023.0/bounds.size[i] : 0;
+
+	space->ray_batch.resize(p_query_count);
+	space->ray_batch_hits.resize(p_query_count);
+	SpaceSW::RayBatchItem *items = space->ray_batch.ptr();
+
+	for(int i=0;i<p_query_count;i++) {
+
+		Vector3 c = ((p_queries[i].from+p_queries[i].to)*0.5-bounds.pos)*scale;
+		items[i].key=_morton_spread_3(c.x)|(_morton_spread_3(c.y)<<1)|(_morton_spread_3(c.z)<<2);
+		items[i].query=i;
+	}
+
+	SortArray<SpaceSW::RayBatchItem> sorter;
+	sorter.sort(items,p_query_count);
+
+	/* broadphase, done serially as culling is not reentrant */
+
+	int candidate_count=0;
+
+	for(int g=0;g<p_query_count;g+=SpaceSW::RAY_BATCH_GROUP) {
+
+		int group_end=MIN(g+SpaceSW::RAY_BATCH_GROUP,p_query_count);
+
+		AABB group_aabb;
+		real_t longest=0;
+		for(int i=g;i<group_end;i++) {
+
+			const RayQuery &q=p_queries[items[i].query];
+			AABB ray_aabb(q.from,Vector3());
+			ray_aabb.expand_to(q.to);
+			longest=MAX(longest,ray_aabb.get_longest_axis_size());
+			if (i==g)
+				group_aabb=ray_aabb;
+			else
+				group_aabb.merge_with(ray_aabb);
+		}
+
+		int amount=-1;
+
+		//only share the query if the group is about as compact as its rays
+		if (group_end-g>1 && group_aabb.get_longest_axis_size()<=longest*2.0) {
+
+			amount = space->broadphase->cull_aabb(group_aabb,space->intersection_query_results,SpaceSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
+			if (amount==SpaceSW::INTERSECTION_QUERY_MAX)
+				amount=-1; //overflowed, query rays one by one
+			else
+				space->_ray_batch_add_candidates(amount,candidate_count);
+		}
+
+		for(int i=g;i<group_end;i++) {
+
+			if (amount>=0) {
+
+				items[i].from=candidate_count-amount;
+				items[i].amount=amount;
+				items[i].shared=true;
+			} else {
+
+				const RayQuery &q=p_queries[items[i].query];
+				int ray_amount = space->broadphase->cull_segment(q.from,q.to,space->intersection_query_results,SpaceSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
+				space->_ray_batch_add_candidates(ray_amount,candidate_count);
+				items[i].from=candidate_count-ray_amount;
+				items[i].amount=ray_amount;
+				items[i].shared=false;
+			}
+		}
+	}
+
+	/* narrow phase, can go wide */
+
+	IntersectRaysWork work;
+	work.queries=p_queries;
+	work.items=items;
+	work.objects=space->ray_batch_objects.ptr();
+	work.subindices=space->ray_batch_subindices.ptr();
+	work.exclude=&p_exclude;
+	work.hits=space->ray_batch_hits.ptr();
+	work.hit=r_hits;
+
+	if (space->work_pool && space->work_pool->is_threaded() && p_query_count>=SpaceSW::RAY_BATCH_THREAD_MIN) {
+
+		space->work_pool->do_work(p_query_count,_intersect_rays_work,&work);
+	} else {
+
+		for(int i=0;i<p_query_count;i++)
+			_intersect_rays_work(&work,i);
+	}
+
+	int hits=0;
+
+	for(int i=0;i<p_query_count;i++) {
+
+		if (!r_hits[i])
+			continue;
+
+		const RayHit &hit=work.hits[i];
+		RayResult &r_result=r_results[i];
+
+		r_result.collider_id=hit.object->get_instance_id();
+		r_result.collider = r_result.collider_id!=0 ? ObjectDB::get_instance(r_result.collider_id) : NULL;
+		r_result.normal=hit.normal;
+		r_result.position=hit.position;
+		r_result.rid=hit.object->get_self();
+		r_result.shape=hit.shape;
+		hits++;
+	}
+
+	return hits;
+}
+
 
 int PhysicsDirectSpaceStateSW::intersect_shape(const RID& p_shape, const Transform& p_xform,ShapeResult *r_results,int p_result_max,const Set<RID>& p_exclude,uint32_t p_user_mask) {
 
 	if (p_result_max<=0)
 		return 0;
 
-	ShapeSW *shape = static_cast<PhysicsServerSW*>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
+	ShapeSW *shape = space->shape_owner->get(p_shape);
 	ERR_FAIL_COND_V(!shape,0);
 
 	AABB aabb = p_xform.xform(shape->get_aabb());
@@ -390,6 +559,27 @@ bool SpaceSW::is_locked() const {
 	return locked;
 }
 
+void SpaceSW::_ray_batch_add_candidates(int p_amount,int &r_count) {
+
+	if (r_count+p_amount > ray_batch_objects.size()) {
+
+		int size = nearest_power_of_2(r_count+p_amount);
+		ray_batch_objects.resize(size);
+		ray_batch_subindices.resize(size);
+	}
+
+	CollisionObjectSW **objects = ray_batch_objects.ptr();
+	int *subindices = ray_batch_subindices.ptr();
+
+	for(int i=0;i<p_amount;i++) {
+
+		objects[r_count+i]=intersection_query_results[i];
+		subindices[r_count+i]=intersection_query_subindex_results[i];
+	}
+
+	r_count+=p_amount;
+}
+
 PhysicsDirectSpaceStateSW *SpaceSW::get_direct_state() {
 
 	return direct_access;
@@ -399,6 +589,9 @@ SpaceSW::SpaceSW() {
 
 
 	locked=false;
+	threaded_setup=false;
+	work_pool=NULL;
+	shape_owner=NULL;
 	contact_recycle_radius=0.01;
 	contact_max_separation=0.05;
 	contact_max_allowed_penetration= 0.01;
@@ -37,16 +37,35 @@
 #include "area_pair_sw.h"
 #include "broad_phase_sw.h"
 #include "collision_object_sw.h"
+#include "os/thread_work_pool.h"
 
 
 class PhysicsDirectSpaceStateSW : public PhysicsDirectSpaceState {
 
 	OBJ_TYPE( PhysicsDirectSpaceStateSW, PhysicsDirectSpaceState );
+public:
+
+	struct RayHit {
+
+		Vector3 position;
+		Vector3 normal;
+		const CollisionObjectSW *object;
+		int shape;
+	};
+
+private:
+
+	struct IntersectRaysWork;
+
+	static bool _intersect_ray_candidates(const Vector3& p_from, const Vector3& p_to,CollisionObjectSW **p_objects,const int *p_subindices,int p_amount,bool p_test_aabb,const Set<RID>& p_exclude,RayHit &r_hit);
+	static void _intersect_rays_work(void *p_userdata,int p_index);
+
 public:
 
 	SpaceSW *space;
 
 	bool intersect_ray(const Vector3& p_from, const Vector3& p_to,RayResult &r_result,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0);
+	int intersect_rays(const RayQuery *p_queries,int p_query_count,RayResult *r_results,bool *r_hits,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0);
 	int intersect_shape(const RID& p_shape, const Transform& p_xform,ShapeResult *r_results,int p_result_max,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0);
 
 	PhysicsDirectSpaceStateSW();
@@ -81,18 +100,43 @@ class SpaceSW {
 
 	enum {
 
-		INTERSECTION_QUERY_MAX=2048
+		INTERSECTION_QUERY_MAX=2048,
+		RAY_BATCH_GROUP=16, //rays sharing one broadphase query
+		RAY_BATCH_THREAD_MIN=64 //don't wake up the workers for less
 	};
 
 	CollisionObjectSW *intersection_query_results[INTERSECTION_QUERY_MAX];
 	int intersection_query_subindex_results[INTERSECTION_QUERY_MAX];
 
+	//batched ray queries, kept between calls so they don't reallocate
+	struct RayBatchItem {
+
+		uint32_t key;
+		int query;
+		int from; //range in ray_batch_objects
+		int amount;
+		bool shared; //culled together with its group, needs aabb checks
+
+		_FORCE_INLINE_ bool operator<(const RayBatchItem& p_item) const { return key<p_item.key; }
+	};
+
+	Vector<RayBatchItem> ray_batch;
+	Vector<PhysicsDirectSpaceStateSW::RayHit> ray_batch_hits;
+	Vector<CollisionObjectSW*> ray_batch_objects;
+	Vector<int> ray_batch_subindices;
+
+	ThreadWorkPool *work_pool;
+	RID_Owner<ShapeSW> *shape_owner; //of the server that owns the space, queries resolve shapes through it
+
+	void _ray_batch_add_candidates(int p_amount,int &r_count);
+
 	float body_linear_velocity_sleep_treshold;
 	float body_angular_velocity_sleep_treshold;
 	float body_time_to_sleep;
 	float body_angular_velocity_damp_ratio;
 
 	bool locked;
+	bool threaded_setup;
 
 friend class PhysicsDirectSpaceStateSW;
 
@@ -104,6 +148,9 @@ public:
 	void set_default_area(AreaSW *p_area) { area=p_area; }
 	AreaSW *get_default_area() const { return area; }
 
+	void set_work_pool(ThreadWorkPool *p_pool) { work_pool=p_pool; }
+	void set_shape_owner(RID_Owner<ShapeSW> *p_owner) { shape_owner=p_owner; }
+
 	const SelfList<BodySW>::List& get_active_body_list() const;
 	void body_add_to_active_list(SelfList<BodySW>* p_body);
 	void body_remove_from_active_list(SelfList<BodySW>* p_body);
@@ -144,6 +191,10 @@ public:
 	void lock();
 	void unlock();
 
+	//set while islands are set up in parallel, static bodies are shared by them so contacts reported to those wait
+	_FORCE_INLINE_ void set_threaded_setup(bool p_enable) { threaded_setup=p_enable; }
+	_FORCE_INLINE_ bool is_threaded_setup() const { return threaded_setup; }
+
 	void set_param(PhysicsServer::SpaceParameter p_param, real_t p_value);
 	real_t get_param(PhysicsServer::SpaceParameter p_param) const;
 
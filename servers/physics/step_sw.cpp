@@ -56,12 +56,14 @@ void StepSW::_populate_island(BodySW* p_body,BodySW** p_island,ConstraintSW **p_
 	}
 }
 
-void StepSW::_setup_island(ConstraintSW *p_island,float p_delta) {
+void StepSW::_setup_island(ConstraintSW *p_island,float p_delta,bool p_skip_serial) {
 
 	ConstraintSW *ci=p_island;
 	while(ci) {
-		bool process = ci->setup(p_delta);
-		//todo remove from island if process fails
+		if (!p_skip_serial || !ci->is_serial_setup()) {
+			bool process = ci->setup(p_delta);
+			//todo remove from island if process fails
+		}
 		ci=ci->get_island_next();
 	}
 }
@@ -112,8 +114,173 @@ void StepSW::_check_suspend(BodySW *p_island,float p_delta) {
 	}
 }
 
+void StepSW::_integrate_forces_work(void *p_userdata,int p_index) {
+
+	StepSW *self=(StepSW*)p_userdata;
+	self->body_array[p_index]->integrate_forces_local(self->work_delta);
+}
+
+void StepSW::_setup_island_work(void *p_userdata,int p_index) {
+
+	StepSW *self=(StepSW*)p_userdata;
+	self->_setup_island(self->constraint_island_array[p_index],self->work_delta,true);
+}
+
+void StepSW::_solve_island_work(void *p_userdata,int p_index) {
+
+	StepSW *self=(StepSW*)p_userdata;
+	self->_solve_island(self->constraint_island_array[p_index],self->work_iterations,self->work_delta);
+}
+
+void StepSW::_integrate_velocities_work(void *p_userdata,int p_index) {
+
+	StepSW *self=(StepSW*)p_userdata;
+	self->body_array[p_index]->integrate_velocities_local(self->work_delta);
+}
+
+void StepSW::_step_threaded(SpaceSW* p_space,float p_delta,int p_iterations) {
+
+	/* Same as step(), but islands and bodies are processed by the work pool.
+	   Islands share no dynamic bodies. Static bodies are shared, but impulses
+	   don't touch them and contacts reported to them are deferred, then sent
+	   serially with everything else that touches shared objects (areas), in the
+	   order the single threaded path uses, so results are identical to it. */
+
+	p_space->lock(); // can't access space during this
+
+	p_space->setup(); //update inertias, etc
+
+	work_delta=p_delta;
+	work_iterations=p_iterations;
+
+	const SelfList<BodySW>::List * body_list = &p_space->get_active_body_list();
+
+	int active_count=0;
+	const SelfList<BodySW>*b = body_list->first();
+	while(b) {
+
+		if (active_count>=body_array.size())
+			body_array.resize(nearest_power_of_2(active_count+1));
+		body_array[active_count++]=b->self();
+		b=b->next();
+	}
+
+	/* INTEGRATE FORCES */
+
+	work_pool.do_work(active_count,_integrate_forces_work,this);
+
+	for(int i=0;i<active_count;i++) {
+		body_array[i]->integrate_forces_sync(p_delta);
+	}
+
+	/* GENERATE CONSTRAINT ISLANDS */
+
+	BodySW *island_list=NULL;
+	int island_count=0;
+
+	for(int i=0;i<active_count;i++) {
+		BodySW *body = body_array[i];
+
+		if (body->get_island_step()!=_step) {
+
+			BodySW *island=NULL;
+			ConstraintSW *constraint_island=NULL;
+			_populate_island(body,&island,&constraint_island);
+
+			island->set_island_list_next(island_list);
+			island_list=island;
+
+			if (constraint_island) {
+				if (island_count>=constraint_island_array.size())
+					constraint_island_array.resize(nearest_power_of_2(island_count+1));
+				constraint_island_array[island_count++]=constraint_island;
+			}
+
+		}
+	}
+
+	const SelfList<AreaSW>::List &aml = p_space->get_moved_area_list();
+
+	while(aml.first()) {
+		for(const Set<ConstraintSW*>::Element *E=aml.first()->self()->get_constraints().front();E;E=E->next()) {
+
+			ConstraintSW*c=E->get();
+			if (c->get_island_step()==_step)
+				continue;
+			c->set_island_step(_step);
+			c->set_island_next(NULL);
+			if (island_count>=constraint_island_array.size())
+				constraint_island_array.resize(nearest_power_of_2(island_count+1));
+			constraint_island_array[island_count++]=c;
+		}
+		p_space->area_remove_from_moved_list((SelfList<AreaSW>*)aml.first()); //faster to remove here
+	}
+
+	/* SETUP CONSTRAINT ISLANDS */
+
+	p_space->set_threaded_setup(true);
+	work_pool.do_work(island_count,_setup_island_work,this);
+	p_space->set_threaded_setup(false);
+
+	//constraints touching shared objects (area pairs, contacts on static bodies), in the order the serial step would set them up
+	for(int i=island_count-1;i>=0;i--) {
+
+		ConstraintSW *ci=constraint_island_array[i];
+		while(ci) {
+			if (ci->is_serial_setup())
+				ci->setup(p_delta);
+			else
+				ci->report_deferred_contacts();
+			ci=ci->get_island_next();
+		}
+	}
+
+	/* SOLVE CONSTRAINT ISLANDS */
+
+	work_pool.do_work(island_count,_solve_island_work,this);
+
+	/* INTEGRATE VELOCITIES */
+
+	work_pool.do_work(active_count,_integrate_velocities_work,this);
+
+	for(int i=0;i<active_count;i++) {
+		body_array[i]->integrate_velocities_sync(p_delta);
+	}
+
+	/* SLEEP / WAKE UP ISLANDS */
+
+	{
+		BodySW *bi=island_list;
+		while(bi) {
+
+			_check_suspend(bi,p_delta);
+			bi=bi->get_island_list_next();
+		}
+	}
+
+	p_space->update();
+	p_space->unlock();
+	_step++;
+}
+
+void StepSW::set_thread_count(int p_count) {
+
+	work_pool.finish();
+	work_pool.init(p_count);
+}
+
+int StepSW::get_thread_count() const {
+
+	return work_pool.get_thread_count();
+}
+
 void StepSW::step(SpaceSW* p_space,float p_delta,int p_iterations) {
 
+	if (work_pool.is_threaded()) {
+		_step_threaded(p_space,p_delta,p_iterations);
+		return;
+	}
+
 	p_space->lock(); // can't access space during this
 
 	p_space->setup(); //update inertias, etc
@@ -234,4 +401,11 @@ void StepSW::step(SpaceSW* p_space,float p_delta,int p_iterations) {
 StepSW::StepSW() {
 
 	_step=1;
+	work_delta=0;
+	work_iterations=0;
+}
+
+StepSW::~StepSW() {
+
+	work_pool.finish();
 }
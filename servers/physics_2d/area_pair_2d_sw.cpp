@@ -73,6 +73,7 @@ AreaPair2DSW::AreaPair2DSW(Body2DSW *p_body,int p_body_shape, Area2DSW *p_area,i
 	body_shape=p_body_shape;
 	area_shape=p_area_shape;
 	colliding=false;
+	set_serial_setup(true);
 	body->add_constraint(this,0);
 	area->add_constraint(this);
 
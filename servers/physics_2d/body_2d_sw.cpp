@@ -350,6 +350,12 @@ void Body2DSW::_compute_area_gravity(const Area2DSW *p_area) {
 
 void Body2DSW::integrate_forces(real_t p_step) {
 
+	integrate_forces_local(p_step);
+	integrate_forces_sync(p_step);
+}
+
+void Body2DSW::integrate_forces_local(real_t p_step) {
+
 	if (mode==Physics2DServer::BODY_MODE_STATIC)
 		return;
 
@@ -371,9 +377,6 @@ void Body2DSW::integrate_forces(real_t p_step) {
 	_compute_area_gravity(current_area);
 	density=current_area->get_density();
 
-	Vector2 motion;
-	bool do_motion=false;
-
 	if (mode==Physics2DServer::BODY_MODE_KINEMATIC) {
 
 		//compute motion, angular and etc. velocities from prev transform
@@ -382,9 +385,6 @@ void Body2DSW::integrate_forces(real_t p_step) {
 		real_t rot = new_transform.affine_inverse().basis_xform(get_transform().elements[1]).atan2();
 		angular_velocity = rot / p_step;
 
-		motion = new_transform.elements[2] - get_transform().elements[2];
-		do_motion=true;
-
 		for(int i=0;i<get_shape_count();i++) {
 			set_shape_kinematic_advance(i,Vector2());
 			set_shape_kinematic_retreat(i,0);
@@ -414,13 +414,6 @@ void Body2DSW::integrate_forces(real_t p_step) {
 			linear_velocity+=_inv_mass * force * p_step;
 			angular_velocity+=_inv_inertia * torque * p_step;
 		}
-
-		if (continuous_cd_mode!=Physics2DServer::CCD_MODE_DISABLED) {
-
-			motion = new_transform.get_origin() - get_transform().get_origin();
-			//linear_velocity*p_step;
-			do_motion=true;
-		}
 	}
 
 
@@ -429,29 +422,37 @@ void Body2DSW::integrate_forces(real_t p_step) {
 	biased_angular_velocity=0;
 	biased_linear_velocity=Vector2();
 
-	if (do_motion) {//shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
-	}
-
 	current_area=NULL; // clear the area, so it is set in the next frame
 	contact_count=0;
 
 }
 
-void Body2DSW::integrate_velocities(real_t p_step) {
+void Body2DSW::integrate_forces_sync(real_t p_step) {
 
 	if (mode==Physics2DServer::BODY_MODE_STATIC)
 		return;
 
-	if (fi_callback)
-		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	if (mode==Physics2DServer::BODY_MODE_KINEMATIC || continuous_cd_mode!=Physics2DServer::CCD_MODE_DISABLED) {
+		//shapes temporarily extend for raycast
+		_update_shapes_with_motion(new_transform.get_origin() - get_transform().get_origin());
+	}
+}
+
+void Body2DSW::integrate_velocities(real_t p_step) {
+
+	integrate_velocities_local(p_step);
+	integrate_velocities_sync(p_step);
+}
+
+void Body2DSW::integrate_velocities_local(real_t p_step) {
+
+	if (mode==Physics2DServer::BODY_MODE_STATIC)
+		return;
 
 	if (mode==Physics2DServer::BODY_MODE_KINEMATIC) {
 
 		_set_transform(new_transform,false);
-		_set_inv_transform(new_transform.affine_inverse());				;
-		if (linear_velocity==Vector2() && angular_velocity==0)
-			set_active(false); //stopped moving, deactivate
+		_set_inv_transform(new_transform.affine_inverse());
 		return;
 	}
 
@@ -461,7 +462,7 @@ void Body2DSW::integrate_velocities(real_t p_step) {
 	real_t angle = get_transform().get_rotation() - total_angular_velocity * p_step;
 	Vector2 pos = get_transform().get_origin() + total_linear_velocity * p_step;
 
-	_set_transform(Matrix32(angle,pos),continuous_cd_mode==Physics2DServer::CCD_MODE_DISABLED);
+	_set_transform(Matrix32(angle,pos),false);
 	_set_inv_transform(get_transform().inverse());
 
 	if (continuous_cd_mode!=Physics2DServer::CCD_MODE_DISABLED)
@@ -470,6 +471,25 @@ void Body2DSW::integrate_velocities(real_t p_step) {
 	//_update_inertia_tensor();
 }
 
+void Body2DSW::integrate_velocities_sync(real_t p_step) {
+
+	if (mode==Physics2DServer::BODY_MODE_STATIC)
+		return;
+
+	if (fi_callback)
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+
+	if (mode==Physics2DServer::BODY_MODE_KINEMATIC) {
+
+		if (linear_velocity==Vector2() && angular_velocity==0)
+			set_active(false); //stopped moving, deactivate
+		return;
+	}
+
+	if (continuous_cd_mode==Physics2DServer::CCD_MODE_DISABLED)
+		_update_shapes();
+}
+
 
 
 void Body2DSW::wakeup_neighbours() {
@@ -177,12 +177,16 @@ public:
 
 	_FORCE_INLINE_ void apply_impulse(const Vector2& p_pos, const Vector2& p_j) {
 
+		if (mode<=Physics2DServer::BODY_MODE_KINEMATIC)
+			return; //no effect anyway, and islands solved in parallel share static and kinematic bodies
 		linear_velocity += p_j * _inv_mass;
 		angular_velocity += _inv_inertia * p_pos.cross(p_j);
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector2& p_pos, const Vector2& p_j) {
 
+		if (mode<=Physics2DServer::BODY_MODE_KINEMATIC)
+			return;
 		biased_linear_velocity += p_j * _inv_mass;
 		biased_angular_velocity += _inv_inertia * p_pos.cross(p_j);
 	}
@@ -223,6 +227,13 @@ public:
 	void integrate_forces(real_t p_step);
 	void integrate_velocities(real_t p_step);
 
+	//split versions for the multithreaded step, the first half only touches the body and can run in any thread,
+	//the second half updates the broadphase, active and query lists of the space and must be called serially
+	void integrate_forces_local(real_t p_step);
+	void integrate_forces_sync(real_t p_step);
+	void integrate_velocities_local(real_t p_step);
+	void integrate_velocities_sync(real_t p_step);
+
 	_FORCE_INLINE_ Vector2 get_motion() const {
 
 		if (mode>Physics2DServer::BODY_MODE_KINEMATIC) {
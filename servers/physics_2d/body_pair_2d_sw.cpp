@@ -232,6 +232,7 @@ bool BodyPair2DSW::_test_ccd(float p_step,Body2DSW *p_A, int p_shape_A,const Mat
 
 bool BodyPair2DSW::setup(float p_step) {
 
+	report_deferred=-1;
 
 	//cannot collide
 	if (A->is_shape_set_as_trigger(shape_A) || B->is_shape_set_as_trigger(shape_B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self()) || (A->get_mode()<=Physics2DServer::BODY_MODE_KINEMATIC && B->get_mode()<=Physics2DServer::BODY_MODE_KINEMATIC)) {
@@ -285,6 +286,15 @@ bool BodyPair2DSW::setup(float p_step) {
 
 	}
 
+	if (space->is_threaded_setup()) {
+
+		//static and kinematic bodies are shared between islands, the step reports to them serially afterwards
+		if (A->get_mode()<=Physics2DServer::BODY_MODE_KINEMATIC)
+			report_deferred=0;
+		else if (B->get_mode()<=Physics2DServer::BODY_MODE_KINEMATIC)
+			report_deferred=1;
+	}
+
 	real_t max_penetration = space->get_contact_max_allowed_penetration();
 
 	float bias = 0.3f;
@@ -334,12 +344,24 @@ bool BodyPair2DSW::setup(float p_step) {
 
 			if (gather_A) {
 				Vector2 crB( -B->get_angular_velocity() * c.rB.y, B->get_angular_velocity() * c.rB.x );
-				A->add_contact(global_A,-c.normal,depth,shape_A,global_B,shape_B,B->get_instance_id(),B->get_self(),crB+B->get_linear_velocity());
+				if (report_deferred==0) {
+					c.report_A=global_A;
+					c.report_B=global_B;
+					c.report_velocity=crB+B->get_linear_velocity();
+				} else {
+					A->add_contact(global_A,-c.normal,depth,shape_A,global_B,shape_B,B->get_instance_id(),B->get_self(),crB+B->get_linear_velocity());
+				}
 			}
 			if (gather_B) {
 
 				Vector2 crA( -A->get_angular_velocity() * c.rA.y, A->get_angular_velocity() * c.rA.x );
-				B->add_contact(global_B,c.normal,depth,shape_B,global_A,shape_A,A->get_instance_id(),A->get_self(),crA+A->get_linear_velocity());
+				if (report_deferred==1) {
+					c.report_A=global_A;
+					c.report_B=global_B;
+					c.report_velocity=crA+A->get_linear_velocity();
+				} else {
+					B->add_contact(global_B,c.normal,depth,shape_B,global_A,shape_A,A->get_instance_id(),A->get_self(),crA+A->get_linear_velocity());
+				}
 			}
 		}
 
@@ -380,6 +402,28 @@ bool BodyPair2DSW::setup(float p_step) {
 	return true;
 }
 
+void BodyPair2DSW::report_deferred_contacts() {
+
+	if (report_deferred==-1)
+		return;
+
+	Body2DSW *body=_arr[report_deferred];
+	if (!body->can_report_contacts())
+		return;
+
+	for(int i=0;i<contact_count;i++) {
+
+		const Contact &c = contacts[i];
+		if (!c.active)
+			continue;
+
+		if (report_deferred==0)
+			A->add_contact(c.report_A,-c.normal,c.depth,shape_A,c.report_B,shape_B,B->get_instance_id(),B->get_self(),c.report_velocity);
+		else
+			B->add_contact(c.report_B,c.normal,c.depth,shape_B,c.report_A,shape_A,A->get_instance_id(),A->get_self(),c.report_velocity);
+	}
+}
+
 void BodyPair2DSW::solve(float p_step) {
 
 	if (!collided)
@@ -454,6 +498,7 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A,Body2DSW *p_B, int p_sha
 	B->add_constraint(this,1);
 	contact_count=0;
 	collided=false;
+	report_deferred=-1;
 
 }
 
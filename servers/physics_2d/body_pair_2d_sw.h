@@ -66,6 +66,7 @@ class BodyPair2DSW : public Constraint2DSW {
 		bool active;
 		Vector2 rA,rB;
 		bool reused;
+		Vector2 report_A,report_B,report_velocity; //kept while the report is deferred
 	};
 
 	Vector2 offset_B; //use local A coordinates to avoid numerical issues on collision detection
@@ -75,6 +76,7 @@ class BodyPair2DSW : public Constraint2DSW {
 	int contact_count;
 	bool collided;
 	int cc;
+	int report_deferred; //body (0 is A, 1 is B) whose contact reports wait for report_deferred_contacts(), or -1
 
 
 	bool _test_ccd(float p_step,Body2DSW *p_A, int p_shape_A,const Matrix32& p_xform_A,Body2DSW *p_B, int p_shape_B,const Matrix32& p_xform_B,bool p_swap_result=false);
@@ -85,6 +87,7 @@ class BodyPair2DSW : public Constraint2DSW {
 public:
 
 	bool setup(float p_step);
+	void report_deferred_contacts();
 	void solve(float p_step);
 
 	BodyPair2DSW(Body2DSW *p_A, int p_shape_A,Body2DSW *p_B, int p_shape_B);
@@ -29,81 +29,200 @@
 #include "broad_phase_2d_hash_grid.h"
 #include "globals.h"
 
-void BroadPhase2DHashGrid::_pair_attempt(Element *p_elem, Element* p_with) {
+void BroadPhase2DHashGrid::FlatTable::init(uint32_t p_capacity) {
 
-	Map<Element*,PairData*>::Element *E=p_elem->paired.find(p_with);
+	uint32_t capacity = nearest_power_of_2(MAX(p_capacity,16));
+	slots=(Slot*)memalloc(sizeof(Slot)*capacity);
+	mask=capacity-1;
+	count=0;
 
-	ERR_FAIL_COND(p_elem->_static && p_with->_static);
+	for(uint32_t i=0;i<capacity;i++)
+		slots[i].value=-1;
+}
+
+void BroadPhase2DHashGrid::FlatTable::clear() {
+
+	for(uint32_t i=0;i<=mask;i++)
+		slots[i].value=-1;
+	count=0;
+}
+
+void BroadPhase2DHashGrid::FlatTable::insert(uint64_t p_key,int p_value) {
+
+	if ((count+1)*2 > mask+1) {
+		//keep load under one half, rehash
+		Slot *old_slots=slots;
+		uint32_t old_capacity=mask+1;
+		init(old_capacity*2);
+		for(uint32_t i=0;i<old_capacity;i++) {
+			if (old_slots[i].value!=-1)
+				insert(old_slots[i].key,old_slots[i].value);
+		}
+		memfree(old_slots);
+	}
+
+	uint32_t pos=hash(p_key)&mask;
+	while(slots[pos].value!=-1)
+		pos=(pos+1)&mask;
+
+	slots[pos].key=p_key;
+	slots[pos].value=p_value;
+	count++;
+}
+
+void BroadPhase2DHashGrid::FlatTable::erase(uint64_t p_key) {
+
+	uint32_t hole=hash(p_key)&mask;
+	while(true) {
+		ERR_FAIL_COND(slots[hole].value==-1);
+		if (slots[hole].key==p_key)
+			break;
+		hole=(hole+1)&mask;
+	}
+
+	//shift back entries that probed past the hole
+	uint32_t pos=(hole+1)&mask;
+	while(slots[pos].value!=-1) {
+
+		uint32_t ideal=hash(slots[pos].key)&mask;
+		if (((pos-ideal)&mask) >= ((pos-hole)&mask)) {
+			slots[hole]=slots[pos];
+			hole=pos;
+		}
+		pos=(pos+1)&mask;
+	}
+
+	slots[hole].value=-1;
+	count--;
+}
+
+void BroadPhase2DHashGrid::_pair_attempt(ID p_elem, ID p_with) {
 
-	if (!E) {
+	ERR_FAIL_COND(elements[p_elem-1]._static && elements[p_with-1]._static);
+
+	uint64_t key=_pair_key(p_elem,p_with);
+	int p=pair_table.get(key);
+
+	if (p!=-1) {
+		pairs[p].rc++;
+		return;
+	}
 
-		PairData *pd = memnew( PairData );
-		p_elem->paired[p_with]=pd;
-		p_with->paired[p_elem]=pd;
-	} else {
-		E->get()->rc++;
+	p=pairs.alloc();
+	PairData &pd=pairs[p];
+	pd.a=MIN(p_elem,p_with);
+	pd.b=MAX(p_elem,p_with);
+	pd.colliding=false;
+	pd.rc=1;
+	pd.ud=NULL;
+
+	for(int i=0;i<2;i++) {
+
+		ID id = i==0 ? pd.a : pd.b;
+		Element &e=elements[id-1];
+		pd.prev[i]=-1;
+		pd.next[i]=e.pair_list;
+		if (e.pair_list!=-1) {
+			PairData &head=pairs[e.pair_list];
+			head.prev[head.side(id)]=p;
+		}
+		e.pair_list=p;
 	}
 
+	pair_table.insert(key,p);
+
+}
+
+void BroadPhase2DHashGrid::_unlink_pair(int p_pair) {
+
+	PairData &pd=pairs[p_pair];
+
+	for(int i=0;i<2;i++) {
+
+		ID id = i==0 ? pd.a : pd.b;
+
+		if (pd.prev[i]!=-1) {
+			PairData &prev=pairs[pd.prev[i]];
+			prev.next[prev.side(id)]=pd.next[i];
+		} else {
+			elements[id-1].pair_list=pd.next[i];
+		}
+
+		if (pd.next[i]!=-1) {
+			PairData &next=pairs[pd.next[i]];
+			next.prev[next.side(id)]=pd.prev[i];
+		}
+	}
 }
 
-void BroadPhase2DHashGrid::_unpair_attempt(Element *p_elem, Element* p_with) {
+void BroadPhase2DHashGrid::_unpair_attempt(ID p_elem, ID p_with) {
 
-	Map<Element*,PairData*>::Element *E=p_elem->paired.find(p_with);
+	uint64_t key=_pair_key(p_elem,p_with);
+	int p=pair_table.get(key);
 
-	ERR_FAIL_COND(!E); //this should really be paired..
+	ERR_FAIL_COND(p==-1); //this should really be paired..
 
-	E->get()->rc--;
+	PairData &pd=pairs[p];
+	pd.rc--;
 
-	if (E->get()->rc==0) {
+	if (pd.rc==0) {
 
-		if (E->get()->colliding) {
+		if (pd.colliding) {
 			//uncollide
 			if (unpair_callback) {
-				unpair_callback(p_elem->owner,p_elem->subindex,p_with->owner,p_with->subindex,E->get()->ud,unpair_userdata);
+				const Element &e=elements[p_elem-1];
+				const Element &w=elements[p_with-1];
+				unpair_callback(e.owner,e.subindex,w.owner,w.subindex,pd.ud,unpair_userdata);
 			}
 
 
 		}
 
-		memdelete(E->get());
-		p_elem->paired.erase(E);
-		p_with->paired.erase(p_elem);
+		_unlink_pair(p);
+		pair_table.erase(key);
+		pairs.free(p);
 	}
 
 
 }
 
-void BroadPhase2DHashGrid::_check_motion(Element *p_elem) {
+void BroadPhase2DHashGrid::_check_motion(ID p_elem) {
+
+	Element &e=elements[p_elem-1];
 
-	for (Map<Element*,PairData*>::Element *E=p_elem->paired.front();E;E=E->next()) {
+	for (int p=e.pair_list;p!=-1;p=pairs[p].next[pairs[p].side(p_elem)]) {
 
-		bool pairing = p_elem->aabb.intersects( E->key()->aabb );
+		PairData &pd=pairs[p];
+		Element &w=elements[pd.other(p_elem)-1];
 
-		if (pairing!=E->get()->colliding) {
+		bool pairing = e.aabb.intersects( w.aabb );
+
+		if (pairing!=pd.colliding) {
 
 			if (pairing) {
 
 				if (pair_callback) {
-					E->get()->ud=pair_callback(p_elem->owner,p_elem->subindex,E->key()->owner,E->key()->subindex,pair_userdata);
+					pd.ud=pair_callback(e.owner,e.subindex,w.owner,w.subindex,pair_userdata);
 				}
 			} else {
 
 				if (unpair_callback) {
-					unpair_callback(p_elem->owner,p_elem->subindex,E->key()->owner,E->key()->subindex,E->get()->ud,unpair_userdata);
+					unpair_callback(e.owner,e.subindex,w.owner,w.subindex,pd.ud,unpair_userdata);
 				}
 
 			}
 
-			E->get()->colliding=pairing;
+			pd.colliding=pairing;
 		}
 	}
 }
 
-void BroadPhase2DHashGrid::_enter_grid( Element* p_elem, const Rect2& p_rect,bool p_static) {
+void BroadPhase2DHashGrid::_enter_grid( ID p_id, const Rect2& p_rect,bool p_static) {
 
 
 	Point2i from = (p_rect.pos/cell_size).floor();
 	Point2i to = ((p_rect.pos+p_rect.size)/cell_size).floor();
+	CollisionObject2DSW *owner = elements[p_id-1].owner;
 
 	for(int i=from.x;i<=to.x;i++) {
 
@@ -114,59 +233,52 @@ void BroadPhase2DHashGrid::_enter_grid( Element* p_elem, const Rect2& p_rect,boo
 			pk.x=i;
 			pk.y=j;
 
-			uint32_t idx = pk.hash() % hash_table_size;
-			PosBin *pb = hash_table[idx];
-
-			while (pb) {
-
-				if (pb->key == pk) {
-					break;
-				}
+			int c = cell_table.get(pk.key);
 
-				pb=pb->next;
+			if (c==-1) {
+				//does not exist, create!
+				c=cells.alloc();
+				cells[c].key=pk;
+				cells[c].objects=-1;
+				cells[c].static_objects=-1;
+				cell_table.insert(pk.key,c);
 			}
 
+			int &list = p_static ? cells[c].static_objects : cells[c].objects;
 
-			bool entered=false;
+			int ce=list;
+			while(ce!=-1 && cell_entries[ce].element!=p_id)
+				ce=cell_entries[ce].next;
 
-			if (!pb) {
-				//does not exist, create!
-				pb = memnew( PosBin );
-				pb->key=pk;
-				pb->next=hash_table[idx];
-				hash_table[idx]=pb;
+			if (ce!=-1) {
+				cell_entries[ce].rc++;
+				continue;
 			}
 
+			ce=cell_entries.alloc();
+			cell_entries[ce].element=p_id;
+			cell_entries[ce].rc=1;
+			cell_entries[ce].next=list;
+			list=ce;
 
+			//entered
 
-			if (p_static) {
-				if (pb->static_object_set[p_elem].inc()==1) {
-					entered=true;
-				}
-			} else {
-				if (pb->object_set[p_elem].inc()==1) {
+			for(int E=cells[c].objects;E!=-1;E=cell_entries[E].next) {
 
-					entered=true;
-				}
+				ID with=cell_entries[E].element;
+				if (elements[with-1].owner==owner)
+					continue;
+				_pair_attempt(p_id,with);
 			}
 
-			if (entered) {
+			if (!p_static) {
 
-				for(Map<Element*,RC>::Element *E=pb->object_set.front();E;E=E->next()) {
+				for(int E=cells[c].static_objects;E!=-1;E=cell_entries[E].next) {
 
-					if (E->key()->owner==p_elem->owner)
+					ID with=cell_entries[E].element;
+					if (elements[with-1].owner==owner)
 						continue;
-					_pair_attempt(p_elem,E->key());
-				}
-
-				if (!p_static) {
-
-					for(Map<Element*,RC>::Element *E=pb->static_object_set.front();E;E=E->next()) {
-
-						if (E->key()->owner==p_elem->owner)
-							continue;
-						_pair_attempt(p_elem,E->key());
-					}
+					_pair_attempt(p_id,with);
 				}
 			}
 
@@ -178,11 +290,12 @@ void BroadPhase2DHashGrid::_enter_grid( Element* p_elem, const Rect2& p_rect,boo
 }
 
 
-void BroadPhase2DHashGrid::_exit_grid( Element* p_elem, const Rect2& p_rect,bool p_static) {
+void BroadPhase2DHashGrid::_exit_grid( ID p_id, const Rect2& p_rect,bool p_static) {
 
 
 	Point2i from = (p_rect.pos/cell_size).floor();
 	Point2i to = ((p_rect.pos+p_rect.size)/cell_size).floor();
+	CollisionObject2DSW *owner = elements[p_id-1].owner;
 
 	for(int i=from.x;i<=to.x;i++) {
 
@@ -192,190 +305,221 @@ void BroadPhase2DHashGrid::_exit_grid( Element* p_elem, const Rect2& p_rect,bool
 			pk.x=i;
 			pk.y=j;
 
-			uint32_t idx = pk.hash() % hash_table_size;
-			PosBin *pb = hash_table[idx];
+			int c = cell_table.get(pk.key);
 
-			while (pb) {
+			ERR_CONTINUE(c==-1); //should exist!!
 
-				if (pb->key == pk) {
-					break;
-				}
+			int &list = p_static ? cells[c].static_objects : cells[c].objects;
 
-				pb=pb->next;
+			int prev=-1;
+			int ce=list;
+			while(ce!=-1 && cell_entries[ce].element!=p_id) {
+				prev=ce;
+				ce=cell_entries[ce].next;
 			}
 
-			ERR_CONTINUE(!pb); //should exist!!
+			ERR_CONTINUE(ce==-1);
 
-			bool exited=false;
+			if (--cell_entries[ce].rc==0) {
 
+				if (prev!=-1)
+					cell_entries[prev].next=cell_entries[ce].next;
+				else
+					list=cell_entries[ce].next;
+				cell_entries.free(ce);
 
-			if (p_static) {
-				if (pb->static_object_set[p_elem].dec()==0) {
+				//exited
 
-					pb->static_object_set.erase(p_elem);
-					exited=true;
+				for(int E=cells[c].objects;E!=-1;E=cell_entries[E].next) {
+
+					ID with=cell_entries[E].element;
+					if (elements[with-1].owner==owner)
+						continue;
+					_unpair_attempt(p_id,with);
 
 				}
-			} else {
-				if (pb->object_set[p_elem].dec()==0) {
 
-					pb->object_set.erase(p_elem);
-					exited=true;
+				if (!p_static) {
+
+					for(int E=cells[c].static_objects;E!=-1;E=cell_entries[E].next) {
 
+						ID with=cell_entries[E].element;
+						if (elements[with-1].owner==owner)
+							continue;
+						_unpair_attempt(p_id,with);
+					}
 				}
 			}
 
-			if (exited) {
+			if (cells[c].objects==-1 && cells[c].static_objects==-1) {
 
-				for(Map<Element*,RC>::Element *E=pb->object_set.front();E;E=E->next()) {
+				cell_table.erase(pk.key);
+				cells.free(c);
 
-					if (E->key()->owner==p_elem->owner)
-						continue;
-					_unpair_attempt(p_elem,E->key());
+			}
+		}
 
-				}
+	}
 
-				if (!p_static) {
+}
 
-					for(Map<Element*,RC>::Element *E=pb->static_object_set.front();E;E=E->next()) {
+void BroadPhase2DHashGrid::_rebuild_grid(int p_cell_size) {
 
-						if (E->key()->owner==p_elem->owner)
-							continue;
-						_unpair_attempt(p_elem,E->key());
-					}
-				}
-			}
+	//pairs keep their collision state and userdata, only the cell coverage is recounted
 
-			if (pb->object_set.empty() && pb->static_object_set.empty()) {
+	for(int i=0;i<elements.used;i++) {
 
-				if (hash_table[idx]==pb) {
-					hash_table[idx]=pb->next;
-				} else {
+		if (!elements[i].owner)
+			continue;
+		for (int p=elements[i].pair_list;p!=-1;p=pairs[p].next[pairs[p].side(i+1)])
+			pairs[p].rc=0;
+	}
 
-					PosBin *px = hash_table[idx];
+	cell_table.clear();
+	cells.reset();
+	cell_entries.reset();
 
-					while (px) {
+	cell_size=p_cell_size;
 
-						if (px->next==pb) {
-							px->next=pb->next;
-							break;
-						}
+	for(int i=0;i<elements.used;i++) {
 
-						px=px->next;
-					}
+		if (!elements[i].owner || elements[i].aabb==Rect2())
+			continue;
+		_enter_grid(i+1,elements[i].aabb,elements[i]._static);
+	}
 
-					ERR_CONTINUE(!px);
-				}
+	//pairs that no longer share any cell are gone
+
+	for(int i=0;i<elements.used;i++) {
+
+		if (!elements[i].owner)
+			continue;
+
+		int p=elements[i].pair_list;
+		while(p!=-1) {
 
-				memdelete(pb);
+			PairData &pd=pairs[p];
+			int next=pd.next[pd.side(i+1)];
 
+			if (pd.rc==0) {
+
+				if (pd.colliding && unpair_callback) {
+					const Element &a=elements[pd.a-1];
+					const Element &b=elements[pd.b-1];
+					unpair_callback(a.owner,a.subindex,b.owner,b.subindex,pd.ud,unpair_userdata);
+				}
+
+				pair_table.erase(_pair_key(pd.a,pd.b));
+				_unlink_pair(p);
+				pairs.free(p);
 			}
-		}
 
+			p=next;
+		}
 	}
-
 }
 
 
 BroadPhase2DHashGrid::ID BroadPhase2DHashGrid::create(CollisionObject2DSW *p_object, int p_subindex) {
 
-	current++;
+	ERR_FAIL_COND_V(!p_object,0);
+
+	int idx=elements.alloc();
 
-	Element e;
+	Element &e=elements[idx];
 	e.owner=p_object;
 	e._static=false;
+	e.aabb=Rect2();
 	e.subindex=p_subindex;
-	e.self=current;
 	e.pass=0;
+	e.pair_list=-1;
 
-	element_map[current]=e;
-	return current;
+	return idx+1;
 
 }
 
 void BroadPhase2DHashGrid::move(ID p_id, const Rect2& p_aabb) {
 
 
-	Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND(!E);
+	ERR_FAIL_COND(!_has_element(p_id));
 
-	Element &e=E->get();
+	Element &e=elements[p_id-1];
 
 	if (p_aabb==e.aabb)
 		return;
 
+	_add_extent(e.aabb,-1);
+	_add_extent(p_aabb,1);
 
 	if (p_aabb!=Rect2()) {
 
-		_enter_grid(&e,p_aabb,e._static);
+		_enter_grid(p_id,p_aabb,e._static);
 	}
 
 	if (e.aabb!=Rect2()) {
 
-		_exit_grid(&e,e.aabb,e._static);
+		_exit_grid(p_id,e.aabb,e._static);
 	}
 
 	e.aabb=p_aabb;
 
-	_check_motion(&e);
-
-	e.aabb=p_aabb;
+	_check_motion(p_id);
 
 }
 void BroadPhase2DHashGrid::set_static(ID p_id, bool p_static) {
 
-	Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND(!E);
+	ERR_FAIL_COND(!_has_element(p_id));
 
-	Element &e=E->get();
+	Element &e=elements[p_id-1];
 
 	if (e._static==p_static)
 		return;
 
 	if (e.aabb!=Rect2())
-		_exit_grid(&e,e.aabb,e._static);
+		_exit_grid(p_id,e.aabb,e._static);
 
 	e._static=p_static;
 
 	if (e.aabb!=Rect2()) {
-		_enter_grid(&e,e.aabb,e._static);
-		_check_motion(&e);
+		_enter_grid(p_id,e.aabb,e._static);
+		_check_motion(p_id);
 	}
 
 }
 void BroadPhase2DHashGrid::remove(ID p_id) {
 
-	Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND(!E);
+	ERR_FAIL_COND(!_has_element(p_id));
 
-	Element &e=E->get();
+	Element &e=elements[p_id-1];
 
-	if (e.aabb!=Rect2())
-		_exit_grid(&e,e.aabb,e._static);
+	if (e.aabb!=Rect2()) {
+		_exit_grid(p_id,e.aabb,e._static);
+		_add_extent(e.aabb,-1);
+	}
+
+	ERR_FAIL_COND(e.pair_list!=-1); //all pairs should be gone along with the cells
 
-	element_map.erase(p_id);
+	e.owner=NULL;
+	elements.free(p_id-1);
 
 }
 
 CollisionObject2DSW *BroadPhase2DHashGrid::get_object(ID p_id) const {
 
-	const Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND_V(!E,NULL);
-	return E->get().owner;
+	ERR_FAIL_COND_V(!_has_element(p_id),NULL);
+	return elements[p_id-1].owner;
 
 }
 bool BroadPhase2DHashGrid::is_static(ID p_id) const {
 
-	const Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND_V(!E,false);
-	return E->get()._static;
+	ERR_FAIL_COND_V(!_has_element(p_id),false);
+	return elements[p_id-1]._static;
 
 }
 int BroadPhase2DHashGrid::get_subindex(ID p_id) const {
 
-	const Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND_V(!E,-1);
-	return E->get().subindex;
+	ERR_FAIL_COND_V(!_has_element(p_id),-1);
+	return elements[p_id-1].subindex;
 }
 
 template<bool use_aabb,bool use_segment>
@@ -386,69 +530,40 @@ void BroadPhase2DHashGrid::_cull(const Point2i p_cell,const Rect2& p_aabb,const
 	pk.x=p_cell.x;
 	pk.y=p_cell.y;
 
-	uint32_t idx = pk.hash() % hash_table_size;
-	PosBin *pb = hash_table[idx];
+	int c = cell_table.get(pk.key);
 
-	while (pb) {
-
-		if (pb->key == pk) {
-			break;
-		}
-
-		pb=pb->next;
-	}
-
-	if (!pb)
+	if (c==-1)
 		return;
 
+	for(int k=0;k<2;k++) {
 
+		for(int E = k==0 ? cells[c].objects : cells[c].static_objects;E!=-1;E=cell_entries[E].next) {
 
-	for(Map<Element*,RC>::Element *E=pb->object_set.front();E;E=E->next()) {
 
+			if (index>=p_max_results)
+				return;
 
-		if (index>=p_max_results)
-			break;
-		if (E->key()->pass==pass)
-			continue;
+			Element &e=elements[cell_entries[E].element-1];
 
-		E->key()->pass=pass;
+			if (e.pass==pass)
+				continue;
 
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb))
-			continue;
+			e.pass=pass;
 
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from,p_to))
-			continue;
-
-		p_results[index]=E->key()->owner;
-		p_result_indices[index]=E->key()->subindex;
-		index++;
+			if (use_aabb && !p_aabb.intersects(e.aabb))
+				continue;
 
+			if (use_segment && !e.aabb.intersects_segment(p_from,p_to))
+				continue;
 
-	}
+			p_results[index]=e.owner;
+			p_result_indices[index]=e.subindex;
+			index++;
 
-	for(Map<Element*,RC>::Element *E=pb->static_object_set.front();E;E=E->next()) {
 
-
-		if (index>=p_max_results)
-			break;
-		if (E->key()->pass==pass)
-			continue;
-
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb)) {
-			continue;
 		}
-
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from,p_to))
-			continue;
-
-		E->key()->pass=pass;
-		p_results[index]=E->key()->owner;
-		p_result_indices[index]=E->key()->subindex;
-		index++;
-
 	}
 }
-
 int BroadPhase2DHashGrid::cull_segment(const Vector2& p_from, const Vector2& p_to,CollisionObject2DSW** p_results,int p_max_results,int *p_result_indices) {
 
 	pass++;
@@ -564,9 +679,41 @@ void BroadPhase2DHashGrid::set_unpair_callback(UnpairCallback p_unpair_callback,
 
 void BroadPhase2DHashGrid::update() {
 
+	if (!cell_size_auto || extent_count==0)
+		return;
+
+	//aim for cells about twice the average shape extent, and only rebuild
+	//when that drifts far enough to be worth it
+	real_t target = MAX(extent_sum*2.0/extent_count,1.0);
+
+	if (target > cell_size*2 || target < cell_size/2)
+		_rebuild_grid(nearest_power_of_2(int(target)));
 
 }
 
+void BroadPhase2DHashGrid::set_cell_size(int p_size) {
+
+	ERR_FAIL_COND(p_size<1);
+	if (p_size==cell_size)
+		return;
+	_rebuild_grid(p_size);
+}
+
+int BroadPhase2DHashGrid::get_cell_size() const {
+
+	return cell_size;
+}
+
+void BroadPhase2DHashGrid::set_cell_size_auto(bool p_enable) {
+
+	cell_size_auto=p_enable;
+}
+
+bool BroadPhase2DHashGrid::is_cell_size_auto() const {
+
+	return cell_size_auto;
+}
+
 BroadPhase2DSW *BroadPhase2DHashGrid::_create() {
 
 	return memnew( BroadPhase2DHashGrid );
@@ -575,31 +722,24 @@ BroadPhase2DSW *BroadPhase2DHashGrid::_create() {
 
 BroadPhase2DHashGrid::BroadPhase2DHashGrid() {
 
-	hash_table_size = GLOBAL_DEF("physics_2d/bp_hash_table_size",4096);
-	hash_table_size = Math::larger_prime(hash_table_size);
-	hash_table = memnew_arr( PosBin*, hash_table_size);
+	cell_table.init( GLOBAL_DEF("physics_2d/bp_hash_table_size",4096) );
+	pair_table.init( 1024 );
 
 	cell_size = GLOBAL_DEF("physics_2d/cell_size",128);
+	cell_size_auto = GLOBAL_DEF("physics_2d/cell_size_auto",false);
+	extent_sum=0;
+	extent_count=0;
 
-	for(int i=0;i<hash_table_size;i++)
-		hash_table[i]=NULL;
-	pass=1;
+	pair_callback=NULL;
+	pair_userdata=NULL;
+	unpair_callback=NULL;
+	unpair_userdata=NULL;
 
-	current=0;
+	pass=1;
 }
 
 BroadPhase2DHashGrid::~BroadPhase2DHashGrid() {
 
-	for(int i=0;i<hash_table_size;i++) {
-		while(hash_table[i]) {
-			PosBin *pb=hash_table[i];
-			hash_table[i]=pb->next;
-			memdelete(pb);
-		}
-	}
-
-	memdelete_arr( hash_table );
-
 
 }
 
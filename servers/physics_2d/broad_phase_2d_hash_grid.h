@@ -30,73 +30,124 @@
 #define BROAD_PHASE_2D_HASH_GRID_H
 
 #include "broad_phase_2d_sw.h"
-#include "map.h"
 
 class BroadPhase2DHashGrid : public BroadPhase2DSW {
 
 
-	struct PairData {
+	/* Everything is kept in flat pools addressed by index, so once the pools
+	   and tables have grown to fit the scene, moving objects around does not
+	   touch the heap. */
 
-		bool colliding;
-		int rc;
-		void *ud;
-		PairData() { colliding=false; rc=1; ud=NULL; }
-	};
+	template<class T>
+	struct Pool {
 
-	struct Element {
+		T *data;
+		int *free_stack;
+		int used;
+		int free_count;
+		int capacity;
 
-		ID self;
-		CollisionObject2DSW *owner;
-		bool _static;
-		Rect2 aabb;
-		int subindex;
-		uint64_t pass;
-		Map<Element*,PairData*> paired;
+		_FORCE_INLINE_ T& operator[](int p_idx) { return data[p_idx]; }
+		_FORCE_INLINE_ const T& operator[](int p_idx) const { return data[p_idx]; }
 
-	};
+		int alloc() {
 
+			if (free_count)
+				return free_stack[--free_count];
 
-	Map<ID,Element> element_map;
+			if (used==capacity) {
 
-	ID current;
+				capacity=capacity?capacity*2:64;
+				data=(T*)(data?memrealloc(data,sizeof(T)*capacity):memalloc(sizeof(T)*capacity));
+				free_stack=(int*)(free_stack?memrealloc(free_stack,sizeof(int)*capacity):memalloc(sizeof(int)*capacity));
+			}
 
-	uint64_t pass;
+			return used++;
+		}
 
+		_FORCE_INLINE_ void free(int p_idx) { free_stack[free_count++]=p_idx; }
+		_FORCE_INLINE_ void reset() { used=0; free_count=0; }
 
-	struct PairKey {
+		Pool() { data=NULL; free_stack=NULL; used=0; free_count=0; capacity=0; }
+		~Pool() { if (data) { memfree(data); memfree(free_stack); } }
+	};
 
-		union {
-			struct {
-				ID a;
-				ID b;
-			};
+	/* open addressing with linear probing, deletion shifts back the following
+	   entries so no tombstones build up while cells and pairs come and go. */
+
+	struct FlatTable {
+
+		struct Slot {
 			uint64_t key;
+			int value;
 		};
 
-		_FORCE_INLINE_ bool operator<(const PairKey& p_key) const {
-			return key < p_key.key;
+		Slot *slots;
+		uint32_t mask;
+		uint32_t count;
+
+		_FORCE_INLINE_ static uint32_t hash(uint64_t p_key) {
+			uint64_t k=p_key;
+			k = (~k) + (k << 18); // k = (k << 18) - k - 1;
+			k = k ^ (k >> 31);
+			k = k * 21; // k = (k + (k << 2)) + (k << 4);
+			k = k ^ (k >> 11);
+			k = k + (k << 6);
+			k = k ^ (k >> 22);
+			return k;
 		}
 
-		PairKey() { key=0; }
-		PairKey(ID p_a, ID p_b) { if (p_a>p_b) { a=p_b; b=p_a; } else { a=p_a; b=p_b; }}
+		_FORCE_INLINE_ int get(uint64_t p_key) const {
 
+			uint32_t pos=hash(p_key)&mask;
+			while(slots[pos].value!=-1) {
+				if (slots[pos].key==p_key)
+					return slots[pos].value;
+				pos=(pos+1)&mask;
+			}
+			return -1;
+		}
+
+		void insert(uint64_t p_key,int p_value);
+		void erase(uint64_t p_key);
+		void clear();
+		void init(uint32_t p_capacity);
+
+		FlatTable() { slots=NULL; mask=0; count=0; }
+		~FlatTable() { if (slots) memfree(slots); }
 	};
 
+	struct PairData {
 
-	Map<PairKey,PairData> pair_map;
+		ID a; // a<b
+		ID b;
+		bool colliding;
+		int rc;
+		void *ud;
+		int next[2]; // links in the pair list of a (0) and b (1)
+		int prev[2];
 
-	int cell_size;
+		_FORCE_INLINE_ int side(ID p_id) const { return p_id==a?0:1; }
+		_FORCE_INLINE_ ID other(ID p_id) const { return p_id==a?b:a; }
+	};
 
-	PairCallback pair_callback;
-	void *pair_userdata;
-	UnpairCallback unpair_callback;
-	void *unpair_userdata;
+	struct Element {
 
-	void _enter_grid(Element* p_elem, const Rect2& p_rect,bool p_static);
-	void _exit_grid(Element* p_elem, const Rect2& p_rect,bool p_static);
-	template<bool use_aabb,bool use_segment>
-	_FORCE_INLINE_ void _cull(const Point2i p_cell,const Rect2& p_aabb,const Point2& p_from, const Point2& p_to,CollisionObject2DSW** p_results,int p_max_results,int *p_result_indices,int &index);
+		CollisionObject2DSW *owner;
+		bool _static;
+		Rect2 aabb;
+		int subindex;
+		uint64_t pass;
+		int pair_list;
 
+	};
+
+	struct CellEntry {
+
+		ID element;
+		int rc;
+		int next;
+	};
 
 	struct PosKey {
 
@@ -108,58 +159,62 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 			uint64_t key;
 		};
 
-
-		_FORCE_INLINE_ uint32_t hash() const {
-			uint64_t k=key;
-			k = (~k) + (k << 18); // k = (k << 18) - k - 1;
-			k = k ^ (k >> 31);
-			k = k * 21; // k = (k + (k << 2)) + (k << 4);
-			k = k ^ (k >> 11);
-			k = k + (k << 6);
-			k = k ^ (k >> 22);
-			return k;
-		}
-
 		bool operator==(const PosKey& p_key) const { return key==p_key.key; }
-		_FORCE_INLINE_ bool operator<(const PosKey& p_key) const {
-			return key < p_key.key;
-		}
+	};
+
+	struct Cell {
 
+		PosKey key;
+		int objects;
+		int static_objects;
 	};
 
-	struct RC {
+	_FORCE_INLINE_ static uint64_t _pair_key(ID p_a, ID p_b) {
+		return p_a<p_b ? (uint64_t(p_a)<<32)|p_b : (uint64_t(p_b)<<32)|p_a;
+	}
 
-		int ref;
+	Pool<Element> elements; // ID is index+1
+	Pool<PairData> pairs;
+	Pool<Cell> cells;
+	Pool<CellEntry> cell_entries;
 
-		_FORCE_INLINE_ int inc() {
-			ref++;
-			return ref;
-		}
-		_FORCE_INLINE_ int dec() {
-			ref--;
-			return ref;
-		}
+	FlatTable pair_table;
+	FlatTable cell_table;
 
-		_FORCE_INLINE_ RC() {
-			ref=0;
-		}
-	};
+	uint64_t pass;
 
-	struct PosBin {
+	int cell_size;
 
-		PosKey key;
-		Map<Element*,RC> object_set;
-		Map<Element*,RC> static_object_set;
-		PosBin *next;
-	};
+	bool cell_size_auto;
+	double extent_sum;
+	int extent_count;
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
 
+	_FORCE_INLINE_ bool _has_element(ID p_id) const {
+		return p_id>0 && int(p_id)<=elements.used && elements[p_id-1].owner;
+	}
 
-	uint32_t hash_table_size;
-	PosBin **hash_table;
+	_FORCE_INLINE_ void _add_extent(const Rect2& p_rect,int p_sign) {
+		if (p_rect==Rect2())
+			return;
+		extent_sum+=MAX(p_rect.size.width,p_rect.size.height)*p_sign;
+		extent_count+=p_sign;
+	}
 
-	void _pair_attempt(Element *p_elem, Element* p_with);
-	void _unpair_attempt(Element *p_elem, Element* p_with);
-	void _check_motion(Element *p_elem);
+	void _enter_grid(ID p_id, const Rect2& p_rect,bool p_static);
+	void _exit_grid(ID p_id, const Rect2& p_rect,bool p_static);
+	void _rebuild_grid(int p_cell_size);
+	template<bool use_aabb,bool use_segment>
+	_FORCE_INLINE_ void _cull(const Point2i p_cell,const Rect2& p_aabb,const Point2& p_from, const Point2& p_to,CollisionObject2DSW** p_results,int p_max_results,int *p_result_indices,int &index);
+
+	void _pair_attempt(ID p_elem, ID p_with);
+	void _unpair_attempt(ID p_elem, ID p_with);
+	void _unlink_pair(int p_pair);
+	void _check_motion(ID p_elem);
 
 
 public:
@@ -181,6 +236,11 @@ public:
 
 	virtual void update();
 
+	void set_cell_size(int p_size);
+	int get_cell_size() const;
+
+	void set_cell_size_auto(bool p_enable);
+	bool is_cell_size_auto() const;
 
 	static BroadPhase2DSW *_create();
 
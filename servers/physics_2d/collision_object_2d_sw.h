@@ -68,11 +68,10 @@ private:
 	uint32_t user_mask;
 	bool _static;
 
-	void _update_shapes();
-
 protected:
 
 
+	void _update_shapes();
 	void _update_shapes_with_motion(const Vector2& p_motion);
 	void _unregister_shapes();
 
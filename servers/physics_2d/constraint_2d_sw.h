@@ -38,12 +38,15 @@ class Constraint2DSW {
 	uint64_t island_step;
 	Constraint2DSW *island_next;
 	Constraint2DSW *island_list_next;
+	bool serial_setup;
 
 
 	RID self;
 
 protected:
-	Constraint2DSW(Body2DSW **p_body_ptr=NULL,int p_body_count=0) { _body_ptr=p_body_ptr; _body_count=p_body_count; island_step=0; }
+	Constraint2DSW(Body2DSW **p_body_ptr=NULL,int p_body_count=0) { _body_ptr=p_body_ptr; _body_count=p_body_count; island_step=0; serial_setup=false; }
+
+	_FORCE_INLINE_ void set_serial_setup(bool p_enable) { serial_setup=p_enable; }
 public:
 
 	_FORCE_INLINE_ void set_self(const RID& p_self) { self=p_self; }
@@ -62,8 +65,12 @@ public:
 	_FORCE_INLINE_ Body2DSW **get_body_ptr() const { return _body_ptr; }
 	_FORCE_INLINE_ int get_body_count() const { return _body_count; }
 
+	//setup() touches objects shared between islands, so the multithreaded step runs it serially
+	_FORCE_INLINE_ bool is_serial_setup() const { return serial_setup; }
+
 
 	virtual bool setup(float p_step)=0;
+	virtual void report_deferred_contacts() {} //after a threaded setup, see Space2DSW::set_threaded_setup()
 	virtual void solve(float p_step)=0;
 
 	virtual ~Constraint2DSW() {}
@@ -30,6 +30,7 @@
 #include "broad_phase_2d_basic.h"
 #include "broad_phase_2d_hash_grid.h"
 #include "collision_solver_2d_sw.h"
+#include "globals.h"
 
 RID Physics2DServerSW::shape_create(ShapeType p_shape) {
 
@@ -197,6 +198,8 @@ RID Physics2DServerSW::space_create() {
 	Space2DSW *space = memnew( Space2DSW );
 	RID id = space_owner.make_rid(space);
 	space->set_self(id);
+	space->set_work_pool(stepper->get_work_pool());
+	space->set_shape_owner(&shape_owner);
 	RID area_id = area_create();
 	Area2DSW *area = area_owner.get(area_id);
 	ERR_FAIL_COND_V(!area,RID());
@@ -1056,6 +1059,7 @@ void Physics2DServerSW::init() {
 	last_step=0.001;
 	iterations=8;// 8?
 	stepper = memnew( Step2DSW );
+	stepper->set_thread_count(GLOBAL_DEF("physics_2d/thread_count",1));
 	direct_state = memnew( Physics2DDirectBodyStateSW );
 };
 
@@ -29,6 +29,7 @@
 #include "space_2d_sw.h"
 #include "collision_solver_2d_sw.h"
 #include "physics_2d_server_sw.h"
+#include "sort.h"
 
 
 _FORCE_INLINE_ static bool _match_object_type_query(CollisionObject2DSW *p_object, uint32_t p_user_mask, uint32_t p_type_mask) {
@@ -45,11 +46,7 @@ _FORCE_INLINE_ static bool _match_object_type_query(CollisionObject2DSW *p_objec
 
 }
 
-bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2& p_from, const Vector2& p_to,RayResult &r_result,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
-
-
-
-	ERR_FAIL_COND_V(space->locked,false);
+bool Physics2DDirectSpaceStateSW::_intersect_ray_candidates(const Vector2& p_from, const Vector2& p_to,CollisionObject2DSW **p_objects,const int *p_subindices,int p_amount,bool p_test_aabb,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask,RayHit &r_hit) {
 
 	Vector2 begin,end;
 	Vector2 normal;
@@ -57,28 +54,27 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2& p_from, const Vec
 	end=p_to;
 	normal=(end-begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin,end,space->intersection_query_results,Space2DSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
-
 	//todo, create another array tha references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided=false;
-	Vector2 res_point,res_normal;
-	int res_shape;
-	const CollisionObject2DSW *res_obj;
 	real_t min_d=1e10;
 
 
-	for(int i=0;i<amount;i++) {
+	for(int i=0;i<p_amount;i++) {
 
-		if (!_match_object_type_query(space->intersection_query_results[i],p_user_mask,p_object_type_mask))
+		if (!_match_object_type_query(p_objects[i],p_user_mask,p_object_type_mask))
 			continue;
 
-		if (p_exclude.has( space->intersection_query_results[i]->get_self()))
+		if (p_exclude.has( p_objects[i]->get_self()))
 			continue;
 
-		const CollisionObject2DSW *col_obj=space->intersection_query_results[i];
+		const CollisionObject2DSW *col_obj=p_objects[i];
+
+		int shape_idx=p_subindices[i];
+
+		if (p_test_aabb && !col_obj->get_shape_aabb(shape_idx).intersects_segment(begin,end))
+			continue;
 
-		int shape_idx=space->intersection_query_subindex_results[i];
 		Matrix32 inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -108,39 +104,240 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2& p_from, const Vec
 			if (ld<min_d) {
 
 				min_d=ld;
-				res_point=shape_point;
-				res_normal=inv_xform.basis_xform_inv(shape_normal).normalized();
-				res_shape=shape_idx;
-				res_obj=col_obj;
+				r_hit.position=shape_point;
+				r_hit.normal=inv_xform.basis_xform_inv(shape_normal).normalized();
+				r_hit.shape=shape_idx;
+				r_hit.object=col_obj;
 				collided=true;
 			}
 		}
 
 	}
 
-	if (!collided)
+	return collided;
+}
+
+bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2& p_from, const Vector2& p_to,RayResult &r_result,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
+
+
+
+	ERR_FAIL_COND_V(space->locked,false);
+
+	int amount = space->broadphase->cull_segment(p_from,p_to,space->intersection_query_results,Space2DSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
+
+	RayHit hit;
+	if (!_intersect_ray_candidates(p_from,p_to,space->intersection_query_results,space->intersection_query_subindex_results,amount,false,p_exclude,p_user_mask,p_object_type_mask,hit))
 		return false;
 
 
-	r_result.collider_id=res_obj->get_instance_id();
+	r_result.collider_id=hit.object->get_instance_id();
 	if (r_result.collider_id!=0)
 		r_result.collider=ObjectDB::get_instance(r_result.collider_id);
-	r_result.normal=res_normal;
-	r_result.position=res_point;
-	r_result.rid=res_obj->get_self();
-	r_result.shape=res_shape;
+	r_result.normal=hit.normal;
+	r_result.position=hit.position;
+	r_result.rid=hit.object->get_self();
+	r_result.shape=hit.shape;
 
 	return true;
 
 }
 
+static _FORCE_INLINE_ uint32_t _morton_spread_2(uint32_t p_val) {
+
+	uint32_t x=p_val&0xFFFF;
+	x = (x | (x << 8)) & 0x00FF00FF;
+	x = (x | (x << 4)) & 0x0F0F0F0F;
+	x = (x | (x << 2)) & 0x33333333;
+	x = (x | (x << 1)) & 0x55555555;
+	return x;
+}
+
+void Physics2DDirectSpaceStateSW::_query_batch_broadphase(int p_query_count,const RayQuery *p_rays) {
+
+	const Rect2 *aabbs = space->query_batch_aabbs.ptr();
+
+	/* sort queries along a morton curve through their centers, so queries
+	   close to each other land in the same group and share one cull */
+
+	Rect2 bounds;
+	for(int i=0;i<p_query_count;i++) {
+
+		Vector2 center = aabbs[i].pos+aabbs[i].size*0.5;
+		if (i==0)
+			bounds=Rect2(center,Vector2());
+		else
+			bounds.expand_to(center);
+	}
+
+	Vector2 scale;
+	scale.x = bounds.size.x>0 ? 65535.0/bounds.size.x : 0;
+	scale.y = bounds.size.y>0 ? 65535.0/bounds.size.y : 0;
+
+	space->query_batch.resize(p_query_count);
+	Space2DSW::QueryBatchItem *items = space->query_batch.ptr();
+
+	for(int i=0;i<p_query_count;i++) {
+
+		Vector2 c = (aabbs[i].pos+aabbs[i].size*0.5-bounds.pos)*scale;
+		items[i].key=_morton_spread_2(c.x)|(_morton_spread_2(c.y)<<1);
+		items[i].query=i;
+	}
+
+	SortArray<Space2DSW::QueryBatchItem> sorter;
+	sorter.sort(items,p_query_count);
+
+	/* done serially, as culling is not reentrant */
+
+	int candidate_count=0;
+
+	for(int g=0;g<p_query_count;g+=Space2DSW::QUERY_BATCH_GROUP) {
+
+		int group_end=MIN(g+Space2DSW::QUERY_BATCH_GROUP,p_query_count);
+
+		Rect2 group_aabb;
+		real_t longest=0;
+		for(int i=g;i<group_end;i++) {
+
+			const Rect2 &aabb=aabbs[items[i].query];
+			longest=MAX(longest,MAX(aabb.size.x,aabb.size.y));
+			if (i==g)
+				group_aabb=aabb;
+			else
+				group_aabb=group_aabb.merge(aabb);
+		}
+
+		int amount=-1;
+
+		//only share the cull if the group is about as compact as its queries
+		if (group_end-g>1 && MAX(group_aabb.size.x,group_aabb.size.y)<=longest*2.0) {
+
+			amount = space->broadphase->cull_aabb(group_aabb,space->intersection_query_results,Space2DSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
+			if (amount==Space2DSW::INTERSECTION_QUERY_MAX)
+				amount=-1; //overflowed, cull queries one by one
+			else
+				space->_query_batch_add_candidates(amount,candidate_count);
+		}
+
+		for(int i=g;i<group_end;i++) {
+
+			if (amount>=0) {
+
+				items[i].from=candidate_count-amount;
+				items[i].amount=amount;
+				items[i].shared=true;
+			} else {
+
+				int q=items[i].query;
+				int query_amount;
+				if (p_rays)
+					query_amount = space->broadphase->cull_segment(p_rays[q].from,p_rays[q].to,space->intersection_query_results,Space2DSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
+				else
+					query_amount = space->broadphase->cull_aabb(aabbs[q],space->intersection_query_results,Space2DSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
+
+				space->_query_batch_add_candidates(query_amount,candidate_count);
+				items[i].from=candidate_count-query_amount;
+				items[i].amount=query_amount;
+				items[i].shared=false;
+			}
+		}
+	}
+}
+
+void Physics2DDirectSpaceStateSW::_query_batch_run(int p_query_count,ThreadWorkCallback p_callback,void *p_userdata) {
+
+	if (space->work_pool && space->work_pool->is_threaded() && p_query_count>=Space2DSW::QUERY_BATCH_THREAD_MIN) {
+
+		space->work_pool->do_work(p_query_count,p_callback,p_userdata);
+	} else {
+
+		for(int i=0;i<p_query_count;i++)
+			p_callback(p_userdata,i);
+	}
+}
+
+struct Physics2DDirectSpaceStateSW::IntersectRaysWork {
+
+	const RayQuery *queries;
+	const Space2DSW::QueryBatchItem *items;
+	CollisionObject2DSW **objects;
+	const int *subindices;
+	const Set<RID> *exclude;
+	uint32_t user_mask;
+	uint32_t object_type_mask;
+	RayHit *hits;
+	bool *hit;
+};
+
+void Physics2DDirectSpaceStateSW::_intersect_rays_work(void *p_userdata,int p_index) {
+
+	IntersectRaysWork *work = (IntersectRaysWork*)p_userdata;
+	const Space2DSW::QueryBatchItem &item = work->items[p_index];
+	const RayQuery &q = work->queries[item.query];
+
+	work->hit[item.query]=_intersect_ray_candidates(q.from,q.to,&work->objects[item.from],&work->subindices[item.from],item.amount,item.shared,*work->exclude,work->user_mask,work->object_type_mask,work->hits[item.query]);
+}
+
+int Physics2DDirectSpaceStateSW::intersect_rays(const RayQuery *p_queries,int p_query_count,RayResult *r_results,bool *r_hits,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
+
+	ERR_FAIL_COND_V(space->locked,0);
+
+	if (p_query_count<=0)
+		return 0;
+
+	space->query_batch_aabbs.resize(p_query_count);
+	space->query_batch_ray_hits.resize(p_query_count);
+	Rect2 *aabbs = space->query_batch_aabbs.ptr();
+
+	for(int i=0;i<p_query_count;i++) {
+
+		aabbs[i]=Rect2(p_queries[i].from,Vector2());
+		aabbs[i].expand_to(p_queries[i].to);
+	}
+
+	_query_batch_broadphase(p_query_count,p_queries);
+
+	IntersectRaysWork work;
+	work.queries=p_queries;
+	work.items=space->query_batch.ptr();
+	work.objects=space->query_batch_objects.ptr();
+	work.subindices=space->query_batch_subindices.ptr();
+	work.exclude=&p_exclude;
+	work.user_mask=p_user_mask;
+	work.object_type_mask=p_object_type_mask;
+	work.hits=space->query_batch_ray_hits.ptr();
+	work.hit=r_hits;
+
+	_query_batch_run(p_query_count,_intersect_rays_work,&work);
+
+	int hits=0;
+
+	for(int i=0;i<p_query_count;i++) {
+
+		if (!r_hits[i])
+			continue;
+
+		const RayHit &hit=work.hits[i];
+		RayResult &r_result=r_results[i];
+
+		r_result.collider_id=hit.object->get_instance_id();
+		r_result.collider = r_result.collider_id!=0 ? ObjectDB::get_instance(r_result.collider_id) : NULL;
+		r_result.normal=hit.normal;
+		r_result.position=hit.position;
+		r_result.rid=hit.object->get_self();
+		r_result.shape=hit.shape;
+		hits++;
+	}
+
+	return hits;
+}
+
 
 int Physics2DDirectSpaceStateSW::intersect_shape(const RID& p_shape, const Matrix32& p_xform,const Vector2& p_motion,float p_margin,ShapeResult *r_results,int p_result_max,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
 
 	if (p_result_max<=0)
 		return 0;
 
-	Shape2DSW *shape = static_cast<Physics2DServerSW*>(Physics2DServer::get_singleton())->shape_owner.get(p_shape);
+	Shape2DSW *shape = space->shape_owner->get(p_shape);
 	ERR_FAIL_COND_V(!shape,0);
 
 	Rect2 aabb = p_xform.xform(shape->get_aabb());
@@ -182,48 +379,37 @@ int Physics2DDirectSpaceStateSW::intersect_shape(const RID& p_shape, const Matri
 
 
 
-bool Physics2DDirectSpaceStateSW::cast_motion(const RID& p_shape, const Matrix32& p_xform,const Vector2& p_motion,float p_margin,float &p_closest_safe,float &p_closest_unsafe, const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
-
-
-
-	Shape2DSW *shape = static_cast<Physics2DServerSW*>(Physics2DServer::get_singleton())->shape_owner.get(p_shape);
-	ERR_FAIL_COND_V(!shape,false);
-
-	Rect2 aabb = p_xform.xform(shape->get_aabb());
-	aabb=aabb.merge(Rect2(aabb.pos+p_motion,aabb.size)); //motion
-	aabb=aabb.grow(p_margin);
-
-	//if (p_motion!=Vector2())
-	//	print_line(p_motion);
-
-	int amount = space->broadphase->cull_aabb(aabb,space->intersection_query_results,Space2DSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
+bool Physics2DDirectSpaceStateSW::_cast_motion_candidates(const Shape2DSW *p_shape, const Matrix32& p_xform,const Vector2& p_motion,float p_margin,CollisionObject2DSW **p_objects,const int *p_subindices,int p_amount,bool p_test_aabb,const Rect2& p_aabb,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask,float &p_closest_safe,float &p_closest_unsafe) {
 
 	float best_safe=1;
 	float best_unsafe=1;
 
-	for(int i=0;i<amount;i++) {
+	for(int i=0;i<p_amount;i++) {
 
 
-		if (!_match_object_type_query(space->intersection_query_results[i],p_user_mask,p_object_type_mask))
+		if (!_match_object_type_query(p_objects[i],p_user_mask,p_object_type_mask))
 			continue;
 
-		if (p_exclude.has( space->intersection_query_results[i]->get_self()))
+		if (p_exclude.has( p_objects[i]->get_self()))
 			continue; //ignore excluded
 
 
-		const CollisionObject2DSW *col_obj=space->intersection_query_results[i];
-		int shape_idx=space->intersection_query_subindex_results[i];
+		const CollisionObject2DSW *col_obj=p_objects[i];
+		int shape_idx=p_subindices[i];
+
+		if (p_test_aabb && !p_aabb.intersects(col_obj->get_shape_aabb(shape_idx)))
+			continue;
 
 
 		Matrix32 col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (!CollisionSolver2DSW::solve(shape,p_xform,p_motion,col_obj->get_shape(shape_idx),col_obj_xform,Vector2() ,NULL,NULL,NULL,p_margin)) {
+		if (!CollisionSolver2DSW::solve(p_shape,p_xform,p_motion,col_obj->get_shape(shape_idx),col_obj_xform,Vector2() ,NULL,NULL,NULL,p_margin)) {
 			continue;
 		}
 
 
 		//test initial overlap
-		if (CollisionSolver2DSW::solve(shape,p_xform,Vector2(),col_obj->get_shape(shape_idx),col_obj_xform,Vector2() ,NULL,NULL,NULL,p_margin)) {
+		if (CollisionSolver2DSW::solve(p_shape,p_xform,Vector2(),col_obj->get_shape(shape_idx),col_obj_xform,Vector2() ,NULL,NULL,NULL,p_margin)) {
 
 			return false;
 		}
@@ -240,7 +426,7 @@ bool Physics2DDirectSpaceStateSW::cast_motion(const RID& p_shape, const Matrix32
 			float ofs = (low+hi)*0.5;
 
 			Vector2 sep=mnormal; //important optimization for this to work fast enough
-			bool collided = CollisionSolver2DSW::solve(shape,p_xform,p_motion*ofs,col_obj->get_shape(shape_idx),col_obj_xform,Vector2(),NULL,NULL,&sep,p_margin);
+			bool collided = CollisionSolver2DSW::solve(p_shape,p_xform,p_motion*ofs,col_obj->get_shape(shape_idx),col_obj_xform,Vector2(),NULL,NULL,&sep,p_margin);
 
 			if (collided) {
 
@@ -262,10 +448,113 @@ bool Physics2DDirectSpaceStateSW::cast_motion(const RID& p_shape, const Matrix32
 	p_closest_unsafe=best_unsafe;
 
 	return true;
+}
+
+bool Physics2DDirectSpaceStateSW::cast_motion(const RID& p_shape, const Matrix32& p_xform,const Vector2& p_motion,float p_margin,float &p_closest_safe,float &p_closest_unsafe, const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
+
+
+
+	Shape2DSW *shape = space->shape_owner->get(p_shape);
+	ERR_FAIL_COND_V(!shape,false);
+
+	Rect2 aabb = p_xform.xform(shape->get_aabb());
+	aabb=aabb.merge(Rect2(aabb.pos+p_motion,aabb.size)); //motion
+	aabb=aabb.grow(p_margin);
+
+	//if (p_motion!=Vector2())
+	//	print_line(p_motion);
+
+	int amount = space->broadphase->cull_aabb(aabb,space->intersection_query_results,Space2DSW::INTERSECTION_QUERY_MAX,space->intersection_query_subindex_results);
+
+	return _cast_motion_candidates(shape,p_xform,p_motion,p_margin,space->intersection_query_results,space->intersection_query_subindex_results,amount,false,aabb,p_exclude,p_user_mask,p_object_type_mask,p_closest_safe,p_closest_unsafe);
 
 
 }
 
+struct Physics2DDirectSpaceStateSW::CastMotionsWork {
+
+	const MotionQuery *queries;
+	const Space2DSW::QueryBatchItem *items;
+	const Shape2DSW **shapes;
+	const Rect2 *aabbs;
+	CollisionObject2DSW **objects;
+	const int *subindices;
+	float margin;
+	const Set<RID> *exclude;
+	uint32_t user_mask;
+	uint32_t object_type_mask;
+	MotionResult *results;
+};
+
+void Physics2DDirectSpaceStateSW::_cast_motions_work(void *p_userdata,int p_index) {
+
+	CastMotionsWork *work = (CastMotionsWork*)p_userdata;
+	const Space2DSW::QueryBatchItem &item = work->items[p_index];
+	const MotionQuery &q = work->queries[item.query];
+	MotionResult &r = work->results[item.query];
+
+	if (!work->shapes[item.query]) {
+		r.valid=false;
+		return;
+	}
+
+	r.valid=_cast_motion_candidates(work->shapes[item.query],q.xform,q.motion,work->margin,&work->objects[item.from],&work->subindices[item.from],item.amount,item.shared,work->aabbs[item.query],*work->exclude,work->user_mask,work->object_type_mask,r.closest_safe,r.closest_unsafe);
+}
+
+int Physics2DDirectSpaceStateSW::cast_motions(const MotionQuery *p_queries,int p_query_count,float p_margin,MotionResult *r_results,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
+
+	ERR_FAIL_COND_V(space->locked,0);
+
+	if (p_query_count<=0)
+		return 0;
+
+	space->query_batch_aabbs.resize(p_query_count);
+	space->query_batch_shapes.resize(p_query_count);
+	Rect2 *aabbs = space->query_batch_aabbs.ptr();
+	const Shape2DSW **shapes = space->query_batch_shapes.ptr();
+
+	for(int i=0;i<p_query_count;i++) {
+
+		const MotionQuery &q=p_queries[i];
+		Shape2DSW *shape = space->shape_owner->get(q.shape);
+		shapes[i]=shape;
+		if (!shape) {
+			ERR_PRINT("Invalid shape in cast_motions() query.");
+			aabbs[i]=Rect2(q.xform.get_origin(),Vector2());
+			continue;
+		}
+
+		Rect2 aabb = q.xform.xform(shape->get_aabb());
+		aabb=aabb.merge(Rect2(aabb.pos+q.motion,aabb.size)); //motion
+		aabbs[i]=aabb.grow(p_margin);
+	}
+
+	_query_batch_broadphase(p_query_count,NULL);
+
+	CastMotionsWork work;
+	work.queries=p_queries;
+	work.items=space->query_batch.ptr();
+	work.shapes=shapes;
+	work.aabbs=aabbs;
+	work.objects=space->query_batch_objects.ptr();
+	work.subindices=space->query_batch_subindices.ptr();
+	work.margin=p_margin;
+	work.exclude=&p_exclude;
+	work.user_mask=p_user_mask;
+	work.object_type_mask=p_object_type_mask;
+	work.results=r_results;
+
+	_query_batch_run(p_query_count,_cast_motions_work,&work);
+
+	int valid=0;
+	for(int i=0;i<p_query_count;i++) {
+		if (r_results[i].valid)
+			valid++;
+	}
+
+	return valid;
+}
+
 
 bool Physics2DDirectSpaceStateSW::collide_shape(RID p_shape, const Matrix32& p_shape_xform,const Vector2& p_motion,float p_margin,Vector2 *r_results,int p_result_max,int &r_result_count, const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
 
@@ -273,7 +562,7 @@ bool Physics2DDirectSpaceStateSW::collide_shape(RID p_shape, const Matrix32& p_s
 	if (p_result_max<=0)
 		return 0;
 
-	Shape2DSW *shape = static_cast<Physics2DServerSW*>(Physics2DServer::get_singleton())->shape_owner.get(p_shape);
+	Shape2DSW *shape = space->shape_owner->get(p_shape);
 	ERR_FAIL_COND_V(!shape,0);
 
 	Rect2 aabb = p_shape_xform.xform(shape->get_aabb());
@@ -356,7 +645,7 @@ static void _rest_cbk_result(const Vector2& p_point_A,const Vector2& p_point_B,v
 bool Physics2DDirectSpaceStateSW::rest_info(RID p_shape, const Matrix32& p_shape_xform,const Vector2& p_motion,float p_margin,ShapeRestInfo *r_info, const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
 
 
-	Shape2DSW *shape = static_cast<Physics2DServerSW*>(Physics2DServer::get_singleton())->shape_owner.get(p_shape);
+	Shape2DSW *shape = space->shape_owner->get(p_shape);
 	ERR_FAIL_COND_V(!shape,0);
 
 	Rect2 aabb = p_shape_xform.xform(shape->get_aabb());
@@ -638,6 +927,27 @@ bool Space2DSW::is_locked() const {
 	return locked;
 }
 
+void Space2DSW::_query_batch_add_candidates(int p_amount,int &r_count) {
+
+	if (r_count+p_amount > query_batch_objects.size()) {
+
+		int size = nearest_power_of_2(r_count+p_amount);
+		query_batch_objects.resize(size);
+		query_batch_subindices.resize(size);
+	}
+
+	CollisionObject2DSW **objects = query_batch_objects.ptr();
+	int *subindices = query_batch_subindices.ptr();
+
+	for(int i=0;i<p_amount;i++) {
+
+		objects[r_count+i]=intersection_query_results[i];
+		subindices[r_count+i]=intersection_query_subindex_results[i];
+	}
+
+	r_count+=p_amount;
+}
+
 Physics2DDirectSpaceStateSW *Space2DSW::get_direct_state() {
 
 	return direct_access;
@@ -647,6 +957,9 @@ Space2DSW::Space2DSW() {
 
 
 	locked=false;
+	threaded_setup=false;
+	work_pool=NULL;
+	shape_owner=NULL;
 	contact_recycle_radius=0.01;
 	contact_max_separation=0.05;
 	contact_max_allowed_penetration= 0.01;
@@ -37,18 +37,44 @@
 #include "area_pair_2d_sw.h"
 #include "broad_phase_2d_sw.h"
 #include "collision_object_2d_sw.h"
+#include "os/thread_work_pool.h"
 
 
 class Physics2DDirectSpaceStateSW : public Physics2DDirectSpaceState {
 
 	OBJ_TYPE( Physics2DDirectSpaceStateSW, Physics2DDirectSpaceState );
+public:
+
+	struct RayHit {
+
+		Vector2 position;
+		Vector2 normal;
+		const CollisionObject2DSW *object;
+		int shape;
+	};
+
+private:
+
+	struct IntersectRaysWork;
+	struct CastMotionsWork;
+
+	static bool _intersect_ray_candidates(const Vector2& p_from, const Vector2& p_to,CollisionObject2DSW **p_objects,const int *p_subindices,int p_amount,bool p_test_aabb,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask,RayHit &r_hit);
+	static bool _cast_motion_candidates(const Shape2DSW *p_shape, const Matrix32& p_xform,const Vector2& p_motion,float p_margin,CollisionObject2DSW **p_objects,const int *p_subindices,int p_amount,bool p_test_aabb,const Rect2& p_aabb,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask,float &p_closest_safe,float &p_closest_unsafe);
+	static void _intersect_rays_work(void *p_userdata,int p_index);
+	static void _cast_motions_work(void *p_userdata,int p_index);
+
+	void _query_batch_broadphase(int p_query_count,const RayQuery *p_rays);
+	void _query_batch_run(int p_query_count,ThreadWorkCallback p_callback,void *p_userdata);
+
 public:
 
 	Space2DSW *space;
 
 	virtual bool intersect_ray(const Vector2& p_from, const Vector2& p_to,RayResult &r_result,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION);
+	virtual int intersect_rays(const RayQuery *p_queries,int p_query_count,RayResult *r_results,bool *r_hits,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION);
 	virtual int intersect_shape(const RID& p_shape, const Matrix32& p_xform,const Vector2& p_motion,float p_margin,ShapeResult *r_results,int p_result_max,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION);
 	virtual bool cast_motion(const RID& p_shape, const Matrix32& p_xform,const Vector2& p_motion,float p_margin,float &p_closest_safe,float &p_closest_unsafe, const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION);
+	virtual int cast_motions(const MotionQuery *p_queries,int p_query_count,float p_margin,MotionResult *r_results,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION);
 	virtual bool collide_shape(RID p_shape, const Matrix32& p_shape_xform,const Vector2& p_motion,float p_margin,Vector2 *r_results,int p_result_max,int &r_result_count, const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION);
 	virtual bool rest_info(RID p_shape, const Matrix32& p_shape_xform,const Vector2& p_motion,float p_margin,ShapeRestInfo *r_info, const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION);
 
@@ -84,18 +110,45 @@ class Space2DSW {
 
 	enum {
 
-		INTERSECTION_QUERY_MAX=2048
+		INTERSECTION_QUERY_MAX=2048,
+		QUERY_BATCH_GROUP=16, //queries sharing one broadphase cull
+		QUERY_BATCH_THREAD_MIN=64 //don't wake up the workers for less
 	};
 
 	CollisionObject2DSW *intersection_query_results[INTERSECTION_QUERY_MAX];
 	int intersection_query_subindex_results[INTERSECTION_QUERY_MAX];
 
+	//batched queries, kept between calls so they don't reallocate
+	struct QueryBatchItem {
+
+		uint32_t key;
+		int query;
+		int from; //range in query_batch_objects
+		int amount;
+		bool shared; //culled together with its group, needs aabb checks
+
+		_FORCE_INLINE_ bool operator<(const QueryBatchItem& p_item) const { return key<p_item.key; }
+	};
+
+	Vector<QueryBatchItem> query_batch;
+	Vector<Rect2> query_batch_aabbs;
+	Vector<const Shape2DSW*> query_batch_shapes;
+	Vector<Physics2DDirectSpaceStateSW::RayHit> query_batch_ray_hits;
+	Vector<CollisionObject2DSW*> query_batch_objects;
+	Vector<int> query_batch_subindices;
+
+	ThreadWorkPool *work_pool;
+	RID_Owner<Shape2DSW> *shape_owner; //of the server that owns the space, queries resolve shapes through it
+
+	void _query_batch_add_candidates(int p_amount,int &r_count);
+
 	float body_linear_velocity_sleep_treshold;
 	float body_angular_velocity_sleep_treshold;
 	float body_time_to_sleep;
 	float body_angular_velocity_damp_ratio;
 
 	bool locked;
+	bool threaded_setup;
 
 friend class Physics2DDirectSpaceStateSW;
 
@@ -107,6 +160,9 @@ public:
 	void set_default_area(Area2DSW *p_area) { area=p_area; }
 	Area2DSW *get_default_area() const { return area; }
 
+	void set_work_pool(ThreadWorkPool *p_pool) { work_pool=p_pool; }
+	void set_shape_owner(RID_Owner<Shape2DSW> *p_owner) { shape_owner=p_owner; }
+
 	const SelfList<Body2DSW>::List& get_active_body_list() const;
 	void body_add_to_active_list(SelfList<Body2DSW>* p_body);
 	void body_remove_from_active_list(SelfList<Body2DSW>* p_body);
@@ -150,6 +206,10 @@ public:
 	void lock();
 	void unlock();
 
+	//set while islands are set up in parallel, static and kinematic bodies are shared by them so contacts reported to those wait
+	_FORCE_INLINE_ void set_threaded_setup(bool p_enable) { threaded_setup=p_enable; }
+	_FORCE_INLINE_ bool is_threaded_setup() const { return threaded_setup; }
+
 	void set_param(Physics2DServer::SpaceParameter p_param, real_t p_value);
 	real_t get_param(Physics2DServer::SpaceParameter p_param) const;
 
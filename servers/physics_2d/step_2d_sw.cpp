@@ -56,12 +56,14 @@ void Step2DSW::_populate_island(Body2DSW* p_body,Body2DSW** p_island,Constraint2
 	}
 }
 
-void Step2DSW::_setup_island(Constraint2DSW *p_island,float p_delta) {
+void Step2DSW::_setup_island(Constraint2DSW *p_island,float p_delta,bool p_skip_serial) {
 
 	Constraint2DSW *ci=p_island;
 	while(ci) {
-		bool process = ci->setup(p_delta);
-		//todo remove from island if process fails
+		if (!p_skip_serial || !ci->is_serial_setup()) {
+			bool process = ci->setup(p_delta);
+			//todo remove from island if process fails
+		}
 		ci=ci->get_island_next();
 	}
 }
@@ -117,8 +119,173 @@ void Step2DSW::_check_suspend(Body2DSW *p_island,float p_delta) {
 	}
 }
 
+void Step2DSW::_integrate_forces_work(void *p_userdata,int p_index) {
+
+	Step2DSW *self=(Step2DSW*)p_userdata;
+	self->body_array[p_index]->integrate_forces_local(self->work_delta);
+}
+
+void Step2DSW::_setup_island_work(void *p_userdata,int p_index) {
+
+	Step2DSW *self=(Step2DSW*)p_userdata;
+	self->_setup_island(self->constraint_island_array[p_index],self->work_delta,true);
+}
+
+void Step2DSW::_solve_island_work(void *p_userdata,int p_index) {
+
+	Step2DSW *self=(Step2DSW*)p_userdata;
+	self->_solve_island(self->constraint_island_array[p_index],self->work_iterations,self->work_delta);
+}
+
+void Step2DSW::_integrate_velocities_work(void *p_userdata,int p_index) {
+
+	Step2DSW *self=(Step2DSW*)p_userdata;
+	self->body_array[p_index]->integrate_velocities_local(self->work_delta);
+}
+
+void Step2DSW::_step_threaded(Space2DSW* p_space,float p_delta,int p_iterations) {
+
+	/* Same as step(), but islands and bodies are processed by the work pool.
+	   Islands share no rigid or character bodies. Static and kinematic bodies
+	   are shared, but impulses don't touch them and contacts reported to them
+	   are deferred, then sent serially with everything else that touches shared
+	   objects (areas), in the order the single threaded path uses, so results
+	   are identical to it. */
+
+	p_space->lock(); // can't access space during this
+
+	p_space->setup(); //update inertias, etc
+
+	work_delta=p_delta;
+	work_iterations=p_iterations;
+
+	const SelfList<Body2DSW>::List * body_list = &p_space->get_active_body_list();
+
+	int active_count=0;
+	const SelfList<Body2DSW>*b = body_list->first();
+	while(b) {
+
+		if (active_count>=body_array.size())
+			body_array.resize(nearest_power_of_2(active_count+1));
+		body_array[active_count++]=b->self();
+		b=b->next();
+	}
+
+	/* INTEGRATE FORCES */
+
+	work_pool.do_work(active_count,_integrate_forces_work,this);
+
+	for(int i=0;i<active_count;i++) {
+		body_array[i]->integrate_forces_sync(p_delta);
+	}
+
+	/* GENERATE CONSTRAINT ISLANDS */
+
+	Body2DSW *island_list=NULL;
+	int island_count=0;
+
+	for(int i=0;i<active_count;i++) {
+		Body2DSW *body = body_array[i];
+
+		if (body->get_island_step()!=_step) {
+
+			Body2DSW *island=NULL;
+			Constraint2DSW *constraint_island=NULL;
+			_populate_island(body,&island,&constraint_island);
+
+			island->set_island_list_next(island_list);
+			island_list=island;
+
+			if (constraint_island) {
+				if (island_count>=constraint_island_array.size())
+					constraint_island_array.resize(nearest_power_of_2(island_count+1));
+				constraint_island_array[island_count++]=constraint_island;
+			}
+
+		}
+	}
+
+	const SelfList<Area2DSW>::List &aml = p_space->get_moved_area_list();
+
+	while(aml.first()) {
+		for(const Set<Constraint2DSW*>::Element *E=aml.first()->self()->get_constraints().front();E;E=E->next()) {
+
+			Constraint2DSW*c=E->get();
+			if (c->get_island_step()==_step)
+				continue;
+			c->set_island_step(_step);
+			c->set_island_next(NULL);
+			if (island_count>=constraint_island_array.size())
+				constraint_island_array.resize(nearest_power_of_2(island_count+1));
+			constraint_island_array[island_count++]=c;
+		}
+		p_space->area_remove_from_moved_list((SelfList<Area2DSW>*)aml.first()); //faster to remove here
+	}
+
+	/* SETUP CONSTRAINT ISLANDS */
+
+	p_space->set_threaded_setup(true);
+	work_pool.do_work(island_count,_setup_island_work,this);
+	p_space->set_threaded_setup(false);
+
+	//constraints touching shared objects (area pairs, contacts on static and kinematic bodies), in the order the serial step would set them up
+	for(int i=island_count-1;i>=0;i--) {
+
+		Constraint2DSW *ci=constraint_island_array[i];
+		while(ci) {
+			if (ci->is_serial_setup())
+				ci->setup(p_delta);
+			else
+				ci->report_deferred_contacts();
+			ci=ci->get_island_next();
+		}
+	}
+
+	/* SOLVE CONSTRAINT ISLANDS */
+
+	work_pool.do_work(island_count,_solve_island_work,this);
+
+	/* INTEGRATE VELOCITIES */
+
+	work_pool.do_work(active_count,_integrate_velocities_work,this);
+
+	for(int i=0;i<active_count;i++) {
+		body_array[i]->integrate_velocities_sync(p_delta);
+	}
+
+	/* SLEEP / WAKE UP ISLANDS */
+
+	{
+		Body2DSW *bi=island_list;
+		while(bi) {
+
+			_check_suspend(bi,p_delta);
+			bi=bi->get_island_list_next();
+		}
+	}
+
+	p_space->update();
+	p_space->unlock();
+	_step++;
+}
+
+void Step2DSW::set_thread_count(int p_count) {
+
+	work_pool.finish();
+	work_pool.init(p_count);
+}
+
+int Step2DSW::get_thread_count() const {
+
+	return work_pool.get_thread_count();
+}
+
 void Step2DSW::step(Space2DSW* p_space,float p_delta,int p_iterations) {
 
+	if (work_pool.is_threaded()) {
+		_step_threaded(p_space,p_delta,p_iterations);
+		return;
+	}
 
 	p_space->lock(); // can't access space during this
 
@@ -241,4 +408,11 @@ void Step2DSW::step(Space2DSW* p_space,float p_delta,int p_iterations) {
 Step2DSW::Step2DSW() {
 
 	_step=1;
+	work_delta=0;
+	work_iterations=0;
+}
+
+Step2DSW::~Step2DSW() {
+
+	work_pool.finish();
 }
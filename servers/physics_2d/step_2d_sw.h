@@ -30,19 +30,40 @@
 #define STEP_2D_SW_H
 
 #include "space_2d_sw.h"
+#include "os/thread_work_pool.h"
 
 class Step2DSW {
 
 	uint64_t _step;
 
+	ThreadWorkPool work_pool;
+
+	//used by the multithreaded step, kept between steps so they don't reallocate
+	Vector<Body2DSW*> body_array;
+	Vector<Constraint2DSW*> constraint_island_array;
+	float work_delta;
+	int work_iterations;
+
 	void _populate_island(Body2DSW* p_body,Body2DSW** p_island,Constraint2DSW **p_constraint_island);
-	void _setup_island(Constraint2DSW *p_island,float p_delta);
+	void _setup_island(Constraint2DSW *p_island,float p_delta,bool p_skip_serial=false);
 	void _solve_island(Constraint2DSW *p_island,int p_iterations,float p_delta);
 	void _check_suspend(Body2DSW *p_island,float p_delta);
+
+	static void _integrate_forces_work(void *p_userdata,int p_index);
+	static void _setup_island_work(void *p_userdata,int p_index);
+	static void _solve_island_work(void *p_userdata,int p_index);
+	static void _integrate_velocities_work(void *p_userdata,int p_index);
+
+	void _step_threaded(Space2DSW* p_space,float p_delta,int p_iterations);
 public:
 
+	void set_thread_count(int p_count); ///< 1 steps in the calling thread only, 0 uses one thread per processor
+	int get_thread_count() const;
+	ThreadWorkPool *get_work_pool() { return &work_pool; }
+
 	void step(Space2DSW* p_space,float p_delta,int p_iterations);
 	Step2DSW();
+	~Step2DSW();
 };
 
 #endif // STEP_2D_SW_H
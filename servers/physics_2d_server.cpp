@@ -190,6 +190,122 @@ Variant Physics2DDirectSpaceState::_cast_motion(const RID& p_shape, const Matrix
 
 
 
+Array Physics2DDirectSpaceState::_intersect_rays(const DVector<Vector2>& p_from, const DVector<Vector2>& p_to,const Vector<RID>& p_exclude,uint32_t p_user_mask) {
+
+	ERR_FAIL_COND_V(p_from.size()!=p_to.size(),Array());
+
+	int count=p_from.size();
+	Array ret;
+	if (count==0)
+		return ret;
+
+	Set<RID> exclude;
+	for(int i=0;i<p_exclude.size();i++)
+		exclude.insert(p_exclude[i]);
+
+	Vector<RayQuery> queries;
+	Vector<RayResult> results;
+	Vector<bool> hits;
+	queries.resize(count);
+	results.resize(count);
+	hits.resize(count);
+
+	DVector<Vector2>::Read fr=p_from.read();
+	DVector<Vector2>::Read tr=p_to.read();
+	for(int i=0;i<count;i++) {
+		queries[i].from=fr[i];
+		queries[i].to=tr[i];
+	}
+
+	intersect_rays(&queries[0],count,&results[0],&hits[0],exclude,p_user_mask);
+
+	ret.resize(count);
+	for(int i=0;i<count;i++) {
+
+		if (!hits[i])
+			continue;
+
+		Dictionary d(true);
+		d["position"]=results[i].position;
+		d["normal"]=results[i].normal;
+		d["collider_id"]=results[i].collider_id;
+		d["collider"]=results[i].collider;
+		d["shape"]=results[i].shape;
+		d["rid"]=results[i].rid;
+		ret[i]=d;
+	}
+
+	return ret;
+}
+
+Array Physics2DDirectSpaceState::_cast_motions(const RID& p_shape, const Array& p_xforms,const DVector<Vector2>& p_motions,const Vector<RID>& p_exclude,uint32_t p_user_mask) {
+
+	ERR_FAIL_COND_V(p_xforms.size()!=p_motions.size(),Array());
+
+	int count=p_xforms.size();
+	Array ret;
+	if (count==0)
+		return ret;
+
+	Set<RID> exclude;
+	for(int i=0;i<p_exclude.size();i++)
+		exclude.insert(p_exclude[i]);
+
+	Vector<MotionQuery> queries;
+	Vector<MotionResult> results;
+	queries.resize(count);
+	results.resize(count);
+
+	DVector<Vector2>::Read mr=p_motions.read();
+	for(int i=0;i<count;i++) {
+		queries[i].shape=p_shape;
+		queries[i].xform=p_xforms[i];
+		queries[i].motion=mr[i];
+	}
+
+	cast_motions(&queries[0],count,0,&results[0],exclude,p_user_mask);
+
+	ret.resize(count);
+	for(int i=0;i<count;i++) {
+
+		if (!results[i].valid)
+			continue;
+
+		Array r;
+		r.push_back(results[i].closest_safe);
+		r.push_back(results[i].closest_unsafe);
+		ret[i]=r;
+	}
+
+	return ret;
+}
+
+int Physics2DDirectSpaceState::intersect_rays(const RayQuery *p_queries,int p_query_count,RayResult *r_results,bool *r_hits,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
+
+	int hits=0;
+	for(int i=0;i<p_query_count;i++) {
+
+		r_hits[i]=intersect_ray(p_queries[i].from,p_queries[i].to,r_results[i],p_exclude,p_user_mask,p_object_type_mask);
+		if (r_hits[i])
+			hits++;
+	}
+
+	return hits;
+}
+
+int Physics2DDirectSpaceState::cast_motions(const MotionQuery *p_queries,int p_query_count,float p_margin,MotionResult *r_results,const Set<RID>& p_exclude,uint32_t p_user_mask,uint32_t p_object_type_mask) {
+
+	int valid=0;
+	for(int i=0;i<p_query_count;i++) {
+
+		r_results[i].valid=cast_motion(p_queries[i].shape,p_queries[i].xform,p_queries[i].motion,p_margin,r_results[i].closest_safe,r_results[i].closest_unsafe,p_exclude,p_user_mask,p_object_type_mask);
+		if (r_results[i].valid)
+			valid++;
+	}
+
+	return valid;
+}
+
 Physics2DDirectSpaceState::Physics2DDirectSpaceState() {
 
 
@@ -201,8 +317,10 @@ void Physics2DDirectSpaceState::_bind_methods() {
 
 
 	ObjectTypeDB::bind_method(_MD("intersect_ray:Dictionary","from","to","exclude","umask"),&Physics2DDirectSpaceState::_intersect_ray,DEFVAL(Array()),DEFVAL(0));
+	ObjectTypeDB::bind_method(_MD("intersect_rays:Array","from","to","exclude","umask"),&Physics2DDirectSpaceState::_intersect_rays,DEFVAL(Array()),DEFVAL(0));
 	ObjectTypeDB::bind_method(_MD("intersect_shape:Physics2DShapeQueryResult","shape","xform","result_max","exclude","umask"),&Physics2DDirectSpaceState::_intersect_shape,DEFVAL(Array()),DEFVAL(0));
 	ObjectTypeDB::bind_method(_MD("cast_motion","shape","xform","motion","exclude","umask"),&Physics2DDirectSpaceState::_intersect_shape,DEFVAL(Array()),DEFVAL(0));
+	ObjectTypeDB::bind_method(_MD("cast_motions:Array","shape","xforms","motions","exclude","umask"),&Physics2DDirectSpaceState::_cast_motions,DEFVAL(Array()),DEFVAL(0));
 
 }
 
@@ -436,7 +554,7 @@ void Physics2DServer::_bind_methods() {
 
 Physics2DServer::Physics2DServer() {
 
-	ERR_FAIL_COND( singleton!=NULL );
+	//ERR_FAIL_COND( singleton!=NULL ); wrappers replace the server they contain as singleton
 	singleton=this;
 }
 
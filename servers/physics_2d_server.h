@@ -91,6 +91,8 @@ class Physics2DDirectSpaceState : public Object {
 	Variant _intersect_ray(const Vector2& p_from, const Vector2& p_to,const Vector<RID>& p_exclude=Vector<RID>(),uint32_t p_user_mask=0);
 	Variant _intersect_shape(const RID& p_shape, const Matrix32& p_xform,int p_result_max=64,const Vector<RID>& p_exclude=Vector<RID>(),uint32_t p_user_mask=0);
 	Variant _cast_motion(const RID& p_shape, const Matrix32& p_xform,const Vector2& p_motion,const Vector<RID>& p_exclude=Vector<RID>(),uint32_t p_user_mask=0);
+	Array _intersect_rays(const DVector<Vector2>& p_from, const DVector<Vector2>& p_to,const Vector<RID>& p_exclude=Vector<RID>(),uint32_t p_user_mask=0);
+	Array _cast_motions(const RID& p_shape, const Array& p_xforms,const DVector<Vector2>& p_motions,const Vector<RID>& p_exclude=Vector<RID>(),uint32_t p_user_mask=0);
 
 
 protected:
@@ -120,6 +122,15 @@ public:
 
 	virtual bool intersect_ray(const Vector2& p_from, const Vector2& p_to,RayResult &r_result,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION)=0;
 
+	struct RayQuery {
+
+		Vector2 from;
+		Vector2 to;
+	};
+
+	//answers many rays in a single call, r_hits[i] tells whether r_results[i] was filled, returns the amount of hits
+	virtual int intersect_rays(const RayQuery *p_queries,int p_query_count,RayResult *r_results,bool *r_hits,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION);
+
 	struct ShapeResult {
 
 		RID rid;
@@ -135,6 +146,23 @@ public:
 
 	virtual bool cast_motion(const RID& p_shape, const Matrix32& p_xform,const Vector2& p_motion,float p_margin,float &p_closest_safe,float &p_closest_unsafe, const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION)=0;
 
+	struct MotionQuery {
+
+		RID shape;
+		Matrix32 xform;
+		Vector2 motion;
+	};
+
+	struct MotionResult {
+
+		bool valid; //what cast_motion() would return
+		float closest_safe;
+		float closest_unsafe;
+	};
+
+	//casts many shapes in a single call, returns the amount of valid results
+	virtual int cast_motions(const MotionQuery *p_queries,int p_query_count,float p_margin,MotionResult *r_results,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION);
+
 	virtual bool collide_shape(RID p_shape, const Matrix32& p_shape_xform,const Vector2& p_motion,float p_margin,Vector2 *r_results,int p_result_max,int &r_result_count, const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0,uint32_t p_object_type_mask=TYPE_MASK_COLLISION)=0;
 
 	struct ShapeRestInfo {
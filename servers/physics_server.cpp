@@ -135,6 +135,67 @@ Variant PhysicsDirectSpaceState::_intersect_ray(const Vector3& p_from, const Vec
 	return d;
 }
 
+Array PhysicsDirectSpaceState::_intersect_rays(const DVector<Vector3>& p_from, const DVector<Vector3>& p_to,const Vector<RID>& p_exclude,uint32_t p_user_mask) {
+
+	ERR_FAIL_COND_V(p_from.size()!=p_to.size(),Array());
+
+	int count=p_from.size();
+	Array ret;
+	if (count==0)
+		return ret;
+
+	Set<RID> exclude;
+	for(int i=0;i<p_exclude.size();i++)
+		exclude.insert(p_exclude[i]);
+
+	Vector<RayQuery> queries;
+	Vector<RayResult> results;
+	Vector<bool> hits;
+	queries.resize(count);
+	results.resize(count);
+	hits.resize(count);
+
+	DVector<Vector3>::Read fr=p_from.read();
+	DVector<Vector3>::Read tr=p_to.read();
+	for(int i=0;i<count;i++) {
+		queries[i].from=fr[i];
+		queries[i].to=tr[i];
+	}
+
+	intersect_rays(&queries[0],count,&results[0],&hits[0],exclude,p_user_mask);
+
+	ret.resize(count);
+	for(int i=0;i<count;i++) {
+
+		if (!hits[i])
+			continue;
+
+		Dictionary d;
+		d["position"]=results[i].position;
+		d["normal"]=results[i].normal;
+		d["collider_id"]=results[i].collider_id;
+		d["collider"]=results[i].collider;
+		d["shape"]=results[i].shape;
+		d["rid"]=results[i].rid;
+		ret[i]=d;
+	}
+
+	return ret;
+}
+
+int PhysicsDirectSpaceState::intersect_rays(const RayQuery *p_queries,int p_query_count,RayResult *r_results,bool *r_hits,const Set<RID>& p_exclude,uint32_t p_user_mask) {
+
+	int hits=0;
+	for(int i=0;i<p_query_count;i++) {
+
+		r_hits[i]=intersect_ray(p_queries[i].from,p_queries[i].to,r_results[i],p_exclude,p_user_mask);
+		if (r_hits[i])
+			hits++;
+	}
+
+	return hits;
+}
+
 Variant PhysicsDirectSpaceState::_intersect_shape(const RID& p_shape, const Transform& p_xform,int p_result_max,const Vector<RID>& p_exclude,uint32_t p_user_mask) {
 
 
@@ -178,6 +239,7 @@ void PhysicsDirectSpaceState::_bind_methods() {
 
 
 	ObjectTypeDB::bind_method(_MD("intersect_ray","from","to","exclude","umask"),&PhysicsDirectSpaceState::_intersect_ray,DEFVAL(Array()),DEFVAL(0));
+	ObjectTypeDB::bind_method(_MD("intersect_rays:Array","from","to","exclude","umask"),&PhysicsDirectSpaceState::_intersect_rays,DEFVAL(Array()),DEFVAL(0));
 	ObjectTypeDB::bind_method(_MD("intersect_shape:PhysicsShapeQueryResult","shape","xform","result_max","exclude","umask"),&PhysicsDirectSpaceState::_intersect_shape,DEFVAL(Array()),DEFVAL(0));
 
 }
@@ -409,7 +471,7 @@ void PhysicsServer::_bind_methods() {
 
 PhysicsServer::PhysicsServer() {
 
-	ERR_FAIL_COND( singleton!=NULL );
+	//ERR_FAIL_COND( singleton!=NULL ); wrappers replace the server they contain as singleton
 	singleton=this;
 }
 
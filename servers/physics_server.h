@@ -92,6 +92,7 @@ class PhysicsDirectSpaceState : public Object {
 	OBJ_TYPE( PhysicsDirectSpaceState, Object );
 
 	Variant _intersect_ray(const Vector3& p_from, const Vector3& p_to,const Vector<RID>& p_exclude=Vector<RID>(),uint32_t p_user_mask=0);
+	Array _intersect_rays(const DVector<Vector3>& p_from, const DVector<Vector3>& p_to,const Vector<RID>& p_exclude=Vector<RID>(),uint32_t p_user_mask=0);
 	Variant _intersect_shape(const RID& p_shape, const Transform& p_xform,int p_result_max=64,const Vector<RID>& p_exclude=Vector<RID>(),uint32_t p_user_mask=0);
 
 
@@ -112,6 +113,15 @@ public:
 
 	virtual bool intersect_ray(const Vector3& p_from, const Vector3& p_to,RayResult &r_result,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0)=0;
 
+	struct RayQuery {
+
+		Vector3 from;
+		Vector3 to;
+	};
+
+	//answers many rays in a single call, r_hits[i] tells whether r_results[i] was filled, returns the amount of hits
+	virtual int intersect_rays(const RayQuery *p_queries,int p_query_count,RayResult *r_results,bool *r_hits,const Set<RID>& p_exclude=Set<RID>(),uint32_t p_user_mask=0);
+
 	struct ShapeResult {
 
 		RID rid;
@@ -0,0 +1,248 @@
+/*************************************************************************/
+/*  physics_wrap_mt_common.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef PHYSICS_WRAP_MT_COMMON_H
+#define PHYSICS_WRAP_MT_COMMON_H
+
+/* Method wrappers shared by PhysicsServerWrapMT and Physics2DServerWrapMT.
+   The class using them defines server_name (the wrapped server) and ServerName
+   (its type). While a step runs in the server thread, setters are queued behind it
+   and anything returning data waits for the step first, then calls the server directly.
+*/
+
+#define PFUNC0R(m_r,m_func)\
+	virtual m_r m_func() { \
+		_wait_step();\
+		return server_name->m_func();\
+	}
+
+#define PFUNC0RC(m_r,m_func)\
+	virtual m_r m_func() const { \
+		_wait_step();\
+		return server_name->m_func();\
+	}
+
+#define PFUNC0S(m_func)\
+	virtual void m_func() { \
+		_wait_step();\
+		server_name->m_func();\
+	}
+
+#define PFUNC0SC(m_func)\
+	virtual void m_func() const { \
+		_wait_step();\
+		server_name->m_func();\
+	}
+
+#define PFUNC0(m_func)\
+	virtual void m_func() { \
+		if (_must_queue()) {\
+			command_queue.push( server_name, &ServerName::m_func);\
+		} else {\
+			server_name->m_func();\
+		}\
+	}
+
+
+
+#define PFUNC1R(m_r,m_func, m_arg1)\
+	virtual m_r m_func(m_arg1 p1) { \
+		_wait_step();\
+		return server_name->m_func(p1);\
+	}
+
+#define PFUNC1RC(m_r,m_func, m_arg1)\
+	virtual m_r m_func(m_arg1 p1) const { \
+		_wait_step();\
+		return server_name->m_func(p1);\
+	}
+
+#define PFUNC1S(m_func, m_arg1)\
+	virtual void m_func(m_arg1 p1) { \
+		_wait_step();\
+		server_name->m_func(p1);\
+	}
+
+#define PFUNC1SC(m_func, m_arg1)\
+	virtual void m_func(m_arg1 p1) const { \
+		_wait_step();\
+		server_name->m_func(p1);\
+	}
+
+#define PFUNC1(m_func, m_arg1)\
+	virtual void m_func(m_arg1 p1) { \
+		if (_must_queue()) {\
+			command_queue.push( server_name, &ServerName::m_func, p1);\
+		} else {\
+			server_name->m_func(p1);\
+		}\
+	}
+
+
+
+#define PFUNC2R(m_r,m_func, m_arg1, m_arg2)\
+	virtual m_r m_func(m_arg1 p1, m_arg2 p2) { \
+		_wait_step();\
+		return server_name->m_func(p1, p2);\
+	}
+
+#define PFUNC2RC(m_r,m_func, m_arg1, m_arg2)\
+	virtual m_r m_func(m_arg1 p1, m_arg2 p2) const { \
+		_wait_step();\
+		return server_name->m_func(p1, p2);\
+	}
+
+#define PFUNC2S(m_func, m_arg1, m_arg2)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2) { \
+		_wait_step();\
+		server_name->m_func(p1, p2);\
+	}
+
+#define PFUNC2SC(m_func, m_arg1, m_arg2)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2) const { \
+		_wait_step();\
+		server_name->m_func(p1, p2);\
+	}
+
+#define PFUNC2(m_func, m_arg1, m_arg2)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2) { \
+		if (_must_queue()) {\
+			command_queue.push( server_name, &ServerName::m_func, p1, p2);\
+		} else {\
+			server_name->m_func(p1, p2);\
+		}\
+	}
+
+
+
+#define PFUNC3R(m_r,m_func, m_arg1, m_arg2, m_arg3)\
+	virtual m_r m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3) { \
+		_wait_step();\
+		return server_name->m_func(p1, p2, p3);\
+	}
+
+#define PFUNC3RC(m_r,m_func, m_arg1, m_arg2, m_arg3)\
+	virtual m_r m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3) const { \
+		_wait_step();\
+		return server_name->m_func(p1, p2, p3);\
+	}
+
+#define PFUNC3S(m_func, m_arg1, m_arg2, m_arg3)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3) { \
+		_wait_step();\
+		server_name->m_func(p1, p2, p3);\
+	}
+
+#define PFUNC3SC(m_func, m_arg1, m_arg2, m_arg3)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3) const { \
+		_wait_step();\
+		server_name->m_func(p1, p2, p3);\
+	}
+
+#define PFUNC3(m_func, m_arg1, m_arg2, m_arg3)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3) { \
+		if (_must_queue()) {\
+			command_queue.push( server_name, &ServerName::m_func, p1, p2, p3);\
+		} else {\
+			server_name->m_func(p1, p2, p3);\
+		}\
+	}
+
+
+
+#define PFUNC4R(m_r,m_func, m_arg1, m_arg2, m_arg3, m_arg4)\
+	virtual m_r m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) { \
+		_wait_step();\
+		return server_name->m_func(p1, p2, p3, p4);\
+	}
+
+#define PFUNC4RC(m_r,m_func, m_arg1, m_arg2, m_arg3, m_arg4)\
+	virtual m_r m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) const { \
+		_wait_step();\
+		return server_name->m_func(p1, p2, p3, p4);\
+	}
+
+#define PFUNC4S(m_func, m_arg1, m_arg2, m_arg3, m_arg4)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) { \
+		_wait_step();\
+		server_name->m_func(p1, p2, p3, p4);\
+	}
+
+#define PFUNC4SC(m_func, m_arg1, m_arg2, m_arg3, m_arg4)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) const { \
+		_wait_step();\
+		server_name->m_func(p1, p2, p3, p4);\
+	}
+
+#define PFUNC4(m_func, m_arg1, m_arg2, m_arg3, m_arg4)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) { \
+		if (_must_queue()) {\
+			command_queue.push( server_name, &ServerName::m_func, p1, p2, p3, p4);\
+		} else {\
+			server_name->m_func(p1, p2, p3, p4);\
+		}\
+	}
+
+
+
+#define PFUNC5R(m_r,m_func, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)\
+	virtual m_r m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5) { \
+		_wait_step();\
+		return server_name->m_func(p1, p2, p3, p4, p5);\
+	}
+
+#define PFUNC5RC(m_r,m_func, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)\
+	virtual m_r m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5) const { \
+		_wait_step();\
+		return server_name->m_func(p1, p2, p3, p4, p5);\
+	}
+
+#define PFUNC5S(m_func, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5) { \
+		_wait_step();\
+		server_name->m_func(p1, p2, p3, p4, p5);\
+	}
+
+#define PFUNC5SC(m_func, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5) const { \
+		_wait_step();\
+		server_name->m_func(p1, p2, p3, p4, p5);\
+	}
+
+#define PFUNC5(m_func, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)\
+	virtual void m_func(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5) { \
+		if (_must_queue()) {\
+			command_queue.push( server_name, &ServerName::m_func, p1, p2, p3, p4, p5);\
+		} else {\
+			server_name->m_func(p1, p2, p3, p4, p5);\
+		}\
+	}
+
+
+
+#endif
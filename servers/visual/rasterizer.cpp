@@ -536,6 +536,29 @@ void Rasterizer::flush_frame() {
 	//not really necesary to implement
 }
 
+void Rasterizer::canvas_draw_rect_batch(int p_quads, const Vector2* p_vertices, const Vector2* p_uvs, const Color* p_colors, RID p_texture) {
+
+	//generic version, draws the batch as a single polygon
+	ERR_FAIL_COND(p_quads<=0 || p_quads>CANVAS_BATCH_MAX_QUADS);
+
+	if (canvas_batch_indices.empty()) {
+
+		canvas_batch_indices.resize(CANVAS_BATCH_MAX_QUADS*6);
+		for(int i=0;i<CANVAS_BATCH_MAX_QUADS;i++) {
+
+			canvas_batch_indices[i*6+0]=i*4+0;
+			canvas_batch_indices[i*6+1]=i*4+1;
+			canvas_batch_indices[i*6+2]=i*4+2;
+			canvas_batch_indices[i*6+3]=i*4+2;
+			canvas_batch_indices[i*6+4]=i*4+3;
+			canvas_batch_indices[i*6+5]=i*4+0;
+		}
+	}
+
+	canvas_set_opacity(1.0);
+	canvas_draw_polygon(p_quads*6,canvas_batch_indices.ptr(),p_vertices,p_uvs,p_colors,p_texture,false);
+}
+
 Rasterizer::Rasterizer() {
 
 	static const char* fm_names[VS::FIXED_MATERIAL_PARAM_MAX]={
@@ -148,6 +148,8 @@ protected:
 
 	SelfList<FixedMaterial>::List fixed_material_dirty_list;
 
+	Vector<int> canvas_batch_indices;
+
 protected:
 	void _update_fixed_materials();
 	void _free_fixed_material(const RID& p_material);
@@ -492,6 +494,10 @@ public:
 		CANVAS_RECT_FLIP_H=4,
 		CANVAS_RECT_FLIP_V=8
 	};
+
+	enum {
+		CANVAS_BATCH_MAX_QUADS=2048
+	};
 		
 	virtual void canvas_begin()=0;
 	virtual void canvas_set_opacity(float p_opacity)=0;
@@ -505,6 +511,8 @@ public:
 	virtual void canvas_draw_primitive(const Vector<Point2>& p_points, const Vector<Color>& p_colors,const Vector<Point2>& p_uvs, RID p_texture,float p_width)=0;
 	virtual void canvas_draw_polygon(int p_vertex_count, const int* p_indices, const Vector2* p_vertices, const Vector2* p_uvs, const Color* p_colors,const RID& p_texture,bool p_singlecolor)=0;
 	virtual void canvas_set_transform(const Matrix32& p_transform)=0;
+	// quads are 4 vertices each (clockwise), colors are used as they are (canvas opacity is not applied)
+	virtual void canvas_draw_rect_batch(int p_quads, const Vector2* p_vertices, const Vector2* p_uvs, const Color* p_colors, RID p_texture);
 	
 	/* ENVIRONMENT */
 	
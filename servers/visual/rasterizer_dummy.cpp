@@ -1516,6 +1516,11 @@ void RasterizerDummy::canvas_draw_polygon(int p_vertex_count, const int* p_indic
 void RasterizerDummy::canvas_set_transform(const Matrix32& p_transform) {
 
 
+}
+
+void RasterizerDummy::canvas_draw_rect_batch(int p_quads, const Vector2* p_vertices, const Vector2* p_uvs, const Color* p_colors, RID p_texture) {
+
+
 }
 
 /* ENVIRONMENT */
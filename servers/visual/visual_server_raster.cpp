@@ -2251,6 +2251,80 @@ float VisualServerRaster::instance_geometry_get_draw_range_max(RID p_instance) c
 
 }
 
+void VisualServerRaster::instance_geometry_set_lod_meshes(RID p_instance,const Vector<RID>& p_meshes,const Vector<float>& p_distances) {
+
+	VS_CHANGED;
+	Instance *instance = instance_owner.get( p_instance );
+	ERR_FAIL_COND( !instance );
+	ERR_FAIL_COND( p_meshes.size()!=p_distances.size() );
+
+	for(int i=0;i<p_meshes.size();i++) {
+
+		ERR_FAIL_COND( !rasterizer->is_mesh(p_meshes[i]) );
+		ERR_FAIL_COND( i>0 && p_distances[i]<p_distances[i-1] );
+	}
+
+	for(int i=0;i<instance->lod_meshes.size();i++) {
+
+		Map< RID, Set<RID> >::Element * E = instance_lod_map.find( instance->lod_meshes[i] );
+		if (!E)
+			continue; // same mesh used twice
+		E->get().erase( instance->self );
+		if (E->get().size()==0)
+			instance_lod_map.erase(E);
+	}
+
+	instance->lod_meshes=p_meshes;
+	instance->lod_distances=p_distances;
+	instance->lod_level=0;
+
+	for(int i=0;i<p_meshes.size();i++) {
+
+		instance_lod_map[ p_meshes[i] ].insert( instance->self );
+	}
+}
+
+Vector<RID> VisualServerRaster::instance_geometry_get_lod_meshes(RID p_instance) const {
+
+	const Instance *instance = instance_owner.get( p_instance );
+	ERR_FAIL_COND_V( !instance,Vector<RID>() );
+
+	return instance->lod_meshes;
+}
+
+Vector<float> VisualServerRaster::instance_geometry_get_lod_distances(RID p_instance) const {
+
+	const Instance *instance = instance_owner.get( p_instance );
+	ERR_FAIL_COND_V( !instance,Vector<float>() );
+
+	return instance->lod_distances;
+}
+
+void VisualServerRaster::instance_geometry_set_lod_hysteresis(RID p_instance,float p_margin) {
+
+	VS_CHANGED;
+	Instance *instance = instance_owner.get( p_instance );
+	ERR_FAIL_COND( !instance );
+
+	instance->lod_hysteresis=MAX(p_margin,0);
+}
+
+float VisualServerRaster::instance_geometry_get_lod_hysteresis(RID p_instance) const {
+
+	const Instance *instance = instance_owner.get( p_instance );
+	ERR_FAIL_COND_V( !instance,0 );
+
+	return instance->lod_hysteresis;
+}
+
+int VisualServerRaster::instance_geometry_get_lod_level(RID p_instance) const {
+
+	const Instance *instance = instance_owner.get( p_instance );
+	ERR_FAIL_COND_V( !instance,0 );
+
+	return instance->lod_level;
+}
+
 void VisualServerRaster::_update_instance(Instance *p_instance) {
 
 	p_instance->version++;
@@ -2527,8 +2601,10 @@ RID VisualServerRaster::canvas_item_create() {
 	
 	CanvasItem *canvas_item = memnew( CanvasItem );
 	ERR_FAIL_COND_V(!canvas_item,RID());
-		
-	return canvas_item_owner.make_rid( canvas_item );
+
+	RID rid = canvas_item_owner.make_rid( canvas_item );
+	canvas_item->self=rid;
+	return rid;
 }
 
 void VisualServerRaster::canvas_item_set_parent(RID p_item,RID p_parent) {
@@ -2550,6 +2626,7 @@ void VisualServerRaster::canvas_item_set_parent(RID p_item,RID p_parent) {
 		}
 
 		canvas_item->parent=RID();
+		canvas_item->parent_item=NULL;
 	}
 
 
@@ -2564,6 +2641,7 @@ void VisualServerRaster::canvas_item_set_parent(RID p_item,RID p_parent) {
 
 			CanvasItem *item_owner = canvas_item_owner.get(p_parent);
 			item_owner->child_items.push_back(canvas_item);
+			canvas_item->parent_item=item_owner;
 
 		} else {
 
@@ -2575,7 +2653,7 @@ void VisualServerRaster::canvas_item_set_parent(RID p_item,RID p_parent) {
 	}
 
 	canvas_item->parent=p_parent;
-
+	_canvas_item_index_dirty(canvas_item,true);
 
 }
 
@@ -2660,8 +2738,7 @@ const Rect2& VisualServerRaster::CanvasItem::get_rect() const {
 		return rect;
 
 	//must update rect
-	int s=commands.size();
-	if (s==0) {
+	if (!commands) {
 
 		rect=Rect2();
 		rect_dirty=false;
@@ -2672,12 +2749,8 @@ const Rect2& VisualServerRaster::CanvasItem::get_rect() const {
 	bool found_xform=false;
 	bool first=true;
 
-	const CanvasItem::Command * const *cmd = &commands[0];
+	for (const CanvasItem::Command *c=commands;c;c=c->next) {
 
-
-	for (int i=0;i<s;i++) {
-
-		const  CanvasItem::Command *c=cmd[i];
 		Rect2 r;
 
 		switch(c->type) {
@@ -2778,6 +2851,36 @@ const Rect2& VisualServerRaster::CanvasItem::get_rect() const {
 	return rect;
 }
 
+void VisualServerRaster::CanvasItem::clear() {
+
+	for (Command *c=commands;c;) {
+
+		Command *next=c->next;
+		switch(c->type) {
+			case Command::TYPE_PRIMITIVE: static_cast<CommandPrimitive*>(c)->~CommandPrimitive(); break;
+			case Command::TYPE_POLYGON: static_cast<CommandPolygon*>(c)->~CommandPolygon(); break;
+			default: {} //the rest only hold plain data
+		}
+		c=next;
+	}
+
+	for (int i=0;i<blocks.size();i++)
+		blocks[i].usage=0;
+
+	commands=NULL;
+	last_command=NULL;
+	current_block=0;
+	clip=false;
+	rect_dirty=true;
+}
+
+VisualServerRaster::CanvasItem::~CanvasItem() {
+
+	clear();
+	for (int i=0;i<blocks.size();i++)
+		memfree(blocks[i].memory);
+}
+
 void VisualServerRaster::canvas_item_set_transform(RID p_item, const Matrix32& p_transform) {
 
 	VS_CHANGED;
@@ -2785,6 +2888,7 @@ void VisualServerRaster::canvas_item_set_transform(RID p_item, const Matrix32& p
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->xform=p_transform;
+	_canvas_item_index_dirty(canvas_item,true);
 
 }
 
@@ -2797,6 +2901,9 @@ void VisualServerRaster::canvas_item_set_custom_rect(RID p_item, bool p_custom_r
 	canvas_item->custom_rect=p_custom_rect;
 	if (p_custom_rect)
 		canvas_item->rect=p_rect;
+	else
+		canvas_item->rect_dirty=true;
+	_canvas_item_index_dirty(canvas_item);
 
 }
 
@@ -2853,16 +2960,14 @@ void VisualServerRaster::canvas_item_add_line(RID p_item, const Point2& p_from,
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 	
-	CanvasItem::CommandLine * line = memnew( CanvasItem::CommandLine );
+	CanvasItem::CommandLine * line = canvas_item->alloc_command<CanvasItem::CommandLine>();
 	ERR_FAIL_COND(!line);
 	line->color=p_color;
 	line->from=p_from;
 	line->to=p_to;
 	line->width=p_width;
 	canvas_item->rect_dirty=true;
-
-	
-	canvas_item->commands.push_back(line);	
+	_canvas_item_index_dirty(canvas_item);
 }
 
 void VisualServerRaster::canvas_item_add_rect(RID p_item, const Rect2& p_rect, const Color& p_color) {
@@ -2870,13 +2975,12 @@ void VisualServerRaster::canvas_item_add_rect(RID p_item, const Rect2& p_rect, c
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 	
-	CanvasItem::CommandRect * rect = memnew( CanvasItem::CommandRect );
+	CanvasItem::CommandRect * rect = canvas_item->alloc_command<CanvasItem::CommandRect>();
 	ERR_FAIL_COND(!rect);
 	rect->modulate=p_color;
 	rect->rect=p_rect;
 	canvas_item->rect_dirty=true;
-
-	canvas_item->commands.push_back(rect);
+	_canvas_item_index_dirty(canvas_item);
 }
 
 void VisualServerRaster::canvas_item_add_circle(RID p_item, const Point2& p_pos, float p_radius,const Color& p_color) {
@@ -2885,13 +2989,13 @@ void VisualServerRaster::canvas_item_add_circle(RID p_item, const Point2& p_pos,
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 
-	CanvasItem::CommandCircle * circle = memnew( CanvasItem::CommandCircle );
+	CanvasItem::CommandCircle * circle = canvas_item->alloc_command<CanvasItem::CommandCircle>();
 	ERR_FAIL_COND(!circle);
 	circle->color=p_color;
 	circle->pos=p_pos;
 	circle->radius=p_radius;
-
-	canvas_item->commands.push_back(circle);
+	canvas_item->rect_dirty=true;
+	_canvas_item_index_dirty(canvas_item);
 
 }
 
@@ -2900,7 +3004,7 @@ void VisualServerRaster::canvas_item_add_texture_rect(RID p_item, const Rect2& p
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 	
-	CanvasItem::CommandRect * rect = memnew( CanvasItem::CommandRect );
+	CanvasItem::CommandRect * rect = canvas_item->alloc_command<CanvasItem::CommandRect>();
 	ERR_FAIL_COND(!rect);
 	rect->modulate=p_modulate;
 	rect->rect=p_rect;
@@ -2920,7 +3024,7 @@ void VisualServerRaster::canvas_item_add_texture_rect(RID p_item, const Rect2& p
 	}
 	rect->texture=p_texture;
 	canvas_item->rect_dirty=true;
-	canvas_item->commands.push_back(rect);
+	_canvas_item_index_dirty(canvas_item);
 }
 
 void VisualServerRaster::canvas_item_add_texture_rect_region(RID p_item, const Rect2& p_rect, RID p_texture,const Rect2& p_src_rect,const Color& p_modulate)  {
@@ -2928,7 +3032,7 @@ void VisualServerRaster::canvas_item_add_texture_rect_region(RID p_item, const R
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 	
-	CanvasItem::CommandRect * rect = memnew( CanvasItem::CommandRect );
+	CanvasItem::CommandRect * rect = canvas_item->alloc_command<CanvasItem::CommandRect>();
 	ERR_FAIL_COND(!rect);
 	rect->modulate=p_modulate;
 	rect->rect=p_rect;
@@ -2948,8 +3052,7 @@ void VisualServerRaster::canvas_item_add_texture_rect_region(RID p_item, const R
 	}
 
 	canvas_item->rect_dirty=true;
-
-	canvas_item->commands.push_back(rect);	
+	_canvas_item_index_dirty(canvas_item);
 	
 }
 void VisualServerRaster::canvas_item_add_style_box(RID p_item, const Rect2& p_rect, RID p_texture,const Vector2& p_topleft, const Vector2& p_bottomright, bool p_draw_center,const Color& p_modulate) {
@@ -2958,7 +3061,7 @@ void VisualServerRaster::canvas_item_add_style_box(RID p_item, const Rect2& p_re
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 	
-	CanvasItem::CommandStyle * style = memnew( CanvasItem::CommandStyle );
+	CanvasItem::CommandStyle * style = canvas_item->alloc_command<CanvasItem::CommandStyle>();
 	ERR_FAIL_COND(!style);
 	style->texture=p_texture;
 	style->rect=p_rect;
@@ -2969,15 +3072,14 @@ void VisualServerRaster::canvas_item_add_style_box(RID p_item, const Rect2& p_re
 	style->margin[MARGIN_RIGHT]=p_bottomright.x;
 	style->margin[MARGIN_BOTTOM]=p_bottomright.y;
 	canvas_item->rect_dirty=true;
-
-	canvas_item->commands.push_back(style);		
+	_canvas_item_index_dirty(canvas_item);
 }
 void VisualServerRaster::canvas_item_add_primitive(RID p_item,const Vector<Point2>& p_points, const Vector<Color>& p_colors,const Vector<Point2>& p_uvs, RID p_texture,float p_width) {
 	VS_CHANGED;
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 	
-	CanvasItem::CommandPrimitive * prim = memnew( CanvasItem::CommandPrimitive );
+	CanvasItem::CommandPrimitive * prim = canvas_item->alloc_command<CanvasItem::CommandPrimitive>();
 	ERR_FAIL_COND(!prim);
 	prim->texture=p_texture;
 	prim->points=p_points;
@@ -2985,8 +3087,7 @@ void VisualServerRaster::canvas_item_add_primitive(RID p_item,const Vector<Point
 	prim->colors=p_colors;
 	prim->width=p_width;
 	canvas_item->rect_dirty=true;
-
-	canvas_item->commands.push_back(prim);	
+	_canvas_item_index_dirty(canvas_item);
 }
 
 void VisualServerRaster::canvas_item_add_polygon(RID p_item, const Vector<Point2>& p_points, const Vector<Color>& p_colors,const Vector<Point2>& p_uvs, RID p_texture) {
@@ -3010,7 +3111,7 @@ void VisualServerRaster::canvas_item_add_polygon(RID p_item, const Vector<Point2
 		ERR_FAIL_V();
 	}
 
-	CanvasItem::CommandPolygon * polygon = memnew( CanvasItem::CommandPolygon );
+	CanvasItem::CommandPolygon * polygon = canvas_item->alloc_command<CanvasItem::CommandPolygon>();
 	ERR_FAIL_COND(!polygon);
 	polygon->texture=p_texture;
 	polygon->points=p_points;
@@ -3019,8 +3120,7 @@ void VisualServerRaster::canvas_item_add_polygon(RID p_item, const Vector<Point2
 	polygon->indices=indices;
 	polygon->count=indices.size();
 	canvas_item->rect_dirty=true;
-
-	canvas_item->commands.push_back(polygon);
+	_canvas_item_index_dirty(canvas_item);
 
 }
 
@@ -3034,7 +3134,7 @@ void VisualServerRaster::canvas_item_add_triangle_array_ptr(RID p_item, int p_co
 
 	ERR_FAIL_COND(p_points == NULL);
 
-	CanvasItem::CommandPolygonPtr * polygon = memnew( CanvasItem::CommandPolygonPtr );
+	CanvasItem::CommandPolygonPtr * polygon = canvas_item->alloc_command<CanvasItem::CommandPolygonPtr>();
 	ERR_FAIL_COND(!polygon);
 	polygon->texture=p_texture;
 	polygon->points=p_points;
@@ -3043,8 +3143,7 @@ void VisualServerRaster::canvas_item_add_triangle_array_ptr(RID p_item, int p_co
 	polygon->indices=p_indices;
 	polygon->count = p_count * 3;
 	canvas_item->rect_dirty=true;
-
-	canvas_item->commands.push_back(polygon);
+	_canvas_item_index_dirty(canvas_item);
 };
 
 void VisualServerRaster::canvas_item_add_triangle_array(RID p_item, const Vector<int>& p_indices, const Vector<Point2>& p_points, const Vector<Color>& p_colors,const Vector<Point2>& p_uvs, RID p_texture, int p_count) {
@@ -3073,7 +3172,7 @@ void VisualServerRaster::canvas_item_add_triangle_array(RID p_item, const Vector
 			count = indices.size();
 	}
 
-	CanvasItem::CommandPolygon * polygon = memnew( CanvasItem::CommandPolygon );
+	CanvasItem::CommandPolygon * polygon = canvas_item->alloc_command<CanvasItem::CommandPolygon>();
 	ERR_FAIL_COND(!polygon);
 	polygon->texture=p_texture;
 	polygon->points=p_points;
@@ -3082,8 +3181,7 @@ void VisualServerRaster::canvas_item_add_triangle_array(RID p_item, const Vector
 	polygon->indices=indices;
 	polygon->count = count;
 	canvas_item->rect_dirty=true;
-
-	canvas_item->commands.push_back(polygon);
+	_canvas_item_index_dirty(canvas_item);
 }
 
 
@@ -3093,11 +3191,11 @@ void VisualServerRaster::canvas_item_add_set_transform(RID p_item,const Matrix32
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 
-	CanvasItem::CommandTransform * tr = memnew( CanvasItem::CommandTransform );
+	CanvasItem::CommandTransform * tr = canvas_item->alloc_command<CanvasItem::CommandTransform>();
 	ERR_FAIL_COND(!tr);
 	tr->xform=p_transform;
-
-	canvas_item->commands.push_back(tr);
+	canvas_item->rect_dirty=true;
+	_canvas_item_index_dirty(canvas_item);
 
 }
 
@@ -3107,11 +3205,9 @@ void VisualServerRaster::canvas_item_add_set_blend_mode(RID p_item, MaterialBlen
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 
-	CanvasItem::CommandBlendMode * bm = memnew( CanvasItem::CommandBlendMode );
+	CanvasItem::CommandBlendMode * bm = canvas_item->alloc_command<CanvasItem::CommandBlendMode>();
 	ERR_FAIL_COND(!bm);
 	bm->blend_mode = p_blend;
-
-	canvas_item->commands.push_back(bm);
 };
 
 void VisualServerRaster::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
@@ -3120,12 +3216,10 @@ void VisualServerRaster::canvas_item_add_clip_ignore(RID p_item, bool p_ignore)
 	CanvasItem *canvas_item = canvas_item_owner.get( p_item );
 	ERR_FAIL_COND(!canvas_item);
 
-	CanvasItem::CommandClipIgnore * ci = memnew( CanvasItem::CommandClipIgnore);
+	CanvasItem::CommandClipIgnore * ci = canvas_item->alloc_command<CanvasItem::CommandClipIgnore>();
 	ERR_FAIL_COND(!ci);
 	ci->ignore=p_ignore;
 
-	canvas_item->commands.push_back(ci);
-
 }
 
 void VisualServerRaster::canvas_item_clear(RID p_item) {
@@ -3135,6 +3229,7 @@ void VisualServerRaster::canvas_item_clear(RID p_item) {
 	
 	
 	canvas_item->clear();
+	_canvas_item_index_dirty(canvas_item);
 	
 }
 
@@ -3167,6 +3262,237 @@ void VisualServerRaster::canvas_item_raise(RID p_item) {
 
 }
 
+/* CANVAS SPATIAL INDEX */
+
+void VisualServerRaster::_canvas_item_index_dirty(CanvasItem *p_item,bool p_xform) {
+
+	if (!canvas_index_enabled)
+		return;
+
+	if (p_xform)
+		p_item->index_xform_dirty=true;
+	if (!p_item->index_dirty.in_list())
+		canvas_index_dirty_list.add(&p_item->index_dirty);
+}
+
+static _FORCE_INLINE_ uint64_t _canvas_index_key(int p_x,int p_y) {
+
+	return (uint64_t(uint32_t(p_x))<<32)|uint64_t(uint32_t(p_y));
+}
+
+Rect2i VisualServerRaster::_canvas_index_cell_range(const Rect2& p_rect) const {
+
+	static const float limit=1<<30;
+
+	Rect2i r;
+	r.pos.x=CLAMP(Math::floor(p_rect.pos.x/canvas_index_cell_size),-limit,limit);
+	r.pos.y=CLAMP(Math::floor(p_rect.pos.y/canvas_index_cell_size),-limit,limit);
+	r.size.x=CLAMP(Math::floor((p_rect.pos.x+p_rect.size.x)/canvas_index_cell_size),-limit,limit)-r.pos.x;
+	r.size.y=CLAMP(Math::floor((p_rect.pos.y+p_rect.size.y)/canvas_index_cell_size),-limit,limit)-r.pos.y;
+	return r;
+}
+
+void VisualServerRaster::_canvas_index_remove(CanvasItem *p_item) {
+
+	Canvas *canvas=p_item->index_canvas;
+	if (!canvas)
+		return;
+
+	if (p_item->index_large) {
+
+		canvas->index.large.erase(p_item);
+	} else {
+
+		const Rect2i &r=p_item->index_cells;
+		for(int y=r.pos.y;y<=r.pos.y+r.size.y;y++) {
+			for(int x=r.pos.x;x<=r.pos.x+r.size.x;x++) {
+
+				uint64_t key=_canvas_index_key(x,y);
+				Vector<CanvasItem*> *cell=canvas->index.cells.getptr(key);
+				ERR_CONTINUE(!cell);
+				cell->erase(p_item);
+				if (cell->size()==0)
+					canvas->index.cells.erase(key);
+			}
+		}
+	}
+
+	canvas->index.item_count--;
+	p_item->index_canvas=NULL;
+}
+
+void VisualServerRaster::_canvas_index_set(Canvas *p_canvas,CanvasItem *p_item,const Rect2& p_rect) {
+
+	Rect2i r=_canvas_index_cell_range(p_rect);
+
+	if (p_item->index_canvas==p_canvas && p_item->index_cells==r) {
+		//moved within the same cells
+		p_item->index_rect=p_rect;
+		return;
+	}
+
+	_canvas_index_remove(p_item);
+
+	p_item->index_canvas=p_canvas;
+	p_item->index_rect=p_rect;
+	p_item->index_cells=r;
+	p_item->index_large=(int64_t(r.size.x)+1)*(int64_t(r.size.y)+1) > CANVAS_INDEX_MAX_CELLS;
+	p_canvas->index.item_count++;
+
+	if (p_item->index_large) {
+
+		p_canvas->index.large.push_back(p_item);
+		return;
+	}
+
+	for(int y=r.pos.y;y<=r.pos.y+r.size.y;y++) {
+		for(int x=r.pos.x;x<=r.pos.x+r.size.x;x++) {
+
+			p_canvas->index.cells[_canvas_index_key(x,y)].push_back(p_item);
+		}
+	}
+}
+
+void VisualServerRaster::_canvas_index_update_item(CanvasItem *p_item,Canvas *p_canvas,const Matrix32& p_xform,bool p_children) {
+
+	Matrix32 xform = p_xform * p_item->xform;
+
+	// items without commands can't be seen, they are only marked through their children
+	if (p_canvas && (p_item->commands || p_item->custom_rect))
+		_canvas_index_set(p_canvas,p_item,xform.xform(p_item->get_rect()));
+	else
+		_canvas_index_remove(p_item);
+
+	if (!p_children)
+		return;
+
+	for(int i=0;i<p_item->child_items.size();i++) {
+
+		_canvas_index_update_item(p_item->child_items[i],p_canvas,xform,true);
+	}
+}
+
+void VisualServerRaster::_canvas_index_update() {
+
+	while(canvas_index_dirty_list.first()) {
+
+		CanvasItem *item=canvas_index_dirty_list.first()->self();
+		canvas_index_dirty_list.remove(&item->index_dirty);
+
+		bool children=item->index_xform_dirty;
+		item->index_xform_dirty=false;
+
+		// transform of the parent in canvas space, and the canvas the item is in (if any)
+		Matrix32 xform;
+		CanvasItem *top=item;
+		for(CanvasItem *p=item->parent_item;p;p=p->parent_item) {
+
+			xform = p->xform * xform;
+			top=p;
+		}
+
+		Canvas *canvas=NULL;
+		if (top->parent.is_valid() && canvas_owner.owns(top->parent))
+			canvas=canvas_owner.get(top->parent);
+
+		_canvas_index_update_item(item,canvas,xform,children);
+	}
+}
+
+void VisualServerRaster::_canvas_index_cull_item(CanvasItem *p_item,const Rect2& p_rect,uint32_t p_pass,Vector<CanvasItem*> *r_items) {
+
+	if (p_item->index_pass==p_pass || !p_item->index_rect.intersects(p_rect))
+		return;
+
+	p_item->index_pass=p_pass;
+
+	if (r_items) {
+		r_items->push_back(p_item);
+		return;
+	}
+
+	// rendering, parents must be visited to reach the item
+	for(CanvasItem *p=p_item->parent_item;p && p->index_pass!=p_pass;p=p->parent_item) {
+
+		p->index_pass=p_pass;
+	}
+}
+
+void VisualServerRaster::_canvas_index_cull(Canvas *p_canvas,const Rect2& p_rect,uint32_t p_pass,Vector<CanvasItem*> *r_items) {
+
+	Canvas::Index &index=p_canvas->index;
+
+	for(int i=0;i<index.large.size();i++) {
+
+		_canvas_index_cull_item(index.large[i],p_rect,p_pass,r_items);
+	}
+
+	Rect2i r=_canvas_index_cell_range(p_rect);
+
+	if ((int64_t(r.size.x)+1)*(int64_t(r.size.y)+1) > int64_t(index.cells.size())) {
+
+		// more cells in the rect than in use, just go through the used ones
+		const uint64_t *k=NULL;
+		while((k=index.cells.next(k))) {
+
+			const Vector<CanvasItem*> &cell=index.cells[*k];
+			for(int i=0;i<cell.size();i++)
+				_canvas_index_cull_item(cell[i],p_rect,p_pass,r_items);
+		}
+		return;
+	}
+
+	for(int y=r.pos.y;y<=r.pos.y+r.size.y;y++) {
+		for(int x=r.pos.x;x<=r.pos.x+r.size.x;x++) {
+
+			const Vector<CanvasItem*> *cell=index.cells.getptr(_canvas_index_key(x,y));
+			if (!cell)
+				continue;
+			for(int i=0;i<cell->size();i++)
+				_canvas_index_cull_item((*cell)[i],p_rect,p_pass,r_items);
+		}
+	}
+}
+
+void VisualServerRaster::_canvas_item_cull_rect(const CanvasItem *p_item,const Matrix32& p_xform,const Rect2& p_rect,Vector<RID> *r_items) const {
+
+	Matrix32 xform = p_xform * p_item->xform;
+
+	if ((p_item->commands || p_item->custom_rect) && xform.xform(p_item->get_rect()).intersects(p_rect))
+		r_items->push_back(p_item->self);
+
+	for(int i=0;i<p_item->child_items.size();i++) {
+
+		_canvas_item_cull_rect(p_item->child_items[i],xform,p_rect,r_items);
+	}
+}
+
+Vector<RID> VisualServerRaster::canvas_cull_rect(RID p_canvas,const Rect2& p_rect) const {
+
+	Vector<RID> items;
+	Canvas *canvas = canvas_owner.get(p_canvas);
+	ERR_FAIL_COND_V(!canvas,items);
+
+	if (!canvas_index_enabled) {
+
+		for(int i=0;i<canvas->child_items.size();i++)
+			_canvas_item_cull_rect(canvas->child_items[i].item,Matrix32(),p_rect,&items);
+		return items;
+	}
+
+	VisualServerRaster *vsr=const_cast<VisualServerRaster*>(this);
+	vsr->_canvas_index_update(); // check dirty items before culling
+
+	Vector<CanvasItem*> culled;
+	vsr->_canvas_index_cull(canvas,p_rect,vsr->_canvas_index_next_pass(),&culled);
+
+	items.resize(culled.size());
+	for(int i=0;i<culled.size();i++)
+		items[i]=culled[i]->self;
+
+	return items;
+}
+
 /******** CANVAS *********/
 
 
@@ -3231,6 +3557,32 @@ void VisualServerRaster::_free_attached_instances(RID p_rid,bool p_free_scenario
 
 }
 
+void VisualServerRaster::_free_attached_lods(RID p_mesh) {
+
+	// drop the freed mesh (and the levels after it) from every instance using it,
+	// the map entry goes away once no instance refers to the mesh anymore
+	while(true) {
+
+		Map< RID, Set<RID> >::Element * E = instance_lod_map.find( p_mesh );
+		if (!E)
+			break;
+
+		Instance *instance = instance_owner.get( E->get().front()->get() );
+		if (!instance) {
+			ERR_PRINT("lod mesh used by an invalid instance? Bug?");
+			instance_lod_map.erase(E);
+			break;
+		}
+
+		int idx = instance->lod_meshes.find(p_mesh);
+		Vector<RID> meshes = instance->lod_meshes;
+		Vector<float> distances = instance->lod_distances;
+		meshes.resize(idx);
+		distances.resize(idx);
+		instance_geometry_set_lod_meshes(instance->self,meshes,distances);
+	}
+}
+
 void VisualServerRaster::custom_shade_model_set_shader(int p_model, RID p_shader) {
 
 	VS_CHANGED;
@@ -3275,6 +3627,8 @@ void VisualServerRaster::free( RID p_rid ) {
 		//delete the resource
 	
 		_free_attached_instances(p_rid);
+		if (rasterizer->is_mesh(p_rid))
+			_free_attached_lods(p_rid);
 		rasterizer->free(p_rid);
 	} else if (room_owner.owns(p_rid)) {
 
@@ -3345,6 +3699,7 @@ void VisualServerRaster::free( RID p_rid ) {
 		instance_set_room(p_rid,RID());
 		instance_set_scenario(p_rid,RID());
 		instance_set_base(p_rid,RID());
+		instance_geometry_set_lod_meshes(p_rid,Vector<RID>(),Vector<float>());
 			
 		instance_owner.free(p_rid);
 		memdelete(instance);
@@ -3366,6 +3721,17 @@ void VisualServerRaster::free( RID p_rid ) {
 			canvas->viewports.erase( canvas->viewports.front() );
 		}
 
+		// the index goes away with the canvas
+		for (int i=0;i<canvas->index.large.size();i++)
+			canvas->index.large[i]->index_canvas=NULL;
+		const uint64_t *k=NULL;
+		while((k=canvas->index.cells.next(k))) {
+
+			const Vector<CanvasItem*> &cell=canvas->index.cells[*k];
+			for(int i=0;i<cell.size();i++)
+				cell[i]->index_canvas=NULL;
+		}
+
 		for (int i=0;i<canvas->child_items.size();i++) {
 
 			canvas->child_items[i].item->parent=RID();
@@ -3394,9 +3760,13 @@ void VisualServerRaster::free( RID p_rid ) {
 			}
 		}
 
+		_canvas_index_remove(canvas_item);
+
 		for (int i=0;i<canvas_item->child_items.size();i++) {
 
 			canvas_item->child_items[i]->parent=RID();
+			canvas_item->child_items[i]->parent_item=NULL;
+			_canvas_item_index_dirty(canvas_item->child_items[i],true);
 		}
 
 		canvas_item_owner.free( p_rid );
@@ -3447,7 +3817,11 @@ void VisualServerRaster::_instance_draw(Instance *p_instance) {
 				morphs=&p_instance->data.morph_values[0];
 			}
 
-			rasterizer->add_mesh(p_instance->base_rid, &p_instance->data);
+			// morph weights belong to the base mesh, so morphed instances don't switch
+			if (p_instance->lod_level && !morphs)
+				rasterizer->add_mesh(p_instance->lod_meshes[p_instance->lod_level-1], &p_instance->data);
+			else
+				rasterizer->add_mesh(p_instance->base_rid, &p_instance->data);
 		} break;		
 		case INSTANCE_MULTIMESH: {
 			rasterizer->add_multimesh(p_instance->base_rid, &p_instance->data);
@@ -4721,6 +5095,93 @@ void VisualServerRaster::_cull_room(Camera *p_camera, Instance *p_room,Instance
 	
 }
 
+void VisualServerRaster::_cull_instance(Instance *p_instance,const CullRange& p_cull_range,uint32_t p_layer_mask,CullCheck *r_check) const {
+
+	Instance *ins=p_instance;
+	r_check->result=CULL_DISCARD;
+
+	if ((p_layer_mask&ins->layer_mask)==0) {
+
+		//failure
+	} else if (ins->base_type==INSTANCE_LIGHT) {
+
+		r_check->result=CULL_LIGHT;
+		{
+			//compute distance to camera using aabb support
+			Vector3 n = ins->data.transform.basis.xform_inv(p_cull_range.nearp.normal).normalized();
+			Vector3 s = ins->data.transform.xform(ins->aabb.get_support(n));
+			ins->light_info->dtc=p_cull_range.nearp.distance_to(s);
+		}
+
+	} else if ((1<<ins->base_type)&INSTANCE_GEOMETRY_MASK && ins->visible) {
+
+		bool keep=false;
+
+		if (ins->draw_range_end>0) {
+
+			float d = p_cull_range.nearp.distance_to(ins->data.transform.origin);
+			if (d<0)
+				d=0;
+			if (d<ins->draw_range_begin || d>=ins->draw_range_end)
+				return;
+		}
+
+		if (ins->lod_meshes.size()) {
+
+			// the level only moves once the distance is past the switch distance by the hysteresis margin,
+			// it's kept in the instance, so the last camera that rendered it wins
+			float d = p_cull_range.nearp.distance_to(ins->data.transform.origin);
+			int count=ins->lod_meshes.size();
+			const float *distances=ins->lod_distances.ptr();
+			int level=MIN(ins->lod_level,count);
+
+			while(level<count && d>=distances[level]+ins->lod_hysteresis)
+				level++;
+			while(level>0 && d<distances[level-1]-ins->lod_hysteresis)
+				level--;
+
+			ins->lod_level=level;
+		}
+
+		// test if this geometry should be visible
+
+		if (room_cull_enabled) {
+
+			if (ins->visible_in_all_rooms) {
+				keep=true;
+			} else if (ins->room) {
+
+				if (ins->room->room_info->last_visited_pass==render_pass)
+					keep=true;
+			} else if (ins->auto_rooms.size()) {
+
+				for(Set<Instance*>::Element *E=ins->auto_rooms.front();E;E=E->next()) {
+
+					if (E->get()->room_info->last_visited_pass==render_pass) {
+						keep=true;
+						break;
+					}
+				}
+			} else if(exterior_visited)
+				keep=true;
+		} else {
+
+			keep=true;
+		}
+
+		if (keep) {
+			ins->transformed_aabb.project_range_in_plane(p_cull_range.nearp,r_check->min,r_check->max);
+			r_check->result=CULL_GEOMETRY;
+		}
+	}
+}
+
+void VisualServerRaster::_cull_instance_work(void *p_userdata,int p_index) {
+
+	CullWork *work=(CullWork*)p_userdata;
+	work->vsr->_cull_instance(work->instances[p_index],*work->cull_range,work->layer_mask,&work->checks[p_index]);
+}
+
 void VisualServerRaster::_render_camera(Viewport *p_viewport,Camera *p_camera, Scenario *p_scenario) {
 
 
@@ -4770,8 +5231,13 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport,Camera *p_camera, S
 	cull_range.max=cull_range.z_near;
 
 	/* STEP 2 - CULL */
-	int cull_count = p_scenario->octree.cull_convex(planes,instance_cull_result,MAX_INSTANCE_CULL);
+	uint64_t cull_begin = OS::get_singleton()->get_ticks_usec();
+	bool cull_threaded = cull_work_pool.is_threaded() && p_scenario->octree.get_elem_count()>=CULL_THREAD_MIN_INSTANCES;
+
+	int cull_count = p_scenario->octree.cull_convex(planes,&instance_cull_result,cull_threaded?&cull_work_pool:NULL);
+	Instance **cull_result = instance_cull_result.ptr();
 	light_cull_count=0;
+	cull_instances_in_frame+=cull_count;
 
 /*	print_line("OT: "+rtos( (OS::get_singleton()->get_ticks_usec()-t)/1000.0));
 	print_line("OTO: "+itos(p_scenario->octree.get_octant_count()));
@@ -4790,7 +5256,7 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport,Camera *p_camera, S
 	if (room_cull_enabled) {
 		for(int i=0;i<cull_count;i++) {
 
-			Instance *ins = instance_cull_result[i];
+			Instance *ins = cull_result[i];
 			ins->last_render_pass=render_pass;
 
 			if (ins->base_type!=INSTANCE_PORTAL)
@@ -4864,102 +5330,57 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport,Camera *p_camera, S
 	}
 
 	/* STEP 4 - REMOVE FURTHER CULLED OBJECTS, ADD LIGHTS */
-	
-	for(int i=0;i<cull_count;i++) {
-	
-		Instance *ins = instance_cull_result[i];
-				
-		bool keep=false;
-
-
-		if ((camera_layer_mask&ins->layer_mask)==0) {
-
-			//failure
-		} else if (ins->base_type==INSTANCE_LIGHT) {
-
-			if (light_cull_count<MAX_LIGHTS_CULLED) {
-				light_cull_result[light_cull_count++]=ins;
-//				rasterizer->light_instance_set_active_hint(ins->light_info->instance);
-				{
-					//compute distance to camera using aabb support
-					Vector3 n = ins->data.transform.basis.xform_inv(cull_range.nearp.normal).normalized();
-					Vector3 s = ins->data.transform.xform(ins->aabb.get_support(n));
-					ins->light_info->dtc=cull_range.nearp.distance_to(s);
-				}
-			}
 
-		} else if ((1<<ins->base_type)&INSTANCE_GEOMETRY_MASK && ins->visible) {
+	if (instance_cull_checks.size()<cull_count)
+		instance_cull_checks.resize(instance_cull_result.size());
 
+	CullWork cull_work;
+	cull_work.vsr=this;
+	cull_work.instances=cull_result;
+	cull_work.checks=instance_cull_checks.ptr();
+	cull_work.cull_range=&cull_range;
+	cull_work.layer_mask=camera_layer_mask;
 
-			bool discarded=false;
-
-			if (ins->draw_range_end>0) {
-
-				float d = cull_range.nearp.distance_to(ins->data.transform.origin);
-				if (d<0)
-					d=0;
-				discarded=(d<ins->draw_range_begin || d>=ins->draw_range_end);
-
-
-			}
-
-			if (!discarded) {
-
-				// test if this geometry should be visible
-
-				if (room_cull_enabled) {
-
-
-					if (ins->visible_in_all_rooms) {
-						keep=true;
-					} else if (ins->room) {
-
-						if (ins->room->room_info->last_visited_pass==render_pass)
-							keep=true;
-					} else if (ins->auto_rooms.size()) {
-
+	if (cull_threaded) {
+		cull_work_pool.do_work(cull_count,_cull_instance_work,&cull_work);
+	} else {
+		for(int i=0;i<cull_count;i++)
+			_cull_instance_work(&cull_work,i);
+	}
 
-						for(Set<Instance*>::Element *E=ins->auto_rooms.front();E;E=E->next()) {
+	int visible_count=0;
 
-							if (E->get()->room_info->last_visited_pass==render_pass) {
-								keep=true;
-								break;
-							}
-						}
-					} else if(exterior_visited)
-						keep=true;
-				} else {
-
-					keep=true;
-				}
-			}
+	for(int i=0;i<cull_count;i++) {
 
+		Instance *ins = cull_result[i];
+		const CullCheck &check = cull_work.checks[i];
 
-			if (keep) {
-				// update cull range
-				float min,max;
-				ins->transformed_aabb.project_range_in_plane(cull_range.nearp,min,max);
+		if (check.result==CULL_LIGHT && light_cull_count<MAX_LIGHTS_CULLED) {
 
-				if (min<cull_range.min)
-					cull_range.min=min;
-				if (max>cull_range.max)
-					cull_range.max=max;
-			}
-			
+			light_cull_result[light_cull_count++]=ins;
+//			rasterizer->light_instance_set_active_hint(ins->light_info->instance);
 		}
 
-		if (!keep) {
+		if (check.result!=CULL_GEOMETRY) {
 			// remove, no reason to keep
-			cull_count--;
-			SWAP( instance_cull_result[i], instance_cull_result[ cull_count ] );
-			i--;
 			ins->last_render_pass=0; // make invalid
-		} else {
-
-			ins->last_render_pass=render_pass;
+			continue;
 		}
+
+		// update cull range
+		if (check.min<cull_range.min)
+			cull_range.min=check.min;
+		if (check.max>cull_range.max)
+			cull_range.max=check.max;
+
+		ins->last_render_pass=render_pass;
+		cull_result[visible_count++]=ins;
 	}
-	
+
+	cull_count=visible_count;
+	cull_visible_in_frame+=cull_count;
+	cull_usec_in_frame+=OS::get_singleton()->get_ticks_usec()-cull_begin;
+
 	if (cull_range.max > cull_range.z_far )
 		cull_range.max=cull_range.z_far;
 	if (cull_range.min < cull_range.z_near )
@@ -5082,7 +5503,7 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport,Camera *p_camera, S
 
 	for(int i=0;i<cull_count;i++) {
 	
-		Instance *ins = instance_cull_result[i];
+		Instance *ins = cull_result[i];
 
 		ERR_CONTINUE(!((1<<ins->base_type)&INSTANCE_GEOMETRY_MASK));
 		
@@ -5092,6 +5513,151 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport,Camera *p_camera, S
 	rasterizer->end_scene();
 }
 
+void VisualServerRaster::_canvas_begin_direct(const Matrix32& p_xform,const Matrix32& p_extra,float p_opacity,MaterialBlendMode p_blend_mode) {
+
+	_canvas_flush_batch();
+
+	if (canvas_direct)
+		return;
+
+	rasterizer->canvas_begin_rect(p_xform);
+	if (p_extra!=Matrix32())
+		rasterizer->canvas_set_transform(p_extra);
+	rasterizer->canvas_set_opacity(p_opacity);
+	rasterizer->canvas_set_blend_mode(p_blend_mode);
+	canvas_direct=true;
+}
+
+void VisualServerRaster::_canvas_submit_batch() {
+
+	CanvasBatch *b=canvas_batch;
+
+	if (canvas_direct) {
+		rasterizer->canvas_end_rect();
+		canvas_direct=false;
+	}
+
+	//vertices are already transformed to canvas space
+	rasterizer->canvas_begin_rect(Matrix32());
+	rasterizer->canvas_set_blend_mode(b->blend_mode);
+	rasterizer->canvas_draw_rect_batch(b->quads,b->vertices,b->uvs,b->colors,b->texture);
+	rasterizer->canvas_end_rect();
+
+	canvas_batches_in_frame++;
+	canvas_batched_commands_in_frame+=b->commands;
+	b->quads=0;
+	b->commands=0;
+}
+
+VisualServerRaster::CanvasBatch *VisualServerRaster::_canvas_batch_prepare(const RID& p_texture,MaterialBlendMode p_blend_mode,int p_quads) {
+
+	CanvasBatch *b=canvas_batch;
+
+	if (b->quads && (b->texture!=p_texture || b->blend_mode!=p_blend_mode || b->quads+p_quads>CanvasBatch::MAX_QUADS))
+		_canvas_submit_batch();
+
+	if (b->quads==0) {
+
+		if (b->texture!=p_texture) {
+			b->texture=p_texture;
+			if (p_texture.is_valid() && rasterizer->is_texture(p_texture))
+				b->texture_size=Size2(rasterizer->texture_get_width(p_texture),rasterizer->texture_get_height(p_texture));
+			else
+				b->texture_size=Size2();
+		}
+		b->blend_mode=p_blend_mode;
+	}
+
+	return b;
+}
+
+void VisualServerRaster::_canvas_batch_quad(CanvasBatch *p_batch,const Matrix32& p_xform,const Rect2& p_rect,const Rect2& p_uv,const Color& p_color,bool p_flip_h,bool p_flip_v) {
+
+	int ofs=p_batch->quads*4;
+	Vector2 *v=&p_batch->vertices[ofs];
+	Vector2 *uv=&p_batch->uvs[ofs];
+	Color *c=&p_batch->colors[ofs];
+
+	v[0]=p_xform.xform(p_rect.pos);
+	v[1]=p_xform.xform(Vector2(p_rect.pos.x+p_rect.size.width,p_rect.pos.y));
+	v[2]=p_xform.xform(p_rect.pos+p_rect.size);
+	v[3]=p_xform.xform(Vector2(p_rect.pos.x,p_rect.pos.y+p_rect.size.height));
+
+	uv[0]=p_uv.pos;
+	uv[1]=Vector2(p_uv.pos.x+p_uv.size.width,p_uv.pos.y);
+	uv[2]=p_uv.pos+p_uv.size;
+	uv[3]=Vector2(p_uv.pos.x,p_uv.pos.y+p_uv.size.height);
+
+	if (p_flip_h) {
+		SWAP( uv[0], uv[1] );
+		SWAP( uv[2], uv[3] );
+	}
+	if (p_flip_v) {
+		SWAP( uv[1], uv[2] );
+		SWAP( uv[0], uv[3] );
+	}
+
+	c[0]=p_color;
+	c[1]=p_color;
+	c[2]=p_color;
+	c[3]=p_color;
+
+	p_batch->quads++;
+}
+
+void VisualServerRaster::_canvas_batch_rect(const Matrix32& p_xform,const CanvasItem::CommandRect *p_rect,float p_opacity,MaterialBlendMode p_blend_mode) {
+
+	CanvasBatch *b=_canvas_batch_prepare(p_rect->texture,p_blend_mode,1);
+
+	Rect2 uv(0,0,1,1);
+	if (p_rect->flags&Rasterizer::CANVAS_RECT_REGION && b->texture_size.x>0 && b->texture_size.y>0) {
+
+		uv.pos=p_rect->source.pos/b->texture_size;
+		uv.size=p_rect->source.size/b->texture_size;
+	}
+
+	Color c=p_rect->modulate;
+	c.a*=p_opacity;
+	_canvas_batch_quad(b,p_xform,p_rect->rect,uv,c,p_rect->flags&Rasterizer::CANVAS_RECT_FLIP_H,p_rect->flags&Rasterizer::CANVAS_RECT_FLIP_V);
+	b->commands++;
+}
+
+bool VisualServerRaster::_canvas_batch_style(const Matrix32& p_xform,const CanvasItem::CommandStyle *p_style,float p_opacity,MaterialBlendMode p_blend_mode) {
+
+	CanvasBatch *b=_canvas_batch_prepare(p_style->texture,p_blend_mode,9);
+
+	if (b->texture_size.x<=0 || b->texture_size.y<=0)
+		return false; //let the rasterizer report it
+
+	const Rect2 &r=p_style->rect;
+	const float *m=p_style->margin;
+	Size2 ts=b->texture_size;
+	Color c=p_style->color;
+	c.a*=p_opacity;
+
+	//same layout as a nine patch drawn by the rasterizer: columns and rows of the destination and the source
+	float dx[4]={ r.pos.x, r.pos.x+m[MARGIN_LEFT], r.pos.x+r.size.width-m[MARGIN_RIGHT], r.pos.x+r.size.width };
+	float dy[4]={ r.pos.y, r.pos.y+m[MARGIN_TOP], r.pos.y+r.size.height-m[MARGIN_BOTTOM], r.pos.y+r.size.height };
+	float sx[4]={ 0, m[MARGIN_LEFT]/ts.x, (ts.x-m[MARGIN_RIGHT])/ts.x, 1 };
+	float sy[4]={ 0, m[MARGIN_TOP]/ts.y, (ts.y-m[MARGIN_BOTTOM])/ts.y, 1 };
+
+	for(int y=0;y<3;y++) {
+		for(int x=0;x<3;x++) {
+
+			if (x==1 && y==1 && !p_style->draw_center)
+				continue;
+
+			_canvas_batch_quad(b,p_xform,
+				Rect2(dx[x],dy[y],dx[x+1]-dx[x],dy[y+1]-dy[y]),
+				Rect2(sx[x],sy[y],sx[x+1]-sx[x],sy[y+1]-sy[y]),
+				c);
+		}
+	}
+
+	b->commands++;
+	return true;
+}
+
 void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Matrix32& p_transform,const Rect2& p_clip_rect, float p_opacity) {
 
 	CanvasItem *ci = p_canvas_item;
@@ -5099,6 +5665,9 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 	if (!ci->visible)
 		return;
 
+	if (canvas_cull_pass && ci->index_pass!=canvas_cull_pass)
+		return; // neither the item nor its children touch the screen
+
 	if (p_opacity<0.007)
 		return;
 
@@ -5111,6 +5680,7 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 
 	if (global_rect.intersects(p_clip_rect) && ci->viewport.is_valid() && viewport_owner.owns(ci->viewport)) {
 
+		_canvas_flush_batch();
 		Viewport *vp = viewport_owner.get(ci->viewport);
 
 		Point2i from = xform.get_origin() + Point2(viewport_rect.x,viewport_rect.y);
@@ -5127,7 +5697,6 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 		rasterizer->canvas_begin();
 	}
 
-	int s = ci->commands.size();
 	bool reclip=false;
 
 	float opacity = ci->opacity * p_opacity;
@@ -5139,6 +5708,7 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 	CanvasItem **top_items=(CanvasItem**)alloca(child_item_count*sizeof(CanvasItem*));
 
 	if (ci->clip) {
+		_canvas_flush_batch();
 		rasterizer->canvas_set_clip(true,global_rect);
 		canvas_clip=global_rect;
 	}
@@ -5153,31 +5723,37 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 	}
 #endif
 
-	if (s!=0) {
+	if (ci->commands) {
 
 		//Rect2 rect( ci->rect.pos + p_ofs, ci->rect.size);
 
 		if (p_clip_rect.intersects(global_rect)) {
 
-			rasterizer->canvas_begin_rect(xform);
-			rasterizer->canvas_set_opacity( opacity * ci->self_opacity );
-			rasterizer->canvas_set_blend_mode( ci->blend_mode );
-
-			CanvasItem::Command **commands = &ci->commands[0];
+			float item_opacity = opacity * ci->self_opacity;
+			MaterialBlendMode blend_mode = ci->blend_mode;
+			Matrix32 extra;
+			Matrix32 batch_xform = xform;
 
-			for (int i=0;i<s;i++) {
-
-				CanvasItem::Command *c=commands[i];
+			for (CanvasItem::Command *c=ci->commands;c;c=c->next) {
 
 				switch(c->type) {
 					case CanvasItem::Command::TYPE_LINE: {
 
 						CanvasItem::CommandLine* line = static_cast<CanvasItem::CommandLine*>(c);
+						_canvas_begin_direct(xform,extra,item_opacity,blend_mode);
 						rasterizer->canvas_draw_line(line->from,line->to,line->color,line->width);
 					} break;
 					case CanvasItem::Command::TYPE_RECT: {
 
 						CanvasItem::CommandRect* rect = static_cast<CanvasItem::CommandRect*>(c);
+
+						if (canvas_batching) {
+
+							_canvas_batch_rect(batch_xform,rect,item_opacity,blend_mode);
+							break;
+						}
+
+						_canvas_begin_direct(xform,extra,item_opacity,blend_mode);
 //						rasterizer->canvas_draw_rect(rect->rect,rect->region,rect->source,rect->flags&CanvasItem::CommandRect::FLAG_TILE,rect->flags&CanvasItem::CommandRect::FLAG_FLIP_H,rect->flags&CanvasItem::CommandRect::FLAG_FLIP_V,rect->texture,rect->modulate);
 #if 0
 						int flags=0;
@@ -5206,17 +5782,24 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 					case CanvasItem::Command::TYPE_STYLE: {
 
 						CanvasItem::CommandStyle* style = static_cast<CanvasItem::CommandStyle*>(c);
+
+						if (canvas_batching && _canvas_batch_style(batch_xform,style,item_opacity,blend_mode))
+							break;
+
+						_canvas_begin_direct(xform,extra,item_opacity,blend_mode);
 						rasterizer->canvas_draw_style_box(style->rect,style->texture,style->margin,style->draw_center,style->color);
 
 					} break;
 					case CanvasItem::Command::TYPE_PRIMITIVE: {
 
 						CanvasItem::CommandPrimitive* primitive = static_cast<CanvasItem::CommandPrimitive*>(c);
+						_canvas_begin_direct(xform,extra,item_opacity,blend_mode);
 						rasterizer->canvas_draw_primitive(primitive->points,primitive->colors,primitive->uvs,primitive->texture,primitive->width);
 					} break;
 					case CanvasItem::Command::TYPE_POLYGON: {
 
 						CanvasItem::CommandPolygon* polygon = static_cast<CanvasItem::CommandPolygon*>(c);
+						_canvas_begin_direct(xform,extra,item_opacity,blend_mode);
 						rasterizer->canvas_draw_polygon(polygon->count,polygon->indices.ptr(),polygon->points.ptr(),polygon->uvs.ptr(),polygon->colors.ptr(),polygon->texture,polygon->colors.size()==1);
 
 					} break;
@@ -5224,11 +5807,13 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 					case CanvasItem::Command::TYPE_POLYGON_PTR: {
 
 						CanvasItem::CommandPolygonPtr* polygon = static_cast<CanvasItem::CommandPolygonPtr*>(c);
+						_canvas_begin_direct(xform,extra,item_opacity,blend_mode);
 						rasterizer->canvas_draw_polygon(polygon->count,polygon->indices,polygon->points,polygon->uvs,polygon->colors,polygon->texture,false);
 					} break;
 					case CanvasItem::Command::TYPE_CIRCLE: {
 
 						CanvasItem::CommandCircle* circle = static_cast<CanvasItem::CommandCircle*>(c);
+						_canvas_begin_direct(xform,extra,item_opacity,blend_mode);
 						static const int numpoints=32;
 						Vector2 points[numpoints+1];
 						points[numpoints]=circle->pos;
@@ -5247,12 +5832,17 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 					case CanvasItem::Command::TYPE_TRANSFORM: {
 
 						CanvasItem::CommandTransform* transform = static_cast<CanvasItem::CommandTransform*>(c);
-						rasterizer->canvas_set_transform(transform->xform);
+						extra=transform->xform;
+						batch_xform=xform*extra;
+						if (canvas_direct)
+							rasterizer->canvas_set_transform(extra);
 					} break;
 					case CanvasItem::Command::TYPE_BLEND_MODE: {
 
 						CanvasItem::CommandBlendMode* bm = static_cast<CanvasItem::CommandBlendMode*>(c);
-						rasterizer->canvas_set_blend_mode(bm->blend_mode);
+						blend_mode=bm->blend_mode;
+						if (canvas_direct)
+							rasterizer->canvas_set_blend_mode(blend_mode);
 
 					} break;
 					case CanvasItem::Command::TYPE_CLIP_IGNORE: {
@@ -5261,6 +5851,7 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 						if (canvas_clip!=Rect2()) {
 
 							if (ci->ignore!=reclip) {
+								_canvas_flush_batch();
 								if (ci->ignore) {
 
 									rasterizer->canvas_set_clip(false,Rect2());
@@ -5277,13 +5868,18 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 					} break;
 				}
 			}
-			rasterizer->canvas_end_rect();
+
+			if (canvas_direct) {
+				rasterizer->canvas_end_rect();
+				canvas_direct=false;
+			}
 		}
 	}
 
 
 	if (reclip) {
 
+		_canvas_flush_batch();
 		rasterizer->canvas_set_clip(true,canvas_clip);
 	}
 
@@ -5303,6 +5899,7 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 
 
 	if (ci->clip) {
+		_canvas_flush_batch();
 		rasterizer->canvas_set_clip(false,Rect2());
 		canvas_clip=Rect2();
 	}
@@ -5312,9 +5909,39 @@ void VisualServerRaster::_render_canvas_item(CanvasItem *p_canvas_item,const Mat
 void VisualServerRaster::_render_canvas(Canvas *p_canvas,const Matrix32 &p_transform) {
 
 	rasterizer->canvas_begin();
+	canvas_direct=false;
+	canvas_batch->texture=RID(); //size may have changed since last time
 
 	int l = p_canvas->child_items.size();
 
+	// _draw_viewport() may render another canvas from within this one
+	uint32_t prev_cull_pass=canvas_cull_pass;
+	canvas_cull_pass=0;
+
+	float det = p_transform.elements[0][0]*p_transform.elements[1][1] - p_transform.elements[1][0]*p_transform.elements[0][1];
+
+	if (canvas_index_enabled && det!=0) {
+
+		_canvas_index_update();
+
+		uint32_t pass=_canvas_index_next_pass();
+		Rect2 view = p_transform.affine_inverse().xform(Rect2(0,0,viewport_rect.width,viewport_rect.height));
+		_canvas_index_cull(p_canvas,view,pass);
+
+		for(int i=0;i<l;i++) {
+			//mirrored copies see the canvas through a displaced view
+			Point2 mirror=p_canvas->child_items[i].mirror;
+			if (mirror.x!=0)
+				_canvas_index_cull(p_canvas,Rect2(view.pos-Point2(mirror.x,0),view.size),pass);
+			if (mirror.y!=0)
+				_canvas_index_cull(p_canvas,Rect2(view.pos-Point2(0,mirror.y),view.size),pass);
+			if (mirror.x!=0 && mirror.y!=0)
+				_canvas_index_cull(p_canvas,Rect2(view.pos-mirror,view.size),pass);
+		}
+
+		canvas_cull_pass=pass;
+	}
+
 	for(int i=0;i<l;i++) {
 
 		Canvas::ChildItem& ci=p_canvas->child_items[i];
@@ -5339,6 +5966,8 @@ void VisualServerRaster::_render_canvas(Canvas *p_canvas,const Matrix32 &p_trans
 
 	}
 
+	_canvas_flush_batch();
+	canvas_cull_pass=prev_cull_pass;
 }
 
 
@@ -5557,6 +6186,12 @@ void VisualServerRaster::draw() {
 	shadows_enabled=GLOBAL_DEF("render/shadows_enabled",true);
 	room_cull_enabled = GLOBAL_DEF("render/room_cull_enabled",true);
 	light_discard_enabled = GLOBAL_DEF("render/light_discard_enabled",true);
+	canvas_batching = GLOBAL_DEF("render/canvas_batching",true);
+	canvas_batches_in_frame=0;
+	canvas_batched_commands_in_frame=0;
+	cull_instances_in_frame=0;
+	cull_visible_in_frame=0;
+	cull_usec_in_frame=0;
 	rasterizer->begin_frame();
 	_draw_viewports();
 	_draw_cursors_and_margins();
@@ -5571,6 +6206,16 @@ bool VisualServerRaster::has_changed() const {
 
 int VisualServerRaster::get_render_info(RenderInfo p_info) {
 
+	switch(p_info) {
+
+		case INFO_CANVAS_BATCHES_IN_FRAME: return canvas_batches_in_frame;
+		case INFO_CANVAS_BATCHED_COMMANDS_IN_FRAME: return canvas_batched_commands_in_frame;
+		case INFO_CULL_INSTANCES_IN_FRAME: return cull_instances_in_frame;
+		case INFO_CULL_VISIBLE_IN_FRAME: return cull_visible_in_frame;
+		case INFO_CULL_USEC_IN_FRAME: return cull_usec_in_frame;
+		default: {}
+	}
+
 	return rasterizer->get_render_info(p_info);
 }
 
@@ -5624,6 +6269,9 @@ void VisualServerRaster::init() {
 	rasterizer->init();
 	
 	shadows_enabled=GLOBAL_DEF("render/shadows_enabled",true);
+	canvas_index_enabled=GLOBAL_DEF("render/canvas_spatial_index",true);
+	canvas_index_cell_size=MAX(1.0,(float)GLOBAL_DEF("render/canvas_spatial_index_cell_size",256));
+	cull_work_pool.init(GLOBAL_DEF("render/cull_thread_count",0)); // 0 is one per processor
 	//default_scenario = scenario_create();
 	//default_viewport = viewport_create();
 	for(int i=0;i<4;i++)
@@ -5678,6 +6326,7 @@ void VisualServerRaster::finish() {
 
 	rasterizer->finish();
 	octree_allocator.clear();
+	cull_work_pool.finish();
 	
 	if (instance_dependency_map.size()) {
 		print_line("base resources missing "+itos(instance_dependency_map.size()));
@@ -5706,12 +6355,25 @@ VisualServerRaster::VisualServerRaster(Rasterizer *p_rasterizer) {
 	clear_color=Color(0.3,0.3,0.3,1.0);
 	OctreeAllocator::allocator=&octree_allocator;
 	draw_extra_frame=false;
+	canvas_batch=memnew( CanvasBatch );
+	canvas_batching=true;
+	canvas_direct=false;
+	canvas_batches_in_frame=0;
+	canvas_batched_commands_in_frame=0;
+	canvas_index_enabled=false;
+	canvas_index_cell_size=256;
+	canvas_index_pass=0;
+	canvas_cull_pass=0;
+	cull_instances_in_frame=0;
+	cull_visible_in_frame=0;
+	cull_usec_in_frame=0;
 
 }
 
 
 VisualServerRaster::~VisualServerRaster()
 {
+	memdelete(canvas_batch);
 }
 
 
@@ -34,6 +34,9 @@
 #include "servers/visual/rasterizer.h"
 #include "balloon_allocator.h"
 #include "octree.h"
+#include "hash_map.h"
+#include "os/thread_work_pool.h"
+#include "self_list.h"
 
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
@@ -51,7 +54,9 @@ class VisualServerRaster : public VisualServer {
 		MAX_LIGHTS_CULLED=256,
 		MAX_ROOM_CULL=32,
 		MAX_EXTERIOR_PORTALS=128,
-		INSTANCE_ROOMLESS_MASK=(1<<20)
+		INSTANCE_ROOMLESS_MASK=(1<<20),
+		CULL_THREAD_MIN_INSTANCES=1024, // scenarios smaller than this are culled on one thread
+		CANVAS_INDEX_MAX_CELLS=64 // items covering more cells go to Canvas::Index::large
 
 
 	};
@@ -150,6 +155,11 @@ class VisualServerRaster : public VisualServer {
 		float draw_range_end;
 		float extra_margin;
 
+		Vector<RID> lod_meshes; // lod_meshes[i] is drawn instead of base_rid from lod_distances[i] on
+		Vector<float> lod_distances;
+		float lod_hysteresis;
+		int lod_level; // picked while culling, 0 is base_rid
+
 
 		Rasterizer::InstanceData data;
 
@@ -254,6 +264,8 @@ class VisualServerRaster : public VisualServer {
 			draw_range_begin=0;
 			draw_range_end=0;
 			extra_margin=0;
+			lod_hysteresis=0;
+			lod_level=0;
 			visible_in_all_rooms=false;
 
 			light_cache_dirty=true;
@@ -300,6 +312,8 @@ class VisualServerRaster : public VisualServer {
 
 	
 
+	struct Canvas;
+
 	struct CanvasItem {
 		
 		struct Command {
@@ -319,6 +333,9 @@ class VisualServerRaster : public VisualServer {
 			};
 			
 			Type type;
+			Command *next;
+
+			Command() { next=NULL; }
 		};
 		
 		struct CommandLine : public Command {
@@ -410,7 +427,9 @@ class VisualServerRaster : public VisualServer {
 			CommandClipIgnore() { type = TYPE_CLIP_IGNORE; ignore=false; };
 		};
 
+		RID self;
 		RID parent; // canvas it belongs to
+		CanvasItem *parent_item; // NULL when the parent is a canvas
 		List<CanvasItem*>::Element *E;
 		Matrix32 xform;
 		bool clip;
@@ -425,13 +444,73 @@ class VisualServerRaster : public VisualServer {
 		mutable bool rect_dirty;
 		mutable Rect2 rect;
 		
-		Vector<Command*> commands;
+		/* Commands are constructed in place on blocks owned by the item and
+		 * chained in drawing order. clear() keeps the blocks, so items that
+		 * are redrawn every frame stop allocating after the first time. */
+
+		enum {
+			COMMAND_BLOCK_MIN_SIZE=256,
+			COMMAND_BLOCK_MAX_SIZE=4096
+		};
+
+		struct CommandBlock {
+
+			uint8_t *memory;
+			uint32_t size;
+			uint32_t usage;
+		};
+
+		Command *commands;
+		Command *last_command;
+		Vector<CommandBlock> blocks;
+		int current_block;
+
+		template<class T>
+		T* alloc_command() {
+
+			uint32_t size=(sizeof(T)+7)&~7; //keep the next command aligned
+
+			while(current_block<blocks.size() && blocks[current_block].usage+size>blocks[current_block].size)
+				current_block++;
+
+			if (current_block==blocks.size()) {
+
+				CommandBlock block;
+				block.size=blocks.size()?MIN(blocks[blocks.size()-1].size*2,(uint32_t)COMMAND_BLOCK_MAX_SIZE):(uint32_t)COMMAND_BLOCK_MIN_SIZE;
+				block.size=MAX(block.size,size);
+				block.usage=0;
+				block.memory=(uint8_t*)memalloc(block.size);
+				blocks.push_back(block);
+			}
+
+			CommandBlock &block=blocks[current_block];
+			T *command=memnew_placement(block.memory+block.usage,T);
+			block.usage+=size;
+
+			if (last_command)
+				last_command->next=command;
+			else
+				commands=command;
+			last_command=command;
+
+			return command;
+		}
+
 		Vector<CanvasItem*> child_items;
 
+		// spatial index, see Canvas::Index
+		Canvas *index_canvas; // canvas whose index holds this item
+		Rect2 index_rect; // rect in canvas space
+		Rect2i index_cells; // cell range, inclusive
+		bool index_large;
+		bool index_xform_dirty; // children must be updated too
+		uint32_t index_pass;
+		SelfList<CanvasItem> index_dirty;
+
 		const Rect2& get_rect() const;
-		void clear() { for (int i=0;i<commands.size();i++) memdelete( commands[i] ); commands.clear(); clip=false; rect_dirty=true;};
-		CanvasItem() { clip=false; E=NULL; opacity=1; self_opacity=1; blend_mode=MATERIAL_BLEND_MODE_MIX; visible=true; rect_dirty=true; custom_rect=false; ontop=true; }
-		~CanvasItem() { clear(); }
+		void clear();
+		CanvasItem() : index_dirty(this) { commands=NULL; last_command=NULL; current_block=0; clip=false; E=NULL; parent_item=NULL; opacity=1; self_opacity=1; blend_mode=MATERIAL_BLEND_MODE_MIX; visible=true; rect_dirty=true; custom_rect=false; ontop=true; index_canvas=NULL; index_large=false; index_xform_dirty=false; index_pass=0; }
+		~CanvasItem();
 	};
 
 
@@ -448,6 +527,22 @@ class VisualServerRaster : public VisualServer {
 
 		Vector<ChildItem> child_items;
 
+		/* Loose grid over the canvas space rects of all the items in the
+		 * canvas (at any depth), so rendering and picking only visit the
+		 * items that overlap a given rect. Items spanning too many cells
+		 * are kept in a separate list and always tested. */
+
+		struct Index {
+
+			HashMap<uint64_t,Vector<CanvasItem*> > cells;
+			Vector<CanvasItem*> large;
+			int item_count;
+
+			Index() { item_count=0; }
+		};
+
+		Index index;
+
 		int find_item(CanvasItem *p_item) {
 			for(int i=0;i<child_items.size();i++) {
 				if (child_items[i].item==p_item)
@@ -546,6 +641,38 @@ class VisualServerRaster : public VisualServer {
 	};
 
 	Rect2 canvas_clip;
+
+	struct CanvasBatch {
+
+		enum {
+			MAX_QUADS=Rasterizer::CANVAS_BATCH_MAX_QUADS
+		};
+
+		RID texture;
+		Size2 texture_size;
+		MaterialBlendMode blend_mode;
+		int quads;
+		int commands;
+
+		Vector2 vertices[MAX_QUADS*4];
+		Vector2 uvs[MAX_QUADS*4];
+		Color colors[MAX_QUADS*4];
+
+		CanvasBatch() { quads=0; commands=0; blend_mode=MATERIAL_BLEND_MODE_MIX; }
+	};
+
+	CanvasBatch *canvas_batch;
+	bool canvas_batching;
+	bool canvas_direct; // canvas_begin_rect() was called for the item being drawn
+	int canvas_batches_in_frame;
+	int canvas_batched_commands_in_frame;
+
+	bool canvas_index_enabled;
+	float canvas_index_cell_size;
+	uint32_t canvas_index_pass;
+	uint32_t canvas_cull_pass; // when not zero, only items marked with it are rendered
+	SelfList<CanvasItem>::List canvas_index_dirty_list;
+
 	Color clear_color;
 	Cursor cursors[MAX_CURSORS];
 	RID default_cursor_texture;
@@ -553,7 +680,40 @@ class VisualServerRaster : public VisualServer {
 	static void* instance_pair(void *p_self, OctreeElementID,Instance *p_A,int, OctreeElementID,Instance *p_B,int);
 	static void instance_unpair(void *p_self, OctreeElementID,Instance *p_A,int, OctreeElementID,Instance *p_B,int,void*);
 
-	Instance *instance_cull_result[MAX_INSTANCE_CULL];
+	/* Camera culling has no limit on the amount of instances. The octree
+	 * walk and the per instance tests (layers, draw range, rooms) are split
+	 * among cull_work_pool threads, results are then gathered in order. */
+
+	enum CullResult {
+		CULL_DISCARD,
+		CULL_LIGHT,
+		CULL_GEOMETRY
+	};
+
+	struct CullCheck {
+
+		float min,max; // geometry projected on the near plane
+		CullResult result;
+	};
+
+	struct CullWork {
+
+		VisualServerRaster *vsr;
+		Instance **instances;
+		CullCheck *checks;
+		const CullRange *cull_range;
+		uint32_t layer_mask;
+	};
+
+	Vector<Instance*> instance_cull_result;
+	Vector<CullCheck> instance_cull_checks;
+	ThreadWorkPool cull_work_pool;
+	int cull_instances_in_frame;
+	int cull_visible_in_frame;
+	uint64_t cull_usec_in_frame;
+
+	void _cull_instance(Instance *p_instance,const CullRange& p_cull_range,uint32_t p_layer_mask,CullCheck *r_check) const;
+	static void _cull_instance_work(void *p_userdata,int p_index);
 	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
 	Instance *light_cull_result[MAX_LIGHTS_CULLED];	
 	int light_cull_count;
@@ -582,6 +742,7 @@ class VisualServerRaster : public VisualServer {
 	void _update_instance_aabb(Instance *p_instance);
 	void _update_instance(Instance *p_instance);
 	void _free_attached_instances(RID p_rid,bool p_free_scenario=false);
+	void _free_attached_lods(RID p_mesh);
 	void _clean_up_owner(RID_OwnerBase *p_owner,String p_type);
 	
 	Instance *instance_update_list;
@@ -605,6 +766,7 @@ class VisualServerRaster : public VisualServer {
 	mutable RID_Owner<CanvasItem> canvas_item_owner;
 
 	Map< RID, Set<RID> > instance_dependency_map;
+	Map< RID, Set<RID> > instance_lod_map; // lod mesh -> instances using it
 	
 	
 	ViewportRect viewport_rect;
@@ -615,7 +777,25 @@ class VisualServerRaster : public VisualServer {
 	void _cull_room(Camera *p_camera, Instance *p_room,Instance *p_from_portal=NULL);
 	void _render_camera(Viewport *p_viewport,Camera *p_camera, Scenario *p_scenario);
 	void _render_canvas_item(CanvasItem *p_canvas_item,const Matrix32& p_transform,const Rect2& p_clip_rect,float p_opacity);
+	void _canvas_begin_direct(const Matrix32& p_xform,const Matrix32& p_extra,float p_opacity,MaterialBlendMode p_blend_mode);
+	void _canvas_submit_batch();
+	_FORCE_INLINE_ void _canvas_flush_batch() { if (canvas_batch->quads) _canvas_submit_batch(); }
+	_FORCE_INLINE_ CanvasBatch *_canvas_batch_prepare(const RID& p_texture,MaterialBlendMode p_blend_mode,int p_quads);
+	_FORCE_INLINE_ void _canvas_batch_quad(CanvasBatch *p_batch,const Matrix32& p_xform,const Rect2& p_rect,const Rect2& p_uv,const Color& p_color,bool p_flip_h=false,bool p_flip_v=false);
+	void _canvas_batch_rect(const Matrix32& p_xform,const CanvasItem::CommandRect *p_rect,float p_opacity,MaterialBlendMode p_blend_mode);
+	bool _canvas_batch_style(const Matrix32& p_xform,const CanvasItem::CommandStyle *p_style,float p_opacity,MaterialBlendMode p_blend_mode);
 	void _render_canvas(Canvas *p_canvas,const Matrix32 &p_transform);
+
+	void _canvas_item_index_dirty(CanvasItem *p_item,bool p_xform=false);
+	Rect2i _canvas_index_cell_range(const Rect2& p_rect) const;
+	void _canvas_index_remove(CanvasItem *p_item);
+	void _canvas_index_set(Canvas *p_canvas,CanvasItem *p_item,const Rect2& p_rect);
+	void _canvas_index_update_item(CanvasItem *p_item,Canvas *p_canvas,const Matrix32& p_xform,bool p_children);
+	void _canvas_index_update();
+	_FORCE_INLINE_ uint32_t _canvas_index_next_pass() { if (++canvas_index_pass==0) canvas_index_pass=1; return canvas_index_pass; }
+	_FORCE_INLINE_ void _canvas_index_cull_item(CanvasItem *p_item,const Rect2& p_rect,uint32_t p_pass,Vector<CanvasItem*> *r_items);
+	void _canvas_index_cull(Canvas *p_canvas,const Rect2& p_rect,uint32_t p_pass,Vector<CanvasItem*> *r_items=NULL);
+	void _canvas_item_cull_rect(const CanvasItem *p_item,const Matrix32& p_xform,const Rect2& p_rect,Vector<RID> *r_items) const;
 	Vector<Vector3> _camera_generate_endpoints(Instance *p_light,Camera *p_camera,float p_range_min, float p_range_max);
 	Vector<Plane> _camera_generate_orthogonal_planes(Instance *p_light,Camera *p_camera,float p_range_min, float p_range_max);
 
@@ -1013,11 +1193,19 @@ public:
 	virtual float instance_geometry_get_draw_range_max(RID p_instance) const;
 	virtual float instance_geometry_get_draw_range_min(RID p_instance) const;
 
+	virtual void instance_geometry_set_lod_meshes(RID p_instance,const Vector<RID>& p_meshes,const Vector<float>& p_distances);
+	virtual Vector<RID> instance_geometry_get_lod_meshes(RID p_instance) const;
+	virtual Vector<float> instance_geometry_get_lod_distances(RID p_instance) const;
+	virtual void instance_geometry_set_lod_hysteresis(RID p_instance,float p_margin);
+	virtual float instance_geometry_get_lod_hysteresis(RID p_instance) const;
+	virtual int instance_geometry_get_lod_level(RID p_instance) const;
+
 	/* CANVAS (2D) */
 	
 	virtual RID canvas_create();
 	virtual void canvas_set_item_mirroring(RID p_canvas,RID p_item,const Point2& p_mirroring);
 	virtual Point2 canvas_get_item_mirroring(RID p_canvas,RID p_item) const;
+	virtual Vector<RID> canvas_cull_rect(RID p_canvas,const Rect2& p_rect) const;
 
 	virtual RID canvas_item_create();
 
@@ -156,6 +156,12 @@ void VisualServerWrapMT::init() {
 
 void VisualServerWrapMT::finish() {
 
+	if (OS::get_singleton()->is_stdout_verbose()) {
+
+		const CommandQueueMT::Stats &stats=command_queue.get_stats();
+		print_line("Visual server command queue: "+itos(stats.commands_pushed)+" commands, "+itos(stats.bytes_pushed/1024)+" KB pushed, "+itos(stats.stalls)+" stalls, "+itos(stats.sync_waits)+" sync waits ("+itos(stats.sync_wait_usec/1000)+" msec), "+itos(stats.memory_used/1024)+" KB in use.");
+	}
+
 
 	if (thread) {
 
@@ -952,12 +952,20 @@ public:
 	FUNC1RC(float,instance_geometry_get_draw_range_max,RID);
 	FUNC1RC(float,instance_geometry_get_draw_range_min,RID);
 
+	FUNC3(instance_geometry_set_lod_meshes,RID,const Vector<RID>&,const Vector<float>&);
+	FUNC1RC(Vector<RID>,instance_geometry_get_lod_meshes,RID);
+	FUNC1RC(Vector<float>,instance_geometry_get_lod_distances,RID);
+	FUNC2(instance_geometry_set_lod_hysteresis,RID,float);
+	FUNC1RC(float,instance_geometry_get_lod_hysteresis,RID);
+	FUNC1RC(int,instance_geometry_get_lod_level,RID);
+
 
 	/* CANVAS (2D) */
 
 	FUNC0R(RID,canvas_create);
 	FUNC3(canvas_set_item_mirroring,RID,RID,const Point2&);
 	FUNC2RC(Point2,canvas_get_item_mirroring,RID,RID);
+	FUNC2RC(Vector<RID>,canvas_cull_rect,RID,const Rect2&);
 
 	FUNC0R(RID,canvas_item_create);
 
@@ -1048,6 +1056,9 @@ public:
 	FUNC0R(RID,get_test_cube );
 
 
+	// to tell when the render thread can't keep up: stalls grow the queue, sync waits block the caller
+	const CommandQueueMT::Stats& get_command_queue_stats() const { return command_queue.get_stats(); }
+
 	VisualServerWrapMT(VisualServer* p_contained,bool p_create_thread);
 	~VisualServerWrapMT();
 
@@ -470,6 +470,7 @@ void VisualServer::_bind_methods() {
 
 	ObjectTypeDB::bind_method(_MD("canvas_item_clear"),&VisualServer::canvas_item_clear);
 	ObjectTypeDB::bind_method(_MD("canvas_item_raise"),&VisualServer::canvas_item_raise);
+	ObjectTypeDB::bind_method(_MD("canvas_cull_rect"),&VisualServer::canvas_cull_rect);
 
 
 	ObjectTypeDB::bind_method(_MD("cursor_set_rotation"),&VisualServer::cursor_set_rotation);
@@ -626,6 +627,11 @@ void VisualServer::_bind_methods() {
 	BIND_CONSTANT( INFO_VIDEO_MEM_USED );
 	BIND_CONSTANT( INFO_TEXTURE_MEM_USED );
 	BIND_CONSTANT( INFO_VERTEX_MEM_USED );
+	BIND_CONSTANT( INFO_CANVAS_BATCHES_IN_FRAME );
+	BIND_CONSTANT( INFO_CANVAS_BATCHED_COMMANDS_IN_FRAME );
+	BIND_CONSTANT( INFO_CULL_INSTANCES_IN_FRAME );
+	BIND_CONSTANT( INFO_CULL_VISIBLE_IN_FRAME );
+	BIND_CONSTANT( INFO_CULL_USEC_IN_FRAME );
 
 
 }
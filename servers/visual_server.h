@@ -818,12 +818,22 @@ public:
 	virtual float instance_geometry_get_draw_range_max(RID p_instance) const=0;
 	virtual float instance_geometry_get_draw_range_min(RID p_instance) const=0;
 
+	// lod meshes replace the base mesh from their switch distance on (distances must be ascending),
+	// hysteresis is the margin around each switch distance that must be crossed to change level
+	virtual void instance_geometry_set_lod_meshes(RID p_instance,const Vector<RID>& p_meshes,const Vector<float>& p_distances)=0;
+	virtual Vector<RID> instance_geometry_get_lod_meshes(RID p_instance) const=0;
+	virtual Vector<float> instance_geometry_get_lod_distances(RID p_instance) const=0;
+	virtual void instance_geometry_set_lod_hysteresis(RID p_instance,float p_margin)=0;
+	virtual float instance_geometry_get_lod_hysteresis(RID p_instance) const=0;
+	virtual int instance_geometry_get_lod_level(RID p_instance) const=0; // 0 is the base mesh
+
 
 	/* CANVAS (2D) */
 
 	virtual RID canvas_create()=0;
 	virtual void canvas_set_item_mirroring(RID p_canvas,RID p_item,const Point2& p_mirroring)=0;
 	virtual Point2 canvas_get_item_mirroring(RID p_canvas,RID p_item) const=0;
+	virtual Vector<RID> canvas_cull_rect(RID p_canvas,const Rect2& p_rect) const=0; // canvas items whose rect (in canvas space) intersects p_rect
 
 
 	virtual RID canvas_item_create()=0;
@@ -915,6 +925,11 @@ public:
 		INFO_VIDEO_MEM_USED,
 		INFO_TEXTURE_MEM_USED,
 		INFO_VERTEX_MEM_USED,
+		INFO_CANVAS_BATCHES_IN_FRAME,
+		INFO_CANVAS_BATCHED_COMMANDS_IN_FRAME,
+		INFO_CULL_INSTANCES_IN_FRAME,
+		INFO_CULL_VISIBLE_IN_FRAME,
+		INFO_CULL_USEC_IN_FRAME,
 	};
 
 	virtual int get_render_info(RenderInfo p_info)=0;
@@ -35,6 +35,7 @@
 #include "scene/animation/animation_player.h"
 #include "io/resource_saver.h"
 #include "scene/3d/mesh_instance.h"
+#include "scene/resources/mesh_simplifier.h"
 #include "scene/3d/room_instance.h"
 #include "scene/3d/portal.h"
 
@@ -519,6 +520,7 @@ static const char *scene_flag_names[]={
 	"Compress Geometry",
 	"Fail on Missing Images",
 	"Force Generation of Tangent Arrays",
+	"Generate LODs (Simplified Meshes)",
 	NULL
 };
 
@@ -602,16 +604,18 @@ EditorSceneImportDialog::EditorSceneImportDialog(EditorNode *p_editor, EditorSce
 	importopts->set_text(0,"Import:");
 
 	const char ** fn=scene_flag_names;
+	int flag_idx=0;
 
 	while(*fn) {
 
 		TreeItem *opt = import_options->create_item(importopts);
 		opt->set_cell_mode(0,TreeItem::CELL_MODE_CHECK);
-		opt->set_checked(0,true);
+		opt->set_checked(0,EditorSceneImportPlugin::SCENE_FLAGS_DEFAULT&(1<<flag_idx));
 		opt->set_editable(0,true);
 		opt->set_text(0,*fn);
 		scene_flags.push_back(opt);
 		fn++;
+		flag_idx++;
 	}
 
 	hbc = memnew( HBoxContainer );
@@ -1178,6 +1182,56 @@ Node* EditorSceneImportPlugin::_fix_node(Node *p_node,Node *p_root,Map<Ref<Mesh>
 }
 
 
+void EditorSceneImportPlugin::_generate_lods(Node *p_node,Map<Ref<Mesh>,Array> &p_lod_map) {
+
+	for(int i=0;i<p_node->get_child_count();i++)
+		_generate_lods(p_node->get_child(i),p_lod_map);
+
+	MeshInstance *mi = p_node->cast_to<MeshInstance>();
+	if (!mi || mi->get_mesh().is_null())
+		return;
+
+	Ref<Mesh> mesh = mi->get_mesh();
+
+	if (!p_lod_map.has(mesh)) {
+
+		// each level halves the previous one, stop once it doesn't get any simpler
+		Array lods;
+		if (mesh->get_morph_target_count()==0) {
+
+			Ref<MeshSimplifier> simplifier = memnew( MeshSimplifier );
+			int faces=mesh->get_faces().size();
+
+			for(int i=0;i<LOD_LEVELS && faces>=LOD_MIN_FACES;i++) {
+
+				Ref<Mesh> lod = simplifier->simplify(mesh,1.0/(2<<i));
+				int lod_faces=lod->get_faces().size();
+				if (lod_faces>faces*0.9)
+					break;
+				lod->set_name(mesh->get_name()+"_lod"+itos(i+1));
+				lods.push_back(lod);
+				faces=lod_faces;
+			}
+		}
+
+		p_lod_map[mesh]=lods;
+	}
+
+	Array lods=p_lod_map[mesh];
+	if (lods.empty())
+		return;
+
+	// switch distances grow with the mesh size
+	float size=mesh->get_aabb().get_longest_axis_size();
+	DVector<float> distances;
+	for(int i=0;i<lods.size();i++)
+		distances.push_back(size*LOD_DISTANCE_SCALE*(1<<i));
+
+	mi->set_lod_meshes(lods);
+	mi->set_lod_distances(distances);
+	mi->set_lod_hysteresis(size*0.5);
+}
+
 void EditorSceneImportPlugin::_merge_node(Node *p_node,Node*p_root,Node *p_existing,Set<Ref<Resource> >& checked_resources) {
 
 
@@ -1396,6 +1450,12 @@ Error EditorSceneImportPlugin::import(const String& p_dest_path, const Ref<Resou
 
 	scene=_fix_node(scene,scene,collision_map,scene_flags,imagemap);
 
+	if (scene_flags&SCENE_FLAG_GENERATE_LODS) {
+
+		Map<Ref<Mesh>,Array> lod_map;
+		_generate_lods(scene,lod_map);
+	}
+
 
 	/// BEFORE ANYTHING, RUN SCRIPT
 
@@ -99,8 +99,15 @@ class EditorSceneImportPlugin : public EditorImportPlugin {
 
 	Vector<Ref<EditorSceneImporter> > importers;
 
+	enum {
+		LOD_LEVELS=3,
+		LOD_MIN_FACES=256,
+		LOD_DISTANCE_SCALE=8
+	};
+
 	void _find_resources(const Variant& p_var,Set<Ref<ImageTexture> >& image_map);
 	Node* _fix_node(Node *p_node,Node *p_root,Map<Ref<Mesh>,Ref<Shape> > &collision_map,uint32_t p_flags,Set<Ref<ImageTexture> >& image_map);
+	void _generate_lods(Node *p_node,Map<Ref<Mesh>,Array> &p_lod_map);
 	void _merge_node(Node *p_node,Node*p_root,Node *p_existing,Set<Ref<Resource> >& checked_resources);
 	void _merge_scenes(Node *p_existing,Node *p_new);
 
@@ -121,7 +128,14 @@ public:
 		SCENE_FLAG_COMPRESS_GEOMETRY=512,
 		SCENE_FLAG_FAIL_ON_MISSING_IMAGES=1024,
 		SCENE_FLAG_GENERATE_TANGENT_ARRAYS=2048,
-		SCENE_FLAG_DONT_SAVE_TO_DB=8192
+		SCENE_FLAG_GENERATE_LODS=4096,
+		SCENE_FLAG_DONT_SAVE_TO_DB=8192,
+
+		//checked when the import dialog opens, generating lods is slow so it's opt-in
+		SCENE_FLAGS_DEFAULT=SCENE_FLAG_CREATE_COLLISIONS|SCENE_FLAG_CREATE_PORTALS|SCENE_FLAG_CREATE_ROOMS|
+			SCENE_FLAG_SIMPLIFY_ROOMS|SCENE_FLAG_CREATE_BILLBOARDS|SCENE_FLAG_CREATE_IMPOSTORS|
+			SCENE_FLAG_CREATE_LODS|SCENE_FLAG_REMOVE_NOIMP|SCENE_FLAG_IMPORT_ANIMATIONS|
+			SCENE_FLAG_COMPRESS_GEOMETRY|SCENE_FLAG_FAIL_ON_MISSING_IMAGES|SCENE_FLAG_GENERATE_TANGENT_ARRAYS
 	};
 
 
@@ -41,6 +41,7 @@
 #include "globals.h"
 #include "editor_node.h"
 #include "main/performance.h"
+#include "sort.h"
 
 class ScriptEditorDebuggerVariables : public Object {
 
@@ -342,6 +343,35 @@ void ScriptEditorDebugger::_parse_message(const String& p_msg,const Array& p_dat
 		perf_history.push_front(p);
 		perf_draw->update();
 
+	} else if (p_msg=="profile_frame") {
+
+		Array arr = p_data[0];
+		ERR_FAIL_COND(arr.size()%5!=0);
+
+		for(int i=0;i<arr.size();i+=5) {
+
+			String sig = arr[i+0];
+			Map<String,ProfilerItem>::Element *E=profiler_data.find(sig);
+			if (!E) {
+
+				ProfilerItem pi;
+				pi.signature=sig;
+				pi.calls=0;
+				pi.total_time=0;
+				pi.self_time=0;
+				pi.native_time=0;
+				E=profiler_data.insert(sig,pi);
+			}
+
+			ProfilerItem &pi=E->get();
+			pi.calls+=int(arr[i+1]);
+			pi.total_time+=int(arr[i+2]);
+			pi.self_time+=int(arr[i+3]);
+			pi.native_time+=int(arr[i+4]);
+		}
+
+		profiler_dirty=true;
+
 	} else if (p_msg=="kill_me") {
 
 		editor->call_deferred("stop_child_process");
@@ -350,6 +380,56 @@ void ScriptEditorDebugger::_parse_message(const String& p_msg,const Array& p_dat
 }
 
 
+void ScriptEditorDebugger::_profiler_toggled(bool p_pressed) {
+
+	if (connection.is_null() || !connection->is_connected())
+		return; //sent once the process connects
+
+	Array msg;
+	msg.push_back(p_pressed?"start_profiling":"stop_profiling");
+	ppeer->put_var(msg);
+}
+
+void ScriptEditorDebugger::_profiler_clear() {
+
+	profiler_data.clear();
+	profiler_tree->clear();
+	profiler_dirty=false;
+}
+
+void ScriptEditorDebugger::_profiler_update() {
+
+	profiler_dirty=false;
+	profiler_last_update=OS::get_singleton()->get_ticks_msec();
+
+	Vector<ProfilerItem> items;
+	items.resize(profiler_data.size());
+	int idx=0;
+	for(Map<String,ProfilerItem>::Element *E=profiler_data.front();E;E=E->next())
+		items[idx++]=E->get();
+
+	if (items.size())
+		items.sort();
+
+	profiler_tree->clear();
+	TreeItem *root=profiler_tree->create_item();
+
+	for(int i=0;i<items.size();i++) {
+
+		const ProfilerItem &pi=items[i];
+		TreeItem *it=profiler_tree->create_item(root);
+		//signature is source::line::function
+		String func=pi.signature.get_slice("::",2);
+		String source=pi.signature.get_slice("::",0).get_file();
+		it->set_text(0,func+" ("+source+":"+pi.signature.get_slice("::",1)+")");
+		it->set_tooltip(0,pi.signature);
+		it->set_text(1,itos(pi.calls));
+		it->set_text(2,rtos(pi.self_time/1000.0));
+		it->set_text(3,rtos(pi.total_time/1000.0));
+		it->set_text(4,rtos(pi.native_time/1000.0));
+	}
+}
+
 void ScriptEditorDebugger::_performance_select(Object*,int,bool) {
 
 	perf_draw->update();
@@ -447,6 +527,9 @@ void ScriptEditorDebugger::_notification(int p_what) {
 		} break;
 		case NOTIFICATION_PROCESS: {
 
+			if (profiler_dirty && OS::get_singleton()->get_ticks_msec()-profiler_last_update>1000)
+				_profiler_update();
+
 			if (connection.is_null()) {
 
 				if (server->is_connection_available()) {
@@ -460,6 +543,8 @@ void ScriptEditorDebugger::_notification(int p_what) {
 
 					ppeer->set_stream_peer(connection);
 
+					if (profiler_toggle->is_pressed())
+						_profiler_toggled(true);
 
 					show();
 					dobreak->set_disabled(false);
@@ -577,6 +662,7 @@ void ScriptEditorDebugger::start() {
 
 		perf_max[i]=0;
 	}
+	_profiler_clear();
 
 	server->listen(port);
 	set_process(true);
@@ -678,6 +764,8 @@ void ScriptEditorDebugger::_bind_methods() {
 	ObjectTypeDB::bind_method(_MD("_performance_draw"),&ScriptEditorDebugger::_performance_draw);
 	ObjectTypeDB::bind_method(_MD("_performance_select"),&ScriptEditorDebugger::_performance_select);
 	ObjectTypeDB::bind_method(_MD("_scene_tree_request"),&ScriptEditorDebugger::_scene_tree_request);
+	ObjectTypeDB::bind_method(_MD("_profiler_toggled"),&ScriptEditorDebugger::_profiler_toggled);
+	ObjectTypeDB::bind_method(_MD("_profiler_clear"),&ScriptEditorDebugger::_profiler_clear);
 
 	ADD_SIGNAL(MethodInfo("goto_script_line"));
 	ADD_SIGNAL(MethodInfo("breaked",PropertyInfo(Variant::BOOL,"reallydid")));
@@ -834,6 +922,41 @@ ScriptEditorDebugger::ScriptEditorDebugger(EditorNode *p_editor){
 
 	}
 
+	VBoxContainer *profiler_vb = memnew( VBoxContainer );
+	profiler_vb->set_name("Profiler");
+	tabs->add_child(profiler_vb);
+
+	HBoxContainer *profiler_hb = memnew( HBoxContainer );
+	profiler_vb->add_child(profiler_hb);
+	profiler_toggle = memnew( Button );
+	profiler_toggle->set_text("Profile Scripts");
+	profiler_toggle->set_toggle_mode(true);
+	profiler_toggle->connect("toggled",this,"_profiler_toggled");
+	profiler_hb->add_child(profiler_toggle);
+	Button *profiler_clear = memnew( Button );
+	profiler_clear->set_text("Clear");
+	profiler_clear->connect("pressed",this,"_profiler_clear");
+	profiler_hb->add_child(profiler_clear);
+
+	profiler_tree = memnew( Tree );
+	profiler_tree->set_v_size_flags(SIZE_EXPAND_FILL);
+	profiler_tree->set_columns(5);
+	profiler_tree->set_column_title(0,"Function");
+	profiler_tree->set_column_title(1,"Calls");
+	profiler_tree->set_column_title(2,"Self (ms)");
+	profiler_tree->set_column_title(3,"Total (ms)");
+	profiler_tree->set_column_title(4,"Native (ms)");
+	profiler_tree->set_column_expand(0,true);
+	for(int i=1;i<5;i++) {
+		profiler_tree->set_column_expand(i,false);
+		profiler_tree->set_column_min_width(i,90);
+	}
+	profiler_tree->set_column_titles_visible(true);
+	profiler_tree->set_hide_root(true);
+	profiler_vb->add_child(profiler_tree);
+	profiler_dirty=false;
+	profiler_last_update=0;
+
 	info = memnew( HSplitContainer );
 	info->set_name("Info");
 	tabs->add_child(info);
@@ -83,6 +83,23 @@ class ScriptEditorDebugger : public Control {
 	Tree *perf_monitors;
 	Control *perf_draw;
 
+	struct ProfilerItem {
+
+		String signature;
+		uint64_t calls;
+		uint64_t total_time;
+		uint64_t self_time;
+		uint64_t native_time;
+
+		bool operator<(const ProfilerItem& p_item) const { return self_time>p_item.self_time; } //slowest first
+	};
+
+	Map<String,ProfilerItem> profiler_data;
+	Tree *profiler_tree;
+	Button *profiler_toggle;
+	bool profiler_dirty;
+	uint64_t profiler_last_update;
+
 	Tree *stack_dump;
 	PropertyEditor *inspector;
 
@@ -108,6 +125,10 @@ class ScriptEditorDebugger : public Control {
 	void _scene_tree_request();
 	void _parse_message(const String& p_msg,const Array& p_data);
 
+	void _profiler_toggled(bool p_pressed);
+	void _profiler_clear();
+	void _profiler_update();
+
 protected:
 
 	void _notification(int p_what);